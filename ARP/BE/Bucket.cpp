@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <math.h>
 #include <memory.h>
 
 #include <Function.hxx>
@@ -633,28 +634,31 @@ int32_t BucketElimination::Bucket::ComputeOutputFunctions(bool DoMomentMatching)
 			}
 		// NOTE : all max_marginals[*] have same scope and the order of arguments is the same (i.e. argument lists are identical).
 
-		// compute avg max-marginals
+		// compute avg max-marginals; its table, as the tables of max-marginals, comes from the table pool of the workspace.
 		INT64 table_size = max_marginals[0]->TableSize() ;
 		if (table_size <= 0) 
 			goto done_MM ;
-		average_mm_table = new double[table_size] ;
-		if (NULL == average_mm_table) 
+		if (0 != fAvgMM.SetArguments(max_marginals[0]->N(), max_marginals[0]->Arguments())) 
+			goto done_MM ;
+		if (0 != fAvgMM.AllocateInMemoryAsSingleTableBlock() || fAvgMM.TableSize() != table_size) 
 			goto done_MM ;
+		average_mm_table = fAvgMM.TableData() ;
 		average_mm_table[0] = _Workspace->FnCombinationNeutralValue() ;
 		for (int32_t i = 1 ; i < table_size ; i++) average_mm_table[i] = average_mm_table[0] ;
 		for (int32_t j = _MiniBuckets.size() - 1 ; j >= 0 ; j--) {
 			for (int32_t i = 0; i < table_size ; i++) 
 				_Workspace->ApplyFnCombinationOperator(average_mm_table[i], max_marginals[j]->TableEntry(i)) ;
 			}
+		// the average is the N-th root wrt the combination operator; for product in normal scale this is the geometric mean.
 		double N_ = (double) _MiniBuckets.size() ;
+		bool geometric_mean = FN_COBINATION_TYPE_PROD == _Workspace->FnCombinationType() && ! _Workspace->Problem()->FunctionsAreConvertedToLogScale() ;
 		for (int32_t i = 0; i < table_size ; i++) 
-			average_mm_table[i] /= N_ ;
-
-		if (0 != fAvgMM.SetArguments(max_marginals[0]->N(), max_marginals[0]->Arguments())) 
-			goto done_MM ;
-		if (0 != fAvgMM.SetTableData(table_size, average_mm_table)) 
-			goto done_MM ;
-		average_mm_table = NULL ;
+			average_mm_table[i] = geometric_mean ? pow(average_mm_table[i], 1.0/N_) : average_mm_table[i]/N_ ;
+		// error of an average is no more than the largest error of the values averaged.
+		double e = 0.0 ;
+		for (int32_t j = _MiniBuckets.size() - 1 ; j >= 0 ; j--) 
+			{ if (max_marginals[j]->TableErrorBound() > e) e = max_marginals[j]->TableErrorBound() ; }
+		fAvgMM.SetTableErrorBound(e) ;
 		}
 
 	idx = 0 ;
@@ -669,7 +673,6 @@ int32_t BucketElimination::Bucket::ComputeOutputFunctions(bool DoMomentMatching)
 	// done with MM; delete stuff.
 	res = 0 ;
 done_MM :
-	if (NULL != average_mm_table) delete [] average_mm_table ;
 	if (NULL != max_marginals) {
 		for (int32_t j = 0 ; j < _MiniBuckets.size() ; j++) { if (NULL != max_marginals[j]) delete max_marginals[j] ; }
 		delete [] max_marginals ;
@@ -894,7 +897,7 @@ int32_t BucketElimination::Bucket::ComputeFirstVariableDistribution(ARE_Function
 		if (0 == f->N()) bews->ApplyFnCombinationOperator(const_factor, f->ConstValue()) ;
 		else { flist[nFNs++] = f ; f->ComputeArgumentsPermutationList(w, signature) ; }
 		}
-	for (; j < nTotalFunctions ; j++) {
+	for (; j < nFunctions_OA ; j++) {
 		ARE::Function *f = AugmentedFunction(j - nOF) ;
 		if (NULL == f) continue ;
 		if (0 == f->N()) bews->ApplyFnCombinationOperator(const_factor, f->ConstValue()) ;
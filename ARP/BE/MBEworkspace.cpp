@@ -6,7 +6,20 @@
 #include "process.h"    /* _beginthread, _endthread */
 #endif // WINDOWS
 
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <algorithm>
+#include <set>
+#include <queue>
+#include <functional>
+
 #include "Utils/Sort.hxx"
+#include "Utils/TaskScheduler.hxx"
 
 #include "Globals.hxx"
 #include "Utils/MiscUtils.hxx"
@@ -36,6 +49,49 @@ static void *BEWSThreadFn(void *X)
 	int32_t stop_signalled = 0 ;
 	int32_t n = bews->nBuckets() - 1 ;
 	bews->tStart() = ARE::GetTimeInMilliseconds() ;
+	if (bews->nThreads() > 1 && bews->IsValid()) {
+		// compute buckets on a thread pool, each as soon as the buckets it depends on are done.
+		std::mutex statsMutex ;
+		int32_t res = bews->ComputeBuckets([bews, &statsMutex](BucketElimination::Bucket *b) -> int32_t
+		{
+#if defined WINDOWS || _WINDOWS
+			if (0 != InterlockedCompareExchange(&(bews->_StopAndExit), 1, 1)) 
+				return 1 ;
+#else
+			pthread_mutex_lock(&BucketElimination::MBEworkspace::stopSignalMutex) ;
+			int32_t stop = bews->_StopAndExit ;
+			pthread_mutex_unlock(&BucketElimination::MBEworkspace::stopSignalMutex) ;
+			if (0 != stop) 
+				return 1 ;
+#endif
+			int32_t res = b->ComputeOutputFunctions(true) ;
+			if (0 != res) {
+				std::lock_guard<std::mutex> lock(statsMutex) ;
+				if (NULL != bews->logFile()) 
+					fprintf(bews->logFile(), "\n   MBE elimination v=%d, ERROR : ComputeOutputFunctions() returned error=%d; will quit ...", (int32_t) b->Var(0), (int32_t) res) ;
+				return res ;
+				}
+			{
+			std::lock_guard<std::mutex> lock(statsMutex) ;
+			for (BucketElimination::MiniBucket *mb : b->MiniBuckets()) {
+				double table_size_log10 = mb->OutputFunction().GetTableSize_Log10() ;
+				if (bews->TotalNewFunctionSizeComputed_Log10() < -1.0) 
+					bews->TotalNewFunctionSizeComputed_Log10() = table_size_log10 ;
+				else 
+					bews->TotalNewFunctionSizeComputed_Log10() += log10(1.0 + pow(10.0, table_size_log10 - bews->TotalNewFunctionSizeComputed_Log10())) ;
+				}
+			}
+			// tables used by the first bucket are needed by PostComputationProcessing().
+			if (0 != b->IDX()) 
+				b->NoteOutputFunctionComputationCompletion() ;
+			return 0 ;
+		}) ;
+		if (0 == res) 
+			bews->PostComputationProcessing() ;
+		if (NULL != bews->getBucket(0)) 
+			bews->getBucket(0)->NoteOutputFunctionComputationCompletion() ;
+		goto done ;
+		}
 	while (bews->IsValid()) {
 #if defined WINDOWS || _WINDOWS
 		stop_signalled = InterlockedCompareExchange(&(bews->_StopAndExit), 1, 1) ;
@@ -111,6 +167,9 @@ BucketElimination::MBEworkspace::MBEworkspace(const char *BEEMDiskSpaceDirectory
 	_Var2BucketMapping(NULL), 
 	_BTchildlistStorage(NULL), 
 	_DeleteUsedTables(false), 
+	_TableStorage(ARE_Function_TableStorage_Double), 
+	_MaxTableStorageError(0.0), 
+	_TableStorageErrorBound(0.0), 
 	_iBound(1000000), 
 	_InducedWidth(-1), 
 	_nBucketsWithPartitioning(-1), 
@@ -152,7 +211,16 @@ BucketElimination::MBEworkspace::MBEworkspace(const char *BEEMDiskSpaceDirectory
 	_MaxSimultaneousTotalFunctionSize_Log10(-1.0), 
 	_MaxSimultaneousTotalFunctionSpace_Log10(-1.0), 
 	_TotalNewFunctionSizeComputed_Log10(-1.0), 
-	_BucketOrderToCompute(NULL) 
+	_BucketOrderToCompute(NULL), 
+	_nThreads(1), 
+	_BucketScheduler(NULL), 
+	_BucketComputationTimeInMilliseconds(0.0), 
+	_CriticalPathTimeInMilliseconds(0.0), 
+	_BucketTreeWallTimeInMilliseconds(0.0), 
+	_PredictedPeakNewFunctionSpace(-1), 
+	_PredictedParallelPeakNewFunctionSpace(-1), 
+	_PredictedParallelism(1.0), 
+	_BucketSchedulingSpaceLimit(0) 
 {
 	if (! _IsValid) 
 		return ;
@@ -317,6 +385,10 @@ int32_t BucketElimination::MBEworkspace::Initialize(ARE::ARP & Problem, bool Use
 			return 1 ;
 		}
 
+	// a graph (e.g. loaded from a .gr file) has no functions; buckets are built from functions, so make one for each edge.
+	if (Problem.IsGraph() && 0 != Problem.CreateFunctionsFromGraph()) 
+		return 1 ;
+
 	if (! _IsValid || 0 != ARE::Workspace::Initialize(Problem)) 
 		{ _IsValid = false ; return 1 ; }
 	if (NULL == _Problem) 
@@ -358,7 +430,7 @@ int32_t BucketElimination::MBEworkspace::Initialize(ARE::ARP & Problem, bool Use
 		}
 	_InducedWidth = Problem.VarOrdering_InducedWidth() ;
 	for (i = 0 ; i < _nVars ; i++) 
-		_VarOrder[i] = _VarPos[i] = -1 ;
+		_VarOrder[i] = _VarPos[i] = _BucketOrderToCompute[i] = -1 ;
 	for (i = 0 ; i < _nVars ; i++) {
 		_VarOrder[i] = VarOrderingAsVarList[i] ;
 		_VarPos[_VarOrder[i]] = i ;
@@ -894,96 +966,140 @@ failed :
 int32_t BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed(int32_t MinIBound, int32_t & Ibound, double & NewFnSpaceUsed_Log10, int32_t & nBucketsPartitioned)
 {
 	Ibound = -1 ; NewFnSpaceUsed_Log10 = -1 ; nBucketsPartitioned = -1 ;
-//	int32_t original_i = _iBound ;
 
-	// get space for i=2; if this does not work, nothing will work.
-	double iMINspace = -1 ;
-	int32_t iLower ;
-	int32_t iUpper ;
+	// i-bounds are probed with EstimateMBPartitioning(), which does not touch the buckets; probes of a round are run concurrently.
+	int32_t iLower ; // largest ibound that we know that does work; actual largest ibound with space_allowed may be larger
+	int32_t iUpper ; // smallest ibound that we know that does not work
 	double iLowerspace ;
-	double iUpperspace ;
 	int32_t iLNP ;
-	_iBound = MinIBound ;
-	if (0 != CreateMBPartitioning(false, false, 0)) {
-		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR failed for i-bound=%d ...", (int32_t) _iBound) ;
+	int32_t nThreads = _nThreads > 1 ? _nThreads : 1 ;
+	std::vector<int32_t> probes ;
+	std::vector<double> space, total_space, max_space ;
+	std::vector<int32_t> nNP, res ;
+	// one partitioning engine per thread; its buffers are reused across rounds.
+	std::vector<BucketElimination::SymbolicMBPartitioning> engines(nThreads) ;
+	// evaluate all probes; space of each is what is bounded by MaxSpaceAllowed.
+	auto evaluate = [&](void) -> void
+	{
+		int32_t n = probes.size() ;
+		space.assign(n, -1.0) ; total_space.assign(n, -1.0) ; max_space.assign(n, -1.0) ; nNP.assign(n, -1) ; res.assign(n, 1) ;
+		ARE::utils::ParallelFor(nThreads < n ? nThreads : n, n, 1, [&](int32_t ThreadIdx, int64_t Begin, int64_t End) 
+		{
+			for (int64_t k = Begin ; k < End ; k++) 
+				res[k] = EstimateMBPartitioning(engines[ThreadIdx], probes[k], total_space[k], max_space[k], nNP[k]) ;
+		}) ;
+		for (int32_t k = 0 ; k < n ; k++) {
+			space[k] = _DeleteUsedTables ? max_space[k] : total_space[k] ;
+			if (0 == res[k]) 
+				fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space = %g ...", (int32_t) probes[k], space[k]) ;
+			else 
+				fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR failed for i-bound=%d ...", (int32_t) probes[k]) ;
+			}
 		::fflush(ARE::fpLOG) ;
+	} ;
+
+	// estimation of max simultaneous space needs the computation order.
+	if (0 != CreateComputationOrder(0)) 
 		goto failed ;
-		}
-	iMINspace = _DeleteUsedTables ? _MaxSimultaneousNewFunctionSpace_Log10 : _TotalNewFunctionSpace_Log10 ;
-	fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space = %g ...", (int32_t) _iBound, iMINspace) ;
-	::fflush(ARE::fpLOG) ;
-	if (iMINspace > _MaxSpaceAllowed_Log10) {
-		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space exceeds max allowed %g; will quit ...", (int32_t) _iBound, _MaxSpaceAllowed_Log10) ;
+
+	// get space for MinIBound; if this does not work, nothing will work. iUpper=w*+1 might work; needs to be checked.
+	iLower = MinIBound ;
+	iUpper = _InducedWidth > 0 ? _InducedWidth+1 : _nVars ;
+	probes.clear() ;
+	probes.push_back(iLower) ;
+	if (iUpper > iLower) 
+		probes.push_back(iUpper) ;
+	evaluate() ;
+	if (0 != res[0]) 
+		goto failed ;
+	if (space[0] > _MaxSpaceAllowed_Log10) {
+		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space exceeds max allowed %g; will quit ...", (int32_t) iLower, _MaxSpaceAllowed_Log10) ;
 		::fflush(ARE::fpLOG) ;
 		goto failed ;
 		}
-	iLower = MinIBound ; // iLower is largest ibound that we know that does work; actual largest ibound with space_allowed may be larger
-	iUpper = _InducedWidth > 0 ? _InducedWidth+1 : _nVars ;
-	iLowerspace = iMINspace ;
-	iLNP = _nBucketsWithPartitioning ;
-//goto done ;
+	iLowerspace = space[0] ;
+	iLNP = nNP[0] ;
 	if (_InducedWidth > 0 && _InducedWidth < 2) {
 		// if w* is < 2, the i=2 is all we need to check, since minibucket size limit of 2 should be sufficient
-		if (0 != _nBucketsWithPartitioning) {
-			fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR : w*(%d)<2 and i-bound=%d, but there is partitioning ...", (int32_t) _InducedWidth, (int32_t) _iBound) ;
+		if (0 != iLNP) {
+			fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR : w*(%d)<2 and i-bound=%d, but there is partitioning ...", (int32_t) _InducedWidth, (int32_t) iLower) ;
 			::fflush(ARE::fpLOG) ;
 			goto failed ;
 			}
 		goto done ;
 		}
-	if (0 == _nBucketsWithPartitioning) 
+	if (0 == iLNP || probes.size() < 2) 
 		goto done ; // increasing i-bound will not improve; already no partitioning
-
-	// iUpper might work; needs to be checked.
-	_iBound = iUpper ;
-	if (0 != CreateMBPartitioning(false, false, 0)) 
+	if (0 != res[1]) 
 		goto done ;
-	iUpperspace = _DeleteUsedTables ? _MaxSimultaneousNewFunctionSpace_Log10 : _TotalNewFunctionSpace_Log10 ;
-	fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space = %g ...", (int32_t) _iBound, (double) iUpperspace) ;
-	::fflush(ARE::fpLOG) ;
-	if (0 != _nBucketsWithPartitioning) {
-		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR : ibound(%d) >= w*(%d)+1, but there is partitioning ...", (int32_t) _iBound, (int32_t) _InducedWidth) ;
+	if (0 != nNP[1]) {
+		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; ERROR : ibound(%d) >= w*(%d)+1, but there is partitioning ...", (int32_t) iUpper, (int32_t) _InducedWidth) ;
 		::fflush(ARE::fpLOG) ;
 		goto failed ;
 		}
-	if (iUpperspace <= _MaxSpaceAllowed_Log10) 
-		{ iLower = iUpper ; iLowerspace = iUpperspace ; iLNP = _nBucketsWithPartitioning ; goto done ; }
-
-	// iLower is ok, iUpper is not ok.
-	while (iLower < iUpper) {
-		_iBound = (iLower + iUpper)/2 ;
-		if (_iBound <= iLower) 
-			goto done ;
-		double space = -1 ;
-		if (0 != CreateMBPartitioning(false, false, 0)) 
-			goto done ;
-		space = _DeleteUsedTables ? _MaxSimultaneousNewFunctionSpace_Log10 : _TotalNewFunctionSpace_Log10 ;
-		fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; i-bound=%d space = %g ...", (int32_t) _iBound, (double) space) ;
-		if (space <= _MaxSpaceAllowed_Log10) {
-			iLower = _iBound ; iLowerspace = space ; iLNP = _nBucketsWithPartitioning ;
-			if (0 == _nBucketsWithPartitioning) 
+	if (space[1] <= _MaxSpaceAllowed_Log10) 
+		{ iLower = iUpper ; iLowerspace = space[1] ; iLNP = nNP[1] ; goto done ; }
+
+	// iLower is ok, iUpper is not ok. each round probes nThreads i-bounds evenly spaced in between; with 1 thread, this is binary search.
+	while (iUpper - iLower > 1) {
+		probes.clear() ;
+		for (int32_t k = 1 ; k <= nThreads ; k++) {
+			int32_t i = iLower + (int32_t) (((int64_t) (iUpper - iLower) * k)/(nThreads + 1)) ;
+			if (i > iLower && i < iUpper && (0 == probes.size() || i > probes.back())) 
+				probes.push_back(i) ;
+			}
+		if (0 == probes.size()) 
+			probes.push_back(iLower + 1) ;
+		evaluate() ;
+		// space grows with i-bound; find the largest probe that works.
+		int32_t n = probes.size(), k ;
+		for (k = 0 ; k < n ; k++) {
+			if (0 != res[k]) 
+				goto done ;
+			if (space[k] > _MaxSpaceAllowed_Log10) 
+				{ iUpper = probes[k] ; break ; }
+			iLower = probes[k] ; iLowerspace = space[k] ; iLNP = nNP[k] ;
+			if (0 == iLNP) 
 				// there is no point in checking higher iBounds since we have no partitioning at current iBound.
 				goto done ;
 			}
-		else 
-			{ iUpper = _iBound ; }
 		}
 
 done :
 	fprintf(ARE::fpLOG, "\n   BucketElimination::MBEworkspace::FindIBoundForSpaceAllowed; done; iLower=%d iUpper=%d iLowerspace=%g ...", (int32_t) iLower, (int32_t) iUpper, (double) iLowerspace) ;
 	::fflush(ARE::fpLOG) ;
-//	_iBound = original_i ;
+	_iBound = iLower ;
 	Ibound = iLower ;
 	NewFnSpaceUsed_Log10 = iLowerspace ;
 	nBucketsPartitioned = iLNP ;
 	return 0 ;
 
 failed :
-//	_iBound = original_i ;
 	return 1 ;
 }
 
 
+int32_t BucketElimination::MBEworkspace::EstimateMBPartitioning(int32_t iBound, double & TotalNewFunctionSpace_Log10, double & MaxSimultaneousNewFunctionSpace_Log10, int32_t & nBucketsWithPartitioning)
+{
+	BucketElimination::SymbolicMBPartitioning partitioning ;
+	return EstimateMBPartitioning(partitioning, iBound, TotalNewFunctionSpace_Log10, MaxSimultaneousNewFunctionSpace_Log10, nBucketsWithPartitioning) ;
+}
+
+
+int32_t BucketElimination::MBEworkspace::EstimateMBPartitioning(BucketElimination::SymbolicMBPartitioning & Partitioning, int32_t iBound, double & TotalNewFunctionSpace_Log10, double & MaxSimultaneousNewFunctionSpace_Log10, int32_t & nBucketsWithPartitioning)
+{
+	TotalNewFunctionSpace_Log10 = MaxSimultaneousNewFunctionSpace_Log10 = -1.0 ; nBucketsWithPartitioning = -1 ;
+	if (NULL == _Buckets || NULL == _VarPos || NULL == _Problem) 
+		return 1 ;
+	if (0 != Partitioning.Run(*this, iBound, ComputationOrderIsValid() ? _BucketOrderToCompute : NULL)) 
+		return 1 ;
+	TotalNewFunctionSpace_Log10 = Partitioning.TotalNewFunctionSpace_Log10() ;
+	MaxSimultaneousNewFunctionSpace_Log10 = Partitioning.MaxSimultaneousNewFunctionSpace_Log10() ;
+	nBucketsWithPartitioning = Partitioning.nBucketsWithPartitioning() ;
+	return 0 ;
+}
+
+
 int32_t BucketElimination::MBEworkspace::CreateMBPartitioning(bool CreateTables, bool doMomentMatching, int32_t ComputeComputationOrder)
 {
 	DestroyMBPartitioning() ;
@@ -1287,6 +1403,59 @@ int32_t BucketElimination::MBEworkspace::CreateComputationOrder(int32_t algorith
 			int32_t bug_here = 1 ;
 			}
 		}
+	else if (2 == algorithm) {
+		std::vector<int64_t> out, released ;
+		if (0 != ComputeBucketTableSpace(out, released)) 
+			return 1 ;
+		std::vector<std::vector<int32_t>> children(_nBuckets) ;
+		std::vector<int32_t> roots ;
+		for (i = 0 ; i < _nBuckets ; i++) {
+			BucketElimination::Bucket *P = _Buckets[i]->ParentBucket() ;
+			if (NULL == P) 
+				roots.push_back(i) ;
+			else if (P->IDX() >= i) 
+				return 1 ;
+			else 
+				children[P->IDX()].push_back(i) ;
+			}
+		// for the subtree of each bucket, compute the peak space while computing it and the space left over when it is done 
+		// (output tables of buckets in the subtree used by buckets above it); children come later in the bucket order.
+		std::vector<int64_t> peak(_nBuckets, 0), residual(_nBuckets, 0) ;
+		auto liu_order = [&peak, &residual](int32_t x, int32_t y) -> bool
+		{
+			int64_t dx = peak[x] - residual[x], dy = peak[y] - residual[y] ;
+			return dx != dy ? dx > dy : x < y ;
+		} ;
+		for (i = _nBuckets - 1 ; i >= 0 ; i--) {
+			std::sort(children[i].begin(), children[i].end(), liu_order) ;
+			int64_t space = 0, p = 0 ;
+			for (int32_t c : children[i]) {
+				if (space + peak[c] > p) 
+					p = space + peak[c] ;
+				space += residual[c] ;
+				}
+			if (space + out[i] > p) 
+				p = space + out[i] ;
+			peak[i] = p ;
+			residual[i] = space + out[i] - released[i] ;
+			}
+		std::sort(roots.begin(), roots.end(), liu_order) ;
+		// each bucket is computed after its children, in the order of the children; the order is filled from last to first.
+		int32_t n = _nBuckets ;
+		std::vector<std::pair<int32_t, int32_t>> stack ; // bucket, next child
+		for (int32_t r : roots) {
+			stack.push_back(std::make_pair(r, 0)) ;
+			while (stack.size() > 0) {
+				std::pair<int32_t, int32_t> & top = stack.back() ;
+				if (top.second < (int32_t) children[top.first].size()) 
+					{ int32_t c = children[top.first][top.second++] ; stack.push_back(std::make_pair(c, 0)) ; continue ; }
+				_BucketOrderToCompute[--n] = top.first ;
+				stack.pop_back() ;
+				}
+			}
+		if (0 != n) 
+			return 1 ;
+		}
 	else {
 		// sort by height descending
 		int32_t *keys = new int32_t[_nBuckets] ;
@@ -1567,43 +1736,690 @@ int32_t BucketElimination::MBEworkspace::ComputeMaxBucketFunctionWidth(void)
 }
 
 
-int32_t BucketElimination::MBEworkspace::RunSimple(void)
+// state of MBEworkspace::ComputeBuckets() when run on a thread pool.
+class BucketTreeExecution
 {
-	int32_t i ;
+public :
+	BucketElimination::MBEworkspace & _WS ;
+	const std::function<int32_t(BucketElimination::Bucket *B)> & _Fn ;
+	const std::vector<std::vector<int32_t>> & _Consumers ; // buckets using output functions of each bucket
+	const std::vector<int32_t> & _Rank ; // ready buckets are started lowest rank first
+	const std::vector<int64_t> & _OutputSpace ; // space of output tables of each bucket
+	const std::vector<int64_t> & _ReleasedSpace ; // space of tables each bucket deletes after use
+	std::vector<int32_t> _nPending ; // number of buckets each bucket is still waiting for
+	double *_tBucket ; // computation time of each bucket [msec]
+	std::atomic<int32_t> _Error ;
+	std::mutex _M ; // protects all of the below
+	std::set<std::pair<int32_t, int32_t>> _Ready ; // rank, bucket
+	int32_t _nRunning ;
+	int64_t _Space ; // space of output tables of buckets being computed and of tables not yet used
+	ARE::utils::TaskScheduler _Scheduler ;
+
+	// start ready buckets, up to nThreads() at a time; a bucket whose output tables don't fit within BucketSchedulingSpaceLimit() waits 
+	// until other buckets are done. _M must be locked.
+	void Dispatch(void) ;
+
+	BucketTreeExecution(BucketElimination::MBEworkspace & WS, const std::function<int32_t(BucketElimination::Bucket *B)> & Fn, 
+		const std::vector<std::vector<int32_t>> & Producers, const std::vector<std::vector<int32_t>> & Consumers, const std::vector<int32_t> & Rank, 
+		const std::vector<int64_t> & OutputSpace, const std::vector<int64_t> & ReleasedSpace, double *tBucket)
+		:
+		_WS(WS), 
+		_Fn(Fn), 
+		_Consumers(Consumers), 
+		_Rank(Rank), 
+		_OutputSpace(OutputSpace), 
+		_ReleasedSpace(ReleasedSpace), 
+		_nPending(Producers.size(), 0), 
+		_tBucket(tBucket), 
+		_Error(0), 
+		_nRunning(0), 
+		_Space(0)
+	{
+		for (int32_t i = 0 ; i < (int32_t) Producers.size() ; i++) {
+			_nPending[i] = (int32_t) Producers[i].size() ;
+			if (0 == _nPending[i]) 
+				_Ready.insert(std::make_pair(_Rank[i], i)) ;
+			}
+	}
+} ;
 
-	for (i = _nBuckets - 1 ; i >= 0 ; i--) {
+// computes one bucket; when done, starts the buckets that were waiting only for this one.
+class BucketTask : public ARE::utils::Task
+{
+protected :
+	BucketTreeExecution & _E ;
+	int32_t _IDX ;
+public :
+	virtual int32_t Execute(int32_t /* ThreadIdx */)
+	{
+		if (0 == _E._Error) {
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now() ;
+			int32_t res = _E._Fn(_E._WS.getBucket(_IDX)) ;
+			_E._tBucket[_IDX] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() ;
+			if (0 != res) {
+				int32_t noerror = 0 ;
+				_E._Error.compare_exchange_strong(noerror, res) ;
+				_E._Scheduler.Cancel() ;
+				}
+			}
+		std::lock_guard<std::mutex> lock(_E._M) ;
+		_E._nRunning-- ;
+		_E._Space -= _E._ReleasedSpace[_IDX] ;
+		if (0 != _E._Error) 
+			return 0 ;
+		for (int32_t c : _E._Consumers[_IDX]) {
+			if (0 == --_E._nPending[c]) 
+				_E._Ready.insert(std::make_pair(_E._Rank[c], c)) ;
+			}
+		_E.Dispatch() ;
+		return 0 ;
+	}
+	BucketTask(BucketTreeExecution & E, int32_t IDX) : _E(E), _IDX(IDX) { }
+} ;
+
+void BucketTreeExecution::Dispatch(void)
+{
+	int64_t limit = _WS.BucketSchedulingSpaceLimit() ;
+	while (_nRunning < _WS.nThreads() && _Ready.size() > 0) {
+		int32_t b = _Ready.begin()->second ;
+		if (limit > 0 && _nRunning > 0 && _Space + _OutputSpace[b] > limit) 
+			break ;
+		_Ready.erase(_Ready.begin()) ;
+		_nRunning++ ;
+		_Space += _OutputSpace[b] ;
+		BucketTask *t = new BucketTask(*this, b) ;
+		if (NULL == t || 0 != _Scheduler.Submit(t)) {
+			_nRunning-- ;
+			int32_t noerror = 0 ;
+			_Error.compare_exchange_strong(noerror, 1) ;
+			break ;
+			}
+		}
+}
+
+// tables of MBE generated functions, when the workspace has a table memory limit (see ARE::Workspace::UseDiskTableBlocks()).
+// when tables in memory exceed the limit, tables are saved to disk as blocks and removed from memory, those needed last first; 
+// before a bucket is computed, its input tables are loaded back. after a bucket is computed, input tables of its parent bucket and of the 
+// next bucket by rank are loaded ahead of time by a background thread, if they fit within the limit.
+// the limit is soft : input/output tables of the buckets being computed are always in memory.
+class DiskTableCache
+{
+public :
+	enum { InMemory = 1, OnDisk = 2, Loading = 3, Saving = 4, Deleted = 5 } ;
+	class TableState
+	{
+	public :
+		int32_t _State ;
+		int32_t _nUsers ; // number of buckets being computed that use this table
+		TableState(void) : _State(0), _nUsers(0) { }
+	} ;
+	BucketElimination::MBEworkspace & _WS ;
+	std::mutex _M ;
+	std::condition_variable _CV ;
+	int64_t _SpaceInMemory ; // bytes of tables in memory, including tables being loaded and output tables being computed
+	std::vector<ARE::Function *> _InMemory ; // functions whose table is in memory
+	std::unordered_map<ARE::Function *, TableState> _Tables ;
+	std::vector<bool> _Done ; // buckets that are computed
+	std::vector<int32_t> _Rank, _Order ; // rank of each bucket and buckets by rank (see MBEworkspace::ComputeBucketRanks())
+	std::vector<ARE::Function *> _LoadQueue ;
+	bool _StopLoader ;
+	std::thread _Loader ;
+
+	static inline int64_t TableSpace(ARE::Function & F) { return F.N() > 0 && F.TableSize() > 0 ? F.TableSize()*F.TableEntrySize() : 0 ; }
+	// output tables are computed in double precision, before they are converted to MBEworkspace::TableStorage().
+	static inline int64_t OutputTableSpace(ARE::Function & F) { return F.N() > 0 && F.TableSize() > 0 ? F.TableSize()*((int64_t) sizeof(ARE_Function_TableType)) : 0 ; }
+
+	// free memory by moving tables to disk, until needed space fits within the limit; tables used by buckets being computed are not moved.
+	// tables whose bucket is computed go first, then tables whose bucket comes last in the bucket order (computed last).
+	// lock must be held.
+	int32_t MakeSpace(std::unique_lock<std::mutex> & lock, int64_t Space)
+	{
+		while (_SpaceInMemory + Space > _WS.TableMemoryLimit()) {
+			int32_t i, victim = -1 ;
+			int32_t victim_key = INT_MAX ;
+			for (i = 0 ; i < (int32_t) _InMemory.size() ; i++) {
+				ARE::Function *f = _InMemory[i] ;
+				TableState & ts = _Tables[f] ;
+				if (ts._nUsers > 0) continue ;
+				BucketElimination::Bucket *b = f->Bucket() ;
+				int32_t key = NULL != b ? b->IDX() : -1 ;
+				if (key >= 0 && _Done[key]) {
+					// tables of the first bucket are needed by PostComputationProcessing().
+					if (0 == key) continue ;
+					key = -1 ;
+					}
+				if (key < victim_key) 
+					{ victim = i ; victim_key = key ; }
+				}
+			if (victim < 0) 
+				return 1 ;
+			ARE::Function *f = _InMemory[victim] ;
+			_InMemory[victim] = _InMemory.back() ; _InMemory.pop_back() ;
+			TableState & ts = _Tables[f] ;
+			ts._State = Saving ;
+			int64_t space = TableSpace(*f) ;
+			_SpaceInMemory -= space ;
+			lock.unlock() ;
+			int32_t res = f->SaveTableBlocks(_WS.DiskTableBlockSize()) ;
+			if (0 == res) 
+				f->DestroyTableData() ;
+			lock.lock() ;
+			if (0 != res) {
+				_Tables[f]._State = InMemory ; _InMemory.push_back(f) ; _SpaceInMemory += space ;
+				_CV.notify_all() ;
+				return res ;
+				}
+			_Tables[f]._State = OnDisk ;
+			_CV.notify_all() ;
+			}
+		return 0 ;
+	}
+
+	// load tables of the given bucket ahead of time, if they fit; lock must be held.
+	void Prefetch(BucketElimination::Bucket *B)
+	{
+		if (NULL == B || _Done[B->IDX()]) 
+			return ;
+		for (int32_t j = 0 ; j < B->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = B->AugmentedFunction(j) ;
+			std::unordered_map<ARE::Function *, TableState>::iterator it = NULL != f ? _Tables.find(f) : _Tables.end() ;
+			if (_Tables.end() == it || OnDisk != it->second._State) 
+				continue ;
+			int64_t space = TableSpace(*f) ;
+			if (_SpaceInMemory + space > _WS.TableMemoryLimit()) 
+				continue ;
+			it->second._State = Loading ;
+			_SpaceInMemory += space ;
+			_LoadQueue.push_back(f) ;
+			}
+		if (_LoadQueue.size() > 0) 
+			_CV.notify_all() ;
+	}
+
+	void LoaderThreadFn(void)
+	{
+		std::unique_lock<std::mutex> lock(_M) ;
+		while (true) {
+			while (! _StopLoader && 0 == _LoadQueue.size()) 
+				_CV.wait(lock) ;
+			if (_StopLoader) 
+				break ;
+			ARE::Function *f = _LoadQueue.front() ;
+			_LoadQueue.erase(_LoadQueue.begin()) ;
+			lock.unlock() ;
+			int32_t res = f->LoadTableBlocks() ;
+			lock.lock() ;
+			if (0 == res) 
+				{ _Tables[f]._State = InMemory ; _InMemory.push_back(f) ; }
+			else 
+				{ _Tables[f]._State = OnDisk ; _SpaceInMemory -= TableSpace(*f) ; }
+			_CV.notify_all() ;
+			}
+		// tables that were queued, but not loaded, stay on disk.
+		for (ARE::Function *f : _LoadQueue) 
+			{ _Tables[f]._State = OnDisk ; _SpaceInMemory -= TableSpace(*f) ; }
+		_LoadQueue.clear() ;
+		_CV.notify_all() ;
+	}
+
+	// make sure input tables of B are in memory; reserve space for output tables of B.
+	int32_t BeforeBucket(BucketElimination::Bucket *B)
+	{
+		int32_t j, res = 0 ;
+		int64_t tStart = ARE::GetTimeInMilliseconds() ;
+		std::unique_lock<std::mutex> lock(_M) ;
+		int64_t space = 0 ;
+		for (BucketElimination::MiniBucket *mb : B->MiniBuckets()) {
+			ARE::Function & f = mb->OutputFunction() ;
+			if (f.N() > 0) f.ComputeTableSize() ;
+			space += OutputTableSpace(f) ;
+			}
+		int64_t space_out = space ;
+		for (j = 0 ; j < B->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = B->AugmentedFunction(j) ;
+			std::unordered_map<ARE::Function *, TableState>::iterator it = NULL != f ? _Tables.find(f) : _Tables.end() ;
+			if (_Tables.end() == it) 
+				continue ;
+			it->second._nUsers++ ;
+			if (InMemory != it->second._State) 
+				space += TableSpace(*f) ;
+			}
+		MakeSpace(lock, space) ;
+		_SpaceInMemory += space_out ;
+		for (j = 0 ; j < B->nAugmentedFunctions() && 0 == res ; j++) {
+			ARE::Function *f = B->AugmentedFunction(j) ;
+			if (NULL == f || _Tables.end() == _Tables.find(f)) 
+				continue ;
+			if (Loading == _Tables[f]._State || Saving == _Tables[f]._State) {
+				int64_t tWaitStart = ARE::GetTimeInMilliseconds() ;
+				while (Loading == _Tables[f]._State || Saving == _Tables[f]._State) 
+					_CV.wait(lock) ;
+				_WS.NoteInputTableBlocksWait(B->IDX(), -1, true, (long) (ARE::GetTimeInMilliseconds() - tWaitStart)) ;
+				}
+			TableState & ts = _Tables[f] ;
+			if (OnDisk != ts._State) 
+				continue ;
+			ts._State = Loading ;
+			int64_t s = TableSpace(*f) ;
+			_SpaceInMemory += s ;
+			lock.unlock() ;
+			res = f->LoadTableBlocks() ;
+			lock.lock() ;
+			if (0 == res) 
+				{ _Tables[f]._State = InMemory ; _InMemory.push_back(f) ; }
+			else 
+				{ _Tables[f]._State = OnDisk ; _SpaceInMemory -= s ; res = ERRORCODE_input_FTB_computed_but_failed_to_fetch ; }
+			_CV.notify_all() ;
+			}
+		lock.unlock() ;
+		_WS.NoteInputTableGetTime((DWORD) (ARE::GetTimeInMilliseconds() - tStart)) ;
+		return res ;
+	}
+
+	// B is computed (or failed); take account of its output tables and of its input tables, if they were deleted.
+	// make space, then load ahead input tables of the buckets that are likely to be computed next.
+	// not being able to get within the limit is not an error; tables stay in memory.
+	void AfterBucket(BucketElimination::Bucket *B)
+	{
+		int32_t j ;
+		std::unique_lock<std::mutex> lock(_M) ;
+		_Done[B->IDX()] = true ;
+		for (BucketElimination::MiniBucket *mb : B->MiniBuckets()) {
+			ARE::Function & f = mb->OutputFunction() ;
+			_SpaceInMemory -= OutputTableSpace(f) ;
+			if (! f.HasTableData() || TableSpace(f) <= 0) 
+				continue ;
+			_Tables[&f]._State = InMemory ;
+			_InMemory.push_back(&f) ;
+			_SpaceInMemory += TableSpace(f) ;
+			}
+		for (j = 0 ; j < B->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = B->AugmentedFunction(j) ;
+			std::unordered_map<ARE::Function *, TableState>::iterator it = NULL != f ? _Tables.find(f) : _Tables.end() ;
+			if (_Tables.end() == it) 
+				continue ;
+			it->second._nUsers-- ;
+			if (InMemory != it->second._State || f->HasTableData()) 
+				continue ;
+			// table was deleted after use (see MBEworkspace::DeleteUsedTables()); blocks on disk are not needed either.
+			it->second._State = Deleted ;
+			_InMemory.erase(std::find(_InMemory.begin(), _InMemory.end(), f)) ;
+			_SpaceInMemory -= TableSpace(*f) ;
+			f->DeleteTableBlocks() ;
+			}
+		MakeSpace(lock, 0) ;
+		for (BucketElimination::MiniBucket *mb : B->MiniBuckets()) 
+			Prefetch(mb->OutputFunction().Bucket()) ;
+		int32_t next = _Rank[B->IDX()] + 1 ;
+		if (next < (int32_t) _Order.size()) 
+			Prefetch(_WS.getBucket(_Order[next])) ;
+	}
+
+	int32_t Start(void)
+	{
+		try {
+			_Loader = std::thread(&DiskTableCache::LoaderThreadFn, this) ;
+			}
+		catch (...) {
+			return 1 ;
+			}
+		return 0 ;
+	}
+	void Stop(void)
+	{
+		{
+		std::lock_guard<std::mutex> lock(_M) ;
+		_StopLoader = true ;
+		_CV.notify_all() ;
+		}
+		if (_Loader.joinable()) 
+			_Loader.join() ;
+	}
+
+	DiskTableCache(BucketElimination::MBEworkspace & WS, const std::vector<int32_t> & Rank)
+		:
+		_WS(WS), 
+		_SpaceInMemory(0), 
+		_Done(WS.nBuckets(), false), 
+		_Rank(Rank), 
+		_Order(Rank.size()), 
+		_StopLoader(false)
+	{
+		for (int32_t i = 0 ; i < (int32_t) Rank.size() ; i++) 
+			_Order[Rank[i]] = i ;
+	}
+} ;
+
+
+int32_t BucketElimination::MBEworkspace::ComputeBucketTableSpace(std::vector<int64_t> & OutputSpace, std::vector<int64_t> & ReleasedSpace)
+{
+	int32_t i, j ;
+
+	OutputSpace.assign(_nBuckets, 0) ;
+	ReleasedSpace.assign(_nBuckets, 0) ;
+	if (NULL == _Buckets) 
+		return 1 ;
+	for (i = 0 ; i < _nBuckets ; i++) {
 		BucketElimination::Bucket *b = _Buckets[i] ;
-		std::vector<MiniBucket *> & mbs = b->MiniBuckets() ;
-		for (MiniBucket *mb : mbs) {
+		for (MiniBucket *mb : b->MiniBuckets()) {
 			ARE::Function & f = mb->OutputFunction() ;
-			f.AllocateInMemoryAsSingleTableBlock() ;
+			if (f.N() > 0 && f.ComputeTableSize() > 0) 
+				OutputSpace[i] += f.TableSize()*ARE::Function::TableStorageEntrySize(TableStorage()) ;
+			}
+		if (! _DeleteUsedTables) 
+			continue ;
+		for (j = 0 ; j < b->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = b->AugmentedFunction(j) ;
+			if (NULL == f || NULL == f->OriginatingMiniBucket() || f->N() <= 0) 
+				continue ;
+			if (f->ComputeTableSize() > 0) 
+				ReleasedSpace[i] += f->TableSize()*ARE::Function::TableStorageEntrySize(TableStorage()) ;
 			}
 		}
+	return 0 ;
+}
 
-	// compute all minibucket output functions
-	for (i = _nBuckets - 1 ; i >= 0 ; i--) {
+
+int32_t BucketElimination::MBEworkspace::ComputeBucketDependencies(std::vector<std::vector<int32_t>> & Producers, std::vector<std::vector<int32_t>> & Consumers)
+{
+	int32_t i, j ;
+
+	Producers.assign(_nBuckets, std::vector<int32_t>()) ;
+	Consumers.assign(_nBuckets, std::vector<int32_t>()) ;
+	// bucket i uses output functions of buckets Producers[i]; these come later in the bucket order.
+	for (i = 0 ; i < _nBuckets ; i++) {
 		BucketElimination::Bucket *b = _Buckets[i] ;
-		std::vector<MiniBucket *> & mbs = b->MiniBuckets() ;
-		for (MiniBucket *mb : mbs) {
-			ARE::Function & f = mb->OutputFunction() ;
-			mb->ComputeOutputFunction(NULL, NULL) ;
+		if (NULL == b || b->IDX() != i) 
+			return 1 ;
+		for (j = 0 ; j < b->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = b->AugmentedFunction(j) ;
+			BucketElimination::Bucket *B = NULL != f ? f->OriginatingBucket() : NULL ;
+			if (NULL == B || B == b) 
+				continue ;
+			if (B->IDX() <= i) 
+				return 1 ;
+			Producers[i].push_back(B->IDX()) ;
+			Consumers[B->IDX()].push_back(i) ;
 			}
 		}
+	return 0 ;
+}
+
+
+bool BucketElimination::MBEworkspace::ComputationOrderIsValid(void) const
+{
+	if (NULL == _BucketOrderToCompute || _nBuckets < 1) 
+		return false ;
+	std::vector<char> seen(_nBuckets, 0) ;
+	for (int32_t i = 0 ; i < _nBuckets ; i++) {
+		int32_t b = _BucketOrderToCompute[i] ;
+		if (b < 0 || b >= _nBuckets || 0 != seen[b]) 
+			return false ;
+		seen[b] = 1 ;
+		}
+	return true ;
+}
+
 
+int32_t BucketElimination::MBEworkspace::ComputeBucketRanks(const std::vector<std::vector<int32_t>> & Producers, std::vector<int32_t> & Rank)
+{
+	int32_t i ;
+
+	Rank.assign(_nBuckets, -1) ;
+	bool valid = NULL != _BucketOrderToCompute ;
+	for (i = 0 ; i < _nBuckets && valid ; i++) {
+		int32_t b = _BucketOrderToCompute[_nBuckets - 1 - i] ;
+		if (b < 0 || b >= _nBuckets || Rank[b] >= 0) 
+			{ valid = false ; break ; }
+		Rank[b] = i ;
+		}
+	for (i = 0 ; i < _nBuckets && valid ; i++) {
+		for (int32_t p : Producers[i]) 
+			{ if (Rank[p] > Rank[i]) { valid = false ; break ; } }
+		}
+	if (! valid) {
+		for (i = 0 ; i < _nBuckets ; i++) 
+			Rank[i] = _nBuckets - 1 - i ;
+		}
 	return 0 ;
 }
 
 
-int32_t BucketElimination::MBEworkspace::ComputeOutputFunctions(bool DoMomentMatching)
+int32_t BucketElimination::MBEworkspace::PredictComputation(int32_t nThreads, int64_t SpaceLimit)
 {
 	int32_t i ;
 
+	_PredictedPeakNewFunctionSpace = _PredictedParallelPeakNewFunctionSpace = -1 ;
+	_PredictedParallelism = 1.0 ;
+	if (_nBuckets <= 0 || NULL == _Buckets) 
+		return 0 ;
+	std::vector<std::vector<int32_t>> producers, consumers ;
+	std::vector<int32_t> rank ;
+	std::vector<int64_t> out, released ;
+	if (0 != ComputeBucketDependencies(producers, consumers) || 0 != ComputeBucketRanks(producers, rank) || 0 != ComputeBucketTableSpace(out, released)) 
+		return 1 ;
+
+	// one bucket at a time, in the order of rank
+	std::vector<int32_t> order(_nBuckets) ;
+	for (i = 0 ; i < _nBuckets ; i++) 
+		order[rank[i]] = i ;
+	int64_t space = 0, peak = 0 ;
+	for (int32_t b : order) {
+		space += out[b] ;
+		if (space > peak) 
+			peak = space ;
+		space -= released[b] ;
+		}
+	_PredictedPeakNewFunctionSpace = peak ;
+
+	// nThreads at a time; each bucket takes time proportional to its processing complexity. this is the schedule of BucketTreeExecution::Dispatch().
+	std::vector<double> cost(_nBuckets, 0.0) ;
+	double work = 0.0 ;
+	for (i = 0 ; i < _nBuckets ; i++) {
+		for (MiniBucket *mb : _Buckets[i]->MiniBuckets()) 
+			cost[i] += (double) mb->ComputeProcessingComplexity() ;
+		if (cost[i] < 1.0) 
+			cost[i] = 1.0 ;
+		work += cost[i] ;
+		}
+	std::vector<int32_t> nPending(_nBuckets) ;
+	std::set<std::pair<int32_t, int32_t>> ready ;
+	for (i = 0 ; i < _nBuckets ; i++) {
+		nPending[i] = (int32_t) producers[i].size() ;
+		if (0 == nPending[i]) 
+			ready.insert(std::make_pair(rank[i], i)) ;
+		}
+	std::priority_queue<std::pair<double, int32_t>, std::vector<std::pair<double, int32_t>>, std::greater<std::pair<double, int32_t>>> running ;
+	double t = 0.0 ;
+	space = peak = 0 ;
+	if (nThreads < 1) 
+		nThreads = 1 ;
+	while (true) {
+		while ((int32_t) running.size() < nThreads && ready.size() > 0) {
+			int32_t b = ready.begin()->second ;
+			if (SpaceLimit > 0 && running.size() > 0 && space + out[b] > SpaceLimit) 
+				break ;
+			ready.erase(ready.begin()) ;
+			space += out[b] ;
+			if (space > peak) 
+				peak = space ;
+			running.push(std::make_pair(t + cost[b], b)) ;
+			}
+		if (running.empty()) 
+			break ;
+		int32_t b = running.top().second ;
+		t = running.top().first ;
+		running.pop() ;
+		space -= released[b] ;
+		for (int32_t c : consumers[b]) {
+			if (0 == --nPending[c]) 
+				ready.insert(std::make_pair(rank[c], c)) ;
+			}
+		}
+	_PredictedParallelPeakNewFunctionSpace = peak ;
+	_PredictedParallelism = t > 0.0 ? work/t : 1.0 ;
+	return 0 ;
+}
+
+
+int32_t BucketElimination::MBEworkspace::ComputeBuckets(const std::function<int32_t(Bucket *B)> & Fn)
+{
+	int32_t i, res = 0 ;
+
+	_BucketComputationTimeInMilliseconds = _CriticalPathTimeInMilliseconds = _BucketTreeWallTimeInMilliseconds = 0.0 ;
+	_MaxTableStorageError = _TableStorageErrorBound = 0.0 ;
+	if (_nBuckets <= 0 || NULL == _Buckets) 
+		return 0 ;
+
+	std::vector<std::vector<int32_t>> producers, consumers ;
+	std::vector<int32_t> rank ;
+	std::vector<int64_t> out, released ;
+	if (0 != ComputeBucketDependencies(producers, consumers) || 0 != ComputeBucketRanks(producers, rank) || 0 != ComputeBucketTableSpace(out, released)) 
+		return 1 ;
+	std::vector<double> tBucket(_nBuckets, 0.0) ;
+
+	if (0 == PredictComputation(_nThreads, _BucketSchedulingSpaceLimit) && NULL != _fpLOG) {
+		fprintf(_fpLOG, "\nMBE compute buckets : predicted peak new function space %lld bytes; with nThreads=%d (space limit %lld bytes) %lld bytes, parallelism %.2f", 
+			(long long) _PredictedPeakNewFunctionSpace, (int32_t) _nThreads, (long long) _BucketSchedulingSpaceLimit, (long long) _PredictedParallelPeakNewFunctionSpace, _PredictedParallelism) ;
+		fflush(_fpLOG) ;
+		}
+
+	// with a table memory limit, tables are moved to/from disk around the computation of each bucket.
+	DiskTableCache *cache = NULL ;
+	if (UseDiskTableBlocks()) {
+		cache = new DiskTableCache(*this, rank) ;
+		if (NULL == cache) 
+			return 1 ;
+		if (0 != cache->Start()) 
+			{ delete cache ; return 1 ; }
+		ResetStatistics() ;
+		}
+	std::function<int32_t(Bucket *B)> FnWithDiskTables = [this, cache, &Fn](Bucket *b) -> int32_t
+	{
+		int32_t res = cache->BeforeBucket(b) ;
+		if (0 != res) 
+			return res ;
+		INT64 t0 = ARE::GetTimeInMilliseconds() ;
+		res = Fn(b) ;
+		NoteFTBComputationTime((DWORD) (ARE::GetTimeInMilliseconds() - t0)) ;
+		cache->AfterBucket(b) ;
+		return res ;
+	} ;
+	const std::function<int32_t(Bucket *B)> & fn = NULL != cache ? FnWithDiskTables : Fn ;
+	time_t ttStart = time(NULL) ;
+
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now() ;
+	if (_nThreads <= 1) {
+		std::vector<int32_t> order(_nBuckets) ;
+		for (i = 0 ; i < _nBuckets ; i++) 
+			order[rank[i]] = i ;
+		for (i = 0 ; i < _nBuckets && 0 == res ; i++) {
+			int32_t b = order[i] ;
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now() ;
+			res = fn(_Buckets[b]) ;
+			tBucket[b] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() ;
+			}
+		}
+	else {
+		BucketTreeExecution E(*this, fn, producers, consumers, rank, out, released, tBucket.data()) ;
+		if (0 != E._Scheduler.Start(_nThreads)) 
+			res = 1 ;
+		else {
+			_BucketScheduler = &E._Scheduler ;
+			{
+			std::lock_guard<std::mutex> lock(E._M) ;
+			E.Dispatch() ;
+			}
+			E._Scheduler.Wait(-1) ;
+			E._Scheduler.Stop() ;
+			_BucketScheduler = NULL ;
+			res = E._Error ;
+			}
+		}
+	_BucketTreeWallTimeInMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count() ;
+	if (NULL != cache) {
+		cache->Stop() ;
+		delete cache ;
+		if (NULL != _fpLOG) {
+			fprintf(_fpLOG, "\nMBE compute buckets : table memory limit %lld bytes; %lld table blocks saved, %lld loaded (waited %lld times, %lld msec); max %lld bytes of loaded tables in memory", 
+				(long long) _TableMemoryLimit, (long long) _nTableBlocksSaved, (long long) _nTableBlocksLoaded, (long long) _nInputTableBlocksWaited, (long long) _InputTableBlocksWaitPeriodTotal, (long long) _MaximumDiskMemorySpaceCached) ;
+			fflush(_fpLOG) ;
+			}
+		LogStatistics(ttStart, time(NULL)) ;
+		}
+
+	// critical path : producers come after consumers in the bucket order, so going from last to first, producers are done first.
+	std::vector<double> tPath(_nBuckets, 0.0) ;
 	for (i = _nBuckets - 1 ; i >= 0 ; i--) {
+		double t = 0.0 ;
+		for (int32_t p : producers[i]) 
+			{ if (tPath[p] > t) t = tPath[p] ; }
+		tPath[i] = t + tBucket[i] ;
+		_BucketComputationTimeInMilliseconds += tBucket[i] ;
+		if (tPath[i] > _CriticalPathTimeInMilliseconds) 
+			_CriticalPathTimeInMilliseconds = tPath[i] ;
+		}
+	if (NULL != _fpLOG) {
+		fprintf(_fpLOG, "\nMBE compute buckets : nThreads=%d nBuckets=%d res=%d; critical path %d buckets (tree height %d), %.1f msec; work %.1f msec, elapsed %.1f msec; parallelism achieved %.2f, available %.2f", 
+			(int32_t) _nThreads, (int32_t) _nBuckets, (int32_t) res, (int32_t) (_MaxTreeHeight + 1), (int32_t) _MaxTreeHeight, _CriticalPathTimeInMilliseconds, 
+			_BucketComputationTimeInMilliseconds, _BucketTreeWallTimeInMilliseconds, AchievedParallelism(), AvailableParallelism()) ;
+		fflush(_fpLOG) ;
+		}
+	ARE::utils::TablePool *pool = TableDataPool() ;
+	if (NULL != _fpLOG && NULL != pool) {
+		fprintf(_fpLOG, "\nMBE table pool : budget %lld bytes; %lld bytes in use (max %lld), max %lld bytes reserved; %lld allocations, %lld reused, %lld failed", 
+			(long long) pool->ByteLimit(), (long long) pool->nBytesInUse(), (long long) pool->MaxBytesInUse(), (long long) pool->MaxBytesReserved(), 
+			(long long) pool->nAllocations(), (long long) pool->nAllocationsReused(), (long long) pool->nAllocationsFailed()) ;
+		fflush(_fpLOG) ;
+		}
+
+	return res ;
+}
+
+
+int32_t BucketElimination::MBEworkspace::RunSimple(void)
+{
+	int32_t i ;
+
+	// with a table memory limit, tables are allocated as buckets are computed.
+	for (i = _nBuckets - 1 ; i >= 0 && ! UseDiskTableBlocks() ; i--) {
 		BucketElimination::Bucket *b = _Buckets[i] ;
-		b->ComputeOutputFunctions(DoMomentMatching) ;
+		std::vector<MiniBucket *> & mbs = b->MiniBuckets() ;
+		for (MiniBucket *mb : mbs) {
+			ARE::Function & f = mb->OutputFunction() ;
+			f.AllocateInMemoryAsSingleTableBlock() ;
+			}
 		}
 
-	return 0 ;
+	// compute all minibucket output functions
+	return ComputeBuckets([](BucketElimination::Bucket *b) -> int32_t
+	{
+		std::vector<MiniBucket *> & mbs = b->MiniBuckets() ;
+		for (MiniBucket *mb : mbs) {
+			int32_t res = mb->ComputeOutputFunction(NULL, NULL) ;
+			if (0 != res) 
+				return res ;
+			}
+		// tables used by the first bucket are needed by PostComputationProcessing().
+		if (0 != b->IDX()) 
+			b->NoteOutputFunctionComputationCompletion() ;
+		return 0 ;
+	}) ;
+}
+
+
+int32_t BucketElimination::MBEworkspace::ComputeOutputFunctions(bool DoMomentMatching)
+{
+	return ComputeBuckets([DoMomentMatching](BucketElimination::Bucket *b) -> int32_t
+	{
+		int32_t res = b->ComputeOutputFunctions(DoMomentMatching) ;
+		if (0 != res) 
+			return res ;
+		// tables used by the first bucket are needed by PostComputationProcessing().
+		if (0 != b->IDX()) 
+			b->NoteOutputFunctionComputationCompletion() ;
+		return 0 ;
+	}) ;
 }
 
 
@@ -1617,6 +2433,7 @@ int32_t BucketElimination::MBEworkspace::DeleteMBEgeneratedTables(void)
 		for (BucketElimination::MiniBucket *mb : MBs) {
 			ARE::Function & output_fn = mb->OutputFunction() ;
 			output_fn.DestroyTableData() ;
+			output_fn.DeleteTableBlocks() ;
 			}
 		}
 
@@ -1651,6 +2468,16 @@ int32_t BucketElimination::MBEworkspace::BuildSolution(void)
 		// given that context (of b) is instantiated, find best value for var(s) of this bucket.
 		// don't need to include intermediate functions, since they don't contain this var, hence are invariant wrt picking value for this var.
 		int32_t nF = b->nOriginalFunctions() + b->nAugmentedFunctions() ;
+		// tables moved to disk during the computation are loaded for the time this bucket is processed.
+		std::vector<ARE::Function *> loaded ;
+		for (int32_t j = 0 ; j < b->nAugmentedFunctions() ; j++) {
+			ARE::Function *f = b->AugmentedFunction(j) ;
+			if (f->HasTableData() || ! f->TableIsOnDisk()) 
+				continue ;
+			if (0 != f->LoadTableBlocks()) 
+				{ for (ARE::Function *lf : loaded) lf->DestroyTableData() ; return 1 ; }
+			loaded.push_back(f) ;
+			}
 		int32_t best_value = -1 ; ARE_Function_TableType best_value_cost = VarEliminationDefaultValue() ;
 		for (int32_t k = 0 ; k < K ; k++) {
 			values[v] = k ;
@@ -1664,6 +2491,8 @@ int32_t BucketElimination::MBEworkspace::BuildSolution(void)
 				{ best_value = k ; best_value_cost = value ; }
 			}
 		values[v] = best_value ;
+		for (ARE::Function *f : loaded) 
+			f->DestroyTableData() ;
 		}
 
 	// compute value of the solution
@@ -1686,6 +2515,7 @@ int32_t BucketElimination::MBEworkspace::PostComputationProcessing(void)
 	// compose complete_elimination_answer
 	ARE_Function_TableType v = _AnswerFactor ;
 	ARE_Function_TableType v_all_except_first = v ; // this will be combined value of all roots, except for vars[0]
+	double e = 0.0 ; // error of the result due to table storage; errors of the values combined add up.
 	for (int32_t i = _nBuckets - 1 ; i >= 0 ; i--) {
 		BucketElimination::Bucket *b = _Buckets[i] ;
 		if (0 == b->DistanceToRoot()) {
@@ -1693,6 +2523,7 @@ int32_t BucketElimination::MBEworkspace::PostComputationProcessing(void)
 			for (BucketElimination::MiniBucket *mb : MBs) {
 				ARE::Function & output_fn = mb->OutputFunction() ;
 				ApplyFnCombinationOperator(v, output_fn.ConstValue()) ;
+				e += output_fn.TableErrorBound() ;
 				if (0 != i) 
 					v_all_except_first = v ;
 				}
@@ -1702,12 +2533,19 @@ int32_t BucketElimination::MBEworkspace::PostComputationProcessing(void)
 				if (NULL == f) continue ;
 				if (f->N() > 0) continue ; // this should not happen
 				ApplyFnCombinationOperator(v, f->ConstValue()) ;
+				e += f->TableErrorBound() ;
 				if (0 != i) 
 					v_all_except_first = v ;
 				}
 			}
 		}
 	SetCompleteEliminationResult(v) ;
+	_TableStorageErrorBound = e ;
+	if (NULL != _fpLOG && ARE_Function_TableStorage_Double != TableStorage()) {
+		fprintf(_fpLOG, "\nMBE table storage %s : max table entry error %g; bound on error of the result %g (%s)", 
+			ARE_Function_TableStorage_Float == TableStorage() ? "float" : "q16", _MaxTableStorageError, _TableStorageErrorBound, TableErrorIsRelative() ? "relative" : "absolute") ;
+		fflush(_fpLOG) ;
+		}
 
 	// compose vars[0] distribution
 	if (_nBuckets > 0) {
@@ -1882,7 +2720,7 @@ simple_vars_figured_out :
 						table_size = f->ComputeTableSize() ;
 						if (table_size < 0) continue ;
 						}
-					if (table_size > 0 && NULL == f->TableData()) 
+					if (table_size > 0 && ! f->HasTableData()) 
 						continue ;
 					int32_t old_argument = f->Argument(k) ;
 					int32_t new_argument = Old2NewVarMap[old_argument] ;
@@ -1916,7 +2754,7 @@ simple_vars_figured_out :
 					for (INT64 idx = 0 ; idx < table_size ;) {
 						fprintf(fpOUTPUTuai, "\n") ;
 						for (int32_t k = 0 ; k < last_var_k ; k++, idx++) {
-							double entry = (f->TableData())[idx] ;
+							double entry = f->TableEntry(idx) ;
 							if (_Problem->FunctionsAreConvertedToLogScale()) 
 								entry = pow(10.0, entry) ;
 							fprintf(fpOUTPUTuai, "%s%g", (0 == k) ? "" : " ", (double) entry) ;
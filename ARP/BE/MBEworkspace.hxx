@@ -2,12 +2,15 @@
 #define MBEworkspace_HXX_INCLUDED
 
 #include <inttypes.h>
+#include <functional>
 
 #include "Function.hxx"
 #include "Problem.hxx"
 #include "Bucket.hxx"
 #include "MiniBucket.hxx"
+#include "SymbolicPartitioning.hxx"
 #include "Workspace.hxx"
+#include "Utils/TaskScheduler.hxx"
 
 namespace ARE { class Workspace ; }
 
@@ -35,6 +38,14 @@ protected :
 	bool _DeleteUsedTables ; // delete tables used (child tables when parent bucket is computed)
 	FILE *_fpLOG ;
 
+	// storage of minibucket output tables (ARE_Function_TableStorage_XXX); tables are computed in double precision and then converted. 
+	// when errors are relative (product combination in normal scale), Q16 is not used (its error is absolute), float is used instead.
+	int32_t _TableStorage ;
+	// max error of a table entry introduced by converting output tables to _TableStorage; relative if TableErrorIsRelative().
+	double _MaxTableStorageError ;
+	// bound on the error of the result (wrt computing in double precision) due to table storage; relative if TableErrorIsRelative().
+	double _TableStorageErrorBound ;
+
 	int32_t _InducedWidth ; // induced width of the given ordering
 
 	int32_t _iBound ; // iBound is the max num of variables in a mini-bucket, including ones being eliminated and ones remaining; default is 1000000 = meaning infinite
@@ -58,6 +69,18 @@ public :
 	inline bool DeleteUsedTables(void) const { return _DeleteUsedTables ; }
 	inline void SetDeleteUsedTables(bool v) { _DeleteUsedTables = v ; }
 
+	inline bool TableErrorIsRelative(void) const { return FN_COBINATION_TYPE_PROD == _FnCombinationType && ! _Problem->FunctionsAreConvertedToLogScale() ; }
+	inline int32_t TableStorage(void) const { return ARE_Function_TableStorage_Q16 == _TableStorage && TableErrorIsRelative() ? ARE_Function_TableStorage_Float : _TableStorage ; }
+	inline void SetTableStorage(int32_t Storage) { _TableStorage = Storage ; }
+	inline double MaxTableStorageError(void) const { return _MaxTableStorageError ; }
+	inline double TableStorageErrorBound(void) const { return _TableStorageErrorBound ; }
+	inline void NoteTableStorageError(double Error)
+	{
+		ARE::utils::AutoLock lock(_FTBMutex) ;
+		if (Error > _MaxTableStorageError) 
+			_MaxTableStorageError = Error ;
+	}
+
 	inline FILE * & logFile(void) { return _fpLOG ; }
 
 public :
@@ -320,9 +343,18 @@ public :
 	// note : this fn will destroy current MB partitioning.
 	int32_t SaveReducedProblem(int32_t & nNewVariables, std::vector<int32_t> & Old2NewVarMap, std::vector<ARE::Function*> & ReducedProblemFunctions) ;
 
-	// find largest i-bound so that new function space is within given space limit
+	// find largest i-bound so that new function space is within given space limit; sets iBound() to it.
+	// i-bounds are probed with EstimateMBPartitioning(), nThreads() at a time; current MB partitioning is not changed.
 	int32_t FindIBoundForSpaceAllowed(int32_t MinIBound, int32_t & bestIboundFound, double & NewFnSpaceUsed_Log10, int32_t & nBucketsPartitioned) ;
 
+	// compute the new function space (total, and max simultaneous when buckets are computed in the current computation order; -1 if there is 
+	// no valid order yet), and the number of buckets with >1 minibuckets, of the MB partitioning CreateMBPartitioning() would create for the 
+	// given i-bound, from function scopes only; 
+	// no minibuckets/functions are created and the workspace is not modified, so this fn can be called for different i-bounds concurrently.
+	// the second version runs the given (per thread) partitioning engine, which then holds the partitioning (see SymbolicMBPartitioning).
+	int32_t EstimateMBPartitioning(int32_t iBound, double & TotalNewFunctionSpace_Log10, double & MaxSimultaneousNewFunctionSpace_Log10, int32_t & nBucketsWithPartitioning) ;
+	int32_t EstimateMBPartitioning(SymbolicMBPartitioning & Partitioning, int32_t iBound, double & TotalNewFunctionSpace_Log10, double & MaxSimultaneousNewFunctionSpace_Log10, int32_t & nBucketsWithPartitioning) ;
+
 	// compute output functions of all buckets
 	int32_t ComputeOutputFunctions(bool DoMomentMatching) ;
 
@@ -332,8 +364,14 @@ public :
 	// create an order in which buckets should be processed
 	// algorithm=0 means from leaves to root in terms of uniform height, i.e. one level must be finished before starting next level. this is default.
 	// algorithm=1 means in the order that minimizes space, e.g. finish computing one bucket before starting next sibling.
+	// algorithm=2 means the order that minimizes the peak space of new function tables (tables computed and not yet used, plus output tables of the 
+	// bucket being computed) among orders that finish a subtree before starting its next sibling; this is Liu's ordering, where children of each 
+	// bucket are computed in decreasing order of (peak space of child subtree - space left over when the child subtree is done).
+	// the peak depends on the DeleteUsedTables flag.
 	// MB partitioning should be done when this fn is called.
 	virtual int32_t CreateComputationOrder(int32_t algorithm) ;
+	// true iff the computation order lists each bucket once; it is not, until CreateComputationOrder() is called.
+	bool ComputationOrderIsValid(void) const ;
 
 	// create/destroy MB partitionin.
 	int32_t CreateMBPartitioning(bool CreateTables, bool doMomentMatching, int32_t ComputeComputationOrder) ;
@@ -357,6 +395,72 @@ public :
 	// run regular (M)BE on the bucket-tree
 	virtual int32_t RunSimple(void) ;
 
+protected :
+
+	int32_t _nThreads ; // number of threads buckets are computed with; default is 1.
+	// pool of nThreads() threads that buckets are computed on, while ComputeBuckets() runs with nThreads() > 1; NULL otherwise.
+	// work within a bucket that is split among threads (see MiniBucket::ComputeOutputFunction()) is run on this pool too, 
+	// so that at most nThreads() threads are busy in total.
+	ARE::utils::TaskScheduler *_BucketScheduler ;
+
+	// statistics of the last ComputeBuckets()
+	double _BucketComputationTimeInMilliseconds ; // sum of computation times of all buckets
+	double _CriticalPathTimeInMilliseconds ; // computation time of the longest (in time) chain of buckets, each using output of the next
+	double _BucketTreeWallTimeInMilliseconds ; // elapsed time
+
+public :
+
+	inline int32_t nThreads(void) const { return _nThreads ; }
+	inline void SetnThreads(int32_t n) { _nThreads = n > 1 ? n : 1 ; }
+	inline ARE::utils::TaskScheduler *BucketScheduler(void) const { return _BucketScheduler ; }
+	inline double BucketComputationTimeInMilliseconds(void) const { return _BucketComputationTimeInMilliseconds ; }
+	inline double CriticalPathTimeInMilliseconds(void) const { return _CriticalPathTimeInMilliseconds ; }
+	inline double BucketTreeWallTimeInMilliseconds(void) const { return _BucketTreeWallTimeInMilliseconds ; }
+	// speedup over computing all buckets one after another.
+	inline double AchievedParallelism(void) const { return _BucketTreeWallTimeInMilliseconds > 0.0 ? _BucketComputationTimeInMilliseconds / _BucketTreeWallTimeInMilliseconds : 1.0 ; }
+	// upper bound on the speedup, given by the critical path.
+	inline double AvailableParallelism(void) const { return _CriticalPathTimeInMilliseconds > 0.0 ? _BucketComputationTimeInMilliseconds / _CriticalPathTimeInMilliseconds : 1.0 ; }
+
+protected :
+
+	// peak space (in bytes) of new function tables, as predicted by PredictComputation().
+	int64_t _PredictedPeakNewFunctionSpace ; // when buckets are computed one at a time, in the computation order
+	int64_t _PredictedParallelPeakNewFunctionSpace ; // when buckets are computed by nThreads() threads
+	double _PredictedParallelism ; // speedup predicted when buckets are computed by nThreads() threads
+	// when buckets are computed by nThreads() > 1 threads, a bucket is not started while its output tables, on top of the tables of buckets being 
+	// computed and tables not yet used, would exceed this many bytes (unless no bucket is being computed); 0 = no limit.
+	// this trades parallelism for peak space.
+	int64_t _BucketSchedulingSpaceLimit ;
+
+public :
+
+	inline int64_t PredictedPeakNewFunctionSpace(void) const { return _PredictedPeakNewFunctionSpace ; }
+	inline int64_t PredictedParallelPeakNewFunctionSpace(void) const { return _PredictedParallelPeakNewFunctionSpace ; }
+	inline double PredictedParallelism(void) const { return _PredictedParallelism ; }
+	inline int64_t BucketSchedulingSpaceLimit(void) const { return _BucketSchedulingSpaceLimit ; }
+	inline void SetBucketSchedulingSpaceLimit(int64_t Limit) { _BucketSchedulingSpaceLimit = Limit > 0 ? Limit : 0 ; }
+
+	// space (in bytes) of output tables of each bucket, and of the tables each bucket deletes after using them (0 unless DeleteUsedTables flag is set).
+	int32_t ComputeBucketTableSpace(std::vector<int64_t> & OutputSpace, std::vector<int64_t> & ReleasedSpace) ;
+	// Producers[i] are the buckets that generate augmented functions of bucket i; Consumers[i] are the buckets that use output functions of bucket i.
+	int32_t ComputeBucketDependencies(std::vector<std::vector<int32_t>> & Producers, std::vector<std::vector<int32_t>> & Consumers) ;
+	// position of each bucket in the order buckets are computed in by one thread; this is the computation order (see CreateComputationOrder()) 
+	// from last to first, if it is valid, otherwise buckets from last to first.
+	int32_t ComputeBucketRanks(const std::vector<std::vector<int32_t>> & Producers, std::vector<int32_t> & Rank) ;
+
+	// simulate computing buckets by nThreads threads, each bucket taking time proportional to its processing complexity, ready buckets being 
+	// started in the order of their rank, subject to SpaceLimit (see _BucketSchedulingSpaceLimit). computes _PredictedPeakNewFunctionSpace, 
+	// _PredictedParallelPeakNewFunctionSpace and _PredictedParallelism.
+	int32_t PredictComputation(int32_t nThreads, int64_t SpaceLimit) ;
+
+	// run Fn(B) for all buckets B; B is run once all buckets that generated its augmented functions are done.
+	// with nThreads() > 1, buckets that are ready are run on a pool of nThreads() threads, lowest rank first (see ComputeBucketRanks()) and 
+	// subject to BucketSchedulingSpaceLimit(); otherwise buckets are run in the order of their rank.
+	// Fn may run concurrently for different buckets. if Fn returns non-0, no more buckets are started and the first such value is returned.
+	// with a table memory limit (see ARE::Workspace::UseDiskTableBlocks()), MBE generated tables are moved to disk when the limit is exceeded, 
+	// and loaded back (ahead of time, if they fit) for the bucket that uses them; tables may be left on disk when this fn returns.
+	int32_t ComputeBuckets(const std::function<int32_t(Bucket *B)> & Fn) ;
+
 	// extract solution assignment from current MBE execution; operator (min/max) will be obtained from the problem.
 	// solution will be stored in the problem.
 	int32_t BuildSolution(void) ;
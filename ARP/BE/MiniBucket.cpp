@@ -7,6 +7,8 @@
 #include <Bucket.hxx>
 #include <MiniBucket.hxx>
 #include <Sort.hxx>
+#include <TableKernels.hxx>
+#include "Utils/TaskScheduler.hxx"
 
 
 BucketElimination::MiniBucket::MiniBucket(void)
@@ -452,6 +454,17 @@ failed :
 }
 
 
+// sum of the error bounds of the given functions (see ARE::Function::TableErrorBound()); the errors of the input tables of a bucket carry 
+// over to its output tables (to first order, if they are relative errors).
+static double SumOfTableErrorBounds(int32_t nFNs, ARE::Function **FNs)
+{
+	double e = 0.0 ;
+	for (int32_t j = 0 ; j < nFNs ; j++) 
+		{ if (NULL != FNs[j]) e += FNs[j]->TableErrorBound() ; }
+	return e ;
+}
+
+
 int32_t BucketElimination::MiniBucket::ComputeOutputFunction_EliminateAllVars(void)
 {
 	int32_t j, k, ret = 0 ;
@@ -477,7 +490,6 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction_EliminateAllVars(vo
 	if (_nFunctions > MAX_NUM_FUNCTIONS_PER_BUCKET) 
 		return ERRORCODE_too_many_functions ;
 
-	int32_t values[MAX_NUM_VARIABLES_PER_BUCKET] ; // this is the current value combination of the arguments of this function (table block).
 	ARE::Function *flist[MAX_NUM_FUNCTIONS_PER_BUCKET] ; // this is a list of input functions
 
 	ARE_Function_TableType const_factor = bews->FnCombinationNeutralValue() ;
@@ -489,27 +501,8 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction_EliminateAllVars(vo
 		else { flist[nFNs++] = f ; f->ComputeArgumentsPermutationList(w, signature) ; }
 		}
 
-	int64_t ElimSize = 1 ;
-	for (j = 0 ; j < w ; j++) 
-		ElimSize *= problem->K(signature[j]) ;
-
-	ARE::Function *MissingFunction = NULL ;
-	int64_t MissingBlockIDX = -1 ;
-
-	V = bews->VarEliminationDefaultValue() ;
-	for (j = 0 ; j < w ; j++) 
-		values[j] = 0 ;
-	for (int64_t ElimIDX = 0 ; ElimIDX < ElimSize ; ElimIDX++) {
-		ARE_Function_TableType value = nv ;
-		for (j = 0 ; j < nFNs ; j++) { // note : it should be that 0 != flist[j]->N(). note : it is assumed that flist[j] has 1 block. note : it is assumed that order of flist[j] arguments is the same as signature.
-			int64_t adr = flist[j]->ComputeFnTableAdr_wrtLocalPermutation(w, values, problem->K()) ;
-			bews->ApplyFnCombinationOperator(value, flist[j]->TableEntry(adr)) ;
-			}
-		bews->ApplyVarEliminationOperator(V, value) ;
-		// go to next argument value combination
-		ARE::EnumerateNextArgumentsValueCombination(w, signature, values, problem->K()) ;
-		}
-	bews->ApplyFnCombinationOperator(V, const_factor) ;
+	ret = ComputeOutputTable(w, signature, 0, nFNs, flist, NULL, NULL, const_factor, &V, 1) ;
+	f.SetTableErrorBound(SumOfTableErrorBounds(_nFunctions, _Functions)) ;
 done :
 	return ret ;
 }
@@ -547,13 +540,10 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction(ARE::Function *fMax
 	if (0 != f.AllocateTableData())
 		return ERRORCODE_memory_allocation_failure ;
 
-	int32_t values[MAX_NUM_VARIABLES_PER_BUCKET] ; // this is the current value combination of the arguments of this function (table block).
 	int32_t vars[MAX_NUM_VARIABLES_PER_BUCKET] ; // this is the list of variables : vars2Keep + vars2Eliminate
 	const int32_t *refFNarguments = f.Arguments() ;
-	for (j = 0 ; j < nA ; j++) {
+	for (j = 0 ; j < nA ; j++) 
 		vars[j] = refFNarguments[j] ;
-		values[j] = 0 ;
-		}
 	for (; j < _Width ; j++) 
 		vars[j] = Var(j - nA) ;
 
@@ -571,35 +561,20 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction(ARE::Function *fMax
 		fAvgMaxMarginal->ComputeArgumentsPermutationList(_Width, vars) ;
 		}
 
-	int64_t ElimIDX, ElimSize = 1 ;
-	for (j = 0 ; j < nVars() ; j++) 
-		ElimSize *= problem->K(Var(j)) ;
-
-	ARE_Function_TableType *data = f.TableData() ;
-	int64_t tablesize = f.TableSize(), adr ;
-	for (int64_t KeepIDX = 0 ; KeepIDX < tablesize ; KeepIDX++) {
-		for (j = nA ; j < _Width ; j++) 
-			values[j] = 0 ;
-		data[KeepIDX] = bews->VarEliminationDefaultValue() ;
-		for (ElimIDX = 0 ; ElimIDX < ElimSize ; ElimIDX++) {
-			ARE_Function_TableType value = bews->FnCombinationNeutralValue() ;
-			for (j = 0 ; j < nFNs ; j++) {
-				adr = flist[j]->ComputeFnTableAdr_wrtLocalPermutation(_Width, values, problem->K()) ;
-				bews->ApplyFnCombinationOperator(value, flist[j]->TableEntry(adr)) ;
-				}
-			if (NULL != fMaxMarginal && NULL != fAvgMaxMarginal) {
-				adr = fAvgMaxMarginal->ComputeFnTableAdr_wrtLocalPermutation(_Width, values, problem->K()) ;
-				bews->ApplyFnCombinationOperator(value, fAvgMaxMarginal->TableEntry(adr)) ;
-				adr = fMaxMarginal->ComputeFnTableAdr_wrtLocalPermutation(_Width, values, problem->K()) ;
-				bews->ApplyFnDivisionOperator(value, fMaxMarginal->TableEntry(adr)) ;
-				}
-			bews->ApplyVarEliminationOperator(data[KeepIDX], value) ;
-			// go to next argument value combination
-			ARE::EnumerateNextArgumentsValueCombination(_Width, vars, values, problem->K()) ;
-			}
-		bews->ApplyFnCombinationOperator(data[KeepIDX], const_factor) ;
-		}
+	int32_t res = ComputeOutputTable(_Width, vars, nA, nFNs, flist, fMaxMarginal, fAvgMaxMarginal, const_factor, f.TableData(), f.TableSize()) ;
+	if (0 != res) 
+		return res ;
 
+	// store the table as the workspace wants it; keep track of the error this introduces.
+	double e = SumOfTableErrorBounds(_nFunctions, _Functions), eConversion = 0.0 ;
+	if (NULL != fMaxMarginal && NULL != fAvgMaxMarginal) 
+		e += fMaxMarginal->TableErrorBound() + fAvgMaxMarginal->TableErrorBound() ;
+	if (ARE_Function_TableStorage_Double != bews->TableStorage()) {
+		if (0 != f.ConvertTableStorage(bews->TableStorage(), bews->TableErrorIsRelative(), eConversion)) 
+			return ERRORCODE_memory_allocation_failure ;
+		bews->NoteTableStorageError(eConversion) ;
+		}
+	f.SetTableErrorBound(e + eConversion) ;
 	return 0 ;
 }
 
@@ -645,12 +620,9 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction(ARE::Function & f,
 	const int32_t *refFNarguments = f.Arguments() ;
 	const int32_t *signature = Signature() ;
 
-	int32_t values[MAX_NUM_VARIABLES_PER_BUCKET] ; // this is the current value combination of the arguments of this function (table block).
 	int32_t vars[MAX_NUM_VARIABLES_PER_BUCKET] ; // this is the list of variables : vars2Keep + vars2Eliminate
-	for (j = 0 ; j < nA ; j++) {
+	for (j = 0 ; j < nA ; j++) 
 		vars[j] = refFNarguments[j] ;
-		values[j] = 0 ;
-		}
 	for (; j < _Width ; j++) 
 		vars[j] = ElimVars[j - nA] ;
 
@@ -664,29 +636,338 @@ int32_t BucketElimination::MiniBucket::ComputeOutputFunction(ARE::Function & f,
 		else  { flist[nFNs++] = f ; f->ComputeArgumentsPermutationList(_Width, vars) ; }
 		}
 
-	int64_t ElimIDX, ElimSize = 1 ;
-	for (j = 0 ; j < nElimVars ; j++) 
-		ElimSize *= problem->K(ElimVars[j]) ;
-
-	ARE_Function_TableType *data = f.TableData() ;
-	int64_t tablesize = f.TableSize() ;
-	for (int64_t KeepIDX = 0 ; KeepIDX < tablesize ; KeepIDX++) {
-		for (j = nA ; j < _Width ; j++) 
-			values[j] = 0 ;
-		data[KeepIDX] = bews->VarEliminationDefaultValue() ;
-		for (ElimIDX = 0 ; ElimIDX < ElimSize ; ElimIDX++) {
-			ARE_Function_TableType value = bews->FnCombinationNeutralValue() ;
-			for (j = 0 ; j < nFNs ; j++) {
-				int64_t adr = flist[j]->ComputeFnTableAdr_wrtLocalPermutation(_Width, values, problem->K()) ;
-				bews->ApplyFnCombinationOperator(value, flist[j]->TableEntry(adr)) ;
+	f.SetTableErrorBound(SumOfTableErrorBounds(_nFunctions, _Functions)) ;
+	if (0 == nA) 
+		return ComputeOutputTable(_Width, vars, 0, nFNs, flist, NULL, NULL, const_factor, &(f.ConstValue()), 1) ;
+	return ComputeOutputTable(_Width, vars, nA, nFNs, flist, NULL, NULL, const_factor, f.TableData(), f.TableSize()) ;
+}
+
+
+// state of MiniBucket::ComputeOutputTable(), handed to the kernel specialized for the (combination, elimination, log-scale) type of the query.
+// value combinations are done a block at a time : the block is nRows (combinations of the innermost eliminated vars) x nCols (combinations 
+// of the innermost kept vars, i.e. consecutive output table cells); the other vars are enumerated one combination at a time.
+class OutputTableComputation
+{
+public :
+	int32_t _nT ; // number of input tables; the last 2 are AvgMaxMarginal/MaxMarginal if _UseMaxMarginals.
+	int32_t _nFNs ;
+	bool _UseMaxMarginals ;
+	const void **_Tables ;
+	const int32_t *_Storage ; // storage of each table (ARE_Function_TableStorage_*); AvgMaxMarginal/MaxMarginal are double.
+	const ARE_Function_TableType *_QuantizationBase ; // Q16 parameters of each table
+	const ARE_Function_TableType *_QuantizationStep ;
+	const int64_t *_Stride ; // see ComputeOutputTable()
+	const int64_t *_Wrap ;
+	const int32_t *_K ; // domain size of each position of Vars
+	const int32_t *_Vars ;
+	const int32_t *_DomainSizes ; // domain size of each variable of the problem
+	int32_t _nKeepVars ;
+	int32_t _KeepBegin ; // kept positions [_KeepBegin,_nKeepVars) are the block columns
+	int32_t _nOuter ; // positions enumerated one combination at a time (last changing fastest)
+	const int32_t *_Outer ;
+	int32_t _nRows ;
+	int32_t _nCols ;
+	const int64_t *_Offsets ; // _Offsets[j*_nRows*_nCols + r*_nCols + c] is the address (relative to the block) of cell (r,c) of the block in table j
+	const char *_Access ; // for each table : 'c' = contiguous (offset is the cell index), '0' = constant (offset 0), 'g' = gather
+	int64_t _nBlocksPerCol ; // number of blocks per output table cell
+	ARE_Function_TableType _ConstFactor ;
+	ARE_Function_TableType *_Output ;
+	int64_t _KeepSize ;
+} ;
+
+#define ARE_BE_KERNEL_BUFFER_SIZE (ARE_BE_KERNEL_BLOCK_SIZE > MAX_NUM_VALUES_PER_VAR_DOMAIN ? ARE_BE_KERNEL_BLOCK_SIZE : MAX_NUM_VALUES_PER_VAR_DOMAIN)
+
+// combines the block at address Adr of table j, stored as float/Q16, into Buf; entries are converted to double in Temp first.
+template<class Ops> static inline void CombineConvertedBlock(const OutputTableComputation & C, int32_t j, int64_t Adr, ARE_Function_TableType *Buf, ARE_Function_TableType *Temp, int32_t n)
+{
+	const int64_t *o = C._Offsets + j*n ;
+	if (ARE_Function_TableStorage_Float == C._Storage[j]) {
+		const float *t = (const float *) C._Tables[j] + Adr ;
+		if ('0' == C._Access[j]) 
+			{ Ops::CombineConst(Buf, *t, n) ; return ; }
+		if ('c' == C._Access[j]) 
+			BucketElimination::TableKernels::FloatToDouble(Temp, t, n) ;
+		else 
+			BucketElimination::TableKernels::FloatToDoubleGather(Temp, t, o, n) ;
+		}
+	else {
+		const uint16_t *t = (const uint16_t *) C._Tables[j] + Adr ;
+		const ARE_Function_TableType base = C._QuantizationBase[j], step = C._QuantizationStep[j] ;
+		if ('0' == C._Access[j]) 
+			{ Ops::CombineConst(Buf, ARE::DecodeTableEntryQ16(*t, base, step), n) ; return ; }
+		if ('c' == C._Access[j]) 
+			BucketElimination::TableKernels::DecodeQ16(Temp, t, base, step, n) ;
+		else 
+			BucketElimination::TableKernels::DecodeQ16Gather(Temp, t, o, base, step, n) ;
+		}
+	Ops::CombineContiguous(Buf, Temp, n) ;
+}
+
+// computes output table cells [KeepBegin,KeepEnd); KeepBegin/KeepEnd are multiples of _nCols.
+template<class Ops> static void ComputeOutputTableKernel(const OutputTableComputation & C, int64_t KeepBegin, int64_t KeepEnd)
+{
+	int32_t i, j, p ;
+	ARE_Function_TableType buf[ARE_BE_KERNEL_BUFFER_SIZE] ;
+	ARE_Function_TableType temp[ARE_BE_KERNEL_BUFFER_SIZE] ; // for tables stored as float/Q16
+	int32_t values[MAX_NUM_VARIABLES_PER_BUCKET] ; // current value combination of _Outer positions
+	int64_t adr[MAX_NUM_FUNCTIONS_PER_BUCKET + 2] ; // address of the current block in each table
+
+	// start from the value combination of kept vars of output cell KeepBegin (block columns are 0 there); eliminated vars start at 0.
+	int32_t keepValues[MAX_NUM_VARIABLES_PER_BUCKET] ;
+	ARE::ComputeArgCombinationFromFnTableAdr(KeepBegin, C._nKeepVars, C._Vars, keepValues, C._DomainSizes) ;
+	for (j = 0 ; j < C._nT ; j++) 
+		adr[j] = 0 ;
+	for (i = 0 ; i < C._nOuter ; i++) {
+		p = C._Outer[i] ;
+		values[i] = p < C._KeepBegin ? keepValues[p] : 0 ;
+		for (j = 0 ; j < C._nT ; j++) 
+			adr[j] += values[i] * C._Stride[p*C._nT + j] ;
+		}
+	const int32_t n = C._nRows * C._nCols ;
+	const ARE_Function_TableType nv = Ops::CombinationNeutralValue(), dv = Ops::EliminationDefaultValue() ;
+
+	for (int64_t KeepIDX = KeepBegin ; KeepIDX < KeepEnd ; KeepIDX += C._nCols) {
+		ARE_Function_TableType *V = C._Output + KeepIDX ;
+		for (i = 0 ; i < C._nCols ; i++) 
+			V[i] = dv ;
+		for (int64_t b = 0 ; b < C._nBlocksPerCol ; b++) {
+			for (i = 0 ; i < n ; i++) 
+				buf[i] = nv ;
+			for (j = 0 ; j < C._nFNs ; j++) {
+				if (ARE_Function_TableStorage_Double != C._Storage[j]) 
+					{ CombineConvertedBlock<Ops>(C, j, adr[j], buf, temp, n) ; continue ; }
+				const ARE_Function_TableType *t = (const ARE_Function_TableType *) C._Tables[j] + adr[j] ;
+				if ('c' == C._Access[j]) 
+					Ops::CombineContiguous(buf, t, n) ;
+				else if ('0' == C._Access[j]) 
+					Ops::CombineConst(buf, *t, n) ;
+				else 
+					Ops::CombineGather(buf, t, C._Offsets + j*n, n) ;
+				}
+			if (C._UseMaxMarginals) {
+				const ARE_Function_TableType *tAvg = (const ARE_Function_TableType *) C._Tables[C._nFNs] + adr[C._nFNs], *tMax = (const ARE_Function_TableType *) C._Tables[C._nFNs+1] + adr[C._nFNs+1] ;
+				const int64_t *oAvg = C._Offsets + C._nFNs*n, *oMax = C._Offsets + (C._nFNs+1)*n ;
+				for (i = 0 ; i < n ; i++) {
+					Ops::Combine(buf[i], tAvg[oAvg[i]]) ;
+					Ops::Divide(buf[i], tMax[oMax[i]]) ;
+					}
+				}
+			Ops::Eliminate(V, buf, C._nRows, C._nCols) ;
+			// go to next value combination of _Outer positions; only the digits that change adjust the addresses.
+			for (i = C._nOuter - 1 ; i >= 0 ; i--) {
+				p = C._Outer[i] ;
+				const int64_t *s = C._Stride + p*C._nT ;
+				if (++values[i] < C._K[p]) {
+					for (j = 0 ; j < C._nT ; j++) 
+						adr[j] += s[j] ;
+					break ;
+					}
+				values[i] = 0 ;
+				const int64_t *w = C._Wrap + p*C._nT ;
+				for (j = 0 ; j < C._nT ; j++) 
+					adr[j] -= w[j] ;
+				}
+			}
+		Ops::CombineConst(V, C._ConstFactor, C._nCols) ;
+		}
+}
+
+// computes output table cells [0,_KeepSize) in chunks of ChunkSize cells (a multiple of _nCols), using up to nThreads threads of Scheduler (see ARE::utils::ParallelFor()).
+template<int32_t FnCombinationType, int32_t VarEliminationType, bool LogScale> static void ComputeOutputTableKernel(const OutputTableComputation & C, int32_t nThreads, int64_t ChunkSize, ARE::utils::TaskScheduler *Scheduler)
+{
+	ARE::utils::ParallelFor(nThreads, C._KeepSize, ChunkSize, [&C](int32_t /* ThreadIdx */, int64_t Begin, int64_t End)
+	{
+		ComputeOutputTableKernel<BucketElimination::TableOps<FnCombinationType, VarEliminationType, LogScale> >(C, Begin, End) ;
+	}, Scheduler) ;
+}
+
+template<int32_t FnCombinationType, int32_t VarEliminationType> static void ComputeOutputTableKernel(const OutputTableComputation & C, bool LogScale, int32_t nThreads, int64_t ChunkSize, ARE::utils::TaskScheduler *Scheduler)
+{
+	if (LogScale) 
+		ComputeOutputTableKernel<FnCombinationType, VarEliminationType, true>(C, nThreads, ChunkSize, Scheduler) ;
+	else 
+		ComputeOutputTableKernel<FnCombinationType, VarEliminationType, false>(C, nThreads, ChunkSize, Scheduler) ;
+}
+
+// Offsets[i] = address in table j of value combination i of positions [Begin,End), relative to all of them being 0.
+static void ComputeBlockOffsets(const int64_t *Stride, const int64_t *Wrap, int32_t nT, int32_t j, const int32_t *K, int32_t Begin, int32_t End, int64_t *Offsets)
+{
+	int32_t p, values[MAX_NUM_VARIABLES_PER_BUCKET] ;
+	int64_t i, n = 1, a = 0 ;
+	for (p = Begin ; p < End ; p++) 
+		{ values[p] = 0 ; n *= K[p] ; }
+	for (i = 0 ; i < n ; i++) {
+		Offsets[i] = a ;
+		for (p = End - 1 ; p >= Begin ; p--) {
+			if (++values[p] < K[p]) 
+				{ a += Stride[p*nT + j] ; break ; }
+			values[p] = 0 ;
+			a -= Wrap[p*nT + j] ;
+			}
+		}
+}
+
+
+int32_t BucketElimination::MiniBucket::ComputeOutputTable(int32_t nVars, const int32_t *Vars, int32_t nKeepVars, int32_t nFNs, ARE::Function **FNs, 
+	ARE::Function *fMaxMarginal, ARE::Function *fAvgMaxMarginal, ARE_Function_TableType ConstFactor, ARE_Function_TableType *Output, int64_t KeepSize)
+{
+	int32_t i, j, k, p ;
+
+	MBEworkspace *bews = dynamic_cast<MBEworkspace*>(_Workspace) ;
+	if (NULL == bews) 
+		return ERRORCODE_generic ;
+	ARE::ARP *problem = bews->Problem() ;
+	if (NULL == problem) 
+		return ERRORCODE_generic ;
+	if (nVars <= nKeepVars || nVars > MAX_NUM_VARIABLES_PER_BUCKET || nFNs > MAX_NUM_FUNCTIONS_PER_BUCKET) 
+		return ERRORCODE_generic ;
+	const int32_t fnCombinationType = bews->FnCombinationType(), varEliminationType = bews->VarEliminationType() ;
+	if (FN_COBINATION_TYPE_PROD != fnCombinationType && FN_COBINATION_TYPE_SUM != fnCombinationType) 
+		return ERRORCODE_generic ;
+	if (VAR_ELIMINATION_TYPE_SUM != varEliminationType && VAR_ELIMINATION_TYPE_MAX != varEliminationType && VAR_ELIMINATION_TYPE_MIN != varEliminationType) 
+		return ERRORCODE_generic ;
+	const int32_t *K = problem->K() ;
+	const bool useMaxMarginals = NULL != fMaxMarginal && NULL != fAvgMaxMarginal ;
+
+	// tables : FNs[], then AvgMaxMarginal/MaxMarginal.
+	int32_t nT = nFNs + (useMaxMarginals ? 2 : 0) ;
+	const void *tables[MAX_NUM_FUNCTIONS_PER_BUCKET + 2] ;
+	int32_t storage[MAX_NUM_FUNCTIONS_PER_BUCKET + 2] ;
+	ARE_Function_TableType qBase[MAX_NUM_FUNCTIONS_PER_BUCKET + 2], qStep[MAX_NUM_FUNCTIONS_PER_BUCKET + 2] ;
+	char access[MAX_NUM_FUNCTIONS_PER_BUCKET + 2] ;
+	int32_t Kpos[MAX_NUM_VARIABLES_PER_BUCKET] ; // domain size of each position
+	for (p = 0 ; p < nVars ; p++) 
+		Kpos[p] = K[Vars[p]] ;
+	for (j = 0 ; j < nT ; j++) {
+		ARE::Function *fn = j < nFNs ? FNs[j] : (j == nFNs ? fAvgMaxMarginal : fMaxMarginal) ;
+		tables[j] = fn->TableStorageData() ;
+		if (NULL == tables[j]) 
+			return ERRORCODE_generic ;
+		storage[j] = fn->TableStorage() ;
+		qBase[j] = fn->QuantizationBase() ;
+		qStep[j] = fn->QuantizationStep() ;
+		if (j >= nFNs && ARE_Function_TableStorage_Double != storage[j]) 
+			return ERRORCODE_generic ;
+		}
+
+	// block rows are the combinations of eliminated positions [elimBegin,nVars), at least the last one; 
+	// block columns are the combinations of kept positions [keepBegin,nKeepVars), possibly none.
+	int32_t elimBegin = nVars - 1, keepBegin = nKeepVars ;
+	int64_t nRows = Kpos[elimBegin], nCols = 1 ;
+	while (elimBegin > nKeepVars && nRows * Kpos[elimBegin - 1] <= ARE_BE_KERNEL_BLOCK_SIZE) 
+		nRows *= Kpos[--elimBegin] ;
+	while (keepBegin > 0 && nRows * nCols * Kpos[keepBegin - 1] <= ARE_BE_KERNEL_BLOCK_SIZE) 
+		nCols *= Kpos[--keepBegin] ;
+	const int64_t n = nRows * nCols ;
+	int64_t ElimSize = 1 ;
+	for (p = nKeepVars ; p < nVars ; p++) 
+		ElimSize *= Kpos[p] ;
+	int32_t nOuter = 0, outer[MAX_NUM_VARIABLES_PER_BUCKET] ;
+	for (p = 0 ; p < keepBegin ; p++) 
+		outer[nOuter++] = p ;
+	for (p = nKeepVars ; p < elimBegin ; p++) 
+		outer[nOuter++] = p ;
+
+	// stride[p*nT + j] is the change of the address in table j when the value of Vars[p] is incremented (0 if Vars[p] is not in the scope); 
+	// wrap[p*nT + j] is the change when the value of Vars[p] goes from K-1 back to 0.
+	// offsets[j*n + r*nCols + c] is the address, relative to the block, of row r / column c of the block in table j.
+	int64_t *stride = new int64_t[2*nVars*nT + nT*(n + nRows + nCols)] ;
+	if (NULL == stride) 
+		return ERRORCODE_memory_allocation_failure ;
+	int64_t *wrap = stride + nVars*nT ;
+	int64_t *offsets = wrap + nVars*nT ;
+	int64_t *rowOffsets = offsets + nT*n, *colOffsets = rowOffsets + nRows ;
+	for (i = 0 ; i < 2*nVars*nT ; i++) 
+		stride[i] = 0 ;
+	for (j = 0 ; j < nT ; j++) {
+		ARE::Function *fn = j < nFNs ? FNs[j] : (j == nFNs ? fAvgMaxMarginal : fMaxMarginal) ;
+		const int32_t *perm = fn->ArgumentsPermutationList() ;
+		int64_t s = 1 ;
+		for (k = fn->N() - 1 ; k >= 0 ; k--) {
+			p = perm[k] ;
+			if (p < 0 || p >= nVars) 
+				{ delete [] stride ; return ERRORCODE_generic ; }
+			stride[p*nT + j] = s ;
+			wrap[p*nT + j] = (Kpos[p] - 1)*s ;
+			s *= K[fn->Argument(k)] ;
+			}
+		}
+	for (j = 0 ; j < nT ; j++) {
+		ComputeBlockOffsets(stride, wrap, nT, j, Kpos, elimBegin, nVars, rowOffsets) ;
+		ComputeBlockOffsets(stride, wrap, nT, j, Kpos, keepBegin, nKeepVars, colOffsets) ;
+		int64_t *o = offsets + j*n ;
+		bool contiguous = true, constant = true ;
+		for (int64_t r = 0 ; r < nRows ; r++) {
+			for (int64_t c = 0 ; c < nCols ; c++) {
+				int64_t a = rowOffsets[r] + colOffsets[c], idx = r*nCols + c ;
+				o[idx] = a ;
+				if (a != idx) contiguous = false ;
+				if (0 != a) constant = false ;
 				}
-			bews->ApplyVarEliminationOperator(data[KeepIDX], value) ;
-			// go to next argument value combination
-			ARE::EnumerateNextArgumentsValueCombination(_Width, vars, values, problem->K()) ;
 			}
-		bews->ApplyFnCombinationOperator(data[KeepIDX], const_factor) ;
+		access[j] = contiguous ? 'c' : (constant ? '0' : 'g') ;
+		}
+
+	OutputTableComputation C ;
+	C._nT = nT ;
+	C._nFNs = nFNs ;
+	C._UseMaxMarginals = useMaxMarginals ;
+	C._Tables = tables ;
+	C._Storage = storage ;
+	C._QuantizationBase = qBase ;
+	C._QuantizationStep = qStep ;
+	C._Stride = stride ;
+	C._Wrap = wrap ;
+	C._K = Kpos ;
+	C._Vars = Vars ;
+	C._DomainSizes = K ;
+	C._nKeepVars = nKeepVars ;
+	C._KeepBegin = keepBegin ;
+	C._nOuter = nOuter ;
+	C._Outer = outer ;
+	C._nRows = nRows ;
+	C._nCols = nCols ;
+	C._Offsets = offsets ;
+	C._Access = access ;
+	C._nBlocksPerCol = ElimSize / nRows ;
+	C._ConstFactor = ConstFactor ;
+	C._Output = Output ;
+	C._KeepSize = KeepSize ;
+
+	// large tables are split into chunks of output cells, computed by nThreads() threads; a chunk is at least 
+	// ARE_BE_PARALLEL_TABLE_CHUNK_SIZE cells (rounded up to whole blocks) and there are up to 4 chunks per thread, for load balancing.
+	// chunks are tasks on the pool buckets are computed on, so they use threads that are not busy with other buckets; 
+	// outside of ComputeBuckets() the shared pool is used.
+	int32_t nThreads = 1 ;
+	int64_t chunkSize = KeepSize ;
+	if (bews->nThreads() > 1 && (double) KeepSize * (double) ElimSize >= ARE_BE_PARALLEL_TABLE_MIN_SIZE) {
+		nThreads = bews->nThreads() ;
+		chunkSize = KeepSize / (4*nThreads) ;
+		if (chunkSize < ARE_BE_PARALLEL_TABLE_CHUNK_SIZE) 
+			chunkSize = ARE_BE_PARALLEL_TABLE_CHUNK_SIZE ;
+		chunkSize = ((chunkSize + nCols - 1) / nCols) * nCols ;
+		}
+
+	// pick the kernel once for the whole table; inside, combination/elimination operators are fixed at compile time.
+	bool logScale = problem->FunctionsAreConvertedToLogScale() ;
+	if (FN_COBINATION_TYPE_PROD == fnCombinationType) {
+		if (VAR_ELIMINATION_TYPE_SUM == varEliminationType) 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_PROD, VAR_ELIMINATION_TYPE_SUM>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
+		else if (VAR_ELIMINATION_TYPE_MAX == varEliminationType) 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_PROD, VAR_ELIMINATION_TYPE_MAX>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
+		else 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_PROD, VAR_ELIMINATION_TYPE_MIN>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
+		}
+	else {
+		if (VAR_ELIMINATION_TYPE_SUM == varEliminationType) 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_SUM, VAR_ELIMINATION_TYPE_SUM>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
+		else if (VAR_ELIMINATION_TYPE_MAX == varEliminationType) 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_SUM, VAR_ELIMINATION_TYPE_MAX>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
+		else 
+			ComputeOutputTableKernel<FN_COBINATION_TYPE_SUM, VAR_ELIMINATION_TYPE_MIN>(C, logScale, nThreads, chunkSize, bews->BucketScheduler()) ;
 		}
 
+	delete [] stride ;
 	return 0 ;
 }
 
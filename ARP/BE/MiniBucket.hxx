@@ -6,6 +6,11 @@
 #include "Function.hxx"
 #include "Utils/MiscUtils.hxx"
 
+// output tables whose computation (output table size x number of eliminated value combinations) is at least this large are computed by 
+// MBEworkspace::nThreads() threads, each taking chunks of at least ARE_BE_PARALLEL_TABLE_CHUNK_SIZE output cells (32KB of doubles).
+#define ARE_BE_PARALLEL_TABLE_MIN_SIZE		1048576
+#define ARE_BE_PARALLEL_TABLE_CHUNK_SIZE	4096
+
 namespace BucketElimination
 {
 
@@ -134,6 +139,19 @@ public :
 	// basic/general worker fn for eliminating a set of vars; we assume all ElimVars are in the minibucket signature.
 	virtual int32_t ComputeOutputFunction(ARE::Function & OutputFN, const int32_t *ElimVars, int32_t nElimVars, int32_t *TempSpaceForVars) ;
 
+protected :
+
+	// table kernel of the ComputeOutputFunction*() fns. Vars[0,nVars) are the vars of the minibucket; the first nKeepVars are the output fn scope, 
+	// the rest are eliminated (there is at least one). enumerates value combinations of Vars (last var changing fastest) and for each of the KeepSize 
+	// output table cells, eliminates the combination of FNs[] (plus AvgMaxMarginal, minus MaxMarginal, if given) over the eliminated vars.
+	// instead of computing each input table address from scratch, addresses are updated incrementally from per-fn strides of each var; 
+	// the innermost eliminated vars x the innermost kept vars form a block (see ARE_BE_KERNEL_BLOCK_SIZE) that is combined/eliminated by the TableKernels, 
+	// using a kernel picked once per call for the combination/elimination type of the problem. 
+	// large output tables are split into chunks of cells computed in parallel (see ARE_BE_PARALLEL_TABLE_MIN_SIZE). 
+	// the output is combined with ConstFactor. FNs[] must have argument permutation lists wrt Vars.
+	int32_t ComputeOutputTable(int32_t nVars, const int32_t *Vars, int32_t nKeepVars, int32_t nFNs, ARE::Function **FNs, 
+		ARE::Function *fMaxMarginal, ARE::Function *fAvgMaxMarginal, ARE_Function_TableType ConstFactor, ARE_Function_TableType *Output, int64_t KeepSize) ;
+
 public :
 
 	void Initalize(BucketElimination::Bucket & B, int32_t IDX) ;
@@ -0,0 +1,336 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Globals.hxx"
+#include <Sort.hxx>
+#include "Function.hxx"
+#include "Bucket.hxx"
+#include "MBEworkspace.hxx"
+#include "SymbolicPartitioning.hxx"
+
+static inline int32_t PopCount64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(w) ;
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL) ;
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL) ;
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL ;
+	return (int32_t) ((w * 0x0101010101010101ULL) >> 56) ;
+#endif
+}
+
+// index of the lowest set bit; w must not be 0.
+static inline int32_t LowestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(w) ;
+#else
+	int32_t i = 0 ;
+	while (0 == (w & 1)) { w >>= 1 ; ++i ; }
+	return i ;
+#endif
+}
+
+
+BucketElimination::SymbolicMBPartitioning::SymbolicMBPartitioning(void)
+	:
+	_WS(NULL), 
+	_iBound(-1), 
+	_nBucketsWithPartitioning(-1), 
+	_MaxNumMiniBucketsPerBucket(-1), 
+	_MaxBucketFunctionWidth(-1), 
+	_TotalNewFunctionSize_Log10(-1.0), 
+	_TotalNewFunctionSpace_Log10(-1.0), 
+	_TotalNewFunctionComputationComplexity_Log10(-1.0), 
+	_MaxSimultaneousNewFunctionSize_Log10(-1.0), 
+	_MaxSimultaneousNewFunctionSpace_Log10(-1.0) 
+{
+}
+
+
+int32_t BucketElimination::SymbolicMBPartitioning::ProcessBucket(int32_t IDX)
+{
+	BucketElimination::Bucket *b = _WS->getBucket(IDX) ;
+	ARE::ARP *problem = _WS->Problem() ;
+	int32_t i, j, k, x ;
+
+	// assign local indeces to vars of the bucket; bucket vars come first, so that output fn scope is the signature without the first nVars bits.
+	int32_t nV = b->nVars(), nOF = b->nOriginalFunctions(), nAF = 0 ;
+	_LocalVars.clear() ;
+	for (j = 0 ; j < nV ; j++) {
+		int32_t v = b->Var(j) ;
+		if (_Var2Local[v] < 0) 
+			{ _Var2Local[v] = _LocalVars.size() ; _LocalVars.push_back(v) ; }
+		}
+	for (j = 0 ; j < nOF ; j++) {
+		ARE::Function *f = b->OriginalFunction(j) ;
+		for (k = 0 ; k < f->N() ; k++) {
+			int32_t v = f->Argument(k) ;
+			if (_Var2Local[v] < 0) 
+				{ _Var2Local[v] = _LocalVars.size() ; _LocalVars.push_back(v) ; }
+			}
+		}
+	for (x = _AugmentedHead[IDX] ; x >= 0 ; x = _AugmentedFNs[x]._Next) {
+		const int32_t *scope = _ScopeArena.data() + _AugmentedFNs[x]._Scope ;
+		for (k = 0 ; k < _AugmentedFNs[x]._N ; k++) {
+			int32_t v = scope[k] ;
+			if (_Var2Local[v] < 0) 
+				{ _Var2Local[v] = _LocalVars.size() ; _LocalVars.push_back(v) ; }
+			}
+		++nAF ;
+		}
+	int32_t nWords = (_LocalVars.size() + 63) >> 6 ;
+	int32_t nF = nOF + nAF ;
+
+	// scope bitsets; fns [0,nOF) are original fns, fns [nOF,nF) are augmented fns in the order they were added.
+	_FnBits.assign((size_t) nF*nWords, 0) ;
+	_FnN.resize(nF) ;
+	for (j = 0 ; j < nOF ; j++) {
+		ARE::Function *f = b->OriginalFunction(j) ;
+		uint64_t *bits = _FnBits.data() + (size_t) j*nWords ;
+		for (k = 0 ; k < f->N() ; k++) 
+			{ int32_t l = _Var2Local[f->Argument(k)] ; bits[l >> 6] |= 1ULL << (l & 63) ; }
+		_FnN[j] = f->N() ;
+		}
+	for (j = nOF, x = _AugmentedHead[IDX] ; x >= 0 ; j++, x = _AugmentedFNs[x]._Next) {
+		const int32_t *scope = _ScopeArena.data() + _AugmentedFNs[x]._Scope ;
+		uint64_t *bits = _FnBits.data() + (size_t) j*nWords ;
+		for (k = 0 ; k < _AugmentedFNs[x]._N ; k++) 
+			{ int32_t l = _Var2Local[scope[k]] ; bits[l >> 6] |= 1ULL << (l & 63) ; }
+		_FnN[j] = _AugmentedFNs[x]._N ;
+		}
+
+	// sort functions in the order of decreasing scope size; fns with the same scope size are in the same order as in Bucket::CreateMBPartitioning().
+	_Key.clear() ; _Data.clear() ;
+	for (j = nOF - 1 ; j >= 0 ; j--) 
+		{ _Key.push_back(-_FnN[j]) ; _Data.push_back(j) ; }
+	for (j = nF - 1 ; j >= nOF ; j--) 
+		{ _Key.push_back(-_FnN[j]) ; _Data.push_back(j) ; }
+	if (nF > 1) {
+		int32_t left[32], right[32] ;
+		QuickSortLong_i64(_Key.data(), nF, _Data.data(), left, right) ;
+		}
+
+	// place each fn in the first minibucket that allows it (see MiniBucket::AllowsFunction()) : a const fn, or an empty minibucket, or 
+	// a fn that fits within the i-bound or whose scope is already in the minibucket signature.
+	int32_t nMBs = 0 ;
+	_MBBits.resize((size_t) nF*nWords) ;
+	_MBWidth.resize(nF) ;
+	_MBnFunctions.resize(nF) ;
+	for (j = 0 ; j < nF ; j++) {
+		int32_t fn = (int32_t) _Data[j], n = _FnN[fn] ;
+		const uint64_t *fbits = _FnBits.data() + (size_t) fn*nWords ;
+		for (k = 0 ; k < nMBs ; k++) {
+			if (0 == n || 0 == _MBWidth[k]) 
+				break ;
+			if (n > _iBound) 
+				continue ;
+			const uint64_t *mbits = _MBBits.data() + (size_t) k*nWords ;
+			int32_t w = 0 ;
+			for (x = 0 ; x < nWords ; x++) 
+				w += PopCount64(mbits[x] | fbits[x]) ;
+			if (w <= _iBound || w == _MBWidth[k]) 
+				break ;
+			}
+		uint64_t *mbits = _MBBits.data() + (size_t) k*nWords ;
+		if (k >= nMBs) {
+			memset(mbits, 0, sizeof(uint64_t)*nWords) ;
+			_MBWidth[k] = _MBnFunctions[k] = 0 ;
+			++nMBs ;
+			}
+		int32_t w = 0 ;
+		for (x = 0 ; x < nWords ; x++) 
+			{ mbits[x] |= fbits[x] ; w += PopCount64(mbits[x]) ; }
+		_MBWidth[k] = w ;
+		_MBnFunctions[k]++ ;
+		}
+
+	_FirstMB[IDX] = _MBs.size() ;
+	_nBucketMBs[IDX] = nMBs ;
+	if (nMBs > 1) 
+		_nBucketsWithPartitioning++ ;
+	if (nMBs > _MaxNumMiniBucketsPerBucket) 
+		_MaxNumMiniBucketsPerBucket = nMBs ;
+
+	// output fn of each minibucket is over its signature without the bucket vars (none, if the signature is no larger than the bucket vars); 
+	// it goes to the bucket of its highest ordered var.
+	const int32_t *varpos = _WS->VarPos() ;
+	for (k = 0 ; k < nMBs ; k++) {
+		const uint64_t *mbits = _MBBits.data() + (size_t) k*nWords ;
+		MBRecord r ;
+		r._Bucket = IDX ;
+		r._nFunctions = _MBnFunctions[k] ;
+		r._Width = _MBWidth[k] ;
+		r._OutputN = 0 ;
+		r._TargetBucket = -1 ;
+		r._SignatureSize_Log10 = 0.0 ;
+		r._OutputSize_Log10 = 0.0 ;
+		int32_t scope = _ScopeArena.size(), v = -1 ;
+		for (x = 0 ; x < nWords ; x++) {
+			for (uint64_t bits = mbits[x] ; 0 != bits ; bits &= bits - 1) {
+				int32_t l = (x << 6) + LowestBit64(bits) ;
+				int32_t u = _LocalVars[l] ;
+				int32_t K = problem->K(u) ;
+				if (K >= 1) 
+					r._SignatureSize_Log10 += log10((double) K) ;
+				if (l < nV) 
+					continue ;
+				_ScopeArena.push_back(u) ;
+				if (r._OutputSize_Log10 >= 0.0) 
+					r._OutputSize_Log10 = K > 0 ? r._OutputSize_Log10 + log10((double) K) : -1.0 ;
+				if (v < 0 || varpos[u] > varpos[v]) 
+					v = u ;
+				}
+			}
+		if (r._Width <= nV) {
+			_ScopeArena.resize(scope) ;
+			r._OutputSize_Log10 = -1.0 ;
+			}
+		else {
+			BucketElimination::Bucket *target = _WS->MapVar2Bucket(v) ;
+			if (NULL == target || target->IDX() >= IDX) 
+				// this is not supposed to happen
+				return 1 ;
+			r._OutputN = _ScopeArena.size() - scope ;
+			r._TargetBucket = target->IDX() ;
+			AugmentedFn af ;
+			af._Scope = scope ;
+			af._N = r._OutputN ;
+			af._Next = -1 ;
+			af._Size_Log10 = r._OutputSize_Log10 ;
+			i = _AugmentedFNs.size() ;
+			_AugmentedFNs.push_back(af) ;
+			if (_AugmentedTail[r._TargetBucket] >= 0) 
+				_AugmentedFNs[_AugmentedTail[r._TargetBucket]]._Next = i ;
+			else 
+				_AugmentedHead[r._TargetBucket] = i ;
+			_AugmentedTail[r._TargetBucket] = i ;
+			if (r._OutputN > _MaxBucketFunctionWidth) 
+				_MaxBucketFunctionWidth = r._OutputN ;
+			}
+		_MBs.push_back(r) ;
+		}
+
+	for (int32_t u : _LocalVars) 
+		_Var2Local[u] = -1 ;
+	return 0 ;
+}
+
+
+void BucketElimination::SymbolicMBPartitioning::ComputeTotals(const int32_t *ComputationOrder)
+{
+	int32_t i, k, nB = _FirstMB.size() ;
+	const double entry_space_Log10 = log10((double) sizeof(ARE_Function_TableType)) ;
+
+	// total new function size/space, as MBEworkspace::ComputeTotalNewFunctionSizeAndSpace() computes it; sum up starting from the largest table.
+	int32_t maxMB = -1 ;
+	double max_size = -1.0 ;
+	for (i = 0 ; i < nB ; i++) {
+		for (k = _FirstMB[i] ; k < _FirstMB[i] + _nBucketMBs[i] ; k++) {
+			if (_MBs[k]._OutputSize_Log10 > max_size) 
+				{ maxMB = k ; max_size = _MBs[k]._OutputSize_Log10 ; }
+			}
+		}
+	if (max_size >= 0.0) {
+		double max_space = entry_space_Log10 + max_size, temp_sum_1 = 1.0, temp_sum_2 = 1.0 ;
+		for (i = 0 ; i < nB ; i++) {
+			for (k = _FirstMB[i] ; k < _FirstMB[i] + _nBucketMBs[i] ; k++) {
+				if (maxMB == k) 
+					continue ;
+				double s = _MBs[k]._OutputSize_Log10 ;
+				temp_sum_1 += pow(10.0, s - max_size) ;
+				temp_sum_2 += pow(10.0, (s >= 0.0 ? entry_space_Log10 + s : -1.0) - max_space) ;
+				}
+			}
+		_TotalNewFunctionSize_Log10 = max_size + log10(temp_sum_1) ;
+		_TotalNewFunctionSpace_Log10 = max_space + log10(temp_sum_2) ;
+		}
+
+	// total computation complexity; sum up starting from the largest.
+	int32_t nMBs = _MBs.size() ;
+	double max_c = -1.0 ;
+	for (k = 0 ; k < nMBs ; k++) {
+		if (_MBs[k]._nFunctions <= 0) continue ;
+		double c = _MBs[k]._SignatureSize_Log10 + log10((double) _MBs[k]._nFunctions) ;
+		if (c > max_c) 
+			{ max_c = c ; maxMB = k ; }
+		}
+	if (max_c >= 0.0) {
+		double temp_sum = 1.0 ;
+		for (k = 0 ; k < nMBs ; k++) {
+			if (_MBs[k]._nFunctions <= 0 || maxMB == k) continue ;
+			temp_sum += pow(10.0, _MBs[k]._SignatureSize_Log10 + log10((double) _MBs[k]._nFunctions) - max_c) ;
+			}
+		_TotalNewFunctionComputationComplexity_Log10 = max_c + log10(temp_sum) ;
+		}
+
+	// max simultaneous new function space, as MBEworkspace::SimulateComputationAndComputeMinSpace() computes it.
+	if (NULL == ComputationOrder) 
+		return ;
+	bool deleteUsedTables = _WS->DeleteUsedTables() ;
+	double size = -1.0 ;
+	for (i = nB - 1 ; i >= 0 ; i--) {
+		int32_t idx = ComputationOrder[i] ;
+		for (k = _FirstMB[idx] ; k < _FirstMB[idx] + _nBucketMBs[idx] ; k++) {
+			double s = _MBs[k]._OutputSize_Log10 ;
+			if (s < 0.0) 
+				continue ;
+			if (size < 0.0) 
+				size = s ;
+			else if (size >= s) 
+				size = size + log10(1.0 + pow(10.0, s - size)) ;
+			else 
+				size = s + log10(1.0 + pow(10.0, size - s)) ;
+			if (size > _MaxSimultaneousNewFunctionSize_Log10) 
+				_MaxSimultaneousNewFunctionSize_Log10 = size ;
+			}
+		if (deleteUsedTables) {
+			for (int32_t x = _AugmentedHead[idx] ; x >= 0 ; x = _AugmentedFNs[x]._Next) {
+				double sf = _AugmentedFNs[x]._Size_Log10 ;
+				if (sf < 0.0) continue ;
+				if (size <= sf) 
+					{ size = -1.0 ; break ; }
+				LOG_OF_SUB_OF_TWO_NUMBERS_GIVEN_AS_LOGS(size, size, sf) 
+				}
+			}
+		}
+	_MaxSimultaneousNewFunctionSpace_Log10 = entry_space_Log10 + _MaxSimultaneousNewFunctionSize_Log10 ;
+}
+
+
+int32_t BucketElimination::SymbolicMBPartitioning::Run(MBEworkspace & WS, int32_t iBound, const int32_t *ComputationOrder)
+{
+	_WS = &WS ;
+	_iBound = iBound ;
+	_MBs.clear() ;
+	_AugmentedFNs.clear() ;
+	_ScopeArena.clear() ;
+	_nBucketsWithPartitioning = _MaxNumMiniBucketsPerBucket = _MaxBucketFunctionWidth = -1 ;
+	_TotalNewFunctionSize_Log10 = _TotalNewFunctionSpace_Log10 = _TotalNewFunctionComputationComplexity_Log10 = -1.0 ;
+	_MaxSimultaneousNewFunctionSize_Log10 = _MaxSimultaneousNewFunctionSpace_Log10 = -1.0 ;
+
+	ARE::ARP *problem = WS.Problem() ;
+	int32_t nB = WS.nBuckets() ;
+	if (NULL == problem || NULL == WS.VarPos() || nB < 0) 
+		return 1 ;
+	_FirstMB.assign(nB, 0) ;
+	_nBucketMBs.assign(nB, 0) ;
+	_AugmentedHead.assign(nB, -1) ;
+	_AugmentedTail.assign(nB, -1) ;
+	if ((int32_t) _Var2Local.size() < problem->N()) 
+		_Var2Local.resize(problem->N(), -1) ;
+
+	// process buckets, from last to first, as MBEworkspace::CreateMBPartitioning() does.
+	_nBucketsWithPartitioning = _MaxNumMiniBucketsPerBucket = _MaxBucketFunctionWidth = 0 ;
+	for (int32_t i = nB - 1 ; i >= 0 ; i--) {
+		if (0 != ProcessBucket(i)) {
+			for (int32_t u : _LocalVars) 
+				_Var2Local[u] = -1 ;
+			return 1 ;
+			}
+		}
+	ComputeTotals(ComputationOrder) ;
+	return 0 ;
+}
@@ -0,0 +1,112 @@
+#ifndef SymbolicPARTITIONING_HXX_INCLUDED
+#define SymbolicPARTITIONING_HXX_INCLUDED
+
+#include <stdint.h>
+#include <vector>
+
+namespace BucketElimination
+{
+
+class MBEworkspace ;
+
+// scope-only (table-free) minibucket partitioning.
+// Run() replays the greedy MB partitioning of Bucket::CreateMBPartitioning() for a given i-bound on function scopes alone; no MiniBucket/Function 
+// objects are created and the workspace is not modified. within a bucket, fn scopes and minibucket signatures are bitsets over the variables 
+// of the bucket; scopes of output fns are kept (as var lists) in an arena until the bucket they go to is processed. 
+// all memory is kept between runs, so once the buffers have grown to the size of the problem, Run() does not allocate.
+// this is used to estimate space/complexity of MBE for an i-bound (see MBEworkspace::EstimateMBPartitioning()); MiniBuckets are created 
+// (MBEworkspace::CreateMBPartitioning()) only when tables are to be computed.
+// an object is used by one thread at a time; any number of objects can Run() on the same workspace concurrently.
+class SymbolicMBPartitioning
+{
+public :
+
+	class MBRecord
+	{
+	public :
+		int32_t _Bucket ; // index of the bucket
+		int32_t _nFunctions ;
+		int32_t _Width ; // size of the signature, including bucket vars
+		int32_t _OutputN ; // number of arguments of the output fn; 0 if it has none
+		int32_t _TargetBucket ; // bucket the output fn is placed in; -1 if none
+		double _SignatureSize_Log10 ; // number of value combinations of the signature
+		double _OutputSize_Log10 ; // output table size; -1 if the output fn has no arguments
+	} ;
+
+protected :
+
+	MBEworkspace *_WS ;
+	int32_t _iBound ;
+
+	// minibuckets of all buckets; minibuckets of bucket i are [_FirstMB[i], _FirstMB[i] + _nBucketMBs[i]), in the order Bucket::CreateMBPartitioning() 
+	// would create them.
+	std::vector<MBRecord> _MBs ;
+	std::vector<int32_t> _FirstMB, _nBucketMBs ;
+
+	int32_t _nBucketsWithPartitioning ;
+	int32_t _MaxNumMiniBucketsPerBucket ;
+	int32_t _MaxBucketFunctionWidth ;
+	double _TotalNewFunctionSize_Log10 ;
+	double _TotalNewFunctionSpace_Log10 ;
+	double _TotalNewFunctionComputationComplexity_Log10 ;
+	double _MaxSimultaneousNewFunctionSize_Log10 ;
+	double _MaxSimultaneousNewFunctionSpace_Log10 ;
+
+public :
+
+	inline int32_t iBound(void) const { return _iBound ; }
+	inline int32_t nMBs(void) const { return _MBs.size() ; }
+	inline const MBRecord & MB(int32_t IDX) const { return _MBs[IDX] ; }
+	inline int32_t FirstMB(int32_t Bucket) const { return _FirstMB[Bucket] ; }
+	inline int32_t nBucketMBs(int32_t Bucket) const { return _nBucketMBs[Bucket] ; }
+	inline int32_t nBucketsWithPartitioning(void) const { return _nBucketsWithPartitioning ; }
+	inline int32_t MaxNumMiniBucketsPerBucket(void) const { return _MaxNumMiniBucketsPerBucket ; }
+	inline int32_t MaxBucketFunctionWidth(void) const { return _MaxBucketFunctionWidth ; }
+	inline double TotalNewFunctionSize_Log10(void) const { return _TotalNewFunctionSize_Log10 ; }
+	inline double TotalNewFunctionSpace_Log10(void) const { return _TotalNewFunctionSpace_Log10 ; }
+	// sum over minibuckets of (signature size x number of functions); unlike MBEworkspace::ComputeTotalNewFunctionComputationComplexity(), the size 
+	// of the entire signature is used.
+	inline double TotalNewFunctionComputationComplexity_Log10(void) const { return _TotalNewFunctionComputationComplexity_Log10 ; }
+	// -1 if Run() was not given a computation order.
+	inline double MaxSimultaneousNewFunctionSize_Log10(void) const { return _MaxSimultaneousNewFunctionSize_Log10 ; }
+	inline double MaxSimultaneousNewFunctionSpace_Log10(void) const { return _MaxSimultaneousNewFunctionSpace_Log10 ; }
+
+protected :
+
+	// augmented fns of each bucket, as a linked list in the order they are added to the bucket; scopes are in _ScopeArena.
+	class AugmentedFn
+	{
+	public :
+		int32_t _Scope ; // offset in _ScopeArena
+		int32_t _N ;
+		int32_t _Next ; // -1 = last
+		double _Size_Log10 ;
+	} ;
+	std::vector<AugmentedFn> _AugmentedFNs ;
+	std::vector<int32_t> _AugmentedHead, _AugmentedTail ;
+	std::vector<int32_t> _ScopeArena ;
+
+	// scratch space of processing a bucket; local index of each var in the bucket is its bit in the bitsets.
+	std::vector<int32_t> _Var2Local ; // -1 = var not in the bucket
+	std::vector<int32_t> _LocalVars ;
+	std::vector<uint64_t> _FnBits ; // scope of each fn of the bucket
+	std::vector<uint64_t> _MBBits ; // signature of each minibucket of the bucket
+	std::vector<int32_t> _FnN, _MBWidth, _MBnFunctions, _Key ;
+	std::vector<int64_t> _Data ;
+
+	int32_t ProcessBucket(int32_t IDX) ;
+	void ComputeTotals(const int32_t *ComputationOrder) ;
+
+public :
+
+	// partition all buckets of the workspace for the given i-bound. if ComputationOrder is given (as MBEworkspace::BucketOrderToCompute()), 
+	// max simultaneous new fn space is computed for it (taking MBEworkspace::DeleteUsedTables() into account).
+	// returns 0 iff ok.
+	int32_t Run(MBEworkspace & WS, int32_t iBound, const int32_t *ComputationOrder) ;
+
+	SymbolicMBPartitioning(void) ;
+} ;
+
+} // namespace BucketElimination
+
+#endif // SymbolicPARTITIONING_HXX_INCLUDED
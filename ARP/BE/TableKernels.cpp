@@ -0,0 +1,699 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "TableKernels.hxx"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARE_BE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// ****************************************************************************************
+// scalar versions.
+// ****************************************************************************************
+
+static void Add_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] += T[k] ;
+}
+
+static void Mul_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] *= T[k] ;
+}
+
+static void Max_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		{ if (T[k] > Buf[k]) Buf[k] = T[k] ; }
+}
+
+static void Min_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		{ if (T[k] < Buf[k]) Buf[k] = T[k] ; }
+}
+
+static void AddConst_Scalar(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] += x ;
+}
+
+static void MulConst_Scalar(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] *= x ;
+}
+
+static void AddGather_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] += T[Offsets[k]] ;
+}
+
+static void MulGather_Scalar(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] *= T[Offsets[k]] ;
+}
+
+static ARE_Function_TableType ReduceSum_Scalar(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType s = 0.0 ;
+	for (int32_t k = 0 ; k < n ; k++) 
+		s += Buf[k] ;
+	return s ;
+}
+
+static ARE_Function_TableType ReduceMax_Scalar(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = -std::numeric_limits<double>::infinity() ;
+	for (int32_t k = 0 ; k < n ; k++) 
+		{ if (Buf[k] > m) m = Buf[k] ; }
+	return m ;
+}
+
+static ARE_Function_TableType ReduceMin_Scalar(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = std::numeric_limits<double>::infinity() ;
+	for (int32_t k = 0 ; k < n ; k++) 
+		{ if (Buf[k] < m) m = Buf[k] ; }
+	return m ;
+}
+
+#define ARE_LN10 2.30258509299404568402
+
+static ARE_Function_TableType LogSumExp10_Scalar(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = ReduceMax_Scalar(Buf, n) ;
+	if (isinf(m) || isnan(m)) 
+		return m ;
+	ARE_Function_TableType s = 0.0 ;
+	for (int32_t k = 0 ; k < n ; k++) 
+		s += exp((Buf[k] - m) * ARE_LN10) ;
+	return m + log10(s) ;
+}
+
+// LogSumExp10Columns() for column c only.
+static void LogSumExp10Column(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols, int32_t c)
+{
+	int32_t r ;
+	ARE_Function_TableType m = V[c] ;
+	for (r = 0 ; r < nRows ; r++) 
+		{ if (Buf[r*nCols + c] > m) m = Buf[r*nCols + c] ; }
+	if (isinf(m) || isnan(m)) 
+		{ V[c] = m ; return ; }
+	ARE_Function_TableType s = exp((V[c] - m) * ARE_LN10) ;
+	for (r = 0 ; r < nRows ; r++) 
+		s += exp((Buf[r*nCols + c] - m) * ARE_LN10) ;
+	V[c] = m + log10(s) ;
+}
+
+static void LogSumExp10Columns_Scalar(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols)
+{
+	for (int32_t c = 0 ; c < nCols ; c++) 
+		LogSumExp10Column(V, Buf, nRows, nCols, c) ;
+}
+
+static void FloatToDouble_Scalar(ARE_Function_TableType *Buf, const float *T, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] = T[k] ;
+}
+
+static void FloatToDoubleGather_Scalar(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] = T[Offsets[k]] ;
+}
+
+static void DecodeQ16_Scalar(ARE_Function_TableType *Buf, const uint16_t *T, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] = ARE::DecodeTableEntryQ16(T[k], Base, Step) ;
+}
+
+static void DecodeQ16Gather_Scalar(ARE_Function_TableType *Buf, const uint16_t *T, const int64_t *Offsets, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n)
+{
+	for (int32_t k = 0 ; k < n ; k++) 
+		Buf[k] = ARE::DecodeTableEntryQ16(T[Offsets[k]], Base, Step) ;
+}
+
+#ifdef ARE_BE_KERNELS_X86
+
+// ****************************************************************************************
+// AVX2 versions.
+// ****************************************************************************************
+
+// 2^f for f in [-0.5,0.5] : Taylor series of e^(f*ln2) up to degree 12; error is below 2e-16.
+#define ARE_EXP2_POLY(FMA, SET1, r, g) \
+	r = FMA(SET1(1.0/479001600.0), g, SET1(1.0/39916800.0)) ; \
+	r = FMA(r, g, SET1(1.0/3628800.0)) ; \
+	r = FMA(r, g, SET1(1.0/362880.0)) ; \
+	r = FMA(r, g, SET1(1.0/40320.0)) ; \
+	r = FMA(r, g, SET1(1.0/5040.0)) ; \
+	r = FMA(r, g, SET1(1.0/720.0)) ; \
+	r = FMA(r, g, SET1(1.0/120.0)) ; \
+	r = FMA(r, g, SET1(1.0/24.0)) ; \
+	r = FMA(r, g, SET1(1.0/6.0)) ; \
+	r = FMA(r, g, SET1(0.5)) ; \
+	r = FMA(r, g, SET1(1.0)) ; \
+	r = FMA(r, g, SET1(1.0)) ;
+
+#define ARE_LOG2_10 3.32192809488736234787
+#define ARE_LN2 0.69314718055994530942
+
+__attribute__((target("avx2,fma")))
+static void Add_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_add_pd(_mm256_loadu_pd(Buf + k), _mm256_loadu_pd(T + k))) ;
+	for (; k < n ; k++) 
+		Buf[k] += T[k] ;
+}
+
+__attribute__((target("avx2,fma")))
+static void Mul_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_mul_pd(_mm256_loadu_pd(Buf + k), _mm256_loadu_pd(T + k))) ;
+	for (; k < n ; k++) 
+		Buf[k] *= T[k] ;
+}
+
+__attribute__((target("avx2,fma")))
+static void Max_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_max_pd(_mm256_loadu_pd(T + k), _mm256_loadu_pd(Buf + k))) ;
+	for (; k < n ; k++) 
+		{ if (T[k] > Buf[k]) Buf[k] = T[k] ; }
+}
+
+__attribute__((target("avx2,fma")))
+static void Min_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_min_pd(_mm256_loadu_pd(T + k), _mm256_loadu_pd(Buf + k))) ;
+	for (; k < n ; k++) 
+		{ if (T[k] < Buf[k]) Buf[k] = T[k] ; }
+}
+
+__attribute__((target("avx2,fma")))
+static void AddConst_AVX2(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	__m256d X = _mm256_set1_pd(x) ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_add_pd(_mm256_loadu_pd(Buf + k), X)) ;
+	for (; k < n ; k++) 
+		Buf[k] += x ;
+}
+
+__attribute__((target("avx2,fma")))
+static void MulConst_AVX2(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	__m256d X = _mm256_set1_pd(x) ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_mul_pd(_mm256_loadu_pd(Buf + k), X)) ;
+	for (; k < n ; k++) 
+		Buf[k] *= x ;
+}
+
+__attribute__((target("avx2,fma")))
+static void AddGather_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) {
+		__m256d t = _mm256_i64gather_pd(T, _mm256_loadu_si256((const __m256i *) (Offsets + k)), 8) ;
+		_mm256_storeu_pd(Buf + k, _mm256_add_pd(_mm256_loadu_pd(Buf + k), t)) ;
+		}
+	for (; k < n ; k++) 
+		Buf[k] += T[Offsets[k]] ;
+}
+
+__attribute__((target("avx2,fma")))
+static void MulGather_AVX2(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) {
+		__m256d t = _mm256_i64gather_pd(T, _mm256_loadu_si256((const __m256i *) (Offsets + k)), 8) ;
+		_mm256_storeu_pd(Buf + k, _mm256_mul_pd(_mm256_loadu_pd(Buf + k), t)) ;
+		}
+	for (; k < n ; k++) 
+		Buf[k] *= T[Offsets[k]] ;
+}
+
+__attribute__((target("avx2,fma")))
+static ARE_Function_TableType ReduceSum_AVX2(const ARE_Function_TableType *Buf, int32_t n)
+{
+	__m256d S = _mm256_setzero_pd() ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		S = _mm256_add_pd(S, _mm256_loadu_pd(Buf + k)) ;
+	double s4[4] ;
+	_mm256_storeu_pd(s4, S) ;
+	ARE_Function_TableType s = (s4[0] + s4[1]) + (s4[2] + s4[3]) ;
+	for (; k < n ; k++) 
+		s += Buf[k] ;
+	return s ;
+}
+
+__attribute__((target("avx2,fma")))
+static ARE_Function_TableType ReduceMax_AVX2(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = -std::numeric_limits<double>::infinity() ;
+	__m256d M = _mm256_set1_pd(m) ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		M = _mm256_max_pd(M, _mm256_loadu_pd(Buf + k)) ;
+	double m4[4] ;
+	_mm256_storeu_pd(m4, M) ;
+	for (int32_t i = 0 ; i < 4 ; i++) 
+		{ if (m4[i] > m) m = m4[i] ; }
+	for (; k < n ; k++) 
+		{ if (Buf[k] > m) m = Buf[k] ; }
+	return m ;
+}
+
+__attribute__((target("avx2,fma")))
+static ARE_Function_TableType ReduceMin_AVX2(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = std::numeric_limits<double>::infinity() ;
+	__m256d M = _mm256_set1_pd(m) ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		M = _mm256_min_pd(M, _mm256_loadu_pd(Buf + k)) ;
+	double m4[4] ;
+	_mm256_storeu_pd(m4, M) ;
+	for (int32_t i = 0 ; i < 4 ; i++) 
+		{ if (m4[i] < m) m = m4[i] ; }
+	for (; k < n ; k++) 
+		{ if (Buf[k] < m) m = Buf[k] ; }
+	return m ;
+}
+
+// 10^x for x <= 0 (4 lanes); x below -300 gives ~1e-300 instead of 0, which is negligible in LogSumExp10() since the sum is at least 1.
+__attribute__((target("avx2,fma")))
+static inline __m256d Exp10_AVX2(__m256d x)
+{
+	__m256d t = _mm256_max_pd(_mm256_mul_pd(x, _mm256_set1_pd(ARE_LOG2_10)), _mm256_set1_pd(-1000.0)) ;
+	__m256d n = _mm256_round_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) ;
+	__m256d g = _mm256_mul_pd(_mm256_sub_pd(t, n), _mm256_set1_pd(ARE_LN2)) ;
+	__m256d r ;
+	ARE_EXP2_POLY(_mm256_fmadd_pd, _mm256_set1_pd, r, g)
+	// 2^n : n (integer valued, in [-1000,0]) is put in the low bits of the mantissa by adding 1.5*2^52, then moved to the exponent field.
+	__m256i ni = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(6755399441055744.0))), _mm256_castpd_si256(_mm256_set1_pd(6755399441055744.0))) ;
+	__m256i e = _mm256_slli_epi64(_mm256_add_epi64(ni, _mm256_set1_epi64x(1023)), 52) ;
+	return _mm256_mul_pd(r, _mm256_castsi256_pd(e)) ;
+}
+
+__attribute__((target("avx2,fma")))
+static ARE_Function_TableType LogSumExp10_AVX2(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = ReduceMax_AVX2(Buf, n) ;
+	if (isinf(m) || isnan(m)) 
+		return m ;
+	__m256d M = _mm256_set1_pd(m), S = _mm256_setzero_pd() ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		S = _mm256_add_pd(S, Exp10_AVX2(_mm256_sub_pd(_mm256_loadu_pd(Buf + k), M))) ;
+	if (k < n) {
+		// pad the last vector with very small values; those lanes add ~0.
+		double x4[4] = { -1.0e300, -1.0e300, -1.0e300, -1.0e300 } ;
+		for (int32_t i = 0 ; k + i < n ; i++) 
+			x4[i] = Buf[k + i] ;
+		S = _mm256_add_pd(S, Exp10_AVX2(_mm256_sub_pd(_mm256_loadu_pd(x4), M))) ;
+		}
+	double s4[4] ;
+	_mm256_storeu_pd(s4, S) ;
+	return m + log10((s4[0] + s4[1]) + (s4[2] + s4[3])) ;
+}
+
+// columns are done 4 at a time, over all rows; the max of a column is used as shift, unless it is not finite (then the result is the max).
+__attribute__((target("avx2,fma")))
+static void LogSumExp10Columns_AVX2(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols)
+{
+	int32_t r, c = 0, i ;
+	for (; c + 4 <= nCols ; c += 4) {
+		__m256d M = _mm256_loadu_pd(V + c) ;
+		for (r = 0 ; r < nRows ; r++) 
+			M = _mm256_max_pd(_mm256_loadu_pd(Buf + r*nCols + c), M) ;
+		__m256d finite = _mm256_cmp_pd(_mm256_sub_pd(M, M), _mm256_setzero_pd(), _CMP_EQ_OQ) ;
+		__m256d shift = _mm256_and_pd(M, finite) ;
+		__m256d S = Exp10_AVX2(_mm256_sub_pd(_mm256_loadu_pd(V + c), shift)) ;
+		for (r = 0 ; r < nRows ; r++) 
+			S = _mm256_add_pd(S, Exp10_AVX2(_mm256_sub_pd(_mm256_loadu_pd(Buf + r*nCols + c), shift))) ;
+		double m4[4], s4[4] ;
+		_mm256_storeu_pd(m4, M) ;
+		_mm256_storeu_pd(s4, S) ;
+		for (i = 0 ; i < 4 ; i++) 
+			V[c + i] = (isinf(m4[i]) || isnan(m4[i])) ? m4[i] : m4[i] + log10(s4[i]) ;
+		}
+	for (; c < nCols ; c++) 
+		LogSumExp10Column(V, Buf, nRows, nCols, c) ;
+}
+
+__attribute__((target("avx2,fma")))
+static void FloatToDouble_AVX2(ARE_Function_TableType *Buf, const float *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_cvtps_pd(_mm_loadu_ps(T + k))) ;
+	for (; k < n ; k++) 
+		Buf[k] = T[k] ;
+}
+
+__attribute__((target("avx2,fma")))
+static void FloatToDoubleGather_AVX2(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) 
+		_mm256_storeu_pd(Buf + k, _mm256_cvtps_pd(_mm256_i64gather_ps(T, _mm256_loadu_si256((const __m256i *) (Offsets + k)), 4))) ;
+	for (; k < n ; k++) 
+		Buf[k] = T[Offsets[k]] ;
+}
+
+// mul and add are not fused, so that the result is the same as ARE::DecodeTableEntryQ16().
+__attribute__((target("avx2,fma")))
+static void DecodeQ16_AVX2(ARE_Function_TableType *Buf, const uint16_t *T, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n)
+{
+	const __m256d B = _mm256_set1_pd(Base), S = _mm256_set1_pd(Step), one = _mm256_set1_pd(1.0), zero = _mm256_setzero_pd(), top = _mm256_set1_pd(65535.0) ;
+	const __m256d ninf = _mm256_set1_pd(-std::numeric_limits<double>::infinity()), pinf = _mm256_set1_pd(std::numeric_limits<double>::infinity()) ;
+	int32_t k = 0 ;
+	for (; k + 4 <= n ; k += 4) {
+		__m256d q = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *) (T + k)))) ;
+		__m256d v = _mm256_add_pd(B, _mm256_mul_pd(_mm256_sub_pd(q, one), S)) ;
+		v = _mm256_blendv_pd(v, ninf, _mm256_cmp_pd(q, zero, _CMP_EQ_OQ)) ;
+		v = _mm256_blendv_pd(v, pinf, _mm256_cmp_pd(q, top, _CMP_EQ_OQ)) ;
+		_mm256_storeu_pd(Buf + k, v) ;
+		}
+	for (; k < n ; k++) 
+		Buf[k] = ARE::DecodeTableEntryQ16(T[k], Base, Step) ;
+}
+
+// ****************************************************************************************
+// AVX-512 versions.
+// ****************************************************************************************
+
+__attribute__((target("avx512f")))
+static void Add_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_add_pd(_mm512_loadu_pd(Buf + k), _mm512_loadu_pd(T + k))) ;
+	if (k < n) {
+		__mmask8 mask = (__mmask8) ((1u << (n - k)) - 1) ;
+		_mm512_mask_storeu_pd(Buf + k, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, Buf + k), _mm512_maskz_loadu_pd(mask, T + k))) ;
+		}
+}
+
+__attribute__((target("avx512f")))
+static void Mul_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_mul_pd(_mm512_loadu_pd(Buf + k), _mm512_loadu_pd(T + k))) ;
+	if (k < n) {
+		__mmask8 mask = (__mmask8) ((1u << (n - k)) - 1) ;
+		_mm512_mask_storeu_pd(Buf + k, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, Buf + k), _mm512_maskz_loadu_pd(mask, T + k))) ;
+		}
+}
+
+__attribute__((target("avx512f")))
+static void Max_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_max_pd(_mm512_loadu_pd(T + k), _mm512_loadu_pd(Buf + k))) ;
+	for (; k < n ; k++) 
+		{ if (T[k] > Buf[k]) Buf[k] = T[k] ; }
+}
+
+__attribute__((target("avx512f")))
+static void Min_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_min_pd(_mm512_loadu_pd(T + k), _mm512_loadu_pd(Buf + k))) ;
+	for (; k < n ; k++) 
+		{ if (T[k] < Buf[k]) Buf[k] = T[k] ; }
+}
+
+__attribute__((target("avx512f")))
+static void AddConst_AVX512(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	__m512d X = _mm512_set1_pd(x) ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_add_pd(_mm512_loadu_pd(Buf + k), X)) ;
+	if (k < n) {
+		__mmask8 mask = (__mmask8) ((1u << (n - k)) - 1) ;
+		_mm512_mask_storeu_pd(Buf + k, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, Buf + k), X)) ;
+		}
+}
+
+__attribute__((target("avx512f")))
+static void MulConst_AVX512(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+{
+	__m512d X = _mm512_set1_pd(x) ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_mul_pd(_mm512_loadu_pd(Buf + k), X)) ;
+	if (k < n) {
+		__mmask8 mask = (__mmask8) ((1u << (n - k)) - 1) ;
+		_mm512_mask_storeu_pd(Buf + k, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, Buf + k), X)) ;
+		}
+}
+
+__attribute__((target("avx512f")))
+static void AddGather_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) {
+		__m512d t = _mm512_i64gather_pd(_mm512_loadu_si512((const void *) (Offsets + k)), T, 8) ;
+		_mm512_storeu_pd(Buf + k, _mm512_add_pd(_mm512_loadu_pd(Buf + k), t)) ;
+		}
+	for (; k < n ; k++) 
+		Buf[k] += T[Offsets[k]] ;
+}
+
+__attribute__((target("avx512f")))
+static void MulGather_AVX512(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) {
+		__m512d t = _mm512_i64gather_pd(_mm512_loadu_si512((const void *) (Offsets + k)), T, 8) ;
+		_mm512_storeu_pd(Buf + k, _mm512_mul_pd(_mm512_loadu_pd(Buf + k), t)) ;
+		}
+	for (; k < n ; k++) 
+		Buf[k] *= T[Offsets[k]] ;
+}
+
+__attribute__((target("avx512f")))
+static ARE_Function_TableType ReduceSum_AVX512(const ARE_Function_TableType *Buf, int32_t n)
+{
+	__m512d S = _mm512_setzero_pd() ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		S = _mm512_add_pd(S, _mm512_loadu_pd(Buf + k)) ;
+	if (k < n) 
+		S = _mm512_add_pd(S, _mm512_maskz_loadu_pd((__mmask8) ((1u << (n - k)) - 1), Buf + k)) ;
+	return _mm512_reduce_add_pd(S) ;
+}
+
+__attribute__((target("avx512f")))
+static ARE_Function_TableType ReduceMax_AVX512(const ARE_Function_TableType *Buf, int32_t n)
+{
+	__m512d M = _mm512_set1_pd(-std::numeric_limits<double>::infinity()) ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		M = _mm512_max_pd(M, _mm512_loadu_pd(Buf + k)) ;
+	if (k < n) 
+		M = _mm512_mask_max_pd(M, (__mmask8) ((1u << (n - k)) - 1), M, _mm512_maskz_loadu_pd((__mmask8) ((1u << (n - k)) - 1), Buf + k)) ;
+	return _mm512_reduce_max_pd(M) ;
+}
+
+__attribute__((target("avx512f")))
+static ARE_Function_TableType ReduceMin_AVX512(const ARE_Function_TableType *Buf, int32_t n)
+{
+	__m512d M = _mm512_set1_pd(std::numeric_limits<double>::infinity()) ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		M = _mm512_min_pd(M, _mm512_loadu_pd(Buf + k)) ;
+	if (k < n) 
+		M = _mm512_mask_min_pd(M, (__mmask8) ((1u << (n - k)) - 1), M, _mm512_maskz_loadu_pd((__mmask8) ((1u << (n - k)) - 1), Buf + k)) ;
+	return _mm512_reduce_min_pd(M) ;
+}
+
+// 10^x for x <= 0 (8 lanes); see Exp10_AVX2().
+__attribute__((target("avx512f")))
+static inline __m512d Exp10_AVX512(__m512d x)
+{
+	__m512d t = _mm512_max_pd(_mm512_mul_pd(x, _mm512_set1_pd(ARE_LOG2_10)), _mm512_set1_pd(-1000.0)) ;
+	__m512d n = _mm512_roundscale_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) ;
+	__m512d g = _mm512_mul_pd(_mm512_sub_pd(t, n), _mm512_set1_pd(ARE_LN2)) ;
+	__m512d r ;
+	ARE_EXP2_POLY(_mm512_fmadd_pd, _mm512_set1_pd, r, g)
+	return _mm512_scalef_pd(r, n) ;
+}
+
+__attribute__((target("avx512f")))
+static ARE_Function_TableType LogSumExp10_AVX512(const ARE_Function_TableType *Buf, int32_t n)
+{
+	ARE_Function_TableType m = ReduceMax_AVX512(Buf, n) ;
+	if (isinf(m) || isnan(m)) 
+		return m ;
+	__m512d M = _mm512_set1_pd(m), S = _mm512_setzero_pd() ;
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		S = _mm512_add_pd(S, Exp10_AVX512(_mm512_sub_pd(_mm512_loadu_pd(Buf + k), M))) ;
+	if (k < n) {
+		__mmask8 mask = (__mmask8) ((1u << (n - k)) - 1) ;
+		S = _mm512_mask_add_pd(S, mask, S, Exp10_AVX512(_mm512_sub_pd(_mm512_maskz_loadu_pd(mask, Buf + k), M))) ;
+		}
+	return m + log10(_mm512_reduce_add_pd(S)) ;
+}
+
+// see LogSumExp10Columns_AVX2().
+__attribute__((target("avx512f")))
+static void LogSumExp10Columns_AVX512(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols)
+{
+	int32_t r, c = 0, i ;
+	for (; c + 8 <= nCols ; c += 8) {
+		__m512d M = _mm512_loadu_pd(V + c) ;
+		for (r = 0 ; r < nRows ; r++) 
+			M = _mm512_max_pd(_mm512_loadu_pd(Buf + r*nCols + c), M) ;
+		__mmask8 finite = _mm512_cmp_pd_mask(_mm512_sub_pd(M, M), _mm512_setzero_pd(), _CMP_EQ_OQ) ;
+		__m512d shift = _mm512_maskz_mov_pd(finite, M) ;
+		__m512d S = Exp10_AVX512(_mm512_sub_pd(_mm512_loadu_pd(V + c), shift)) ;
+		for (r = 0 ; r < nRows ; r++) 
+			S = _mm512_add_pd(S, Exp10_AVX512(_mm512_sub_pd(_mm512_loadu_pd(Buf + r*nCols + c), shift))) ;
+		double m8[8], s8[8] ;
+		_mm512_storeu_pd(m8, M) ;
+		_mm512_storeu_pd(s8, S) ;
+		for (i = 0 ; i < 8 ; i++) 
+			V[c + i] = (isinf(m8[i]) || isnan(m8[i])) ? m8[i] : m8[i] + log10(s8[i]) ;
+		}
+	for (; c < nCols ; c++) 
+		LogSumExp10Column(V, Buf, nRows, nCols, c) ;
+}
+
+__attribute__((target("avx512f")))
+static void FloatToDouble_AVX512(ARE_Function_TableType *Buf, const float *T, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_cvtps_pd(_mm256_loadu_ps(T + k))) ;
+	for (; k < n ; k++) 
+		Buf[k] = T[k] ;
+}
+
+__attribute__((target("avx512f")))
+static void FloatToDoubleGather_AVX512(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n)
+{
+	int32_t k = 0 ;
+	for (; k + 8 <= n ; k += 8) 
+		_mm512_storeu_pd(Buf + k, _mm512_cvtps_pd(_mm512_i64gather_ps(_mm512_loadu_si512((const void *) (Offsets + k)), T, 4))) ;
+	for (; k < n ; k++) 
+		Buf[k] = T[Offsets[k]] ;
+}
+
+#endif // ARE_BE_KERNELS_X86
+
+// ****************************************************************************************
+// dispatch.
+// ****************************************************************************************
+
+class TableKernelsDispatch
+{
+public :
+	int32_t _Level ;
+	void (*_Add)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+	void (*_Mul)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+	void (*_Max)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+	void (*_Min)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+	void (*_AddConst)(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) ;
+	void (*_MulConst)(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) ;
+	void (*_AddGather)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) ;
+	void (*_MulGather)(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) ;
+	ARE_Function_TableType (*_ReduceSum)(const ARE_Function_TableType *Buf, int32_t n) ;
+	ARE_Function_TableType (*_ReduceMax)(const ARE_Function_TableType *Buf, int32_t n) ;
+	ARE_Function_TableType (*_ReduceMin)(const ARE_Function_TableType *Buf, int32_t n) ;
+	ARE_Function_TableType (*_LogSumExp10)(const ARE_Function_TableType *Buf, int32_t n) ;
+	void (*_LogSumExp10Columns)(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols) ;
+	void (*_FloatToDouble)(ARE_Function_TableType *Buf, const float *T, int32_t n) ;
+	void (*_FloatToDoubleGather)(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n) ;
+	void (*_DecodeQ16)(ARE_Function_TableType *Buf, const uint16_t *T, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n) ;
+	static int32_t MaxSupportedLevel(void)
+	{
+#ifdef ARE_BE_KERNELS_X86
+		__builtin_cpu_init() ;
+		if (__builtin_cpu_supports("avx512f")) 
+			return 2 ;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) 
+			return 1 ;
+#endif
+		return 0 ;
+	}
+	int32_t Set(int32_t Level)
+	{
+		int32_t maxLevel = MaxSupportedLevel() ;
+		if (Level > maxLevel) 
+			Level = maxLevel ;
+		_Level = Level < 0 ? 0 : Level ;
+		_Add = Add_Scalar ; _Mul = Mul_Scalar ; _Max = Max_Scalar ; _Min = Min_Scalar ; _AddConst = AddConst_Scalar ; _MulConst = MulConst_Scalar ; _AddGather = AddGather_Scalar ; _MulGather = MulGather_Scalar ;
+		_ReduceSum = ReduceSum_Scalar ; _ReduceMax = ReduceMax_Scalar ; _ReduceMin = ReduceMin_Scalar ; _LogSumExp10 = LogSumExp10_Scalar ; _LogSumExp10Columns = LogSumExp10Columns_Scalar ;
+		_FloatToDouble = FloatToDouble_Scalar ; _FloatToDoubleGather = FloatToDoubleGather_Scalar ; _DecodeQ16 = DecodeQ16_Scalar ;
+#ifdef ARE_BE_KERNELS_X86
+		if (1 == _Level) {
+			_Add = Add_AVX2 ; _Mul = Mul_AVX2 ; _Max = Max_AVX2 ; _Min = Min_AVX2 ; _AddConst = AddConst_AVX2 ; _MulConst = MulConst_AVX2 ; _AddGather = AddGather_AVX2 ; _MulGather = MulGather_AVX2 ;
+			_ReduceSum = ReduceSum_AVX2 ; _ReduceMax = ReduceMax_AVX2 ; _ReduceMin = ReduceMin_AVX2 ; _LogSumExp10 = LogSumExp10_AVX2 ; _LogSumExp10Columns = LogSumExp10Columns_AVX2 ;
+			_FloatToDouble = FloatToDouble_AVX2 ; _FloatToDoubleGather = FloatToDoubleGather_AVX2 ; _DecodeQ16 = DecodeQ16_AVX2 ;
+			}
+		else if (2 == _Level) {
+			_Add = Add_AVX512 ; _Mul = Mul_AVX512 ; _Max = Max_AVX512 ; _Min = Min_AVX512 ; _AddConst = AddConst_AVX512 ; _MulConst = MulConst_AVX512 ; _AddGather = AddGather_AVX512 ; _MulGather = MulGather_AVX512 ;
+			_ReduceSum = ReduceSum_AVX512 ; _ReduceMax = ReduceMax_AVX512 ; _ReduceMin = ReduceMin_AVX512 ; _LogSumExp10 = LogSumExp10_AVX512 ; _LogSumExp10Columns = LogSumExp10Columns_AVX512 ;
+			// cpus with AVX-512 have AVX2 as well.
+			_FloatToDouble = FloatToDouble_AVX512 ; _FloatToDoubleGather = FloatToDoubleGather_AVX512 ; _DecodeQ16 = DecodeQ16_AVX2 ;
+			}
+#endif
+		return _Level ;
+	}
+	TableKernelsDispatch(void) { Set(2) ; }
+} ;
+
+static TableKernelsDispatch & Dispatch(void)
+{
+	static TableKernelsDispatch d ;
+	return d ;
+}
+
+int32_t BucketElimination::TableKernels::SIMDLevel(void) { return Dispatch()._Level ; }
+int32_t BucketElimination::TableKernels::SetSIMDLevel(int32_t Level) { return Dispatch().Set(Level) ; }
+
+void BucketElimination::TableKernels::Add(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) { Dispatch()._Add(Buf, T, n) ; }
+void BucketElimination::TableKernels::Mul(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) { Dispatch()._Mul(Buf, T, n) ; }
+void BucketElimination::TableKernels::Max(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) { Dispatch()._Max(Buf, T, n) ; }
+void BucketElimination::TableKernels::Min(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) { Dispatch()._Min(Buf, T, n) ; }
+void BucketElimination::TableKernels::AddConst(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) { Dispatch()._AddConst(Buf, x, n) ; }
+void BucketElimination::TableKernels::MulConst(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) { Dispatch()._MulConst(Buf, x, n) ; }
+void BucketElimination::TableKernels::AddGather(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) { Dispatch()._AddGather(Buf, T, Offsets, n) ; }
+void BucketElimination::TableKernels::MulGather(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) { Dispatch()._MulGather(Buf, T, Offsets, n) ; }
+ARE_Function_TableType BucketElimination::TableKernels::ReduceSum(const ARE_Function_TableType *Buf, int32_t n) { return Dispatch()._ReduceSum(Buf, n) ; }
+ARE_Function_TableType BucketElimination::TableKernels::ReduceMax(const ARE_Function_TableType *Buf, int32_t n) { return Dispatch()._ReduceMax(Buf, n) ; }
+ARE_Function_TableType BucketElimination::TableKernels::ReduceMin(const ARE_Function_TableType *Buf, int32_t n) { return Dispatch()._ReduceMin(Buf, n) ; }
+ARE_Function_TableType BucketElimination::TableKernels::LogSumExp10(const ARE_Function_TableType *Buf, int32_t n) { return Dispatch()._LogSumExp10(Buf, n) ; }
+void BucketElimination::TableKernels::LogSumExp10Columns(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols) { Dispatch()._LogSumExp10Columns(V, Buf, nRows, nCols) ; }
+void BucketElimination::TableKernels::FloatToDouble(ARE_Function_TableType *Buf, const float *T, int32_t n) { Dispatch()._FloatToDouble(Buf, T, n) ; }
+void BucketElimination::TableKernels::FloatToDoubleGather(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n) { Dispatch()._FloatToDoubleGather(Buf, T, Offsets, n) ; }
+void BucketElimination::TableKernels::DecodeQ16(ARE_Function_TableType *Buf, const uint16_t *T, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n) { Dispatch()._DecodeQ16(Buf, T, Base, Step, n) ; }
+void BucketElimination::TableKernels::DecodeQ16Gather(ARE_Function_TableType *Buf, const uint16_t *T, const int64_t *Offsets, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n) { DecodeQ16Gather_Scalar(Buf, T, Offsets, Base, Step, n) ; }
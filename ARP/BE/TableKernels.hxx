@@ -0,0 +1,154 @@
+#ifndef TableKernels_HXX_INCLUDED
+#define TableKernels_HXX_INCLUDED
+
+#include <inttypes.h>
+#include <math.h>
+#include <limits>
+
+#include "Function.hxx"
+#include "Globals.hxx"
+
+// max number of cells of a bucket table that table kernels work on at a time.
+#define ARE_BE_KERNEL_BLOCK_SIZE 1024
+
+namespace BucketElimination
+{
+
+// kernels over arrays of table entries, in scalar/AVX2/AVX-512 versions; the version is picked once, based on what the cpu supports.
+namespace TableKernels
+{
+
+// 0 = scalar, 1 = AVX2, 2 = AVX-512.
+int32_t SIMDLevel(void) ;
+// use the given level, or the highest supported level below it; returns the level used.
+int32_t SetSIMDLevel(int32_t Level) ;
+
+// Buf[k] = Buf[k] (op) T[k], k in [0,n).
+void Add(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+void Mul(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+void Max(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+void Min(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n) ;
+// Buf[k] = Buf[k] (op) x.
+void AddConst(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) ;
+void MulConst(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n) ;
+// Buf[k] = Buf[k] (op) T[Offsets[k]].
+void AddGather(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) ;
+void MulGather(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n) ;
+// sum/max/min of Buf[0,n).
+ARE_Function_TableType ReduceSum(const ARE_Function_TableType *Buf, int32_t n) ;
+ARE_Function_TableType ReduceMax(const ARE_Function_TableType *Buf, int32_t n) ;
+ARE_Function_TableType ReduceMin(const ARE_Function_TableType *Buf, int32_t n) ;
+// log10(sum of 10^Buf[k]) of Buf[0,n) in log10 scale; computed as m + log10(sum of 10^(Buf[k]-m)) where m is the max, so there is one log per call.
+ARE_Function_TableType LogSumExp10(const ARE_Function_TableType *Buf, int32_t n) ;
+// same as LogSumExp10(), for each column c of the nRows x nCols matrix Buf (row major), including V[c] in the sum; result goes to V[c].
+void LogSumExp10Columns(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols) ;
+// Buf[k] = T[k] (or T[Offsets[k]]) as double, for tables stored as float/Q16 (see ARE_Function_TableStorage_*).
+void FloatToDouble(ARE_Function_TableType *Buf, const float *T, int32_t n) ;
+void FloatToDoubleGather(ARE_Function_TableType *Buf, const float *T, const int64_t *Offsets, int32_t n) ;
+void DecodeQ16(ARE_Function_TableType *Buf, const uint16_t *T, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n) ;
+void DecodeQ16Gather(ARE_Function_TableType *Buf, const uint16_t *T, const int64_t *Offsets, ARE_Function_TableType Base, ARE_Function_TableType Step, int32_t n) ;
+
+} // namespace TableKernels
+
+// operators of bucket elimination, for a (function combination, variable elimination, log-scale) triple fixed at compile time,
+// so that the inner loops of a bucket have no per-cell branching on the type of the query.
+// this matches MBEworkspace::ApplyFnCombinationOperator()/ApplyFnDivisionOperator()/ApplyVarEliminationOperator().
+template<int32_t FnCombinationType, int32_t VarEliminationType, bool LogScale> class TableOps
+{
+public :
+	static inline ARE_Function_TableType CombinationNeutralValue(void)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) 
+			return LogScale ? 0.0 : 1.0 ;
+		return LogScale ? -std::numeric_limits<double>::infinity() : 0.0 ;
+	}
+	static inline ARE_Function_TableType EliminationDefaultValue(void)
+	{
+		if (VAR_ELIMINATION_TYPE_SUM == VarEliminationType) 
+			return LogScale ? -std::numeric_limits<double>::infinity() : 0.0 ;
+		else if (VAR_ELIMINATION_TYPE_MAX == VarEliminationType) 
+			return -std::numeric_limits<double>::infinity() ;
+		return std::numeric_limits<double>::infinity() ;
+	}
+	static inline void Combine(ARE_Function_TableType & V, ARE_Function_TableType v)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) {
+			if (LogScale) V += v ; else V *= v ;
+			}
+		else {
+			if (LogScale) LOG_OF_SUM_OF_TWO_NUMBERS_GIVEN_AS_LOGS(V, V, v) else V += v ;
+			}
+	}
+	static inline void Divide(ARE_Function_TableType & V, ARE_Function_TableType v)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) {
+			if (LogScale) V -= v ; else V /= v ;
+			}
+		else {
+			if (LogScale) LOG_OF_SUB_OF_TWO_NUMBERS_GIVEN_AS_LOGS(V, V, v) else V -= v ;
+			}
+	}
+	// Buf[k] = Buf[k] (combined with) T[k].
+	static inline void CombineContiguous(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, int32_t n)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) 
+			{ if (LogScale) TableKernels::Add(Buf, T, n) ; else TableKernels::Mul(Buf, T, n) ; }
+		else if (! LogScale) 
+			TableKernels::Add(Buf, T, n) ;
+		else 
+			{ for (int32_t k = 0 ; k < n ; k++) Combine(Buf[k], T[k]) ; }
+	}
+	// Buf[k] = Buf[k] (combined with) x.
+	static inline void CombineConst(ARE_Function_TableType *Buf, ARE_Function_TableType x, int32_t n)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) 
+			{ if (LogScale) TableKernels::AddConst(Buf, x, n) ; else TableKernels::MulConst(Buf, x, n) ; }
+		else if (! LogScale) 
+			TableKernels::AddConst(Buf, x, n) ;
+		else 
+			{ for (int32_t k = 0 ; k < n ; k++) Combine(Buf[k], x) ; }
+	}
+	// Buf[k] = Buf[k] (combined with) T[Offsets[k]].
+	static inline void CombineGather(ARE_Function_TableType *Buf, const ARE_Function_TableType *T, const int64_t *Offsets, int32_t n)
+	{
+		if (FN_COBINATION_TYPE_PROD == FnCombinationType) 
+			{ if (LogScale) TableKernels::AddGather(Buf, T, Offsets, n) ; else TableKernels::MulGather(Buf, T, Offsets, n) ; }
+		else if (! LogScale) 
+			TableKernels::AddGather(Buf, T, Offsets, n) ;
+		else 
+			{ for (int32_t k = 0 ; k < n ; k++) Combine(Buf[k], T[Offsets[k]]) ; }
+	}
+	// eliminate each column c of the nRows x nCols matrix Buf (row major) into V[c].
+	static inline void Eliminate(ARE_Function_TableType *V, const ARE_Function_TableType *Buf, int32_t nRows, int32_t nCols)
+	{
+		int32_t r ;
+		if (1 == nCols) {
+			if (VAR_ELIMINATION_TYPE_SUM == VarEliminationType) {
+				if (LogScale) 
+					{ ARE_Function_TableType s = TableKernels::LogSumExp10(Buf, nRows) ; LOG_OF_SUM_OF_TWO_NUMBERS_GIVEN_AS_LOGS(V[0], V[0], s) }
+				else 
+					V[0] += TableKernels::ReduceSum(Buf, nRows) ;
+				}
+			else if (VAR_ELIMINATION_TYPE_MAX == VarEliminationType) 
+				{ ARE_Function_TableType m = TableKernels::ReduceMax(Buf, nRows) ; if (m > V[0]) V[0] = m ; }
+			else 
+				{ ARE_Function_TableType m = TableKernels::ReduceMin(Buf, nRows) ; if (m < V[0]) V[0] = m ; }
+			return ;
+			}
+		if (VAR_ELIMINATION_TYPE_SUM == VarEliminationType && LogScale) 
+			{ TableKernels::LogSumExp10Columns(V, Buf, nRows, nCols) ; return ; }
+		for (r = 0 ; r < nRows ; r++) {
+			const ARE_Function_TableType *row = Buf + r*nCols ;
+			if (VAR_ELIMINATION_TYPE_SUM == VarEliminationType) 
+				TableKernels::Add(V, row, nCols) ;
+			else if (VAR_ELIMINATION_TYPE_MAX == VarEliminationType) 
+				TableKernels::Max(V, row, nCols) ;
+			else 
+				TableKernels::Min(V, row, nCols) ;
+			}
+	}
+} ;
+
+} // namespace BucketElimination
+
+#endif // TableKernels_HXX_INCLUDED
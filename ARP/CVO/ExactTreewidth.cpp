@@ -0,0 +1,450 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+#include "ExactTreewidth.hxx"
+
+static inline int32_t PopCount64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(w) ;
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL) ;
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL) ;
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL ;
+	return (int32_t) ((w * 0x0101010101010101ULL) >> 56) ;
+#endif
+}
+
+// index of the lowest set bit; w must not be 0.
+static inline int32_t LowestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(w) ;
+#else
+	int32_t i = 0 ;
+	while (0 == (w & 1)) { w >>= 1 ; ++i ; }
+	return i ;
+#endif
+}
+
+ARE::ExactTreewidth::ExactTreewidth(void)
+	:
+	_nNodes(0), 
+	_nWords(0), 
+	_BaseWidth(0), 
+	_k(-1), 
+	_nFailed(0), 
+	_MaxFailed(1048576), 
+	_nStatesExpanded(0)
+{
+}
+
+
+void ARE::ExactTreewidth::SetMemoryLimit(int64_t nBytes)
+{
+	// each state takes its key, and 2 slots of the hash table (the table is kept at most half full).
+	int64_t stateSize = (int64_t) (_nWords > 0 ? _nWords : 1) * sizeof(uint64_t) + 2 * sizeof(int32_t) ;
+	_MaxFailed = nBytes / stateSize ;
+	if (_MaxFailed > 0x3FFFFFFF) 
+		_MaxFailed = 0x3FFFFFFF ;
+}
+
+
+int32_t ARE::ExactTreewidth::Initialize(ARE::Graph & G)
+{
+	_nNodes = _nWords = 0 ;
+	_Node.clear() ;
+	_Node2Local.clear() ;
+	_LogK.clear() ;
+	_Adj0.clear() ;
+	_BaseWidth = G._VarElimOrderWidth > 0 ? G._VarElimOrderWidth : 0 ;
+	if (! G._IsValid || G._nNodes <= 0) 
+		return 1 ;
+
+	int32_t u, i ;
+	_Node2Local.assign(G._nNodes, -1) ;
+	for (u = 0 ; u < G._nNodes ; u++) {
+		if (0 == G._VarType[u]) 
+			continue ;
+		_Node2Local[u] = _nNodes++ ;
+		_Node.push_back(u) ;
+		_LogK.push_back(G._Nodes[u]._LogK) ;
+		}
+	_nWords = (_nNodes + 63) >> 6 ;
+	_Adj0.assign((int64_t) _nNodes * _nWords, 0) ;
+	std::vector<int32_t> neighbors ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		u = _Node[i] ;
+		int32_t n = G._Nodes[u]._Degree > 0 ? G._Nodes[u]._Degree : 0 ;
+		neighbors.resize(n) ;
+		int32_t m = G.CopyNeighbors(u, neighbors.data(), n) ;
+		if (m > n) {
+			neighbors.resize(m) ;
+			G.CopyNeighbors(u, neighbors.data(), m) ;
+			}
+		uint64_t *row = _Adj0.data() + (int64_t) i * _nWords ;
+		for (int32_t j = 0 ; j < m ; j++) {
+			int32_t l = _Node2Local[neighbors[j]] ;
+			if (l >= 0 && l != i) 
+				{ row[l >> 6] |= ((uint64_t) 1) << (l & 63) ; _Adj0[(int64_t) l * _nWords + (i >> 6)] |= ((uint64_t) 1) << (i & 63) ; }
+			}
+		}
+	return 0 ;
+}
+
+
+uint64_t ARE::ExactTreewidth::HashLeft(void) const
+{
+	uint64_t h = 0x9E3779B97F4A7C15ULL ;
+	for (int32_t i = 0 ; i < _nWords ; i++) {
+		h ^= _Left[i] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2) ;
+		h *= 0xBF58476D1CE4E5B9ULL ;
+		}
+	return h ^ (h >> 31) ;
+}
+
+
+bool ARE::ExactTreewidth::IsFailedState(void) const
+{
+	if (0 == _nFailed) 
+		return false ;
+	uint64_t mask = _FailedTable.size() - 1 ;
+	for (uint64_t slot = HashLeft() & mask ; ; slot = (slot + 1) & mask) {
+		int32_t idx = _FailedTable[slot] ;
+		if (idx < 0) 
+			return false ;
+		if (0 == memcmp(_FailedKeys.data() + (int64_t) idx * _nWords, _Left.data(), _nWords * sizeof(uint64_t))) 
+			return true ;
+		}
+}
+
+
+bool ARE::ExactTreewidth::AddFailedState(void)
+{
+	if (_nFailed >= _MaxFailed) 
+		return false ;
+	// keep the table at most half full
+	if (2 * (_nFailed + 1) > (int64_t) _FailedTable.size()) {
+		int64_t n = _FailedTable.size() > 0 ? 2 * _FailedTable.size() : 1024 ;
+		_FailedTable.assign(n, -1) ;
+		uint64_t mask = n - 1 ;
+		std::vector<uint64_t> left(_Left) ;
+		for (int64_t idx = 0 ; idx < _nFailed ; idx++) {
+			memcpy(_Left.data(), _FailedKeys.data() + idx * _nWords, _nWords * sizeof(uint64_t)) ;
+			uint64_t slot = HashLeft() & mask ;
+			while (_FailedTable[slot] >= 0) 
+				slot = (slot + 1) & mask ;
+			_FailedTable[slot] = (int32_t) idx ;
+			}
+		_Left.swap(left) ;
+		}
+	uint64_t mask = _FailedTable.size() - 1 ;
+	uint64_t slot = HashLeft() & mask ;
+	while (_FailedTable[slot] >= 0) 
+		slot = (slot + 1) & mask ;
+	_FailedTable[slot] = (int32_t) _nFailed++ ;
+	_FailedKeys.insert(_FailedKeys.end(), _Left.begin(), _Left.end()) ;
+	return true ;
+}
+
+
+bool ARE::ExactTreewidth::MinorMinWidthExceeds(int32_t k)
+{
+	// minor-min-width on a copy of the graph left : contract a node of min degree into its neighbor of min degree, until k+1 nodes are left.
+	int32_t i, j, nLeft = 0 ;
+	_MinorAdj = _Adj ;
+	_MinorLeft = _Left ;
+	for (i = 0 ; i < _nWords ; i++) {
+		for (uint64_t bits = _Left[i] ; 0 != bits ; bits &= bits - 1) {
+			int32_t u = (i << 6) + LowestBit64(bits) ;
+			_MinorDegree[u] = _Degree[u] ;
+			++nLeft ;
+			}
+		}
+	for (; nLeft > k + 1 ; --nLeft) {
+		int32_t u = -1, w = -1 ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = _MinorLeft[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t x = (i << 6) + LowestBit64(bits) ;
+				if (u < 0 || _MinorDegree[x] < _MinorDegree[u]) 
+					u = x ;
+				}
+			}
+		if (_MinorDegree[u] > k) 
+			return true ;
+		uint64_t *nu = _MinorAdj.data() + (int64_t) u * _nWords ;
+		_MinorLeft[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nu[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t x = (i << 6) + LowestBit64(bits) ;
+				if (w < 0 || _MinorDegree[x] < _MinorDegree[w]) 
+					w = x ;
+				}
+			}
+		if (w < 0) 
+			continue ;
+		// contract u into w : neighbors of u become neighbors of w.
+		uint64_t *nw = _MinorAdj.data() + (int64_t) w * _nWords ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nu[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t x = (i << 6) + LowestBit64(bits) ;
+				uint64_t *nx = _MinorAdj.data() + (int64_t) x * _nWords ;
+				nx[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+				if (x == w) 
+					continue ;
+				if (0 != (nx[w >> 6] & (((uint64_t) 1) << (w & 63)))) 
+					--_MinorDegree[x] ;
+				else 
+					nx[w >> 6] |= ((uint64_t) 1) << (w & 63) ;
+				}
+			}
+		int32_t d = 0 ;
+		for (j = 0 ; j < _nWords ; j++) 
+			nw[j] |= nu[j] ;
+		nw[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+		nw[w >> 6] &= ~(((uint64_t) 1) << (w & 63)) ;
+		for (j = 0 ; j < _nWords ; j++) 
+			d += PopCount64(nw[j]) ;
+		_MinorDegree[w] = d ;
+		}
+	return false ;
+}
+
+
+bool ARE::ExactTreewidth::IsAlmostSimplicial(int32_t v) const
+{
+	const uint64_t *nv = Row(v) ;
+	int32_t i, j, special[2] = { -1, -1 } ;
+	// find a neighbor u with a missing edge to another neighbor x; the special neighbor is then u or x.
+	for (i = 0 ; i < _nWords && special[0] < 0 ; i++) {
+		for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+			int32_t u = (i << 6) + LowestBit64(bits) ;
+			const uint64_t *nu = Row(u) ;
+			for (j = 0 ; j < _nWords ; j++) {
+				uint64_t missing = nv[j] & ~nu[j] ;
+				if (j == (u >> 6)) 
+					missing &= ~(((uint64_t) 1) << (u & 63)) ;
+				if (0 != missing) 
+					{ special[0] = u ; special[1] = (j << 6) + LowestBit64(missing) ; break ; }
+				}
+			if (special[0] >= 0) 
+				break ;
+			}
+		}
+	if (special[0] < 0) 
+		// simplicial
+		return true ;
+	for (int32_t s = 0 ; s < 2 ; s++) {
+		int32_t w = special[s] ;
+		bool ok = true ;
+		for (i = 0 ; i < _nWords && ok ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits && ok ; bits &= bits - 1) {
+				int32_t y = (i << 6) + LowestBit64(bits) ;
+				if (y == w) 
+					continue ;
+				const uint64_t *ny = Row(y) ;
+				for (j = 0 ; j < _nWords ; j++) {
+					uint64_t missing = nv[j] & ~ny[j] ;
+					if (j == (y >> 6)) 
+						missing &= ~(((uint64_t) 1) << (y & 63)) ;
+					if (j == (w >> 6)) 
+						missing &= ~(((uint64_t) 1) << (w & 63)) ;
+					if (0 != missing) 
+						{ ok = false ; break ; }
+					}
+				}
+			}
+		if (ok) 
+			return true ;
+		}
+	return false ;
+}
+
+
+void ARE::ExactTreewidth::Eliminate(int32_t v)
+{
+	int32_t i, j ;
+	const uint64_t *nv = Row(v) ;
+	_Left[v >> 6] &= ~(((uint64_t) 1) << (v & 63)) ;
+	_Order.push_back(v) ;
+	// save rows of the neighbors, then make the neighbors a clique.
+	int32_t nSaved = 0 ;
+	for (i = 0 ; i < _nWords ; i++) {
+		for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+			int32_t u = (i << 6) + LowestBit64(bits) ;
+			uint64_t *nu = Row(u) ;
+			_UndoNodes.push_back(u) ;
+			_UndoRows.insert(_UndoRows.end(), nu, nu + _nWords) ;
+			++nSaved ;
+			int32_t d = 0 ;
+			for (j = 0 ; j < _nWords ; j++) 
+				{ nu[j] |= nv[j] ; }
+			nu[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+			nu[v >> 6] &= ~(((uint64_t) 1) << (v & 63)) ;
+			for (j = 0 ; j < _nWords ; j++) 
+				d += PopCount64(nu[j]) ;
+			_Degree[u] = d ;
+			}
+		}
+	_UndoNodes.push_back(nSaved) ;
+}
+
+
+void ARE::ExactTreewidth::Restore(int32_t v)
+{
+	int32_t nSaved = _UndoNodes.back() ;
+	_UndoNodes.pop_back() ;
+	for (int32_t k = 0 ; k < nSaved ; k++) {
+		int32_t u = _UndoNodes.back() ;
+		_UndoNodes.pop_back() ;
+		uint64_t *nu = Row(u) ;
+		memcpy(nu, _UndoRows.data() + _UndoRows.size() - _nWords, _nWords * sizeof(uint64_t)) ;
+		_UndoRows.resize(_UndoRows.size() - _nWords) ;
+		int32_t d = 0 ;
+		for (int32_t j = 0 ; j < _nWords ; j++) 
+			d += PopCount64(nu[j]) ;
+		_Degree[u] = d ;
+		}
+	_Order.pop_back() ;
+	_Left[v >> 6] |= ((uint64_t) 1) << (v & 63) ;
+}
+
+
+int32_t ARE::ExactTreewidth::Search(int32_t nLeft)
+{
+	int32_t i ;
+	// any order of the nodes left has width <= _k
+	if (nLeft <= _k + 1) {
+		_Solution = _Order ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = _Left[i] ; 0 != bits ; bits &= bits - 1) 
+				_Solution.push_back((i << 6) + LowestBit64(bits)) ;
+			}
+		return 1 ;
+		}
+	if (0 == (++_nStatesExpanded & 4095) && _Stop && _Stop()) 
+		return -1 ;
+	if (IsFailedState()) 
+		return 0 ;
+	if (MinorMinWidthExceeds(_k)) 
+		return AddFailedState() ? 0 : -1 ;
+
+	// candidates are nodes of degree <= _k, smallest degree first; an almost simplicial candidate is the only one that needs to be tried.
+	int32_t first = _Candidates.size() ;
+	for (i = 0 ; i < _nWords ; i++) {
+		for (uint64_t bits = _Left[i] ; 0 != bits ; bits &= bits - 1) {
+			int32_t u = (i << 6) + LowestBit64(bits) ;
+			if (_Degree[u] <= _k) 
+				_Candidates.push_back(u) ;
+			}
+		}
+	std::vector<int32_t> & degree = _Degree ;
+	std::sort(_Candidates.begin() + first, _Candidates.end(), [&degree](int32_t a, int32_t b) { return degree[a] < degree[b] ; }) ;
+	int32_t n = _Candidates.size() - first ;
+	for (i = 0 ; i < n ; i++) {
+		if (IsAlmostSimplicial(_Candidates[first + i])) 
+			{ _Candidates[first] = _Candidates[first + i] ; n = 1 ; break ; }
+		}
+	int32_t res = 0 ;
+	for (i = 0 ; i < n && 0 == res ; i++) {
+		int32_t v = _Candidates[first + i] ;
+		Eliminate(v) ;
+		res = Search(nLeft - 1) ;
+		Restore(v) ;
+		}
+	_Candidates.resize(first) ;
+	if (0 == res && ! AddFailedState()) 
+		return -1 ;
+	return res ;
+}
+
+
+int32_t ARE::ExactTreewidth::Decide(int32_t k, std::vector<int32_t> & Order)
+{
+	Order.clear() ;
+	_k = k ;
+	_Adj = _Adj0 ;
+	_Left.assign(_nWords, 0) ;
+	_Degree.assign(_nNodes, 0) ;
+	_MinorDegree.assign(_nNodes, 0) ;
+	int32_t i, j ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		_Left[i >> 6] |= ((uint64_t) 1) << (i & 63) ;
+		const uint64_t *row = Row(i) ;
+		for (j = 0 ; j < _nWords ; j++) 
+			_Degree[i] += PopCount64(row[j]) ;
+		}
+	_Order.clear() ;
+	_Solution.clear() ;
+	_UndoNodes.clear() ;
+	_UndoRows.clear() ;
+	_Candidates.clear() ;
+	// failed states of a smaller k may not fail for this k
+	_FailedKeys.clear() ;
+	_FailedTable.clear() ;
+	_nFailed = 0 ;
+	_nStatesExpanded = 0 ;
+
+	int32_t res = Search(_nNodes) ;
+	if (1 == res) {
+		for (int32_t u : _Solution) 
+			Order.push_back(_Node[u]) ;
+		}
+	return res ;
+}
+
+
+int32_t ARE::ExactTreewidth::AppendOrder(ARE::Graph & G, const std::vector<int32_t> & Order)
+{
+	if (G._OrderLength + (int32_t) Order.size() > G._nNodes) 
+		return 1 ;
+	_Adj = _Adj0 ;
+	int32_t i, j ;
+	for (int32_t X : Order) {
+		int32_t v = _Node2Local[X] ;
+		if (v < 0) 
+			return 1 ;
+		uint64_t *nv = Row(v) ;
+		// width/complexity of eliminating v, as in Graph::ComputeVariableEliminationOrder_Simple()
+		int32_t degree = 0, nFillEdges = 0 ;
+		double score = _LogK[v] ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t u = (i << 6) + LowestBit64(bits) ;
+				const uint64_t *nu = Row(u) ;
+				++degree ;
+				score += _LogK[u] ;
+				for (j = 0 ; j < _nWords ; j++) 
+					nFillEdges += PopCount64(nv[j] & ~nu[j]) ;
+				--nFillEdges ; // u itself
+				}
+			}
+		G._VarElimOrder[G._OrderLength++] = X ;
+		if (degree > G._VarElimOrderWidth) 
+			G._VarElimOrderWidth = degree ;
+		if (score > G._MaxVarElimComplexity_Log10) 
+			G._MaxVarElimComplexity_Log10 = score ;
+		G._TotalVarElimComplexity_Log10 += log10(1.0 + pow(10.0, score - G._TotalVarElimComplexity_Log10)) ;
+		double space = score - _LogK[v] ;
+		G._TotalNewFunctionStorageAsNumOfElements_Log10 += log10(1.0 + pow(10.0, space - G._TotalNewFunctionStorageAsNumOfElements_Log10)) ;
+		G._nFillEdges += nFillEdges >> 1 ;
+		// eliminate v
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t u = (i << 6) + LowestBit64(bits) ;
+				uint64_t *nu = Row(u) ;
+				for (j = 0 ; j < _nWords ; j++) 
+					nu[j] |= nv[j] ;
+				nu[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+				nu[v >> 6] &= ~(((uint64_t) 1) << (v & 63)) ;
+				}
+			}
+		}
+	return 0 ;
+}
@@ -0,0 +1,98 @@
+#ifndef ARE_ExactTreewidth_HXX_INCLUDED
+#define ARE_ExactTreewidth_HXX_INCLUDED
+
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+namespace ARE
+{
+
+class Graph ;
+
+// exact width of the graph of the nodes of a Graph that are not ordered yet (e.g. the CVO master graph, after easy vars are eliminated). 
+// Decide(k) is a depth-first search over elimination orders of width <= k; the state is the set S of eliminated nodes, since the graph 
+// left after eliminating S does not depend on the order S was eliminated in. states that fail are memoized, so each is expanded once. 
+// a state fails right away if the minor-min-width lower bound (see WidthLowerBound) of its graph is > k. 
+// a node of degree <= k that is almost simplicial (all neighbors but at most one form a clique) is eliminated without branching, since 
+// the graph without it (with its neighbors made a clique) is a minor of the graph, and has width <= k iff the graph does.
+// the graph is kept as a bitset adjacency matrix; eliminating a node ORs its row into the rows of its neighbors, and backtracking restores them.
+// an object is used by one thread at a time.
+class ExactTreewidth
+{
+protected :
+	// copy of the graph
+	int32_t _nNodes ;
+	int32_t _nWords ; // 64-bit words per row
+	std::vector<int32_t> _Node ; // node of the Graph of each local node
+	std::vector<int32_t> _Node2Local ; // -1 if the node is not copied
+	std::vector<double> _LogK ;
+	std::vector<uint64_t> _Adj0 ; // adjacency matrix; _nNodes rows of _nWords words
+	int32_t _BaseWidth ; // width of the nodes of the Graph that are already ordered
+
+	// search state
+	int32_t _k ;
+	std::vector<uint64_t> _Adj ; // adjacency of the graph left
+	std::vector<uint64_t> _Left ; // nodes not eliminated
+	std::vector<int32_t> _Degree ;
+	std::vector<int32_t> _Order ; // nodes eliminated, in order
+	std::vector<int32_t> _Solution ;
+	// rows changed by eliminations on the current path, to be restored when backtracking; each entry is a node and its row.
+	std::vector<int32_t> _UndoNodes ;
+	std::vector<uint64_t> _UndoRows ;
+	std::vector<int32_t> _Candidates ; // candidates of each state on the current path
+	// scratch space of MinorMinWidthExceeds()
+	std::vector<uint64_t> _MinorAdj, _MinorLeft ;
+	std::vector<int32_t> _MinorDegree ;
+
+	// failed states; open addressing hash table of indeces into _FailedKeys, which holds _nWords words (the set of nodes left) per state.
+	std::vector<uint64_t> _FailedKeys ;
+	std::vector<int32_t> _FailedTable ; // -1 = empty slot
+	int64_t _nFailed ;
+	int64_t _MaxFailed ; // memory limit, as a number of states
+	int64_t _nStatesExpanded ;
+	std::function<bool(void)> _Stop ;
+
+	inline const uint64_t *Row(int32_t u) const { return _Adj.data() + (int64_t) u * _nWords ; }
+	inline uint64_t *Row(int32_t u) { return _Adj.data() + (int64_t) u * _nWords ; }
+	uint64_t HashLeft(void) const ;
+	bool IsFailedState(void) const ;
+	// returns false if the memory limit is reached.
+	bool AddFailedState(void) ;
+	// true iff the minor-min-width lower bound of the graph left is > k.
+	bool MinorMinWidthExceeds(int32_t k) ;
+	bool IsAlmostSimplicial(int32_t v) const ;
+	void Eliminate(int32_t v) ;
+	void Restore(int32_t v) ;
+	// 1 = the graph left has an order of width <= _k (it is in _Solution), 0 = it does not, -1 = search was stopped or ran out of memory.
+	int32_t Search(int32_t nLeft) ;
+
+public :
+
+	inline int32_t nNodes(void) const { return _nNodes ; }
+	inline int32_t BaseWidth(void) const { return _BaseWidth ; }
+	inline int64_t nStatesExpanded(void) const { return _nStatesExpanded ; }
+	inline int64_t nFailedStates(void) const { return _nFailed ; }
+	// memory for failed states, in bytes.
+	void SetMemoryLimit(int64_t nBytes) ;
+	// the search is stopped (Decide() returns -1) when Stop returns true; it is called every few thousand states.
+	inline void SetStopFunction(const std::function<bool(void)> & Stop) { _Stop = Stop ; }
+
+	// copy nodes of G that are not ordered yet, and edges between them; G is not changed. returns 0 iff ok.
+	int32_t Initialize(Graph & G) ;
+
+	// find an order of the nodes copied by Initialize(), of width <= k; Order is the list of nodes of G in elimination order.
+	// returns 1 if found, 0 if there is no such order, -1 if the search was stopped or ran out of memory.
+	int32_t Decide(int32_t k, std::vector<int32_t> & Order) ;
+
+	// append Order (as computed by Decide()) to the elimination order of G, and update width/complexity of G as 
+	// Graph::ComputeVariableEliminationOrder_Simple() would; G should be (a copy of) the graph given to Initialize(). 
+	// adjacency and node lists of G are not changed, so afterwards G is good for its order only. returns 0 iff ok.
+	int32_t AppendOrder(Graph & G, const std::vector<int32_t> & Order) ;
+
+	ExactTreewidth(void) ;
+} ;
+
+} // namespace ARE
+
+#endif // ARE_ExactTreewidth_HXX_INCLUDED
@@ -6,6 +6,7 @@
 #include "Utils/Sort.hxx"
 #include "Utils/AVLtreeSimple.hxx"
 #include "Utils/MersenneTwister.h"
+#include "Utils/TaskScheduler.hxx"
 
 #include "Problem.hxx"
 #include "Graph.hxx"
@@ -27,14 +28,54 @@ ARE::Graph::Graph(ARP *Problem, uint32_t RandomGeneratorSeed)
 	_nIgnoreVariables(0), 
 	_OrderLength(0), 
 	_VarElimOrder(NULL), 
+	_VarsToEliminateFirst(NULL), 
+	_nVarsToEliminateFirst(0), 
 	_nTrivialNodes(0), 
 	_TrivialNodesList(NULL), 
 	_nMinFillScore0Nodes(0), 
 	_MinFill0ScoreList(NULL), 
 	_nRemainingNodes(0), 
 	_RemainingNodesList(NULL), 
+	_EdgeU(NULL), 
+	_EdgeV(NULL), 
+	_EdgeBufferSize(0), 
 	_MFShaschanged(NULL), 
 	_MFSchangelist(NULL), 
+	_UseScoreBuckets(true), 
+	_SBCostFunction(-1), 
+	_nSB(0), 
+	_SBMinKey(0), 
+	_SBHead(NULL), 
+	_SBNext(NULL), 
+	_SBPrev(NULL), 
+	_SBKey(NULL), 
+	_JournalSource(NULL), 
+	_JournalDirty(NULL), 
+	_JournalDirtyList(NULL), 
+	_nJournalDirty(0), 
+	_JournalCost(0), 
+	_nJournaledRestores(0), 
+	_nFullRestores(0), 
+	_AdjEngine(0), 
+	_AdjOffset(NULL), 
+	_AdjCapacity(NULL), 
+	_AdjArena(NULL), 
+	_AdjArenaIter(NULL), 
+	_AdjArenaSize(0), 
+	_AdjArenaUsed(0), 
+	_AdjMergeV(NULL), 
+	_AdjMergeIter(NULL), 
+	_AdjMarkIter(NULL), 
+	_BitsetEngineThreshold(0), 
+	_BSBaseEngine(0), 
+	_nBS(0), 
+	_BSnWords(0), 
+	_BSnAllocatedWords(0), 
+	_BSNode(NULL), 
+	_BSRow(NULL), 
+	_BSAdj(NULL), 
+	_BSAdded(NULL), 
+	_BSNX(NULL), 
 	_IsValid(false), 
 	_RNG(RandomGeneratorSeed)
 {
@@ -85,6 +126,38 @@ int32_t ARE::Graph::Destroy(void)
 		delete [] _MFSchangelist ;
 		_MFSchangelist = NULL ;
 		}
+	if (NULL != _SBHead) {
+		delete [] _SBHead ;
+		_SBHead = NULL ;
+		}
+	if (NULL != _SBNext) {
+		delete [] _SBNext ;
+		_SBNext = NULL ;
+		}
+	if (NULL != _SBPrev) {
+		delete [] _SBPrev ;
+		_SBPrev = NULL ;
+		}
+	if (NULL != _SBKey) {
+		delete [] _SBKey ;
+		_SBKey = NULL ;
+		}
+	_nSB = 0 ;
+	_SBMinKey = 0 ;
+	_SBCostFunction = -1 ;
+	if (NULL != _JournalDirty) {
+		delete [] _JournalDirty ;
+		_JournalDirty = NULL ;
+		}
+	if (NULL != _JournalDirtyList) {
+		delete [] _JournalDirtyList ;
+		_JournalDirtyList = NULL ;
+		}
+	_JournalSource = NULL ;
+	_nJournalDirty = 0 ;
+	_JournalCost = 0 ;
+	DestroyAdjacencyBitsets() ;
+	DestroyAdjacencyArrays() ;
 	_nIgnoreVariables = 0 ;
 	_nTrivialNodes = _nMinFillScore0Nodes = _nRemainingNodes = _OrderLength = 0 ;
 	_VarElimOrderWidth = 0 ;
@@ -103,10 +176,72 @@ int32_t ARE::Graph::Destroy(void)
 ARE::Graph::~Graph(void) 
 {
 	Destroy() ;
+	if (NULL != _EdgeU) 
+		delete [] _EdgeU ;
+	if (NULL != _EdgeV) 
+		delete [] _EdgeV ;
+}
+
+
+int32_t ARE::Graph::GrowFillEdgeBuffer(int64_t n, int32_t nKeep)
+{
+	if (n <= _EdgeBufferSize) 
+		return 0 ;
+	int64_t size = (int64_t) _EdgeBufferSize << 1 ;
+	if (size < ARE_GRAPH_FILL_EDGE_BUFFER_INITIAL_SIZE) 
+		size = ARE_GRAPH_FILL_EDGE_BUFFER_INITIAL_SIZE ;
+	if (size < n) 
+		size = n ;
+	if (size > INT_MAX) {
+		size = INT_MAX ;
+		if (size < n) 
+			return 1 ;
+		}
+	int32_t *U = new int32_t[size] ;
+	int32_t *V = new int32_t[size] ;
+	if (NULL == U || NULL == V) {
+		if (NULL != U) delete [] U ;
+		if (NULL != V) delete [] V ;
+		return 1 ;
+		}
+	for (int32_t i = 0 ; i < nKeep ; i++) 
+		{ U[i] = _EdgeU[i] ; V[i] = _EdgeV[i] ; }
+	if (NULL != _EdgeU) 
+		delete [] _EdgeU ;
+	if (NULL != _EdgeV) 
+		delete [] _EdgeV ;
+	_EdgeU = U ;
+	_EdgeV = V ;
+	_EdgeBufferSize = (int32_t) size ;
+	return 0 ;
 }
 
 
-int32_t ARE::Graph::Create(ARP & Problem) 
+int64_t ARE::Graph::MemoryUsage(void) const
+{
+	int64_t n = sizeof(Graph) ;
+	if (NULL != _Nodes) 
+		// _Nodes, 10 int32_t arrays (node lists, order, MFS change list, score buckets, journal) and 3 char arrays.
+		n += (int64_t) _nNodes * (sizeof(Node) + 10 * sizeof(int32_t) + 3 * sizeof(char)) ;
+	if (NULL != _SBHead) 
+		n += (int64_t) _nSB * sizeof(int32_t) ;
+	if (NULL != _StaticAdjVarTotalList) 
+		n += 2 * (int64_t) _nEdges * sizeof(AdjVar) ;
+	if (NULL != _AdjOffset) 
+		n += 5 * (int64_t) _nNodes * sizeof(int32_t) ;
+	n += 2 * (int64_t) _AdjArenaSize * sizeof(int32_t) ;
+	if (NULL != _BSRow) 
+		n += 2 * (int64_t) _nNodes * sizeof(int32_t) + (int64_t) ((_nNodes + 63) >> 6) * sizeof(uint64_t) ;
+	n += 2 * _BSnAllocatedWords * sizeof(uint64_t) ;
+	n += 2 * (int64_t) _EdgeBufferSize * sizeof(int32_t) ;
+	return n ;
+}
+
+
+// number of nodes per chunk of work, when the work for each node is done in parallel by Create().
+#define ARE_GRAPH_CREATE_CHUNK_SIZE 1024
+
+int32_t ARE::Graph::Create(ARP & Problem, int32_t nThreads) 
 {
 	Destroy() ;
 
@@ -131,9 +266,21 @@ int32_t ARE::Graph::Create(ARP & Problem)
 	_RemainingNodesList = new int32_t[_nNodes] ;
 	_MFShaschanged = new char[_nNodes] ;
 	_MFSchangelist = new int32_t[_nNodes] ;
-	if (NULL == _Nodes || NULL == _VarType || NULL == _PosOfVarInList || NULL == _VarElimOrder || NULL == _TrivialNodesList || NULL == _MinFill0ScoreList || NULL == _RemainingNodesList || NULL == _MFShaschanged || NULL == _MFSchangelist) { Destroy() ; return 1 ; }
-
-	int32_t i, j, k, l ;
+	_SBNext = new int32_t[_nNodes] ;
+	_SBPrev = new int32_t[_nNodes] ;
+	_SBKey = new int32_t[_nNodes] ;
+	_JournalDirty = new char[_nNodes] ;
+	_JournalDirtyList = new int32_t[_nNodes] ;
+	if (NULL == _Nodes || NULL == _VarType || NULL == _PosOfVarInList || NULL == _VarElimOrder || NULL == _TrivialNodesList || NULL == _MinFill0ScoreList || NULL == _RemainingNodesList || NULL == _MFShaschanged || NULL == _MFSchangelist || NULL == _SBNext || NULL == _SBPrev || NULL == _SBKey || NULL == _JournalDirty || NULL == _JournalDirtyList) { Destroy() ; return 1 ; }
+	for (int32_t ii = 0 ; ii < _nNodes ; ii++) 
+		{ _SBKey[ii] = -1 ; _JournalDirty[ii] = 0 ; }
+
+	int32_t i, res ;
+	if (nThreads < 1) 
+		nThreads = 1 ;
+	int64_t nChunks = (_nNodes + ARE_GRAPH_CREATE_CHUNK_SIZE - 1) / ARE_GRAPH_CREATE_CHUNK_SIZE ;
+	int64_t *adjStart = NULL ; // for each node, index of its first AdjVar in _StaticAdjVarTotalList
+	int32_t *chunkCounts = NULL ; // for each chunk, number of trivial/MinFillScore=0/remaining nodes
 
 	// *************************************************************************************************
 	// calculate degree of each node/variable
@@ -141,8 +288,10 @@ int32_t ARE::Graph::Create(ARP & Problem)
 
 	_nTrivialNodes = _nMinFillScore0Nodes = _nRemainingNodes = _OrderLength = 0 ;
 	int32_t maxDegree = -1 ;
-	AdjVar *nextAdjVar ;
+	adjStart = new int64_t[_nNodes] ;
+	if (NULL == adjStart) { Destroy() ; return 1 ; }
 	for (i = 0 ; i < _nNodes ; i++) {
+		adjStart[i] = _nEdges ;
 		int32_t domain_size = _Problem->K(i) ;
 		_Nodes[i]._Degree = _Problem->Degree(i) ;
 		_Nodes[i]._LogK = domain_size > 1 ? log10((double) domain_size) : 0.0 ;
@@ -160,6 +309,7 @@ int32_t ARE::Graph::Create(ARP & Problem)
 			_PosOfVarInList[i] = _nTrivialNodes ;
 			_TrivialNodesList[_nTrivialNodes++] = i ;
 			}
+		delete [] adjStart ;
 		goto done ;
 		}
 
@@ -168,17 +318,29 @@ int32_t ARE::Graph::Create(ARP & Problem)
 	// *************************************************************************************************
 
 	_StaticAdjVarTotalList = new AdjVar[_nEdges] ;
-	if (NULL == _StaticAdjVarTotalList) { Destroy() ; return 1 ; }
+	if (NULL == _StaticAdjVarTotalList) { delete [] adjStart ; Destroy() ; return 1 ; }
 	_nEdges >>= 1 ; // actual number of edges is half of what _nEdges is now, since we have double-counted them
-	nextAdjVar = _StaticAdjVarTotalList ;
-	// fill in adjacency list for each node/variable
+	// fill in adjacency list for each node/variable; AdjVars of node i are at adjStart[i], so nodes can be done in any order.
 	{
-	int32_t *keys = new int32_t[maxDegree] ;
-	AdjVar **data = new AdjVar*[maxDegree] ;
-	for (i = 0 ; i < _nNodes ; i++) {
+	int32_t *keys = new int32_t[(int64_t) nThreads * maxDegree] ;
+	AdjVar **data = new AdjVar*[(int64_t) nThreads * maxDegree] ;
+	if (NULL == keys || NULL == data) {
+		if (NULL != keys) delete [] keys ;
+		if (NULL != data) delete [] data ;
+		delete [] adjStart ;
+		Destroy() ;
+		return 1 ;
+		}
+	res = ARE::utils::ParallelFor(nThreads, _nNodes, ARE_GRAPH_CREATE_CHUNK_SIZE, [&](int32_t ThreadIdx, int64_t Begin, int64_t End)
+	{
+	int32_t *thread_keys = keys + (int64_t) ThreadIdx * maxDegree ;
+	AdjVar **thread_data = data + (int64_t) ThreadIdx * maxDegree ;
+	for (int32_t i = (int32_t) Begin ; i < End ; i++) {
 		if (_Nodes[i]._Degree < 1) continue ;
 		// generate adj variable list for i
+		AdjVar *nextAdjVar = _StaticAdjVarTotalList + adjStart[i] ;
 		AdjVar *lastAdjVar = NULL ;
+		int32_t j ;
 		for (j = 0 ; j < _Problem->Degree(i) ; j++) {
 			AdjVar *av = nextAdjVar++ ;
 			if (NULL == lastAdjVar) 
@@ -188,35 +350,43 @@ int32_t ARE::Graph::Create(ARP & Problem)
 			lastAdjVar = av ;
 			av->_V = _Problem->AdjVar(i, j) ;
 			}
-		// sort the list of neighbors
-		if (_Nodes[i]._Degree > 1) {
+		// sort the list of neighbors, unless the problem gave it sorted (e.g. a graph loaded from a .gr file)
+		for (j = 1 ; j < _Nodes[i]._Degree && _Problem->AdjVar(i, j-1) < _Problem->AdjVar(i, j) ; j++) ;
+		if (j < _Nodes[i]._Degree) {
 			int32_t left[32], right[32] ;
 			for (lastAdjVar = _Nodes[i]._Neighbors, j = 0 ; NULL != lastAdjVar ; lastAdjVar = lastAdjVar->_NextAdjVar, j++) {
-				keys[j] = lastAdjVar->_V ;
-				data[j] = lastAdjVar ;
+				thread_keys[j] = lastAdjVar->_V ;
+				thread_data[j] = lastAdjVar ;
 				}
 //#if defined x64 || _M_X64 || _WIN64 || WIN64
-			QuickSortLong_i64(keys, _Nodes[i]._Degree, (int64_t *) data, left, right) ;
+			QuickSortLong_i64(thread_keys, _Nodes[i]._Degree, (int64_t *) thread_data, left, right) ;
 //#else
-//			QuickSortLong(keys, _Nodes[i]._Degree, (int32_t *) data, left, right) ;
+//			QuickSortLong(thread_keys, _Nodes[i]._Degree, (int32_t *) thread_data, left, right) ;
 //#endif // x64
-			_Nodes[i]._Neighbors = lastAdjVar = data[0] ;
+			_Nodes[i]._Neighbors = lastAdjVar = thread_data[0] ;
 			for (j = 1 ; j < _Nodes[i]._Degree ; j++) {
-				lastAdjVar->_NextAdjVar = data[j] ;
+				lastAdjVar->_NextAdjVar = thread_data[j] ;
 				lastAdjVar = lastAdjVar->_NextAdjVar ;
 				}
 			lastAdjVar->_NextAdjVar = NULL ;
 			}
 		}
-	if (NULL != keys) delete [] keys ;
-	if (NULL != data) delete [] data ;
+	}) ;
+	delete [] keys ;
+	delete [] data ;
+	delete [] adjStart ;
+	adjStart = NULL ;
+	// a chunk that failed (e.g. out of memory) left its nodes without neighbors.
+	if (0 != res) { Destroy() ; return 1 ; }
 	}
 
 	// *************************************************************************************************
-	// compute min-fill score for all nodes
+	// compute min-fill score for all nodes; each node only reads neighbor lists and writes its own scores.
 	// *************************************************************************************************
 
-	for (i = 0 ; i < _nNodes ; i++) {
+	res = ARE::utils::ParallelFor(nThreads, _nNodes, ARE_GRAPH_CREATE_CHUNK_SIZE, [&](int32_t /* ThreadIdx */, int64_t Begin, int64_t End)
+	{
+	for (int32_t i = (int32_t) Begin ; i < End ; i++) {
 		_Nodes[i]._MinFillScore = 0 ;
 		AdjVar *av ;
 		for (av = _Nodes[i]._Neighbors ; NULL != av ; av = av->_NextAdjVar) {
@@ -283,28 +453,51 @@ move_on :
 			}
 */
 		}
+	}) ;
+	if (0 != res) { Destroy() ; return 1 ; }
 // DEBUGGG
 //	printf("\nMinFill/Elimination scores computed for all variables ...") ;
 
 	// split nodes into : trivial, MinFillScore=0, RemainingNodes, mutually exclusive lists.
-	for (i = 0 ; i < _nNodes ; i++) {
-		if (_Nodes[i]._Degree <= 1) {
-			_VarType[i] = 1 ;
-			_PosOfVarInList[i] = _nTrivialNodes ;
-			_TrivialNodesList[_nTrivialNodes++] = i ;
-			continue ;
-			}
-		else if (0 == _Nodes[i]._MinFillScore) {
-			_VarType[i] = 2 ;
-			_PosOfVarInList[i] = _nMinFillScore0Nodes ;
-			_MinFill0ScoreList[_nMinFillScore0Nodes++] = i ;
-			}
-		else {
-			_VarType[i] = 3 ;
-			_PosOfVarInList[i] = _nRemainingNodes ;
-			_RemainingNodesList[_nRemainingNodes++] = i ;
-			}
+	// first count nodes of each type in each chunk, then each chunk fills its part of the lists, so that lists are in node order.
+	chunkCounts = new int32_t[3 * nChunks] ;
+	if (NULL == chunkCounts) { Destroy() ; return 1 ; }
+	res = ARE::utils::ParallelFor(nThreads, _nNodes, ARE_GRAPH_CREATE_CHUNK_SIZE, [&](int32_t /* ThreadIdx */, int64_t Begin, int64_t End)
+	{
+	int32_t *counts = chunkCounts + 3 * (Begin / ARE_GRAPH_CREATE_CHUNK_SIZE) ;
+	counts[0] = counts[1] = counts[2] = 0 ;
+	for (int32_t i = (int32_t) Begin ; i < End ; i++) {
+		if (_Nodes[i]._Degree <= 1) 
+			{ _VarType[i] = 1 ; counts[0]++ ; }
+		else if (0 == _Nodes[i]._MinFillScore) 
+			{ _VarType[i] = 2 ; counts[1]++ ; }
+		else 
+			{ _VarType[i] = 3 ; counts[2]++ ; }
+		}
+	}) ;
+	if (0 != res) { delete [] chunkCounts ; Destroy() ; return 1 ; }
+	// turn counts into positions of the first node of each chunk in each list
+	for (int64_t c = 0 ; c < nChunks ; c++) {
+		int32_t *counts = chunkCounts + 3 * c ;
+		int32_t n0 = counts[0], n1 = counts[1], n2 = counts[2] ;
+		counts[0] = _nTrivialNodes ; _nTrivialNodes += n0 ;
+		counts[1] = _nMinFillScore0Nodes ; _nMinFillScore0Nodes += n1 ;
+		counts[2] = _nRemainingNodes ; _nRemainingNodes += n2 ;
 		}
+	res = ARE::utils::ParallelFor(nThreads, _nNodes, ARE_GRAPH_CREATE_CHUNK_SIZE, [&](int32_t /* ThreadIdx */, int64_t Begin, int64_t End)
+	{
+	int32_t *pos = chunkCounts + 3 * (Begin / ARE_GRAPH_CREATE_CHUNK_SIZE) ;
+	for (int32_t i = (int32_t) Begin ; i < End ; i++) {
+		if (1 == _VarType[i]) 
+			{ _PosOfVarInList[i] = pos[0] ; _TrivialNodesList[pos[0]++] = i ; }
+		else if (2 == _VarType[i]) 
+			{ _PosOfVarInList[i] = pos[1] ; _MinFill0ScoreList[pos[1]++] = i ; }
+		else 
+			{ _PosOfVarInList[i] = pos[2] ; _RemainingNodesList[pos[2]++] = i ; }
+		}
+	}) ;
+	delete [] chunkCounts ;
+	if (0 != res) { Destroy() ; return 1 ; }
 
 /*
 	// fill in order computation heap
@@ -332,6 +525,14 @@ done :
 
 int32_t ARE::Graph::ReAllocateEdges(void)
 {
+	if (2 == _AdjEngine && 0 != SetAdjacencyEngine(_BSBaseEngine)) 
+		return 1 ;
+	if (1 == _AdjEngine) 
+		return ReAllocateAdjacencyArrays() ;
+
+	InvalidateJournal() ;
+	InvalidateScoreBuckets() ;
+
 	int32_t n = 0, i ;
 	for (i = 0 ; i < _nNodes ; i++) 
 		n += _Nodes[i]._Degree ;
@@ -370,6 +571,13 @@ int32_t ARE::Graph::ReAllocateEdges(void)
 
 int32_t ARE::Graph::ReAllocateEdges(int32_t NewNumEdges)
 {
+	// the caller will work with AdjVar objects.
+	if (0 != SetAdjacencyEngine(0)) 
+		return 1 ;
+
+	InvalidateJournal() ;
+	InvalidateScoreBuckets() ;
+
 	int32_t n = 0, i ;
 	for (i = 0 ; i < _nNodes ; i++) 
 		n += _Nodes[i]._Degree ;
@@ -543,11 +751,41 @@ int32_t ARE::Graph::RemoveEdge(int32_t u, int32_t v, AdjVar * & uv, AdjVar * & v
 }
 
 
+int32_t ARE::Graph::BuildScoreBuckets(char CostFunction)
+{
+	_SBCostFunction = -1 ;
+	if (_nNodes < 1 || NULL == _SBKey) 
+		return 1 ;
+	int32_t i ;
+	for (i = 0 ; i < _nSB ; i++) 
+		_SBHead[i] = -1 ;
+	for (i = 0 ; i < _nNodes ; i++) 
+		_SBKey[i] = -1 ;
+	_SBCostFunction = CostFunction ;
+	_SBMinKey = INT_MAX ;
+	// insert in reverse list order, so that each bucket lists its nodes in _RemainingNodesList order; this is not required, but it is a nice property when debugging.
+	for (i = _nRemainingNodes - 1 ; i >= 0 ; i--) {
+		if (0 != InsertIntoScoreBucket(_RemainingNodesList[i])) 
+			{ _SBCostFunction = -1 ; return 1 ; }
+		}
+	return 0 ;
+}
+
+
 int32_t ARE::Graph::operator=(const Graph & G)
 {
 	int32_t i ;
 
-	if (! _IsValid || _Problem != G._Problem || _nNodes != G._nNodes || _nEdges != G._nEdges) {
+	InvalidateJournal() ;
+
+	// a bitset matrix is built by (and for) an order computation on this graph; it cannot be copied.
+	if (2 == G._AdjEngine) 
+		return 1 ;
+	// drop the bitset matrix; data of the engine used before it is overwritten below.
+	if (2 == _AdjEngine) 
+		_AdjEngine = _BSBaseEngine ;
+
+	if (! _IsValid || _Problem != G._Problem || _nNodes != G._nNodes || _nEdges != G._nEdges || _AdjEngine != G._AdjEngine) {
 		Destroy() ;
 		if (NULL == G._Problem) {
 			_IsValid = true ;
@@ -566,9 +804,16 @@ int32_t ARE::Graph::operator=(const Graph & G)
 			_RemainingNodesList = new int32_t[_nNodes] ;
 			_MFShaschanged = new char[_nNodes] ;
 			_MFSchangelist = new int32_t[_nNodes] ;
-			if (NULL == _Nodes || NULL == _VarType || NULL == _PosOfVarInList || NULL == _VarElimOrder || NULL == _TrivialNodesList || NULL == _MinFill0ScoreList || NULL == _RemainingNodesList || NULL == _MFShaschanged || NULL == _MFSchangelist) { Destroy() ; return 1 ; }
+			_SBNext = new int32_t[_nNodes] ;
+			_SBPrev = new int32_t[_nNodes] ;
+			_SBKey = new int32_t[_nNodes] ;
+			_JournalDirty = new char[_nNodes] ;
+			_JournalDirtyList = new int32_t[_nNodes] ;
+			if (NULL == _Nodes || NULL == _VarType || NULL == _PosOfVarInList || NULL == _VarElimOrder || NULL == _TrivialNodesList || NULL == _MinFill0ScoreList || NULL == _RemainingNodesList || NULL == _MFShaschanged || NULL == _MFSchangelist || NULL == _SBNext || NULL == _SBPrev || NULL == _SBKey || NULL == _JournalDirty || NULL == _JournalDirtyList) { Destroy() ; return 1 ; }
+			for (i = 0 ; i < _nNodes ; i++) 
+				_JournalDirty[i] = 0 ;
 			}
-		if (_nEdges > 0) {
+		if (_nEdges > 0 && 0 == G._AdjEngine) {
 			_StaticAdjVarTotalList = new AdjVar[_nEdges << 1] ;
 			if (NULL == _StaticAdjVarTotalList) { Destroy() ; return 1 ; }
 			}
@@ -582,7 +827,7 @@ int32_t ARE::Graph::operator=(const Graph & G)
 		_Nodes[i]._LogK = G._Nodes[i]._LogK ;
 		_Nodes[i]._MinFillScore = G._Nodes[i]._MinFillScore ;
 		_Nodes[i]._EliminationScore = G._Nodes[i]._EliminationScore ;
-		if (_Nodes[i]._Degree < 1) G._Nodes[i]._Neighbors = NULL ;
+		if (_Nodes[i]._Degree < 1 || 1 == G._AdjEngine) _Nodes[i]._Neighbors = NULL ;
 		else { int32_t offset = G._Nodes[i]._Neighbors - G._StaticAdjVarTotalList ; _Nodes[i]._Neighbors = _StaticAdjVarTotalList + offset ; }
 		}
 
@@ -600,7 +845,11 @@ int32_t ARE::Graph::operator=(const Graph & G)
 		_RemainingNodesList[i] = G._RemainingNodesList[i] ;
 
 	// fix up edges
-	int32_t e = _nEdges << 1 ;
+	if (1 == G._AdjEngine) {
+		if (0 != CopyAdjacencyArrays(G)) 
+			{ Destroy() ; return 1 ; }
+		}
+	int32_t e = 0 == G._AdjEngine ? _nEdges << 1 : 0 ;
 	for (i = 0 ; i < e ; i++) {
 		AdjVar & AV = G._StaticAdjVarTotalList[i] ;
 		AdjVar & av =   _StaticAdjVarTotalList[i] ;
@@ -618,6 +867,11 @@ int32_t ARE::Graph::operator=(const Graph & G)
 	for (i = 0 ; i < _nIgnoreVariables ; i++) 
 		_IgnoreVariables[i] = G._IgnoreVariables[i] ;
 
+	// score buckets are not copied; they are rebuilt when the next ordering computation starts.
+	_UseScoreBuckets = G._UseScoreBuckets ;
+	_BitsetEngineThreshold = G._BitsetEngineThreshold ;
+	InvalidateScoreBuckets() ;
+
 	_VarElimOrderWidth = G._VarElimOrderWidth ;
 	_MaxVarElimComplexity_Log10 = G._MaxVarElimComplexity_Log10 ;
 	_TotalVarElimComplexity_Log10 = G._TotalVarElimComplexity_Log10 ;
@@ -629,43 +883,163 @@ int32_t ARE::Graph::operator=(const Graph & G)
 }
 
 
+int32_t ARE::Graph::RestoreFrom(const Graph & G)
+{
+	int32_t i, u ;
+
+	// drop the bitset matrix; data of the engine used before it was left as it was at the time of the switch, 
+	// and nodes changed since then are in the journal.
+	if (2 == _AdjEngine) 
+		_AdjEngine = _BSBaseEngine ;
+
+	if (&G != _JournalSource || ! _IsValid || _nNodes != G._nNodes || _nEdges != G._nEdges || _AdjEngine != G._AdjEngine) 
+		goto full_copy ;
+
+	// nodes left on _MFSchangelist were changed by an elimination step that did not finish (e.g. ran out of edge space); journal them too.
+	for (i = 0 ; i < _nMFSchanges ; i++) {
+		u = _MFSchangelist[i] ;
+		_MFShaschanged[u] = 0 ;
+		NoteJournalChange(u) ;
+		}
+	_nMFSchanges = 0 ;
+
+	// copying back a journaled node means chasing its adjacency list, which is a few times slower (per element) than the sequential full copy; 
+	// if the run changed a large part of the graph, do the full copy. with sorted arrays, both copies are sequential.
+	if (1 == _AdjEngine) {
+		if (_JournalCost > (int64_t) _nNodes + (int64_t) G._AdjArenaUsed) 
+			goto full_copy ;
+		}
+	else if ((_JournalCost << 2) > (int64_t) _nNodes + 2 * (int64_t) _nEdges) 
+		goto full_copy ;
+
+	for (i = 0 ; i < _nJournalDirty ; i++) {
+		u = _JournalDirtyList[i] ;
+		_JournalDirty[u] = 0 ;
+
+		Node & n = _Nodes[u] ;
+		const Node & N = G._Nodes[u] ;
+		n._Degree = N._Degree ;
+		n._LogK = N._LogK ;
+		n._MinFillScore = N._MinFillScore ;
+		n._EliminationScore = N._EliminationScore ;
+		_VarType[u] = G._VarType[u] ;
+		_PosOfVarInList[u] = G._PosOfVarInList[u] ;
+		// every list slot that was overwritten during the run belonged (in G) to a node in the journal, so this restores all slots within G's list lengths.
+		if (3 == _VarType[u]) 
+			_RemainingNodesList[_PosOfVarInList[u]] = u ;
+		else if (2 == _VarType[u]) 
+			_MinFill0ScoreList[_PosOfVarInList[u]] = u ;
+		else if (1 == _VarType[u]) 
+			_TrivialNodesList[_PosOfVarInList[u]] = u ;
+
+		// neighbor array of u in G is at the same offset in our arena; slots past G._AdjArenaUsed are dropped below.
+		if (1 == _AdjEngine) {
+			_AdjOffset[u] = G._AdjOffset[u] ;
+			_AdjCapacity[u] = G._AdjCapacity[u] ;
+			int32_t *nu = _AdjArena + _AdjOffset[u], *iu = _AdjArenaIter + _AdjOffset[u] ;
+			const int32_t *NU = G._AdjArena + G._AdjOffset[u] ;
+			for (int32_t j = 0 ; j < N._Degree ; j++) 
+				{ nu[j] = NU[j] ; iu[j] = -1 ; }
+			}
+		// AdjVar objects of u in G are at the same offsets in our _StaticAdjVarTotalList.
+		else if (N._Degree < 1) 
+			n._Neighbors = NULL ;
+		else {
+			n._Neighbors = _StaticAdjVarTotalList + (N._Neighbors - G._StaticAdjVarTotalList) ;
+			for (const AdjVar *AV = N._Neighbors ; NULL != AV ; AV = AV->_NextAdjVar) {
+				AdjVar & av = _StaticAdjVarTotalList[AV - G._StaticAdjVarTotalList] ;
+				av._V = AV->_V ;
+				av._IterationEdgeAdded = -1 ;
+				av._NextAdjVar = NULL == AV->_NextAdjVar ? NULL : _StaticAdjVarTotalList + (AV->_NextAdjVar - G._StaticAdjVarTotalList) ;
+				}
+			}
+		}
+	_nJournalDirty = 0 ;
+	_JournalCost = 0 ;
+	_AdjArenaUsed = G._AdjArenaUsed ;
+
+	_OrderLength = G._OrderLength ;
+	_nTrivialNodes = G._nTrivialNodes ;
+	_nMinFillScore0Nodes = G._nMinFillScore0Nodes ;
+	_nRemainingNodes = G._nRemainingNodes ;
+	_nIgnoreVariables = G._nIgnoreVariables ;
+	for (i = 0 ; i < _nIgnoreVariables ; i++) 
+		_IgnoreVariables[i] = G._IgnoreVariables[i] ;
+	_VarElimOrderWidth = G._VarElimOrderWidth ;
+	_MaxVarElimComplexity_Log10 = G._MaxVarElimComplexity_Log10 ;
+	_TotalVarElimComplexity_Log10 = G._TotalVarElimComplexity_Log10 ;
+	_TotalNewFunctionStorageAsNumOfElements_Log10 = G._TotalNewFunctionStorageAsNumOfElements_Log10 ;
+	_nFillEdges = G._nFillEdges ;
+
+	// score buckets are rebuilt by the next ordering computation; this is cheap, and keeps nodes in each bucket in list order, which makes picking faster.
+	InvalidateScoreBuckets() ;
+	++_nJournaledRestores ;
+	return 0 ;
+
+full_copy :
+	++_nFullRestores ;
+	if (0 != operator=(G)) 
+		return 1 ;
+	if (NULL != _JournalDirty && NULL != _JournalDirtyList) 
+		_JournalSource = &G ;
+	return 0 ;
+}
+
+
 int32_t ARE::Graph::Test(int32_t MaxWidthAcceptableForSingleVariableElimination)
 {
 	int32_t i, j, k, m, n, u, v, ret = 0 ;
-	AdjVar *av ;
 
 	if (MaxWidthAcceptableForSingleVariableElimination < 1) 
 		MaxWidthAcceptableForSingleVariableElimination = 1 ;
 	else if (MaxWidthAcceptableForSingleVariableElimination > MAX_DEGREE_OF_GRAPH_NODE) 
 		MaxWidthAcceptableForSingleVariableElimination = MAX_DEGREE_OF_GRAPH_NODE ;
 
+	// adjacency is checked through CopyNeighbors()/AreAdjacent(), so that this works with either adjacency engine.
+	int32_t *neighbors = new int32_t[_nNodes > 0 ? _nNodes : 1] ;
+	if (NULL == neighbors) 
+		return 1 ;
+
+	// TEST that neighbor arrays are within the arena
+	if (1 == _AdjEngine) {
+		for (i = 0 ; i < _nNodes ; i++) {
+			if (_Nodes[i]._Degree < 1) 
+				continue ;
+			if (_Nodes[i]._Degree > _AdjCapacity[i] || _AdjOffset[i] < 0 || _AdjOffset[i] + _AdjCapacity[i] > _AdjArenaUsed) 
+				{ printf("\nMinFill Test FAIL : var=%d, degree=%d, neighbor array offset=%d capacity=%d, arena used=%d ...", (int32_t) i, (int32_t) _Nodes[i]._Degree, (int32_t) _AdjOffset[i], (int32_t) _AdjCapacity[i], (int32_t) _AdjArenaUsed) ; ret++ ; }
+			}
+		if (ret > 0) 
+			{ delete [] neighbors ; return ret ; }
+		}
+
 	// TEST that degree is correct
 	for (i = 0 ; i < _nNodes ; i++) {
 		int32_t last_v = -1 ;
-		for (j = 0, av = _Nodes[i]._Neighbors ; NULL != av ; av = av->_NextAdjVar, j++) {
-			if (av->_V < 0 || av->_V >= _nNodes) 
-				{ printf("\nMinFill Test FAIL : var=%d, has a bad neighbor %d ...", (int32_t) i, (int32_t) av->_V) ; ret++ ; }
-			if (last_v >= av->_V) 
-				{ printf("\nMinFill Test FAIL : var=%d, has unsorted neighbor list %d, %d ...", (int32_t) i, (int32_t) last_v, (int32_t) av->_V) ; ret++ ; }
-			if (av->_V == i) 
+		j = CopyNeighbors(i, neighbors, _nNodes) ;
+		for (k = 0 ; k < j && k < _nNodes ; k++) {
+			v = neighbors[k] ;
+			if (v < 0 || v >= _nNodes) 
+				{ printf("\nMinFill Test FAIL : var=%d, has a bad neighbor %d ...", (int32_t) i, (int32_t) v) ; ret++ ; }
+			if (last_v >= v) 
+				{ printf("\nMinFill Test FAIL : var=%d, has unsorted neighbor list %d, %d ...", (int32_t) i, (int32_t) last_v, (int32_t) v) ; ret++ ; }
+			if (v == i) 
 				{ printf("\nMinFill Test FAIL : var=%d, has an edge that goes to itself ...", (int32_t) i) ; ret++ ; }
-			last_v = av->_V ;
+			last_v = v ;
 			}
 		if (j != _Nodes[i]._Degree) 
 			{ printf("\nMinFill Test FAIL : var=%d, degree=%d, but actual=%d ...", (int32_t) i, (int32_t) _Nodes[i]._Degree, (int32_t) j) ; ret++ ; }
 		}
+	// the checks below assume neighbor lists are sane.
+	if (ret > 0) 
+		{ delete [] neighbors ; return ret ; }
 
 	// TEST that edges are mutual (u,v) -> (v,u)
-	AdjVar *av_u ;
 	for (i = 0 ; i < _nNodes ; i++) {
-		for (av = _Nodes[i]._Neighbors ; NULL != av ; av = av->_NextAdjVar) {
-			u = av->_V ;
+		j = CopyNeighbors(i, neighbors, _nNodes) ;
+		for (k = 0 ; k < j ; k++) {
+			u = neighbors[k] ;
 			// check that u has an edge pointing to i
-			for (av_u = _Nodes[u]._Neighbors ; NULL != av_u ; av_u = av_u->_NextAdjVar) {
-				if (i == av_u->_V) 
-					break ;
-				}
-			if (NULL == av_u) 
+			if (! AreAdjacent(u, i)) 
 				{ printf("\nMinFill Test FAIL : var=%d, is adj to %d, but %d is not adj to %d ...", (int32_t) i, (int32_t) u, (int32_t) u, (int32_t) i) ; ret++ ; }
 			}
 		}
@@ -732,6 +1106,28 @@ int32_t ARE::Graph::Test(int32_t MaxWidthAcceptableForSingleVariableElimination)
 			{ printf("\nMinFill Test FAIL : _VarElimOrder[%d]=%d", i, _VarElimOrder[i]) ; ret++ ; }
 		}
 
+	// TEST that score buckets hold exactly the general nodes, each in the bucket of its current score
+	if (_SBCostFunction >= 0) {
+		int32_t nInBuckets = 0 ;
+		for (j = 0 ; j < _nSB ; j++) {
+			int32_t prev = -1 ;
+			for (u = _SBHead[j] ; u >= 0 ; u = _SBNext[u]) {
+				++nInBuckets ;
+				if (3 != _VarType[u]) 
+					{ printf("\nMinFill Test FAIL : var=%d, is in score bucket %d, but type=%d ...", (int32_t) u, (int32_t) j, (int32_t) _VarType[u]) ; ret++ ; }
+				if (_SBKey[u] != j || ComputeScoreBucketKey(u) != j) 
+					{ printf("\nMinFill Test FAIL : var=%d, is in score bucket %d, but key=%d score key=%d ...", (int32_t) u, (int32_t) j, (int32_t) _SBKey[u], (int32_t) ComputeScoreBucketKey(u)) ; ret++ ; }
+				if (_SBPrev[u] != prev) 
+					{ printf("\nMinFill Test FAIL : var=%d, score bucket %d prev link broken ...", (int32_t) u, (int32_t) j) ; ret++ ; }
+				if (j < _SBMinKey) 
+					{ printf("\nMinFill Test FAIL : score bucket %d is not empty, but min key is %d ...", (int32_t) j, (int32_t) _SBMinKey) ; ret++ ; }
+				prev = u ;
+				}
+			}
+		if (nInBuckets != _nRemainingNodes) 
+			{ printf("\nMinFill Test FAIL : %d nodes in score buckets, but _nRemainingNodes=%d ...", (int32_t) nInBuckets, (int32_t) _nRemainingNodes) ; ret++ ; }
+		}
+
 	// TEST that graph ElimComplexity of each node is accurate
 	if (NULL != _Problem) {
 		for (i = 0 ; i < _nNodes ; i++) {
@@ -754,17 +1150,14 @@ int32_t ARE::Graph::Test(int32_t MaxWidthAcceptableForSingleVariableElimination)
 	// TEST that graph MinFill scores are accurate
 	for (i = 0 ; i < _nNodes ; i++) {
 		int32_t score = 0 ;
-		for (AdjVar *av_u = _Nodes[i]._Neighbors ; NULL != av_u ; av_u = av_u->_NextAdjVar) {
-			u = av_u->_V ;
-			for (AdjVar *av_v = _Nodes[i]._Neighbors ; NULL != av_v ; av_v = av_v->_NextAdjVar) {
-				v = av_v->_V ;
+		j = CopyNeighbors(i, neighbors, _nNodes) ;
+		for (k = 0 ; k < j ; k++) {
+			u = neighbors[k] ;
+			for (m = 0 ; m < j ; m++) {
+				v = neighbors[m] ;
 				if (u == v) continue ;
 				// check if u and v are adjacent
-				for (av = _Nodes[u]._Neighbors ; NULL != av ; av = av->_NextAdjVar) {
-					if (av->_V == v) 
-						break ;
-					}
-				if (NULL == av) 
+				if (! AreAdjacent(u, v)) 
 					score++ ;
 				}
 			}
@@ -773,6 +1166,7 @@ int32_t ARE::Graph::Test(int32_t MaxWidthAcceptableForSingleVariableElimination)
 			{ printf("\nMinFill Test FAIL : var=%d, is considered, but MinFillScore=%d is not accurate; real score=%d ...", (int32_t) i, (int32_t) _Nodes[i]._MinFillScore, (int32_t) score) ; ret++ ; }
 		}
 
+	delete [] neighbors ;
 	return ret ;
 
 /*
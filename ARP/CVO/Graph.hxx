@@ -13,7 +13,8 @@
 
 #include "Problem/Problem.hxx"
 
-#define ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED 100000
+#define ARE_GRAPH_FILL_EDGE_BUFFER_INITIAL_SIZE 4096
+#define ARE_GRAPH_MAX_SCORE_BUCKET 16777215
 
 namespace ARE
 {
@@ -60,6 +61,7 @@ public :
 	// and we want to consolidate/cleanup the edge set.
 	// note that NewNumEdges may be larger than current number of edges.
 	int32_t ReAllocateEdges(int32_t NewNumEdges) ;
+	// AddEdge()/RemoveEdge() work on AdjVar lists; they require _AdjEngine=0.
 	// this function adds an edge (both ways) between two variables, using the provided AdjVar objects; if uv/vu data member _V is -1, then this obj was not used (probably because already adjacent before).
 	int32_t AddEdge(int32_t u, int32_t v, AdjVar & uv, AdjVar & vu) ;
 	// this function adds an edge u->v, using the provided AdjVar object
@@ -75,7 +77,15 @@ public :
 public :
 	inline double ComputeEliminationComplexity(int32_t v) 
 	{
+		if (2 == _AdjEngine) 
+			return ComputeEliminationComplexity_Bitsets(v) ;
 		double score = _Nodes[v]._LogK ;
+		if (1 == _AdjEngine) {
+			const int32_t *nv = _AdjArena + _AdjOffset[v] ;
+			for (int32_t iii = 0 ; iii < _Nodes[v]._Degree ; iii++) 
+				score += _Nodes[nv[iii]]._LogK ;
+			return score ;
+			}
 		for (AdjVar *av = _Nodes[v]._Neighbors ; NULL != av ; av = av->_NextAdjVar) 
 			score += _Nodes[av->_V]._LogK ;
 		return score ;
@@ -169,6 +179,9 @@ public :
 	// list of ordered variables; in elimination order.
 	int32_t _OrderLength ;
 	int32_t *_VarElimOrder ;
+	// vars ComputeVariableEliminationOrder_Simple() eliminates first, in this order, before picking any (see EliminateVariables()); not owned, not copied.
+	const int32_t *_VarsToEliminateFirst ;
+	int32_t _nVarsToEliminateFirst ;
 	// temporary space for holding trivial nodes (degree(X) <= 1)
 	int32_t _nTrivialNodes ;
 	int32_t *_TrivialNodesList ;
@@ -182,12 +195,232 @@ public :
 public :
 	// temporary space for storing edges to add during each variable ordering computation iteration.
 	// 2015-12-01 KK : changed _Edge[] element type from short to int, so that more than 32K variables can be used.
-	int32_t _EdgeU[ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED] ;
-	int32_t _EdgeV[ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED] ;
+	// the buffer grows as needed (eliminating a node of degree d may add d(d-1)/2 edges); it is not freed by Destroy()/operator=, 
+	// so a graph that is reused for many runs (e.g. by a worker) allocates it only a few times.
+	int32_t *_EdgeU ;
+	int32_t *_EdgeV ;
+	int32_t _EdgeBufferSize ;
+	// make room for at least n edges, keeping the first nKeep. returns 0 iff ok.
+	int32_t GrowFillEdgeBuffer(int64_t n, int32_t nKeep) ;
+	inline int32_t ReserveFillEdge(int32_t nEdgesAdded)
+	{
+		if (nEdgesAdded < _EdgeBufferSize) 
+			return 0 ;
+		return GrowFillEdgeBuffer((int64_t) nEdgesAdded + 1, nEdgesAdded) ;
+	}
 	// we need to track vars whose MFS changes.
 	char *_MFShaschanged ; // a boolean for each var, whether its MFS has changed of not
 	int32_t *_MFSchangelist ; // a list of vars whose MFS has changed
 	int32_t _nMFSchanges ;
+public :
+	// bucket queue over general (type 3) nodes, keyed by the score of the cost function used by ComputeVariableEliminationOrder_Simple(). 
+	// it lets us fetch the best few candidates for elimination without scanning the whole _RemainingNodesList each iteration.
+	// buckets are doubly-linked lists threaded through _SBNext/_SBPrev; they are (re)built at the start of each ordering computation 
+	// and kept up to date from _MFSchangelist, since all nodes whose score changes during an elimination step are on that list.
+	bool _UseScoreBuckets ; // if false, candidates are found by scanning _RemainingNodesList; kept as a reference implementation.
+	char _SBCostFunction ; // cost function the buckets are keyed on; -1 means buckets are not built/maintained.
+	int32_t _nSB ; // number of allocated buckets
+	int32_t _SBMinKey ; // lower bound on the smallest non-empty bucket
+	int32_t *_SBHead ; // first node in each bucket; -1 if empty
+	int32_t *_SBNext ;
+	int32_t *_SBPrev ;
+	int32_t *_SBKey ; // bucket each node is currently in
+	inline int32_t ComputeScoreBucketKey(int32_t u)
+	{
+		int32_t key ;
+		if (1 == _SBCostFunction) 
+			key = _Nodes[u]._Degree ;
+		else if (2 == _SBCostFunction) 
+			key = _Nodes[u]._EliminationScore > 0.0 ? (_Nodes[u]._EliminationScore < (double) ARE_GRAPH_MAX_SCORE_BUCKET ? (int32_t) _Nodes[u]._EliminationScore : ARE_GRAPH_MAX_SCORE_BUCKET) : 0 ;
+		else 
+			key = _Nodes[u]._MinFillScore ;
+		if (key < 0) 
+			key = 0 ;
+		else if (key > ARE_GRAPH_MAX_SCORE_BUCKET) 
+			// all very large scores share the last bucket; they are rarely picked.
+			key = ARE_GRAPH_MAX_SCORE_BUCKET ;
+		return key ;
+	}
+	inline int32_t InsertIntoScoreBucket(int32_t u)
+	{
+		int32_t key = ComputeScoreBucketKey(u) ;
+		if (key >= _nSB) {
+			int32_t n = _nSB > 0 ? _nSB : 64 ;
+			while (n <= key) n <<= 1 ;
+			if (n > ARE_GRAPH_MAX_SCORE_BUCKET + 1) n = ARE_GRAPH_MAX_SCORE_BUCKET + 1 ;
+			int32_t *newHead = new int32_t[n] ;
+			if (NULL == newHead) 
+				return 1 ;
+			int32_t i ;
+			for (i = 0 ; i < _nSB ; i++) newHead[i] = _SBHead[i] ;
+			for (; i < n ; i++) newHead[i] = -1 ;
+			if (NULL != _SBHead) delete [] _SBHead ;
+			_SBHead = newHead ;
+			_nSB = n ;
+			}
+		_SBKey[u] = key ;
+		_SBPrev[u] = -1 ;
+		_SBNext[u] = _SBHead[key] ;
+		if (_SBHead[key] >= 0) 
+			_SBPrev[_SBHead[key]] = u ;
+		_SBHead[key] = u ;
+		if (key < _SBMinKey) 
+			_SBMinKey = key ;
+		return 0 ;
+	}
+	inline void RemoveFromScoreBucket(int32_t u)
+	{
+		int32_t key = _SBKey[u] ;
+		if (key < 0) 
+			return ;
+		if (_SBPrev[u] >= 0) 
+			_SBNext[_SBPrev[u]] = _SBNext[u] ;
+		else 
+			_SBHead[key] = _SBNext[u] ;
+		if (_SBNext[u] >= 0) 
+			_SBPrev[_SBNext[u]] = _SBPrev[u] ;
+		_SBKey[u] = -1 ;
+	}
+	inline void UpdateScoreBucket(int32_t u)
+	{
+		if (ComputeScoreBucketKey(u) == _SBKey[u]) 
+			return ;
+		RemoveFromScoreBucket(u) ;
+		InsertIntoScoreBucket(u) ;
+	}
+	// build buckets for all general nodes, keyed on the given cost function.
+	int32_t BuildScoreBuckets(char CostFunction) ;
+	// stop maintaining the buckets (e.g. when the cost function is not the one the buckets are keyed on).
+	inline void InvalidateScoreBuckets(void) { _SBCostFunction = -1 ; }
+public :
+	// journal of nodes changed by ComputeVariableEliminationOrder_Simple() since this graph was copied from _JournalSource. 
+	// RestoreFrom() uses it to undo a run by copying back only these nodes (scores, list positions, adjacency lists), instead of the whole graph.
+	// a node is changed only if it is eliminated, if its score changes (then it is on _MFSchangelist) or if it is moved within a list (RemoveVarFromList()); 
+	// AdjVar objects are only modified when they are in the adjacency list of a changed node, or were in the list of an eliminated node.
+	const Graph *_JournalSource ; // graph the journal is relative to; NULL means no journal is kept.
+	char *_JournalDirty ; // for each node, whether it is in _JournalDirtyList[]
+	int32_t *_JournalDirtyList ;
+	int32_t _nJournalDirty ;
+	int64_t _JournalCost ; // number of nodes+AdjVars RestoreFrom() would copy; when larger than the graph, a full copy is done instead.
+	int64_t _nJournaledRestores, _nFullRestores ; // number of RestoreFrom() calls that copied back the journal, and that did a full copy; not changed by operator=
+	inline void NoteJournalChange(int32_t u)
+	{
+		if (NULL == _JournalSource || 0 != _JournalDirty[u]) 
+			return ;
+		_JournalDirty[u] = 1 ;
+		_JournalDirtyList[_nJournalDirty++] = u ;
+		_JournalCost += 1 + _JournalSource->_Nodes[u]._Degree ;
+	}
+	// stop keeping the journal; this must be called by anything that changes the graph, other than ComputeVariableEliminationOrder_Simple().
+	inline void InvalidateJournal(void)
+	{
+		for (int32_t iii = 0 ; iii < _nJournalDirty ; iii++) 
+			_JournalDirty[_JournalDirtyList[iii]] = 0 ;
+		_nJournalDirty = 0 ;
+		_JournalCost = 0 ;
+		_JournalSource = NULL ;
+	}
+	// make this graph equal to G. if this graph was restored from G before, and since then only ComputeVariableEliminationOrder_Simple() was run, 
+	// only the nodes in the journal are copied; otherwise this is the same as operator=. G must not change in between.
+	int32_t RestoreFrom(const Graph & G) ;
+public :
+	// adjacency engine; 0 = linked AdjVar lists (_Nodes[]._Neighbors), 1 = sorted neighbor arrays (below), 2 = bitset matrix (see _BS* below).
+	// with sorted arrays, neighbors of u are _AdjArena[_AdjOffset[u] ... _AdjOffset[u] + _Nodes[u]._Degree), in increasing order, and 
+	// _AdjArenaIter[] is the iteration each edge was added in (same as AdjVar::_IterationEdgeAdded). u owns _AdjCapacity[u] slots starting at _AdjOffset[u]; 
+	// when u outgrows them, it gets a larger slice at the end of the arena, and the old slice is unused until the arena is reallocated.
+	// merges done by the elimination step are then linear scans over these arrays, instead of chasing AdjVar pointers.
+	// only ComputeVariableEliminationOrder_Simple() runs on sorted arrays; other functions that change the graph switch back to AdjVar lists.
+	char _AdjEngine ;
+	int32_t *_AdjOffset ;
+	int32_t *_AdjCapacity ;
+	int32_t *_AdjArena ;
+	int32_t *_AdjArenaIter ;
+	int32_t _AdjArenaSize ; // number of slots allocated in _AdjArena/_AdjArenaIter
+	int32_t _AdjArenaUsed ; // slots [_AdjArenaUsed, _AdjArenaSize) are free
+	int32_t *_AdjMergeV ; // temp space for merging neighbor lists; size _nNodes
+	int32_t *_AdjMergeIter ;
+	int32_t *_AdjMarkIter ; // for each node w, iteration edge (u,w) was added in, if w is adjacent to the node u being processed; INT_MIN otherwise.
+	// number of slots given to a node with the given degree; the slack lets most nodes take a few fill edges without moving.
+	inline int32_t AdjSliceCapacity(int32_t Degree) { return Degree > 0 ? Degree + (Degree >> 1) + 4 : 0 ; }
+	// convert adjacency to the given engine; a no-op if already using it.
+	int32_t SetAdjacencyEngine(char Engine) ;
+	// lay out neighbor arrays of all nodes contiguously in a new arena, with fresh slack; this is the sorted-array counterpart of ReAllocateEdges().
+	int32_t ReAllocateAdjacencyArrays(void) ;
+	// make sure there are at least n free slots at the end of the arena.
+	int32_t ReserveAdjacencyArena(int32_t n) ;
+	// allocate per-node arrays used by the sorted-array engine, if not allocated yet.
+	int32_t AllocateAdjacencyArrays(void) ;
+	// copy sorted arrays from G; used by operator=.
+	int32_t CopyAdjacencyArrays(const Graph & G) ;
+	void DestroyAdjacencyArrays(void) ;
+	// eliminate X (degree>0) from the graph, when using sorted arrays; this is the sorted-array version of the graph update done by ComputeVariableEliminationOrder_Simple(), 
+	// and it does the same score updates, in the same order, so that both engines compute the same orders.
+	int32_t EliminateVariable_SortedArrays(int32_t X, int32_t IterationIdx) ;
+	void AdjustScoresForArcAddition_SortedArrays(int32_t u, int32_t v, int32_t CurrentIteration) ;
+	// engine independent access to adjacency; these are slow with AdjVar lists, and are meant for testing.
+	inline bool AreAdjacent(int32_t u, int32_t v)
+	{
+		if (2 == _AdjEngine) {
+			int32_t ru = _BSRow[u], rv = _BSRow[v] ;
+			if (ru < 0 || rv < 0) 
+				return false ;
+			return 0 != (_BSAdj[(int64_t) ru * _BSnWords + (rv >> 6)] & (((uint64_t) 1) << (rv & 63))) ;
+			}
+		if (1 == _AdjEngine) {
+			const int32_t *nu = _AdjArena + _AdjOffset[u] ;
+			int32_t l = 0, r = _Nodes[u]._Degree ;
+			while (l < r) {
+				int32_t m = (l + r) >> 1 ;
+				if (nu[m] < v) l = m + 1 ; else r = m ;
+				}
+			return l < _Nodes[u]._Degree && v == nu[l] ;
+			}
+		for (AdjVar *av = _Nodes[u]._Neighbors ; NULL != av ; av = av->_NextAdjVar) {
+			if (v == av->_V) 
+				return true ;
+			}
+		return false ;
+	}
+	// copy neighbors of u into Neighbors[] (at most MaxN); return the number of neighbors u has.
+	inline int32_t CopyNeighbors(int32_t u, int32_t *Neighbors, int32_t MaxN)
+	{
+		int32_t n = 0 ;
+		if (2 == _AdjEngine) 
+			return CopyNeighbors_Bitsets(u, Neighbors, MaxN) ;
+		if (1 == _AdjEngine) {
+			const int32_t *nu = _AdjArena + _AdjOffset[u] ;
+			for (; n < _Nodes[u]._Degree ; n++) 
+				{ if (n < MaxN) Neighbors[n] = nu[n] ; }
+			return n ;
+			}
+		for (AdjVar *av = _Nodes[u]._Neighbors ; NULL != av ; av = av->_NextAdjVar, n++) 
+			{ if (n < MaxN) Neighbors[n] = av->_V ; }
+		return n ;
+	}
+public :
+	// bitset adjacency (engine 2). when few nodes are left, the remaining graph is usually dense; ComputeVariableEliminationOrder_Simple() then 
+	// switches to an adjacency matrix over the remaining nodes, where neighbor merges and fill counting are done a word (64 nodes) at a time.
+	// rows are assigned to nodes in increasing order of node index, so that scanning a row visits nodes in the same order as scanning a sorted list.
+	// data of the engine used before the switch (_BSBaseEngine) is left as it was; RestoreFrom()/operator= go back to that engine, 
+	// restoring nodes changed since the switch like any other journaled node.
+	int32_t _BitsetEngineThreshold ; // switch when fewer than this many nodes are left to order; 0 means never.
+	char _BSBaseEngine ;
+	int32_t _nBS ; // number of rows in the matrix
+	int32_t _BSnWords ; // number of 64-bit words per row
+	int64_t _BSnAllocatedWords ; // size of _BSAdj/_BSAdded
+	int32_t *_BSNode ; // node of each row; size _nNodes
+	int32_t *_BSRow ; // row of each node, -1 if the node is not in the matrix; size _nNodes
+	uint64_t *_BSAdj ; // adjacency matrix; _nBS rows of _BSnWords words
+	uint64_t *_BSAdded ; // for each node adjacent to the node being eliminated, edges added to it during this elimination step
+	uint64_t *_BSNX ; // neighbors of the node being eliminated; _BSnWords words
+	// build the matrix over all nodes not ordered yet (and the node being eliminated, if any), and switch to it.
+	int32_t BuildAdjacencyBitsets(void) ;
+	// go back from bitsets to sorted arrays, rebuilt from the matrix.
+	int32_t RebuildAdjacencyArraysFromBitsets(void) ;
+	void DestroyAdjacencyBitsets(void) ;
+	int32_t EliminateVariable_Bitsets(int32_t X) ;
+	double ComputeEliminationComplexity_Bitsets(int32_t v) ;
+	int32_t CopyNeighbors_Bitsets(int32_t u, int32_t *Neighbors, int32_t MaxN) ;
 public :
 	inline bool IsIgnoreVariable(int32_t X)
 	{
@@ -206,21 +439,26 @@ public :
 			if (--_nRemainingNodes != i) {
 				_RemainingNodesList[i] = _RemainingNodesList[_nRemainingNodes] ;
 				_PosOfVarInList[_RemainingNodesList[i]] = i ;
+				NoteJournalChange(_RemainingNodesList[i]) ;
 				}
 			}
 		else if (2 == _VarType[X]) {
 			if (--_nMinFillScore0Nodes != i) {
 				_MinFill0ScoreList[i] = _MinFill0ScoreList[_nMinFillScore0Nodes] ;
 				_PosOfVarInList[_MinFill0ScoreList[i]] = i ;
+				NoteJournalChange(_MinFill0ScoreList[i]) ;
 				}
 			}
 		else if (1 == _VarType[X]) {
 			if (--_nTrivialNodes != i) {
 				_TrivialNodesList[i] = _TrivialNodesList[_nTrivialNodes] ;
 				_PosOfVarInList[_TrivialNodesList[i]] = i ;
+				NoteJournalChange(_TrivialNodesList[i]) ;
 				}
 			}
 		// else X is ordered; we will not remove these variables.
+		if (3 == _VarType[X] && _SBCostFunction >= 0) 
+			RemoveFromScoreBucket(X) ;
 	}
 	inline void ProcessPostEliminationNodeListLocation(int32_t u) 
 	{
@@ -254,6 +492,9 @@ public :
 				_MinFill0ScoreList[_nMinFillScore0Nodes++] = u ;
 				_VarType[u] = 2 ;
 				}
+			// u stays in the general list; its score may have changed, so move it to the right bucket.
+			else if (_SBCostFunction >= 0) 
+				UpdateScoreBucket(u) ;
 			}
 	}
 public :
@@ -281,6 +522,9 @@ public :
 		// temp AdjVar space; size of each block is TempAdjVarSpaceSize.
 		int32_t & TempAdjVarSpaceSizeExtraArrayN, AdjVar *TempAdjVarSpaceSizeExtraArray[]
 		) ;
+	// eliminate Vars, in this order, then all trivial/MinFillScore0 vars, as ComputeVariableEliminationOrder_Simple() with QuitAfterEasyIsDone does. 
+	// this applies reductions that pick vars by rules the ordering computation does not know (see SafeReductions). returns 0 iff ok.
+	int32_t EliminateVariables(const int32_t *Vars, int32_t nVars, int32_t & TempAdjVarSpaceSizeExtraArrayN, AdjVar *TempAdjVarSpaceSizeExtraArray[]) ;
 	int32_t ComputeVariableEliminationOrder_Simple_wMinFillOnly(
 		// width/complexity of the best know order; used to cut off search when the elimination order we found is not very good
 		int32_t WidthLimit, 
@@ -300,13 +544,16 @@ public :
 public :
 	int32_t operator=(const Graph & G) ;
 	int32_t Test(int32_t MaxWidthAcceptableForSingleVariableElimination) ;
+	// number of bytes used by this graph, including the object itself; sizes of AdjVar lists are estimated from _nEdges.
+	int64_t MemoryUsage(void) const ;
 public :
 	Graph(ARP *Problem = NULL, uint32_t RandomGeneratorSeed = 0) ;
 	~Graph(void) ;
 	int32_t Destroy(void) ;
 
-	// create a graph from a problem
-	int32_t Create(ARP & Problem) ;
+	// create a graph from a problem; sorting of neighbor lists, min-fill scores and splitting of nodes into lists are done by nThreads threads. 
+	// the graph does not depend on nThreads.
+	int32_t Create(ARP & Problem, int32_t nThreads = 1) ;
 
 //	// create a graph from the given set of fn signatures. 
 //	// we assume each signature is correct : var indeces range [0, nNodes), there are no repetitions.
@@ -0,0 +1,410 @@
+#include <stdlib.h>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+
+
+void ARE::Graph::DestroyAdjacencyArrays(void)
+{
+	if (NULL != _AdjOffset) {
+		delete [] _AdjOffset ;
+		_AdjOffset = NULL ;
+		}
+	if (NULL != _AdjCapacity) {
+		delete [] _AdjCapacity ;
+		_AdjCapacity = NULL ;
+		}
+	if (NULL != _AdjArena) {
+		delete [] _AdjArena ;
+		_AdjArena = NULL ;
+		}
+	if (NULL != _AdjArenaIter) {
+		delete [] _AdjArenaIter ;
+		_AdjArenaIter = NULL ;
+		}
+	if (NULL != _AdjMergeV) {
+		delete [] _AdjMergeV ;
+		_AdjMergeV = NULL ;
+		}
+	if (NULL != _AdjMergeIter) {
+		delete [] _AdjMergeIter ;
+		_AdjMergeIter = NULL ;
+		}
+	if (NULL != _AdjMarkIter) {
+		delete [] _AdjMarkIter ;
+		_AdjMarkIter = NULL ;
+		}
+	_AdjArenaSize = _AdjArenaUsed = 0 ;
+	_AdjEngine = 0 ;
+}
+
+
+int32_t ARE::Graph::AllocateAdjacencyArrays(void)
+{
+	if (NULL != _AdjOffset) 
+		return 0 ;
+	_AdjOffset = new int32_t[_nNodes] ;
+	_AdjCapacity = new int32_t[_nNodes] ;
+	_AdjMergeV = new int32_t[_nNodes] ;
+	_AdjMergeIter = new int32_t[_nNodes] ;
+	_AdjMarkIter = new int32_t[_nNodes] ;
+	if (NULL == _AdjOffset || NULL == _AdjCapacity || NULL == _AdjMergeV || NULL == _AdjMergeIter || NULL == _AdjMarkIter) 
+		{ DestroyAdjacencyArrays() ; return 1 ; }
+	for (int32_t i = 0 ; i < _nNodes ; i++) 
+		_AdjMarkIter[i] = INT_MIN ;
+	_AdjArenaSize = _AdjArenaUsed = 0 ;
+	return 0 ;
+}
+
+
+int32_t ARE::Graph::ReserveAdjacencyArena(int32_t n)
+{
+	if (_AdjArenaUsed + (int64_t) n <= _AdjArenaSize) 
+		return 0 ;
+	int64_t size = (int64_t) _AdjArenaSize << 1 ;
+	if (size < (int64_t) _AdjArenaUsed + n) 
+		size = (int64_t) _AdjArenaUsed + n ;
+	if (size < 1024) 
+		size = 1024 ;
+	if (size > INT_MAX) {
+		size = INT_MAX ;
+		if (size < (int64_t) _AdjArenaUsed + n) 
+			return 1 ;
+		}
+	int32_t *arena = new int32_t[size] ;
+	int32_t *arenaIter = new int32_t[size] ;
+	if (NULL == arena || NULL == arenaIter) {
+		if (NULL != arena) delete [] arena ;
+		if (NULL != arenaIter) delete [] arenaIter ;
+		return 1 ;
+		}
+	for (int32_t i = 0 ; i < _AdjArenaUsed ; i++) 
+		{ arena[i] = _AdjArena[i] ; arenaIter[i] = _AdjArenaIter[i] ; }
+	if (NULL != _AdjArena) delete [] _AdjArena ;
+	if (NULL != _AdjArenaIter) delete [] _AdjArenaIter ;
+	_AdjArena = arena ;
+	_AdjArenaIter = arenaIter ;
+	_AdjArenaSize = size ;
+	return 0 ;
+}
+
+
+int32_t ARE::Graph::SetAdjacencyEngine(char Engine)
+{
+	int32_t i, j ;
+
+	if (Engine == _AdjEngine) 
+		return 0 ;
+	if (Engine < 0 || Engine > 2) 
+		return 1 ;
+	if (2 == Engine) 
+		return BuildAdjacencyBitsets() ;
+	// from bitsets, go through sorted arrays.
+	if (2 == _AdjEngine) {
+		if (0 != RebuildAdjacencyArraysFromBitsets()) 
+			return 1 ;
+		if (1 == Engine) 
+			return 0 ;
+		}
+
+	InvalidateJournal() ;
+
+	int64_t nSlots = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) 
+		nSlots += 1 == Engine ? AdjSliceCapacity(_Nodes[i]._Degree) : _Nodes[i]._Degree ;
+	if (nSlots > INT_MAX) 
+		return 1 ;
+
+	if (1 == Engine) {
+		if (0 != AllocateAdjacencyArrays()) 
+			return 1 ;
+		// leave some room for nodes that outgrow their slices.
+		if (0 != ReserveAdjacencyArena(nSlots + (nSlots >> 2))) 
+			{ DestroyAdjacencyArrays() ; return 1 ; }
+		for (i = 0 ; i < _nNodes ; i++) {
+			_AdjOffset[i] = _AdjArenaUsed ;
+			_AdjCapacity[i] = AdjSliceCapacity(_Nodes[i]._Degree) ;
+			_AdjArenaUsed += _AdjCapacity[i] ;
+			j = _AdjOffset[i] ;
+			for (AdjVar *av = _Nodes[i]._Neighbors ; NULL != av ; av = av->_NextAdjVar, j++) 
+				{ _AdjArena[j] = av->_V ; _AdjArenaIter[j] = av->_IterationEdgeAdded ; }
+			_Nodes[i]._Neighbors = NULL ;
+			}
+		// AdjVar lists may also use temp AdjVar blocks of the caller; these are not ours to free.
+		if (NULL != _StaticAdjVarTotalList) {
+			delete [] _StaticAdjVarTotalList ;
+			_StaticAdjVarTotalList = NULL ;
+			}
+		_nEdges = 0 ;
+		for (i = 0 ; i < _nNodes ; i++) 
+			_nEdges += _Nodes[i]._Degree ;
+		_nEdges >>= 1 ;
+		_AdjEngine = 1 ;
+		return 0 ;
+		}
+
+	// back to AdjVar lists; lay them out contiguously, as ReAllocateEdges() does.
+	AdjVar *AV = NULL ;
+	if (nSlots > 0) {
+		AV = new AdjVar[nSlots] ;
+		if (NULL == AV) 
+			return 1 ;
+		}
+	AdjVar *AVend = AV ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		_Nodes[i]._Neighbors = NULL ;
+		AdjVar *lastAdjVar = NULL ;
+		const int32_t *ni = _AdjArena + _AdjOffset[i], *ii = _AdjArenaIter + _AdjOffset[i] ;
+		for (j = 0 ; j < _Nodes[i]._Degree ; j++) {
+			AdjVar *av = AVend++ ;
+			av->_V = ni[j] ;
+			av->_IterationEdgeAdded = ii[j] ;
+			if (NULL == lastAdjVar) 
+				_Nodes[i]._Neighbors = av ;
+			else 
+				lastAdjVar->_NextAdjVar = av ;
+			lastAdjVar = av ;
+			}
+		}
+	DestroyAdjacencyArrays() ;
+	if (NULL != _StaticAdjVarTotalList) 
+		delete [] _StaticAdjVarTotalList ;
+	_StaticAdjVarTotalList = AV ;
+	_nEdges = nSlots >> 1 ;
+	return 0 ;
+}
+
+
+int32_t ARE::Graph::ReAllocateAdjacencyArrays(void)
+{
+	int32_t i, j ;
+
+	if (1 != _AdjEngine) 
+		return 1 ;
+
+	InvalidateJournal() ;
+	InvalidateScoreBuckets() ;
+
+	int64_t nSlots = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) 
+		nSlots += AdjSliceCapacity(_Nodes[i]._Degree) ;
+	nSlots += nSlots >> 2 ;
+	if (nSlots < 1024) 
+		nSlots = 1024 ;
+	if (nSlots > INT_MAX) 
+		return 1 ;
+
+	int32_t *arena = new int32_t[nSlots] ;
+	int32_t *arenaIter = new int32_t[nSlots] ;
+	if (NULL == arena || NULL == arenaIter) {
+		if (NULL != arena) delete [] arena ;
+		if (NULL != arenaIter) delete [] arenaIter ;
+		return 1 ;
+		}
+	int32_t used = 0, nEdges = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		const int32_t *ni = _AdjArena + _AdjOffset[i], *ii = _AdjArenaIter + _AdjOffset[i] ;
+		for (j = 0 ; j < _Nodes[i]._Degree ; j++) 
+			{ arena[used + j] = ni[j] ; arenaIter[used + j] = ii[j] ; }
+		_AdjOffset[i] = used ;
+		_AdjCapacity[i] = AdjSliceCapacity(_Nodes[i]._Degree) ;
+		used += _AdjCapacity[i] ;
+		nEdges += _Nodes[i]._Degree ;
+		}
+
+	delete [] _AdjArena ;
+	delete [] _AdjArenaIter ;
+	_AdjArena = arena ;
+	_AdjArenaIter = arenaIter ;
+	_AdjArenaSize = nSlots ;
+	_AdjArenaUsed = used ;
+	_nEdges = nEdges >> 1 ;
+
+	return 0 ;
+}
+
+
+int32_t ARE::Graph::CopyAdjacencyArrays(const Graph & G)
+{
+	int32_t i ;
+
+	if (1 != G._AdjEngine) 
+		return 1 ;
+	if (0 != AllocateAdjacencyArrays()) 
+		return 1 ;
+	// G's arena may have slack at the end; take as much, so that nodes can grow without reallocating the arena right away.
+	_AdjArenaUsed = 0 ;
+	if (0 != ReserveAdjacencyArena(G._AdjArenaSize)) 
+		return 1 ;
+	_AdjEngine = 1 ;
+
+	for (i = 0 ; i < _nNodes ; i++) {
+		_AdjOffset[i] = G._AdjOffset[i] ;
+		_AdjCapacity[i] = G._AdjCapacity[i] ;
+		}
+	_AdjArenaUsed = G._AdjArenaUsed ;
+	for (i = 0 ; i < _AdjArenaUsed ; i++) {
+		_AdjArena[i] = G._AdjArena[i] ;
+		_AdjArenaIter[i] = -1 ;
+		}
+
+	return 0 ;
+}
+
+
+void ARE::Graph::AdjustScoresForArcAddition_SortedArrays(int32_t u, int32_t v, int32_t CurrentIteration)
+{
+	// same as AdjustScoresForArcAddition(), except that neighbors of u are marked in _AdjMarkIter[], so only neighbors of v are scanned; 
+	// common neighbors are still visited in increasing order. u<v always, since edges are recorded that way, and (u,v) is already in the graph.
+	const int32_t *nv = _AdjArena + _AdjOffset[v], *iv = _AdjArenaIter + _AdjOffset[v] ;
+	int32_t dv = _Nodes[v]._Degree ;
+	int32_t j, nCommon = 0 ;
+	for (j = 0 ; j < dv ; j++) {
+		int32_t w = nv[j] ;
+		int32_t iu = _AdjMarkIter[w] ;
+		if (INT_MIN == iu) // w is adjacent to v but not to u
+			continue ;
+		++nCommon ;
+		// common neighbor; if both edges existed before this iteration, subtract 1.
+		if (iu < CurrentIteration && iv[j] < CurrentIteration) {
+			--_Nodes[w]._MinFillScore ;
+			if (0 == _MFShaschanged[w]) 
+				{ _MFShaschanged[w] = 1 ; _MFSchangelist[_nMFSchanges++] = w ; }
+			}
+		}
+	// all other neighbors of u (but v) are not adjacent to v, and vice versa.
+	int32_t nu_only = _Nodes[u]._Degree - 1 - nCommon ;
+	int32_t nv_only = dv - 1 - nCommon ;
+	if (nu_only > 0) {
+		_Nodes[u]._MinFillScore += nu_only ;
+		if (0 == _MFShaschanged[u]) 
+			{ _MFShaschanged[u] = 1 ; _MFSchangelist[_nMFSchanges++] = u ; }
+		}
+	if (nv_only > 0) {
+		_Nodes[v]._MinFillScore += nv_only ;
+		if (0 == _MFShaschanged[v]) 
+			{ _MFShaschanged[v] = 1 ; _MFSchangelist[_nMFSchanges++] = v ; }
+		}
+}
+
+
+int32_t ARE::Graph::EliminateVariable_SortedArrays(int32_t X, int32_t IterationIdx)
+{
+	int32_t i, j, k, n, u, v, w ;
+
+	// for each u adjacent to X, merge N(u) and N(X) into _AdjMerge*, dropping X and adding fill edges (u,w),
+	// then write the result back into the slice of u (moving it to the end of the arena if it does not fit).
+	// see ComputeVariableEliminationOrder_Simple() for how scores change.
+	int32_t nEdgesAdded = 0 ;
+	int32_t dX = _Nodes[X]._Degree ;
+	for (k = 0 ; k < dX ; k++) {
+		// the arena may have moved during the previous step.
+		const int32_t *nX = _AdjArena + _AdjOffset[X] ;
+		u = nX[k] ;
+		_MFShaschanged[u] = 1 ;
+		_MFSchangelist[_nMFSchanges++] = u ;
+		_Nodes[u]._EliminationScore -= _Nodes[X]._LogK ;
+
+		const int32_t *nu = _AdjArena + _AdjOffset[u], *iu = _AdjArenaIter + _AdjOffset[u] ;
+		int32_t du = _Nodes[u]._Degree ;
+		int32_t nLost = 0 ; // neighbors of u, other than X, not adjacent to X
+		i = j = n = 0 ;
+		while (i < du && j < dX) {
+			v = nu[i] ;
+			w = nX[j] ;
+			if (v < w) { // v is adjacent to u but not to X
+				if (X != v) 
+					{ _AdjMergeV[n] = v ; _AdjMergeIter[n++] = iu[i] ; ++nLost ; }
+				++i ;
+				}
+			else if (v > w) { // w is adjacent to X and not to u; add an edge (u,w) 
+				if (u != w) {
+					if (u < w) {
+						if (0 != ReserveFillEdge(nEdgesAdded)) 
+							return ERRORCODE_out_of_memory_CVOedges ;
+						_EdgeU[nEdgesAdded] = u ;
+						_EdgeV[nEdgesAdded] = w ;
+						nEdgesAdded++ ;
+						}
+					_AdjMergeV[n] = w ; _AdjMergeIter[n++] = IterationIdx ;
+					}
+				++j ;
+				}
+			else { // edge (u,v) stays
+				_AdjMergeV[n] = v ; _AdjMergeIter[n++] = iu[i] ;
+				++i ;
+				++j ;
+				}
+			}
+		for (; i < du ; i++) {
+			v = nu[i] ;
+			if (X != v) 
+				{ _AdjMergeV[n] = v ; _AdjMergeIter[n++] = iu[i] ; ++nLost ; }
+			}
+		for (; j < dX ; j++) {
+			w = nX[j] ;
+			if (u == w) 
+				continue ;
+			if (u < w) {
+				if (0 != ReserveFillEdge(nEdgesAdded)) 
+					return ERRORCODE_out_of_memory_CVOedges ;
+				_EdgeU[nEdgesAdded] = u ;
+				_EdgeV[nEdgesAdded] = w ;
+				nEdgesAdded++ ;
+				}
+			_AdjMergeV[n] = w ; _AdjMergeIter[n++] = IterationIdx ;
+			}
+		// (u,X) edge will be gone; u no longer has to connect X with neighbors not adjacent to X.
+		_Nodes[u]._MinFillScore -= nLost ;
+
+		if (n > _AdjCapacity[u]) {
+			int32_t capacity = AdjSliceCapacity(n) ;
+			if (0 != ReserveAdjacencyArena(capacity)) 
+				return ERRORCODE_out_of_memory_CVOadjvarlist ;
+			_AdjOffset[u] = _AdjArenaUsed ;
+			_AdjCapacity[u] = capacity ;
+			_AdjArenaUsed += capacity ;
+			}
+		int32_t *nu_new = _AdjArena + _AdjOffset[u], *iu_new = _AdjArenaIter + _AdjOffset[u] ;
+		for (i = 0 ; i < n ; i++) 
+			{ nu_new[i] = _AdjMergeV[i] ; iu_new[i] = _AdjMergeIter[i] ; }
+		_Nodes[u]._Degree = n ;
+		}
+
+	// add edges between nodes (that used to be) adj to X that don't have them yet. 
+	// edges are grouped by u; mark neighbors of u once for all its edges.
+	for (i = 0 ; i < nEdgesAdded ; i = j) {
+		u = _EdgeU[i] ;
+		const int32_t *nu = _AdjArena + _AdjOffset[u], *iu = _AdjArenaIter + _AdjOffset[u] ;
+		int32_t du = _Nodes[u]._Degree ;
+		for (k = 0 ; k < du ; k++) 
+			_AdjMarkIter[nu[k]] = iu[k] ;
+		for (j = i ; j < nEdgesAdded && u == _EdgeU[j] ; j++) {
+			v = _EdgeV[j] ;
+			AdjustScoresForArcAddition_SortedArrays(u, v, IterationIdx) ;
+			_Nodes[u]._EliminationScore += _Nodes[v]._LogK ;
+			_Nodes[v]._EliminationScore += _Nodes[u]._LogK ;
+			}
+		for (k = 0 ; k < du ; k++) 
+			_AdjMarkIter[nu[k]] = INT_MIN ;
+		}
+	_nFillEdges += nEdgesAdded ;
+
+	// check variables whose MinFillScore changed whether they need to be moved to a different list.
+	for (i = 0 ; i < _nMFSchanges ; i++) {
+		u = _MFSchangelist[i] ;
+		_MFShaschanged[u] = 0 ;
+		NoteJournalChange(u) ;
+		ProcessPostEliminationNodeListLocation(u) ;
+		}
+	_nMFSchanges = 0 ;
+
+	// dump X from the graph; its slice is not reused.
+	_Nodes[X]._Degree = 0 ;
+	_Nodes[X]._EliminationScore = _Nodes[X]._LogK ;
+	_Nodes[X]._MinFillScore = 0 ;
+
+	return 0 ;
+}
@@ -0,0 +1,330 @@
+#include <stdlib.h>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+
+static inline int32_t PopCount64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(w) ;
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL) ;
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL) ;
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL ;
+	return (int32_t) ((w * 0x0101010101010101ULL) >> 56) ;
+#endif
+}
+
+// index of the lowest set bit; w must not be 0.
+static inline int32_t LowestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(w) ;
+#else
+	int32_t i = 0 ;
+	while (0 == (w & 1)) { w >>= 1 ; ++i ; }
+	return i ;
+#endif
+}
+
+
+void ARE::Graph::DestroyAdjacencyBitsets(void)
+{
+	if (NULL != _BSNode) {
+		delete [] _BSNode ;
+		_BSNode = NULL ;
+		}
+	if (NULL != _BSRow) {
+		delete [] _BSRow ;
+		_BSRow = NULL ;
+		}
+	if (NULL != _BSAdj) {
+		delete [] _BSAdj ;
+		_BSAdj = NULL ;
+		}
+	if (NULL != _BSAdded) {
+		delete [] _BSAdded ;
+		_BSAdded = NULL ;
+		}
+	if (NULL != _BSNX) {
+		delete [] _BSNX ;
+		_BSNX = NULL ;
+		}
+	_nBS = _BSnWords = 0 ;
+	_BSnAllocatedWords = 0 ;
+	if (2 == _AdjEngine) 
+		_AdjEngine = _BSBaseEngine ;
+}
+
+
+int32_t ARE::Graph::BuildAdjacencyBitsets(void)
+{
+	int32_t i, j, r ;
+
+	if (2 == _AdjEngine) 
+		return 0 ;
+	if (_nNodes < 1) 
+		return 1 ;
+
+	if (NULL == _BSRow) {
+		_BSRow = new int32_t[_nNodes] ;
+		_BSNode = new int32_t[_nNodes] ;
+		_BSNX = new uint64_t[(_nNodes + 63) >> 6] ;
+		if (NULL == _BSRow || NULL == _BSNode || NULL == _BSNX) 
+			{ DestroyAdjacencyBitsets() ; return 1 ; }
+		}
+
+	// rows in increasing order of node index.
+	_nBS = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		if (0 != _VarType[i] || _Nodes[i]._Degree > 0) 
+			{ _BSRow[i] = _nBS ; _BSNode[_nBS++] = i ; }
+		else 
+			_BSRow[i] = -1 ;
+		}
+	_BSnWords = (_nBS + 63) >> 6 ;
+	if (_BSnWords < 1) 
+		_BSnWords = 1 ;
+	int64_t nWords = (int64_t) _nBS * _BSnWords ;
+	if (nWords > _BSnAllocatedWords) {
+		if (NULL != _BSAdj) delete [] _BSAdj ;
+		if (NULL != _BSAdded) delete [] _BSAdded ;
+		_BSAdj = new uint64_t[nWords] ;
+		_BSAdded = new uint64_t[nWords] ;
+		if (NULL == _BSAdj || NULL == _BSAdded) 
+			{ DestroyAdjacencyBitsets() ; return 1 ; }
+		_BSnAllocatedWords = nWords ;
+		}
+	for (int64_t k = 0 ; k < nWords ; k++) 
+		_BSAdj[k] = 0 ;
+
+	for (r = 0 ; r < _nBS ; r++) {
+		int32_t u = _BSNode[r] ;
+		uint64_t *ru = _BSAdj + (int64_t) r * _BSnWords ;
+		if (1 == _AdjEngine) {
+			const int32_t *nu = _AdjArena + _AdjOffset[u] ;
+			for (j = 0 ; j < _Nodes[u]._Degree ; j++) {
+				int32_t rv = _BSRow[nu[j]] ;
+				ru[rv >> 6] |= ((uint64_t) 1) << (rv & 63) ;
+				}
+			}
+		else {
+			for (AdjVar *av = _Nodes[u]._Neighbors ; NULL != av ; av = av->_NextAdjVar) {
+				int32_t rv = _BSRow[av->_V] ;
+				ru[rv >> 6] |= ((uint64_t) 1) << (rv & 63) ;
+				}
+			}
+		}
+
+	// data of the current engine is left as it is; see RestoreFrom().
+	_BSBaseEngine = _AdjEngine ;
+	_AdjEngine = 2 ;
+	return 0 ;
+}
+
+
+int32_t ARE::Graph::RebuildAdjacencyArraysFromBitsets(void)
+{
+	int32_t i, k, r ;
+
+	if (2 != _AdjEngine) 
+		return 1 ;
+
+	// data of the base engine is stale; rebuilding replaces it, so the journal is no good either.
+	InvalidateJournal() ;
+	if (0 == _BSBaseEngine) {
+		for (i = 0 ; i < _nNodes ; i++) 
+			_Nodes[i]._Neighbors = NULL ;
+		if (NULL != _StaticAdjVarTotalList) {
+			delete [] _StaticAdjVarTotalList ;
+			_StaticAdjVarTotalList = NULL ;
+			}
+		}
+	_AdjEngine = _BSBaseEngine = 1 ;
+	if (0 != AllocateAdjacencyArrays()) 
+		return 1 ;
+
+	int64_t nSlots = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) 
+		nSlots += AdjSliceCapacity(_Nodes[i]._Degree) ;
+	nSlots += nSlots >> 2 ;
+	if (nSlots > INT_MAX) 
+		return 1 ;
+	_AdjArenaUsed = 0 ;
+	if (0 != ReserveAdjacencyArena((int32_t) nSlots)) 
+		return 1 ;
+
+	int32_t nEdges = 0 ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		_AdjOffset[i] = _AdjArenaUsed ;
+		_AdjCapacity[i] = AdjSliceCapacity(_Nodes[i]._Degree) ;
+		_AdjArenaUsed += _AdjCapacity[i] ;
+		nEdges += _Nodes[i]._Degree ;
+		r = _BSRow[i] ;
+		if (r < 0 || _Nodes[i]._Degree < 1) 
+			continue ;
+		int32_t *ni = _AdjArena + _AdjOffset[i], *ii = _AdjArenaIter + _AdjOffset[i], n = 0 ;
+		const uint64_t *ri = _BSAdj + (int64_t) r * _BSnWords ;
+		for (k = 0 ; k < _BSnWords ; k++) {
+			for (uint64_t b = ri[k] ; 0 != b ; b &= b - 1) {
+				// the graph may be inconsistent if an elimination step did not finish; don't write past the slice.
+				if (n < _AdjCapacity[i]) 
+					{ ni[n] = _BSNode[(k << 6) + LowestBit64(b)] ; ii[n] = -1 ; }
+				++n ;
+				}
+			}
+		}
+	_nEdges = nEdges >> 1 ;
+	return 0 ;
+}
+
+
+double ARE::Graph::ComputeEliminationComplexity_Bitsets(int32_t v)
+{
+	double score = _Nodes[v]._LogK ;
+	int32_t r = _BSRow[v] ;
+	if (r < 0) 
+		return score ;
+	const uint64_t *rv = _BSAdj + (int64_t) r * _BSnWords ;
+	for (int32_t k = 0 ; k < _BSnWords ; k++) {
+		for (uint64_t b = rv[k] ; 0 != b ; b &= b - 1) 
+			score += _Nodes[_BSNode[(k << 6) + LowestBit64(b)]]._LogK ;
+		}
+	return score ;
+}
+
+
+int32_t ARE::Graph::CopyNeighbors_Bitsets(int32_t u, int32_t *Neighbors, int32_t MaxN)
+{
+	int32_t n = 0 ;
+	int32_t r = _BSRow[u] ;
+	if (r < 0) 
+		return 0 ;
+	const uint64_t *ru = _BSAdj + (int64_t) r * _BSnWords ;
+	for (int32_t k = 0 ; k < _BSnWords ; k++) {
+		for (uint64_t b = ru[k] ; 0 != b ; b &= b - 1, n++) 
+			{ if (n < MaxN) Neighbors[n] = _BSNode[(k << 6) + LowestBit64(b)] ; }
+		}
+	return n ;
+}
+
+
+int32_t ARE::Graph::EliminateVariable_Bitsets(int32_t X)
+{
+	int32_t i, k, n, u, v, w, r, rv ;
+	const int32_t W = _BSnWords ;
+	const int32_t rX = _BSRow[X] ;
+	if (rX < 0) 
+		return 0 ;
+	const uint64_t bitX = ((uint64_t) 1) << (rX & 63) ;
+
+	// this does the same score updates, in the same order, as EliminateVariable_SortedArrays(); see there.
+	// the matrix does not keep the iteration an edge was added in; edges added in this step are kept in the _BSAdded rows instead.
+	uint64_t *NX = _BSNX ;
+	for (k = 0 ; k < W ; k++) 
+		NX[k] = _BSAdj[(int64_t) rX * W + k] ;
+
+	int32_t nEdgesAdded = 0 ;
+	for (i = 0 ; i < W ; i++) {
+		for (uint64_t bits = NX[i] ; 0 != bits ; bits &= bits - 1) {
+			r = (i << 6) + LowestBit64(bits) ;
+			u = _BSNode[r] ;
+			_MFShaschanged[u] = 1 ;
+			_MFSchangelist[_nMFSchanges++] = u ;
+			_Nodes[u]._EliminationScore -= _Nodes[X]._LogK ;
+
+			uint64_t *ru = _BSAdj + (int64_t) r * W ;
+			uint64_t *au = _BSAdded + (int64_t) r * W ;
+			// neighbors of u not adjacent to X; this counts X too.
+			int32_t nLost = -1 ;
+			for (k = 0 ; k < W ; k++) {
+				nLost += PopCount64(ru[k] & ~NX[k]) ;
+				au[k] = NX[k] & ~ru[k] ;
+				}
+			au[r >> 6] &= ~(((uint64_t) 1) << (r & 63)) ;
+			// (u,X) edge will be gone; u no longer has to connect X with neighbors not adjacent to X.
+			_Nodes[u]._MinFillScore -= nLost ;
+
+			// edges (u,w), for w adjacent to X and not to u; recorded once, when u<w.
+			n = 0 ;
+			for (k = 0 ; k < W ; k++) {
+				uint64_t a = au[k] ;
+				n += PopCount64(a) ;
+				ru[k] |= a ;
+				if (k < (r >> 6)) 
+					continue ;
+				if (k == (r >> 6)) 
+					a &= (r & 63) < 63 ? ~((((uint64_t) 1) << ((r & 63) + 1)) - 1) : 0 ;
+				for (; 0 != a ; a &= a - 1) {
+					if (0 != ReserveFillEdge(nEdgesAdded)) 
+						return ERRORCODE_out_of_memory_CVOedges ;
+					_EdgeU[nEdgesAdded] = u ;
+					_EdgeV[nEdgesAdded] = _BSNode[(k << 6) + LowestBit64(a)] ;
+					nEdgesAdded++ ;
+					}
+				}
+			ru[rX >> 6] &= ~bitX ;
+			_Nodes[u]._Degree += n - 1 ;
+			}
+		}
+
+	// add edges between nodes (that used to be) adj to X that don't have them yet
+	for (i = 0 ; i < nEdgesAdded ; i++) {
+		u = _EdgeU[i] ;
+		v = _EdgeV[i] ;
+		r = _BSRow[u] ;
+		rv = _BSRow[v] ;
+		const uint64_t *ru = _BSAdj + (int64_t) r * W, *au = _BSAdded + (int64_t) r * W ;
+		const uint64_t *rvv = _BSAdj + (int64_t) rv * W, *av = _BSAdded + (int64_t) rv * W ;
+		// common neighbors of u,v; if both edges existed before this step, subtract 1.
+		int32_t nCommon = 0 ;
+		for (k = 0 ; k < W ; k++) {
+			uint64_t c = ru[k] & rvv[k] ;
+			if (0 == c) 
+				continue ;
+			nCommon += PopCount64(c) ;
+			for (c &= ~(au[k] | av[k]) ; 0 != c ; c &= c - 1) {
+				w = _BSNode[(k << 6) + LowestBit64(c)] ;
+				--_Nodes[w]._MinFillScore ;
+				if (0 == _MFShaschanged[w]) 
+					{ _MFShaschanged[w] = 1 ; _MFSchangelist[_nMFSchanges++] = w ; }
+				}
+			}
+		// all other neighbors of u (but v) are not adjacent to v, and vice versa.
+		int32_t nu_only = _Nodes[u]._Degree - 1 - nCommon ;
+		int32_t nv_only = _Nodes[v]._Degree - 1 - nCommon ;
+		if (nu_only > 0) {
+			_Nodes[u]._MinFillScore += nu_only ;
+			if (0 == _MFShaschanged[u]) 
+				{ _MFShaschanged[u] = 1 ; _MFSchangelist[_nMFSchanges++] = u ; }
+			}
+		if (nv_only > 0) {
+			_Nodes[v]._MinFillScore += nv_only ;
+			if (0 == _MFShaschanged[v]) 
+				{ _MFShaschanged[v] = 1 ; _MFSchangelist[_nMFSchanges++] = v ; }
+			}
+		_Nodes[u]._EliminationScore += _Nodes[v]._LogK ;
+		_Nodes[v]._EliminationScore += _Nodes[u]._LogK ;
+		}
+	_nFillEdges += nEdgesAdded ;
+
+	// check variables whose MinFillScore changed whether they need to be moved to a different list.
+	for (i = 0 ; i < _nMFSchanges ; i++) {
+		u = _MFSchangelist[i] ;
+		_MFShaschanged[u] = 0 ;
+		NoteJournalChange(u) ;
+		ProcessPostEliminationNodeListLocation(u) ;
+		}
+	_nMFSchanges = 0 ;
+
+	// dump X from the graph
+	for (k = 0 ; k < W ; k++) 
+		_BSAdj[(int64_t) rX * W + k] = 0 ;
+	_Nodes[X]._Degree = 0 ;
+	_Nodes[X]._EliminationScore = _Nodes[X]._LogK ;
+	_Nodes[X]._MinFillScore = 0 ;
+
+	return 0 ;
+}
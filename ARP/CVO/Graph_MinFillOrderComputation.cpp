@@ -32,6 +32,87 @@ have_list :
 }
 
 
+// check if a general node can be considered for elimination, given the width/complexity limits of this run.
+static inline bool IsPickableGeneralNode(ARE::Graph & G, int u, int WidthLimit, bool EarlyTermination_W, bool EarlyTermination_C)
+{
+	if (G.IsIgnoreVariable(u)) 
+		return false ;
+	if (EarlyTermination_W) {
+		if (G._Nodes[u]._Degree > WidthLimit) 
+			// don't consider variables with larger width that known best width.
+			// this may not be optimal, since we really minimize total elimination complexity, and space.
+			// however, we want to quickly give up on an ordering computation, if it does not lead to a new better ordering that the previously known best.
+			// we use the width as the key.
+			return false ;
+		}
+	if (EarlyTermination_C) {
+		if (G._Nodes[u]._EliminationScore >= InfiniteSingleVarElimComplexity_log) 
+			// don't consider whose elimination complexity if too large.
+			return false ;
+		}
+	return true ;
+}
+
+
+static inline double PickScore(ARE::Graph & G, int u, char CostFunction)
+{
+	if (1 == CostFunction) 
+		return G._Nodes[u]._Degree ;
+	else if (2 == CostFunction) 
+		return G._Nodes[u]._EliminationScore ;
+	return G._Nodes[u]._MinFillScore ;
+}
+
+
+// add candidate u to the list Vars[], which is kept sorted by (score, position of u in the general list) and holds at most nMax entries.
+// the list does not depend on the order in which candidates are offered, so scanning the general list and walking the score buckets give the same list.
+static inline void NoteCandidateForPicking(int u, double score, int pos, int & n, int nMax, int *Vars, double *Scores, int *Pos)
+{
+	int i ;
+	if (n >= nMax) {
+		if (score > Scores[n-1] || (score == Scores[n-1] && pos > Pos[n-1])) 
+			return ;
+		i = n - 1 ; // last one is dropped
+		}
+	else 
+		i = n++ ;
+	for (; i > 0 ; i--) {
+		if (Scores[i-1] < score || (Scores[i-1] == score && Pos[i-1] < pos)) 
+			break ;
+		Vars[i] = Vars[i-1] ;
+		Scores[i] = Scores[i-1] ;
+		Pos[i] = Pos[i-1] ;
+		}
+	Vars[i] = u ;
+	Scores[i] = score ;
+	Pos[i] = pos ;
+}
+
+
+// add candidate u to the random pick pool Vars[], which holds at most nMax entries. 
+// when the pool is full, u replaces the (first) candidate with the largest score, if u has a smaller score.
+// the pool depends on the order in which candidates are offered; they have to be offered in the order of the general list.
+static inline void NotePoolCandidateForPicking(int u, double score, int & n, int nMax, int *Vars, double *Scores)
+{
+	if (n < nMax) {
+		Scores[n] = score ;
+		Vars[n++] = u ;
+		return ;
+		}
+	// find max
+	int j, k = 0 ;
+	for (j = 1 ; j < n ; j++) {
+		if (Scores[j] > Scores[k]) 
+			k = j ;
+		}
+	// if better than max, replace it
+	if (score < Scores[k]) {
+		Scores[k] = score ;
+		Vars[k] = u ;
+		}
+}
+
+
 int ARE::Graph::ComputeVariableEliminationOrder_Simple(char CostFunction, int WidthLimit, bool EarlyTermination_W, double TotalComplexityLimit, bool EarlyTermination_C, bool QuitAfterEasyIsDone, int EasyWidth, int n4RandomPick, double eRandomPick, int & TempAdjVarSpaceSizeExtraArrayN, AdjVar *TempAdjVarSpaceSizeExtraArray[])
 {
 	_nFillEdges = 0 ;
@@ -54,6 +135,13 @@ int ARE::Graph::ComputeVariableEliminationOrder_Simple(char CostFunction, int Wi
 	for (i = 0 ; i < _nNodes ; i++) 
 		_MFShaschanged[i] = 0 ;
 
+	// score buckets are keyed on the cost function; build them for this computation. 
+	// when only easy variables are eliminated, general nodes are never picked, so don't bother.
+	if (_UseScoreBuckets && ! QuitAfterEasyIsDone) 
+		BuildScoreBuckets(CostFunction) ;
+	else 
+		InvalidateScoreBuckets() ;
+
 	int IterationIdx = _OrderLength ;
 
 	// this is a list of keeping edges that were part of the graph and were removed and that can be reused
@@ -64,10 +152,11 @@ int ARE::Graph::ComputeVariableEliminationOrder_Simple(char CostFunction, int Wi
 	int nTempAdjVarSpace = 0 ;
 
 #define maxNumVarsForPicking 256 // this is built-in hard limit of the number of variables we consider for picking; make it large enough.
-	int nVarsToPickFrom ;
+	int nVarsToPickFrom, nMaxVarsToPickFrom ;
 	int VarsToPickFrom[maxNumVarsForPicking] ; // make sure this array has at least maxNumVarsForPicking elements
 	double VarsToPickFrom_ProbFactor[maxNumVarsForPicking] ; // make sure this array has at least maxNumVarsForPicking elements
 	double VarsToPickFrom_Scores[maxNumVarsForPicking] ; // make sure this array has at least maxNumVarsForPicking elements; keep sorted in inc order.
+	int VarsToPickFrom_Pos[maxNumVarsForPicking] ; // position (in the general list) of each var to pick from; used to break ties.
 	if (n4RandomPick < 1) 
 		n4RandomPick = 1 ;
 	else if (n4RandomPick > maxNumVarsForPicking) 
@@ -127,6 +216,7 @@ pick_next_var :
 	if (nRemaining <= _nIgnoreVariables) {
 		for (i = 0 ; i < _nIgnoreVariables ; i++) {
 			X = _IgnoreVariables[i] ;
+			NoteJournalChange(X) ;
 			_VarType[X] = 0 ;
 			_PosOfVarInList[X] = _OrderLength ;
 			_VarElimOrder[_OrderLength++] = X ;
@@ -137,6 +227,14 @@ pick_next_var :
 		return 0 ;
 		}
 
+	// vars the caller wants eliminated first (see EliminateVariables())
+	while (_nVarsToEliminateFirst > 0) {
+		X = *_VarsToEliminateFirst++ ;
+		--_nVarsToEliminateFirst ;
+		if (0 != _VarType[X] && ! IsIgnoreVariable(X)) 
+			goto eliminate_picked_variable ;
+		}
+
 	// if there are any (non-ignore) trivial/MinFillScore=0 variables, just pick one
 	for (i = 0 ; i < _nTrivialNodes ; i++) {
 		u = _TrivialNodesList[i] ;
@@ -207,6 +305,28 @@ pick_next_var :
 	if (n4RandomPick < 2) {
 		nVarsToPickFrom = 0 ;
 		__int64 best_score = _I64_MAX ;
+		if (_SBCostFunction >= 0) {
+			// walk the buckets in increasing score order; the first bucket with a pickable node has the best score.
+			// ties are ordered by position in the general list, which is the order in which the scan below finds them.
+			while (_SBMinKey < _nSB && _SBHead[_SBMinKey] < 0) 
+				_SBMinKey++ ;
+			for (k = _SBMinKey ; k < _nSB && 0 == nVarsToPickFrom ; k++) {
+				for (u = _SBHead[k] ; u >= 0 ; u = _SBNext[u]) {
+					if (! IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+						continue ;
+					// all nodes in a bucket have the same score, except in the last (overflow) bucket.
+					__int64 score = PickScore(*this, u, CostFunction) ;
+					if (score > best_score) 
+						continue ;
+					if (score < best_score) {
+						nVarsToPickFrom = 0 ;
+						best_score = score ;
+						}
+					NoteCandidateForPicking(u, 0.0, _PosOfVarInList[u], nVarsToPickFrom, maxNumVarsForPicking, VarsToPickFrom, VarsToPickFrom_Scores, VarsToPickFrom_Pos) ;
+					}
+				}
+			}
+		else 
 		for (i = 0 ; i < _nRemainingNodes ; i++) {
 			u = _RemainingNodesList[i] ;
 			if (IsIgnoreVariable(u)) continue ;
@@ -262,11 +382,80 @@ pick_next_var :
 	// **********************************************************************
 
 //#define TEST_COMPL_CORRECT
+//#define TEST_PICK_POOL_CORRECT
 
+	// the pool is filled with the first n4RandomPick pickable nodes in the general list; after that, a node replaces the candidate with the largest score, if its score is smaller.
+	nMaxVarsToPickFrom = n4RandomPick < maxNumVarsForPicking ? n4RandomPick : maxNumVarsForPicking ;
 	nVarsToPickFrom = 0 ;
+	if (_SBCostFunction >= 0) {
+		// the pool is rebuilt from the buckets, as the scan below would build it. 
+		// find the nodes that fill the pool by scanning the list. once the pool is full, the largest score in the pool never goes up; 
+		// so only nodes later in the list with a score smaller than the largest score now can get in. these are in the buckets up to the bucket of that score; 
+		// collect them, and offer them in list order. _MFSchangelist is empty while a variable is picked; use it as temp space for their positions.
+		// if there are many of them, sorting costs more than scanning the rest of the list; then scan.
+		for (i = 0 ; i < _nRemainingNodes && nVarsToPickFrom < nMaxVarsToPickFrom ; i++) {
+			u = _RemainingNodesList[i] ;
+			if (! IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+				continue ;
+			NotePoolCandidateForPicking(u, PickScore(*this, u, CostFunction), nVarsToPickFrom, nMaxVarsToPickFrom, VarsToPickFrom, VarsToPickFrom_Scores) ;
+			}
+		if (nVarsToPickFrom >= nMaxVarsToPickFrom && i < _nRemainingNodes) {
+			int posFirst = i, nLater = 0, nLaterMax = (_nRemainingNodes - posFirst) >> 3 ;
+			k = 0 ;
+			for (j = 1 ; j < nVarsToPickFrom ; j++) {
+				if (VarsToPickFrom_Scores[j] > VarsToPickFrom_Scores[k]) 
+					k = j ;
+				}
+			double max_score = VarsToPickFrom_Scores[k] ;
+			int max_key = _SBKey[VarsToPickFrom[k]] ;
+			while (_SBMinKey < _nSB && _SBHead[_SBMinKey] < 0) 
+				_SBMinKey++ ;
+			for (k = _SBMinKey ; k <= max_key && k < _nSB && nLater <= nLaterMax ; k++) {
+				for (u = _SBHead[k] ; u >= 0 ; u = _SBNext[u]) {
+					if (_PosOfVarInList[u] < posFirst) 
+						continue ;
+					if (! IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+						continue ;
+					if (PickScore(*this, u, CostFunction) < max_score) 
+						_MFSchangelist[nLater++] = _PosOfVarInList[u] ;
+					}
+				}
+			if (nLater > nLaterMax) {
+				nLater = 0 ;
+				for (j = posFirst ; j < _nRemainingNodes ; j++) {
+					u = _RemainingNodesList[j] ;
+					if (IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+						NotePoolCandidateForPicking(u, PickScore(*this, u, CostFunction), nVarsToPickFrom, nMaxVarsToPickFrom, VarsToPickFrom, VarsToPickFrom_Scores) ;
+					}
+				}
+			else if (nLater > 1) {
+				int32_t left[32], right[32] ;
+				QuickSortLong2(_MFSchangelist, nLater, left, right) ;
+				}
+			for (j = 0 ; j < nLater ; j++) {
+				u = _RemainingNodesList[_MFSchangelist[j]] ;
+				NotePoolCandidateForPicking(u, PickScore(*this, u, CostFunction), nVarsToPickFrom, nMaxVarsToPickFrom, VarsToPickFrom, VarsToPickFrom_Scores) ;
+				}
+			}
+#ifdef TEST_PICK_POOL_CORRECT
+{
+int nRef = 0, VarsRef[maxNumVarsForPicking] ; double ScoresRef[maxNumVarsForPicking] ;
+for (j = 0 ; j < _nRemainingNodes ; j++) {
+	u = _RemainingNodesList[j] ;
+	if (IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+		NotePoolCandidateForPicking(u, PickScore(*this, u, CostFunction), nRef, nMaxVarsToPickFrom, VarsRef, ScoresRef) ;
+	}
+bool same = nRef == nVarsToPickFrom ;
+for (j = 0 ; same && j < nRef ; j++) 
+	same = VarsRef[j] == VarsToPickFrom[j] ;
+if (! same) 
+printf("\nERROR : random pick pool from buckets differs from list scan") ;
+}
+#endif // TEST_PICK_POOL_CORRECT
+		}
+	else 
 	for (i = 0 ; i < _nRemainingNodes ; i++) {
 		u = _RemainingNodesList[i] ;
-		if (IsIgnoreVariable(u)) continue ;
 #ifdef TEST_COMPL_CORRECT
 {
 double c = ComputeEliminationComplexity(u) ;
@@ -274,48 +463,11 @@ if (fabs(c - _Nodes[u]._EliminationScore) > 0.001)
 printf("\nERROR : _Nodes[u]._EliminationScore wrong") ;
 }
 #endif // TEST_COMPL_CORRECT
-		if (EarlyTermination_W) {
-			if (_Nodes[u]._Degree > WidthLimit) 
-				// don't consider variables with larger width that known best width.
-				// this may not be optimal, since we really minimize total elimination complexity, and space.
-				// however, we want to quickly give up on an ordering computation, if it does not lead to a new better ordering that the previously known best.
-				// we use the width as the key.
-				continue ;
-			}
-		if (EarlyTermination_C) {
-			if (_Nodes[u]._EliminationScore >= InfiniteSingleVarElimComplexity_log) 
-				// don't consider whose elimination complexity if too large.
-				continue ;
-			}
-
+		if (! IsPickableGeneralNode(*this, u, WidthLimit, EarlyTermination_W, EarlyTermination_C)) 
+			continue ;
 		// There should be no variables with MinFillScore=0, although it is not important for the code here to work correctly.
 		// We will pick n4RandomPick variables with the smallest EliminationComplexity.
-		double score ;
-		if (1 == CostFunction) 
-			score = _Nodes[u]._Degree ;
-		else if (2 == CostFunction) {
-			score = _Nodes[u]._EliminationScore ;
-			}
-		else 
-			score = _Nodes[u]._MinFillScore ;
-		if (nVarsToPickFrom < n4RandomPick) {
-			VarsToPickFrom_Scores[nVarsToPickFrom] = score ;
-			VarsToPickFrom[nVarsToPickFrom] = u ;
-			++nVarsToPickFrom ;
-			}
-		else {
-			// find max
-			k = 0 ;
-			for (j = 1 ; j < nVarsToPickFrom ; j++) {
-				if (VarsToPickFrom_Scores[j] > VarsToPickFrom_Scores[k]) 
-					k = j ;
-				}
-			// if better than max, replace it
-			if (score < VarsToPickFrom_Scores[k]) {
-				VarsToPickFrom_Scores[k] = score ;
-				VarsToPickFrom[k] = u ;
-				}
-			}
+		NotePoolCandidateForPicking(u, PickScore(*this, u, CostFunction), nVarsToPickFrom, nMaxVarsToPickFrom, VarsToPickFrom, VarsToPickFrom_Scores) ;
 		}
 	if (0 == nVarsToPickFrom) 
 // DEBUGGG
@@ -375,6 +527,7 @@ printf("\nMinFill : round %d w=%d type=%c var=%d degree=%d MinFillScore=%d ElimS
 //printf("\n        : VarToMinFill0ScoreListMap=%d nTrivial=%d nMinFillScore0Nodes=%d ...", _VarToMinFill0ScoreListMap[X], (int) _nTrivialNodes, (int) _nMinFillScore0Nodes) ;
 */
 
+	NoteJournalChange(X) ;
 	RemoveVarFromList(X) ;
 	_VarType[X] = 0 ;
 	_PosOfVarInList[X] = _OrderLength ;
@@ -467,6 +620,24 @@ exit(1) ;
 //	// TODO/NOTE : we use long to store edges, which leaves 16 bits for variable, limiting nNodes to 16.
 //	edges2add.Empty() ;
 
+	// when few nodes are left, a bitset matrix is faster than neighbor lists; if it cannot be built, don't try again.
+	if (2 != _AdjEngine && nRemaining < _BitsetEngineThreshold) {
+		if (0 != BuildAdjacencyBitsets()) 
+			_BitsetEngineThreshold = 0 ;
+		}
+	if (2 == _AdjEngine) {
+		int res_elim = EliminateVariable_Bitsets(X) ;
+		if (0 != res_elim) 
+			return res_elim ;
+		goto pick_next_var ;
+		}
+	if (1 == _AdjEngine) {
+		int res_elim = EliminateVariable_SortedArrays(X, IterationIdx) ;
+		if (0 != res_elim) 
+			return res_elim ;
+		goto pick_next_var ;
+		}
+
 	int nEdgesAdded = 0 ;
 
 // DEBUGGGG
@@ -519,7 +690,7 @@ move_on :
 
 				if (u < v) {
 					// edges2add.Insert((u << 16) | v) ; // else edges2add.Insert((v << 16) | u) ; 2010-10-08 KK : add iff u<v, otherwise we would add twice
-					if (nEdgesAdded >= ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED) 
+					if (0 != ReserveFillEdge(nEdgesAdded)) 
 						return ERRORCODE_out_of_memory_CVOedges ;
 					_EdgeU[nEdgesAdded] = u ;
 					_EdgeV[nEdgesAdded] = v ;
@@ -574,7 +745,7 @@ move_on :
 
 			if (u < v) {
 				// edges2add.Insert((u << 16) | v) ; // else edges2add.Insert((v << 16) | u) ; 2010-10-08 KK : add iff u<v, otherwise we would add twice
-				if (nEdgesAdded >= ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED) 
+				if (0 != ReserveFillEdge(nEdgesAdded)) 
 					return ERRORCODE_out_of_memory_CVOedges ;
 				_EdgeU[nEdgesAdded] = u ;
 				_EdgeV[nEdgesAdded] = v ;
@@ -631,6 +802,7 @@ move_on :
 	for (i = 0 ; i < _nMFSchanges ; i++) {
 		u = _MFSchangelist[i] ;
 		_MFShaschanged[u] = 0 ;
+		NoteJournalChange(u) ;
 		ProcessPostEliminationNodeListLocation(u) ;
 		}
 	_nMFSchanges = 0 ;
@@ -679,8 +851,31 @@ remove_X :
 }
 
 
+int ARE::Graph::EliminateVariables(const int32_t *Vars, int32_t nVars, int & TempAdjVarSpaceSizeExtraArrayN, AdjVar *TempAdjVarSpaceSizeExtraArray[])
+{
+	if (nVars < 0 || (nVars > 0 && NULL == Vars)) 
+		return 1 ;
+	// ComputeVariableEliminationOrder_Simple() counts fill edges from 0; keep the count of the vars already ordered.
+	int32_t nFillEdges = _nFillEdges ;
+	_VarsToEliminateFirst = Vars ;
+	_nVarsToEliminateFirst = nVars ;
+	int res = ComputeVariableEliminationOrder_Simple(0, INT_MAX, false, DBL_MAX, false, true, 1, 1, 0.0, TempAdjVarSpaceSizeExtraArrayN, TempAdjVarSpaceSizeExtraArray) ;
+	_VarsToEliminateFirst = NULL ;
+	_nVarsToEliminateFirst = 0 ;
+	_nFillEdges += nFillEdges ;
+	return res ;
+}
+
+
 int ARE::Graph::ComputeVariableEliminationOrder_Simple_wMinFillOnly(int WidthLimit, bool EarlyTermination_W, bool QuitAfterEasyIsDone, int EasyWidth, int n4RandomPick, double eRandomPick, int & TempAdjVarSpaceSizeExtraArrayN, AdjVar *TempAdjVarSpaceSizeExtraArray[])
 {
+	// this function does not keep the journal/score buckets up to date.
+	InvalidateJournal() ;
+	InvalidateScoreBuckets() ;
+	// this function works on AdjVar lists only.
+	if (0 != SetAdjacencyEngine(0)) 
+		return ERRORCODE_out_of_memory ;
+
 	_nFillEdges = 0 ;
 	if (_nNodes < 1) 
 		return 0 ;
@@ -1112,7 +1307,7 @@ move_on :
 
 				if (u < v) {
 					// edges2add.Insert((u << 16) | v) ; // else edges2add.Insert((v << 16) | u) ; 2010-10-08 KK : add iff u<v, otherwise we would add twice
-					if (nEdgesAdded >= ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED) 
+					if (0 != ReserveFillEdge(nEdgesAdded)) 
 						return ERRORCODE_out_of_memory_CVOedges ;
 					_EdgeU[nEdgesAdded] = u ;
 					_EdgeV[nEdgesAdded] = v ;
@@ -1167,7 +1362,7 @@ move_on :
 
 			if (u < v) {
 				// edges2add.Insert((u << 16) | v) ; // else edges2add.Insert((v << 16) | u) ; 2010-10-08 KK : add iff u<v, otherwise we would add twice
-				if (nEdgesAdded >= ARE_GRAPH_VAR_ORDER_COMP_MAX_NUM_EDGES_ADDED) 
+				if (0 != ReserveFillEdge(nEdgesAdded)) 
 					return ERRORCODE_out_of_memory_CVOedges ;
 				_EdgeU[nEdgesAdded] = u ;
 				_EdgeV[nEdgesAdded] = v ;
@@ -1271,6 +1466,13 @@ remove_X :
 
 int ARE::Graph::ComputeVariableEliminationOrder_LowerBound(void)
 {
+	// this function does not keep the journal/score buckets up to date.
+	InvalidateJournal() ;
+	InvalidateScoreBuckets() ;
+	// this function works on AdjVar lists only.
+	if (0 != SetAdjacencyEngine(0)) 
+		return ERRORCODE_out_of_memory ;
+
 	if (NULL == _Problem || _nNodes < 1) 
 		return 0 ;
 	int nRemaining = _nNodes - _OrderLength ;
@@ -15,6 +15,8 @@ int ARE::Graph::RemoveRedundantFillEdges(void)
 {
 	int i ;
 
+	InvalidateJournal() ;
+
 	if (_nFillEdges < 1) 
 		return 0 ;
 	int nNewEdges = _nEdges + _nFillEdges ;
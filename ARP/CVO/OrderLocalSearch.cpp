@@ -0,0 +1,330 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+#include "OrderLocalSearch.hxx"
+
+static inline int32_t PopCount64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(w) ;
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL) ;
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL) ;
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL ;
+	return (int32_t) ((w * 0x0101010101010101ULL) >> 56) ;
+#endif
+}
+
+// index of the lowest set bit; w must not be 0.
+static inline int32_t LowestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(w) ;
+#else
+	int32_t i = 0 ;
+	while (0 == (w & 1)) { w >>= 1 ; ++i ; }
+	return i ;
+#endif
+}
+
+ARE::OrderLocalSearch::OrderLocalSearch(void)
+	:
+	_nNodes(0), 
+	_nWords(0), 
+	_BaseWidth(0), 
+	_CheckpointStep(1), 
+	_Width(-1), 
+	_nAtWidth(0), 
+	_MemoryLimit(((int64_t) 64) << 20), 
+	_nMoves(0), 
+	_nMovesKept(0)
+{
+}
+
+
+int32_t ARE::OrderLocalSearch::Initialize(ARE::Graph & G)
+{
+	_nNodes = _nWords = 0 ;
+	_Node.clear() ;
+	_Node2Local.clear() ;
+	_LogK.clear() ;
+	_Checkpoints.clear() ;
+	_CandidateCheckpoints.clear() ;
+	_Order.clear() ;
+	_Width = -1 ;
+	_nAtWidth = 0 ;
+	_BaseWidth = G._VarElimOrderWidth > 0 ? G._VarElimOrderWidth : 0 ;
+	if (! G._IsValid || G._nNodes <= 0) 
+		return 1 ;
+
+	int32_t u, i ;
+	_Node2Local.assign(G._nNodes, -1) ;
+	for (u = 0 ; u < G._nNodes ; u++) {
+		if (0 == G._VarType[u]) 
+			continue ;
+		_Node2Local[u] = _nNodes++ ;
+		_Node.push_back(u) ;
+		_LogK.push_back(G._Nodes[u]._LogK) ;
+		}
+	_nWords = (_nNodes + 63) >> 6 ;
+	_Checkpoints.resize(1) ;
+	std::vector<uint64_t> & adj = _Checkpoints[0] ;
+	adj.assign((int64_t) _nNodes * _nWords, 0) ;
+	std::vector<int32_t> neighbors ;
+	for (i = 0 ; i < _nNodes ; i++) {
+		u = _Node[i] ;
+		int32_t n = G._Nodes[u]._Degree > 0 ? G._Nodes[u]._Degree : 0 ;
+		neighbors.resize(n) ;
+		int32_t m = G.CopyNeighbors(u, neighbors.data(), n) ;
+		if (m > n) {
+			neighbors.resize(m) ;
+			G.CopyNeighbors(u, neighbors.data(), m) ;
+			}
+		uint64_t *row = adj.data() + (int64_t) i * _nWords ;
+		for (int32_t j = 0 ; j < m ; j++) {
+			int32_t l = _Node2Local[neighbors[j]] ;
+			if (l >= 0 && l != i) 
+				{ row[l >> 6] |= ((uint64_t) 1) << (l & 63) ; adj[(int64_t) l * _nWords + (i >> 6)] |= ((uint64_t) 1) << (i & 63) ; }
+			}
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::OrderLocalSearch::SetOrder(const int32_t *Order, int32_t n)
+{
+	_Order.clear() ;
+	_Width = -1 ;
+	_nAtWidth = 0 ;
+	if (_nNodes <= 0 || NULL == Order) 
+		return 1 ;
+	int32_t i ;
+	std::vector<char> seen(_nNodes, 0) ;
+	for (i = 0 ; i < n ; i++) {
+		int32_t l = Order[i] >= 0 && Order[i] < (int32_t) _Node2Local.size() ? _Node2Local[Order[i]] : -1 ;
+		if (l < 0 || seen[l]) 
+			continue ;
+		seen[l] = 1 ;
+		_Order.push_back(l) ;
+		}
+	if ((int32_t) _Order.size() != _nNodes) 
+		{ _Order.clear() ; return 1 ; }
+
+	// as many checkpoints as the memory allows; the current order and the candidate each have a set.
+	int64_t size = (int64_t) _nNodes * _nWords * sizeof(uint64_t) ;
+	int64_t nCheckpoints = _MemoryLimit / (2 * size) ;
+	if (nCheckpoints < 1) 
+		nCheckpoints = 1 ;
+	if (nCheckpoints > _nNodes) 
+		nCheckpoints = _nNodes ;
+	_CheckpointStep = (_nNodes + nCheckpoints - 1) / nCheckpoints ;
+	nCheckpoints = (_nNodes + _CheckpointStep - 1) / _CheckpointStep ;
+	_Checkpoints.resize(nCheckpoints) ;
+	_CandidateCheckpoints.resize(nCheckpoints) ;
+
+	_CandidateOrder = _Order ;
+	_Degree.assign(_nNodes, 0) ;
+	_CandidateDegree.assign(_nNodes, 0) ;
+	if (! Evaluate(0, INT_MAX)) 
+		{ _Order.clear() ; return 1 ; }
+	Keep(0) ;
+	return 0 ;
+}
+
+
+bool ARE::OrderLocalSearch::Evaluate(int32_t From, int32_t Bound)
+{
+	int32_t c = From / _CheckpointStep, t, i, j ;
+	int32_t start = c * _CheckpointStep ;
+	_Adj = _Checkpoints[c] ;
+	for (t = start ; t < _nNodes ; t++) {
+		if (t > start && 0 == t % _CheckpointStep) 
+			_CandidateCheckpoints[t / _CheckpointStep] = _Adj ;
+		int32_t v = _CandidateOrder[t] ;
+		uint64_t *nv = Row(v) ;
+		int32_t degree = 0 ;
+		for (i = 0 ; i < _nWords ; i++) 
+			degree += PopCount64(nv[i]) ;
+		if (degree > Bound) 
+			return false ;
+		_CandidateDegree[t] = degree ;
+		// eliminate v
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t u = (i << 6) + LowestBit64(bits) ;
+				uint64_t *nu = Row(u) ;
+				for (j = 0 ; j < _nWords ; j++) 
+					nu[j] |= nv[j] ;
+				nu[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+				nu[v >> 6] &= ~(((uint64_t) 1) << (v & 63)) ;
+				}
+			}
+		}
+	return true ;
+}
+
+
+void ARE::OrderLocalSearch::Keep(int32_t From)
+{
+	int32_t c = From / _CheckpointStep, t ;
+	for (t = c + 1 ; t < (int32_t) _Checkpoints.size() ; t++) 
+		_Checkpoints[t].swap(_CandidateCheckpoints[t]) ;
+	for (t = c * _CheckpointStep ; t < _nNodes ; t++) {
+		_Order[t] = _CandidateOrder[t] ;
+		_Degree[t] = _CandidateDegree[t] ;
+		}
+	_Width = 0 ;
+	_AtWidth.clear() ;
+	for (t = 0 ; t < _nNodes ; t++) {
+		if (_Degree[t] < _Width) 
+			continue ;
+		if (_Degree[t] > _Width) 
+			{ _Width = _Degree[t] ; _AtWidth.clear() ; }
+		_AtWidth.push_back(t) ;
+		}
+	_nAtWidth = _AtWidth.size() ;
+}
+
+
+int32_t ARE::OrderLocalSearch::Improve(MTRand & RNG, int64_t nMaxMoves)
+{
+	if (_Width < 0) 
+		return 1 ;
+	int32_t i, t ;
+	std::vector<int32_t> pos(_nNodes), later ;
+	for (t = 0 ; t < _nNodes ; t++) 
+		pos[_Order[t]] = t ;
+	for (int64_t m = 0 ; m < nMaxMoves ; m++) {
+		if (_Stop && _Stop()) 
+			break ;
+		// width 0 is optimal.
+		if (_Width <= 0 || _nNodes < 2) 
+			break ;
+		// node to move from position a to position b; moves are about a node p, which is in a largest bag half of the time. 
+		// moves of other nodes don't lower the width right away, but they keep the search from getting stuck.
+		int32_t p = RNG.randInt(1) ? RNG.randInt(_nNodes - 1) : _AtWidth[RNG.randInt(_AtWidth.size() - 1)], a = p, b ;
+		switch (RNG.randInt(2)) {
+			case 0 : // move it anywhere
+				b = RNG.randInt(_nNodes - 1) ;
+				break ;
+			case 1 : // move it a few positions
+				b = p + (int32_t) RNG.randInt(16) - 8 ;
+				break ;
+			default : // move a neighbor eliminated after it (so it is in its bag) to just before it
+				later.clear() ;
+				{
+				const uint64_t *row = _Checkpoints[0].data() + (int64_t) _Order[p] * _nWords ;
+				for (i = 0 ; i < _nWords ; i++) {
+					for (uint64_t bits = row[i] ; 0 != bits ; bits &= bits - 1) {
+						int32_t u = (i << 6) + LowestBit64(bits) ;
+						if (pos[u] > p) 
+							later.push_back(pos[u]) ;
+						}
+					}
+				}
+				if (later.size() > 0) 
+					a = later[RNG.randInt(later.size() - 1)] ;
+				else if (p + 1 < _nNodes) 
+					a = p + 1 + RNG.randInt(_nNodes - p - 2) ;
+				b = p ;
+				break ;
+			}
+		if (b < 0) 
+			b = 0 ;
+		else if (b >= _nNodes) 
+			b = _nNodes - 1 ;
+		if (a == b) 
+			continue ;
+		++_nMoves ;
+
+		int32_t low = a < b ? a : b, high = a < b ? b : a ;
+		int32_t v = _Order[a] ;
+		if (a < b) {
+			for (t = a ; t < b ; t++) 
+				_CandidateOrder[t] = _Order[t + 1] ;
+			}
+		else {
+			for (t = a ; t > b ; t--) 
+				_CandidateOrder[t] = _Order[t - 1] ;
+			}
+		_CandidateOrder[b] = v ;
+
+		// keep the move if (width, number of nodes at width) is not larger; positions before the checkpoint evaluated from are not changed.
+		bool keep = Evaluate(low, _Width) ;
+		if (keep) {
+			int32_t start = (low / _CheckpointStep) * _CheckpointStep, w = 0, n = 0 ;
+			for (t = 0 ; t < _nNodes ; t++) {
+				int32_t d = t < start ? _Degree[t] : _CandidateDegree[t] ;
+				if (d > w) 
+					{ w = d ; n = 1 ; }
+				else if (d == w) 
+					++n ;
+				}
+			keep = w < _Width || n <= _nAtWidth ;
+			}
+		if (keep) {
+			Keep(low) ;
+			++_nMovesKept ;
+			for (t = low ; t <= high ; t++) 
+				pos[_Order[t]] = t ;
+			}
+		else {
+			for (t = low ; t <= high ; t++) 
+				_CandidateOrder[t] = _Order[t] ;
+			}
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::OrderLocalSearch::AppendOrder(ARE::Graph & G)
+{
+	if (_Width < 0 || G._OrderLength + _nNodes > G._nNodes) 
+		return 1 ;
+	_Adj = _Checkpoints[0] ;
+	int32_t i, j ;
+	for (int32_t v : _Order) {
+		uint64_t *nv = Row(v) ;
+		// width/complexity of eliminating v, as in Graph::ComputeVariableEliminationOrder_Simple()
+		int32_t degree = 0, nFillEdges = 0 ;
+		double score = _LogK[v] ;
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t u = (i << 6) + LowestBit64(bits) ;
+				const uint64_t *nu = Row(u) ;
+				++degree ;
+				score += _LogK[u] ;
+				for (j = 0 ; j < _nWords ; j++) 
+					nFillEdges += PopCount64(nv[j] & ~nu[j]) ;
+				--nFillEdges ; // u itself
+				}
+			}
+		G._VarElimOrder[G._OrderLength++] = _Node[v] ;
+		if (degree > G._VarElimOrderWidth) 
+			G._VarElimOrderWidth = degree ;
+		if (score > G._MaxVarElimComplexity_Log10) 
+			G._MaxVarElimComplexity_Log10 = score ;
+		G._TotalVarElimComplexity_Log10 += log10(1.0 + pow(10.0, score - G._TotalVarElimComplexity_Log10)) ;
+		double space = score - _LogK[v] ;
+		G._TotalNewFunctionStorageAsNumOfElements_Log10 += log10(1.0 + pow(10.0, space - G._TotalNewFunctionStorageAsNumOfElements_Log10)) ;
+		G._nFillEdges += nFillEdges >> 1 ;
+		// eliminate v
+		for (i = 0 ; i < _nWords ; i++) {
+			for (uint64_t bits = nv[i] ; 0 != bits ; bits &= bits - 1) {
+				int32_t u = (i << 6) + LowestBit64(bits) ;
+				uint64_t *nu = Row(u) ;
+				for (j = 0 ; j < _nWords ; j++) 
+					nu[j] |= nv[j] ;
+				nu[u >> 6] &= ~(((uint64_t) 1) << (u & 63)) ;
+				nu[v >> 6] &= ~(((uint64_t) 1) << (v & 63)) ;
+				}
+			}
+		}
+	return 0 ;
+}
@@ -0,0 +1,94 @@
+#ifndef ARE_OrderLocalSearch_HXX_INCLUDED
+#define ARE_OrderLocalSearch_HXX_INCLUDED
+
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+#include "Utils/MersenneTwister.h"
+
+namespace ARE
+{
+
+class Graph ;
+
+// local search improvement of an elimination order of the nodes of a Graph that are not ordered yet (e.g. the CVO master graph, after easy vars
+// are eliminated). a move takes a node, half of the time one eliminated at the width of the order (its bag is a largest bag), and moves it to 
+// another position, or moves a neighbor eliminated after it to just before it. a move is kept if the order is not worse : (width, number of 
+// nodes eliminated at that width) is not larger; so the search walks plateaus of equal width, and the width goes down when the last node at 
+// the width is gone.
+// the order is evaluated by eliminating nodes on a bitset adjacency matrix. the graph left before every _CheckpointStep-th position is kept,
+// so a move at position p is evaluated from the last checkpoint before p; evaluation stops as soon as a node has degree larger than the width.
+// an object is used by one thread at a time.
+class OrderLocalSearch
+{
+protected :
+	// copy of the graph
+	int32_t _nNodes ;
+	int32_t _nWords ; // 64-bit words per row
+	std::vector<int32_t> _Node ; // node of the Graph of each local node
+	std::vector<int32_t> _Node2Local ; // -1 if the node is not copied
+	std::vector<double> _LogK ;
+	int32_t _BaseWidth ; // width of the nodes of the Graph that are already ordered
+
+	// current order (of local nodes), degree of each node when it is eliminated, and graph left before each checkpoint position.
+	std::vector<int32_t> _Order ;
+	std::vector<int32_t> _Degree ;
+	std::vector<std::vector<uint64_t> > _Checkpoints ; // first is the graph copied
+	int32_t _CheckpointStep ;
+	int32_t _Width ; // -1 if there is no order
+	int32_t _nAtWidth ;
+	std::vector<int32_t> _AtWidth ; // positions of nodes eliminated at _Width
+
+	// move being evaluated; same as the current order, up to the first position changed.
+	std::vector<int32_t> _CandidateOrder ;
+	std::vector<int32_t> _CandidateDegree ;
+	std::vector<std::vector<uint64_t> > _CandidateCheckpoints ;
+	std::vector<uint64_t> _Adj ; // graph left, during evaluation
+
+	int64_t _MemoryLimit ;
+	int64_t _nMoves ;
+	int64_t _nMovesKept ;
+	std::function<bool(void)> _Stop ;
+
+	inline uint64_t *Row(int32_t u) { return _Adj.data() + (int64_t) u * _nWords ; }
+	// eliminate _CandidateOrder from position From on, starting from the last checkpoint before it; fill in _CandidateDegree and
+	// _CandidateCheckpoints after that checkpoint. returns false if a node has degree > Bound.
+	bool Evaluate(int32_t From, int32_t Bound) ;
+	// make the candidate, evaluated from position From, the current order.
+	void Keep(int32_t From) ;
+
+public :
+
+	inline int32_t nNodes(void) const { return _nNodes ; }
+	inline int32_t BaseWidth(void) const { return _BaseWidth ; }
+	// width of the current order, of the nodes copied only; -1 if there is none.
+	inline int32_t Width(void) const { return _Width ; }
+	inline int32_t nAtWidth(void) const { return _nAtWidth ; }
+	inline int64_t nMoves(void) const { return _nMoves ; }
+	inline int64_t nMovesKept(void) const { return _nMovesKept ; }
+	// memory for the graphs left at checkpoints, in bytes; the more, the faster a move is evaluated. call before SetOrder().
+	inline void SetMemoryLimit(int64_t nBytes) { _MemoryLimit = nBytes ; }
+	// Improve() returns when Stop returns true; it is called after each move.
+	inline void SetStopFunction(const std::function<bool(void)> & Stop) { _Stop = Stop ; }
+
+	// copy nodes of G that are not ordered yet, and edges between them; G is not changed. returns 0 iff ok.
+	int32_t Initialize(Graph & G) ;
+
+	// set the order to improve; Order is a list of nodes of G, which has all nodes copied by Initialize() (other nodes are skipped). returns 0 iff ok.
+	int32_t SetOrder(const int32_t *Order, int32_t n) ;
+
+	// do moves until the stop function says so, or nMaxMoves moves are done. returns 0 iff ok.
+	int32_t Improve(MTRand & RNG, int64_t nMaxMoves) ;
+
+	// append the current order to the elimination order of G, and update width/complexity of G as
+	// Graph::ComputeVariableEliminationOrder_Simple() would; G should be (a copy of) the graph given to Initialize().
+	// adjacency and node lists of G are not changed, so afterwards G is good for its order only. returns 0 iff ok.
+	int32_t AppendOrder(Graph & G) ;
+
+	OrderLocalSearch(void) ;
+} ;
+
+} // namespace ARE
+
+#endif // ARE_OrderLocalSearch_HXX_INCLUDED
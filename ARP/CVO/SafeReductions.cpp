@@ -0,0 +1,409 @@
+#include <stdlib.h>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+#include "SafeReductions.hxx"
+
+ARE::SafeReductions::SafeReductions(void)
+	:
+	_nSimplicial(0), 
+	_nAlmostSimplicial(0), 
+	_nBuddy(0), 
+	_nCube(0), 
+	_nSafeEdges(0), 
+	_nNodes(0), 
+	_nAlive(0), 
+	_LowerBound(0), 
+	_SeparatorSearchBudget(20000000), 
+	_CurrentStamp(0)
+{
+}
+
+
+int32_t ARE::SafeReductions::Initialize(ARE::Graph & G, int32_t LowerBound)
+{
+	_nSimplicial = _nAlmostSimplicial = _nBuddy = _nCube = _nSafeEdges = 0 ;
+	_nNodes = _nAlive = 0 ;
+	_Alive.clear() ;
+	_Adj.clear() ;
+	_Order.clear() ;
+	_Queue.clear() ;
+	_LowerBound = LowerBound > G._VarElimOrderWidth ? LowerBound : G._VarElimOrderWidth ;
+	if (_LowerBound < 0) 
+		_LowerBound = 0 ;
+	if (! G._IsValid || G._nNodes <= 0) 
+		return 1 ;
+
+	int32_t u, i ;
+	_nNodes = G._nNodes ;
+	_Alive.assign(_nNodes, 0) ;
+	_InQueue.assign(_nNodes, 0) ;
+	_Adj.resize(_nNodes) ;
+	for (u = 0 ; u < _nNodes ; u++) {
+		if (0 != G._VarType[u]) 
+			{ _Alive[u] = 1 ; ++_nAlive ; }
+		}
+	for (u = 0 ; u < _nNodes ; u++) {
+		if (! _Alive[u]) 
+			continue ;
+		std::vector<int32_t> & nu = _Adj[u] ;
+		int32_t n = G._Nodes[u]._Degree > 0 ? G._Nodes[u]._Degree : 0 ;
+		nu.resize(n) ;
+		int32_t m = G.CopyNeighbors(u, nu.data(), n) ;
+		if (m > n) {
+			nu.resize(m) ;
+			G.CopyNeighbors(u, nu.data(), m) ;
+			}
+		nu.resize(m) ;
+		for (i = m - 1 ; i >= 0 ; i--) {
+			if (nu[i] == u || ! _Alive[nu[i]]) 
+				{ nu[i] = nu.back() ; nu.pop_back() ; }
+			}
+		std::sort(nu.begin(), nu.end()) ;
+		nu.erase(std::unique(nu.begin(), nu.end()), nu.end()) ;
+		}
+	return 0 ;
+}
+
+
+void ARE::SafeReductions::AddEdge(int32_t u, int32_t v)
+{
+	std::vector<int32_t> & nu = _Adj[u] ;
+	nu.insert(std::lower_bound(nu.begin(), nu.end(), v), v) ;
+	std::vector<int32_t> & nv = _Adj[v] ;
+	nv.insert(std::lower_bound(nv.begin(), nv.end(), u), u) ;
+}
+
+
+void ARE::SafeReductions::EnqueueAll(void)
+{
+	for (int32_t u = 0 ; u < _nNodes ; u++) 
+		Enqueue(u) ;
+}
+
+
+void ARE::SafeReductions::Eliminate(int32_t v)
+{
+	std::vector<int32_t> nv ;
+	nv.swap(_Adj[v]) ;
+	int32_t i, j, n = nv.size() ;
+	for (i = 0 ; i < n ; i++) {
+		std::vector<int32_t> & nu = _Adj[nv[i]] ;
+		nu.erase(std::lower_bound(nu.begin(), nu.end(), v)) ;
+		}
+	for (i = 0 ; i < n ; i++) {
+		for (j = i + 1 ; j < n ; j++) {
+			if (! IsAdjacent(nv[i], nv[j])) 
+				AddEdge(nv[i], nv[j]) ;
+			}
+		Enqueue(nv[i]) ;
+		}
+	_Alive[v] = 0 ;
+	--_nAlive ;
+	_Order.push_back(v) ;
+}
+
+
+bool ARE::SafeReductions::IsSimplicial(int32_t v) const
+{
+	const std::vector<int32_t> & nv = _Adj[v] ;
+	int32_t i, j, n = nv.size() ;
+	// each neighbor must be adjacent to the n-1 others
+	for (i = 0 ; i < n ; i++) {
+		if ((int32_t) _Adj[nv[i]].size() < n) 
+			return false ;
+		}
+	for (i = 0 ; i < n ; i++) {
+		for (j = i + 1 ; j < n ; j++) {
+			if (! IsAdjacent(nv[i], nv[j])) 
+				return false ;
+			}
+		}
+	return true ;
+}
+
+
+bool ARE::SafeReductions::IsAlmostSimplicial(int32_t v) const
+{
+	const std::vector<int32_t> & nv = _Adj[v] ;
+	int32_t i, j, s, n = nv.size() ;
+	// find a missing edge; one of its ends is the neighbor that is not in the clique.
+	int32_t special[2] = { -1, -1 } ;
+	for (i = 0 ; i < n && special[0] < 0 ; i++) {
+		for (j = i + 1 ; j < n ; j++) {
+			if (! IsAdjacent(nv[i], nv[j])) 
+				{ special[0] = nv[i] ; special[1] = nv[j] ; break ; }
+			}
+		}
+	if (special[0] < 0) 
+		return true ;
+	for (s = 0 ; s < 2 ; s++) {
+		bool ok = true ;
+		for (i = 0 ; i < n && ok ; i++) {
+			if (nv[i] == special[s]) 
+				continue ;
+			for (j = i + 1 ; j < n ; j++) {
+				if (nv[j] == special[s]) 
+					continue ;
+				if (! IsAdjacent(nv[i], nv[j])) 
+					{ ok = false ; break ; }
+				}
+			}
+		if (ok) 
+			return true ;
+		}
+	return false ;
+}
+
+
+bool ARE::SafeReductions::ApplyBuddy(int32_t v)
+{
+	const std::vector<int32_t> & nv = _Adj[v] ;
+	if (3 != nv.size()) 
+		return false ;
+	const std::vector<int32_t> & na = _Adj[nv[0]] ;
+	for (int32_t i = 0 ; i < (int32_t) na.size() ; i++) {
+		int32_t w = na[i] ;
+		if (w != v && _Adj[w] == nv) {
+			// eliminating v makes the neighbors a clique; w is then simplicial, of degree 3.
+			Eliminate(v) ;
+			Eliminate(w) ;
+			return true ;
+			}
+		}
+	return false ;
+}
+
+
+bool ARE::SafeReductions::ApplyCube(int32_t d)
+{
+	const std::vector<int32_t> & nd = _Adj[d] ;
+	if (3 != nd.size()) 
+		return false ;
+	// the 2 other neighbors of each of v, w, x
+	int32_t i, j, other[3][2], corner[3], nCorners = 0 ;
+	for (i = 0 ; i < 3 ; i++) {
+		const std::vector<int32_t> & nu = _Adj[nd[i]] ;
+		if (3 != nu.size()) 
+			return false ;
+		int32_t k = 0 ;
+		for (j = 0 ; j < 3 ; j++) {
+			int32_t y = nu[j] ;
+			if (y == d) 
+				continue ;
+			if (y == nd[0] || y == nd[1] || y == nd[2] || k >= 2) 
+				return false ;
+			other[i][k++] = y ;
+			}
+		if (2 != k) 
+			return false ;
+		for (j = 0 ; j < 2 ; j++) {
+			int32_t c = 0 ;
+			while (c < nCorners && corner[c] != other[i][j]) 
+				++c ;
+			if (c >= nCorners) {
+				if (nCorners >= 3) 
+					return false ;
+				corner[nCorners++] = other[i][j] ;
+				}
+			}
+		}
+	// 3 corners, and no two of v, w, x have the same 2 corners
+	if (3 != nCorners) 
+		return false ;
+	for (i = 0 ; i < 3 ; i++) {
+		for (j = i + 1 ; j < 3 ; j++) {
+			if ((other[i][0] == other[j][0] && other[i][1] == other[j][1]) || (other[i][0] == other[j][1] && other[i][1] == other[j][0])) 
+				return false ;
+			}
+		}
+	// each of v, w, x has degree 3 when eliminated, and so does d, which is then adjacent to a, b, c.
+	int32_t vwx[3] = { nd[0], nd[1], nd[2] } ;
+	for (i = 0 ; i < 3 ; i++) 
+		Eliminate(vwx[i]) ;
+	Eliminate(d) ;
+	return true ;
+}
+
+
+void ARE::SafeReductions::ApplyRules(void)
+{
+	while (_Queue.size() > 0) {
+		int32_t v = _Queue.back() ;
+		_Queue.pop_back() ;
+		_InQueue[v] = 0 ;
+		if (! _Alive[v]) 
+			continue ;
+		int32_t degree = _Adj[v].size() ;
+		if (IsSimplicial(v)) {
+			++_nSimplicial ;
+			Eliminate(v) ;
+			if (degree > _LowerBound) {
+				// nodes that were not picked may be picked with the larger bound
+				_LowerBound = degree ;
+				EnqueueAll() ;
+				}
+			continue ;
+			}
+		if (degree <= _LowerBound && IsAlmostSimplicial(v)) 
+			{ ++_nAlmostSimplicial ; Eliminate(v) ; continue ; }
+		if (_LowerBound >= 3 && 3 == degree) {
+			if (ApplyBuddy(v)) 
+				{ ++_nBuddy ; continue ; }
+			if (ApplyCube(v)) 
+				{ ++_nCube ; continue ; }
+			}
+		}
+}
+
+
+bool ARE::SafeReductions::IsMinimalSeparator(int32_t a, int32_t b)
+{
+	// components of the graph without a, b, found from the neighbors of b; each gets its own stamp, larger than any stamp of earlier calls.
+	int32_t nFull = 0, base = _CurrentStamp ;
+	const std::vector<int32_t> & nb = _Adj[b] ;
+	for (int32_t i = 0 ; i < (int32_t) nb.size() ; i++) {
+		int32_t s = nb[i] ;
+		if (s == a || _Stamp[s] > base) 
+			continue ;
+		int32_t stamp = ++_CurrentStamp ;
+		bool adjacentToA = false ;
+		_Stack.clear() ;
+		_Stack.push_back(s) ;
+		_Stamp[s] = stamp ;
+		while (_Stack.size() > 0) {
+			int32_t u = _Stack.back() ;
+			_Stack.pop_back() ;
+			const std::vector<int32_t> & nu = _Adj[u] ;
+			for (int32_t j = 0 ; j < (int32_t) nu.size() ; j++) {
+				int32_t w = nu[j] ;
+				if (w == a) 
+					{ adjacentToA = true ; continue ; }
+				if (w == b || _Stamp[w] > base) 
+					continue ;
+				_Stamp[w] = stamp ;
+				_Stack.push_back(w) ;
+				}
+			}
+		if (adjacentToA && ++nFull >= 2) 
+			return true ;
+		}
+	return false ;
+}
+
+
+int32_t ARE::SafeReductions::AddSafeSeparatorEdges(void)
+{
+	if (_LowerBound < 2 || _nAlive < 4) 
+		return 0 ;
+	int32_t a, i, n = 0 ;
+	int64_t nEdges = 0 ;
+	for (a = 0 ; a < _nNodes ; a++) 
+		nEdges += _Adj[a].size() ;
+	if ((int64_t) _nAlive * (nEdges >> 1) > _SeparatorSearchBudget) 
+		return 0 ;
+	_Disc.assign(_nNodes, -1) ;
+	_Low.assign(_nNodes, 0) ;
+	_StackPos.assign(_nNodes, 0) ;
+	_IsCut.assign(_nNodes, 0) ;
+	_Stamp.assign(_nNodes, 0) ;
+	_CurrentStamp = 0 ;
+	std::vector<int32_t> cuts, parent(_nNodes, -1) ;
+	for (a = 0 ; a < _nNodes ; a++) {
+		if (! _Alive[a]) 
+			continue ;
+		// cut nodes b of the graph without a; then a, b is a separator. edges added in this loop are incident to a, so they do not change the cut nodes.
+		for (i = 0 ; i < _nNodes ; i++) 
+			_Disc[i] = -1 ;
+		cuts.clear() ;
+		int32_t time = 0 ;
+		for (int32_t r = 0 ; r < _nNodes ; r++) {
+			if (! _Alive[r] || r == a || _Disc[r] >= 0) 
+				continue ;
+			// iterative DFS; _StackPos[u] is the next neighbor of u to look at.
+			int32_t nRootChildren = 0 ;
+			_Stack.clear() ;
+			_Stack.push_back(r) ;
+			_Disc[r] = _Low[r] = time++ ;
+			_StackPos[r] = 0 ;
+			parent[r] = -1 ;
+			while (_Stack.size() > 0) {
+				int32_t u = _Stack.back() ;
+				const std::vector<int32_t> & nu = _Adj[u] ;
+				if (_StackPos[u] < (int32_t) nu.size()) {
+					int32_t w = nu[_StackPos[u]++] ;
+					if (w == a) 
+						continue ;
+					if (_Disc[w] < 0) {
+						parent[w] = u ;
+						_Disc[w] = _Low[w] = time++ ;
+						_StackPos[w] = 0 ;
+						_Stack.push_back(w) ;
+						if (u == r) 
+							++nRootChildren ;
+						}
+					else if (w != parent[u] && _Disc[w] < _Low[u]) 
+						_Low[u] = _Disc[w] ;
+					continue ;
+					}
+				_Stack.pop_back() ;
+				int32_t p = parent[u] ;
+				if (p < 0) 
+					continue ;
+				if (_Low[u] < _Low[p]) 
+					_Low[p] = _Low[u] ;
+				if (p != r && _Low[u] >= _Disc[p] && ! _IsCut[p]) 
+					{ _IsCut[p] = 1 ; cuts.push_back(p) ; }
+				}
+			if (nRootChildren >= 2 && ! _IsCut[r]) 
+				{ _IsCut[r] = 1 ; cuts.push_back(r) ; }
+			}
+		for (i = 0 ; i < (int32_t) cuts.size() ; i++) {
+			int32_t b = cuts[i] ;
+			_IsCut[b] = 0 ;
+			// each pair is found from both ends
+			if (b < a || IsAdjacent(a, b)) 
+				continue ;
+			if (! IsMinimalSeparator(a, b)) 
+				continue ;
+			AddEdge(a, b) ;
+			++n ;
+			// nodes adjacent to both may now be (almost) simplicial
+			Enqueue(a) ;
+			Enqueue(b) ;
+			const std::vector<int32_t> & na = _Adj[a] ;
+			for (int32_t j = 0 ; j < (int32_t) na.size() ; j++) 
+				Enqueue(na[j]) ;
+			const std::vector<int32_t> & nb = _Adj[b] ;
+			for (int32_t j = 0 ; j < (int32_t) nb.size() ; j++) 
+				Enqueue(nb[j]) ;
+			}
+		}
+	_nSafeEdges += n ;
+	return n ;
+}
+
+
+int32_t ARE::SafeReductions::Reduce(void)
+{
+	if (_nNodes <= 0) 
+		return 1 ;
+	EnqueueAll() ;
+	while (true) {
+		ApplyRules() ;
+		if (_nAlive <= _LowerBound + 1) {
+			// any order of the nodes left has width <= the lower bound
+			for (int32_t u = 0 ; u < _nNodes ; u++) {
+				if (_Alive[u]) 
+					{ _Alive[u] = 0 ; _Order.push_back(u) ; }
+				}
+			_nAlive = 0 ;
+			break ;
+			}
+		if (0 == AddSafeSeparatorEdges()) 
+			break ;
+		}
+	return 0 ;
+}
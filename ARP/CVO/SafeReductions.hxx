@@ -0,0 +1,98 @@
+#ifndef ARE_SafeReductions_HXX_INCLUDED
+#define ARE_SafeReductions_HXX_INCLUDED
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+namespace ARE
+{
+
+class Graph ;
+
+// treewidth-safe reduction rules (Bodlaender, Koster, van den Eijkhoff), on the nodes of a Graph that are not ordered yet. given a lower bound low 
+// on width, the rules pick nodes that can be eliminated first, without making the best width of an order larger than max(low, treewidth) :
+//	simplicial : the neighbors of a node form a clique; low is raised to its degree, if larger.
+//	almost simplicial : all neighbors of a node but one form a clique, and its degree is <= low.
+//	buddy (low >= 3) : two nodes of degree 3 have the same neighbors; both are eliminated.
+//	cube (low >= 3) : node d and its neighbors v, w, x have degree 3, and v, w, x are adjacent to a, b / a, c / b, c (a cube without one corner); 
+//		v, w, x, d are eliminated, which makes a, b, c a clique.
+//	safe separator (low >= 2) : if a, b (not adjacent) are a minimal separator, edge a-b can be added without changing treewidth. the edge is only 
+//		added to the copy, so that the other rules apply to more nodes.
+// eliminating the nodes picked, in order, from the Graph (Graph::EliminateVariables()) gives it an order prefix of width <= low, and leaves a graph 
+// that is a subgraph of the reduced copy; any order of it completes the order, and an optimal one gives an optimal order of the Graph.
+// the copy is kept as sorted neighbor lists. separators are looked for only when the graph left is small, since it takes O(n*m) time.
+class SafeReductions
+{
+public :
+
+	// number of times each rule was applied
+	int32_t _nSimplicial ;
+	int32_t _nAlmostSimplicial ;
+	int32_t _nBuddy ;
+	int32_t _nCube ;
+	int32_t _nSafeEdges ;
+
+protected :
+
+	int32_t _nNodes ; // of the Graph; the copy is indexed the same way
+	int32_t _nAlive ;
+	std::vector<char> _Alive ;
+	std::vector<std::vector<int32_t> > _Adj ;
+	int32_t _LowerBound ;
+	int64_t _SeparatorSearchBudget ; // separators are looked for only if n*m of the graph left is at most this
+	std::vector<int32_t> _Order ; // nodes picked, in elimination order
+
+	// nodes to check for rules
+	std::vector<int32_t> _Queue ;
+	std::vector<char> _InQueue ;
+
+	// scratch space of separator search
+	std::vector<int32_t> _Disc, _Low, _Stack, _StackPos, _Stamp ;
+	std::vector<char> _IsCut ;
+	int32_t _CurrentStamp ;
+
+	inline bool IsAdjacent(int32_t u, int32_t v) const
+	{
+		const std::vector<int32_t> & nu = _Adj[u] ;
+		return std::binary_search(nu.begin(), nu.end(), v) ;
+	}
+	void AddEdge(int32_t u, int32_t v) ;
+	inline void Enqueue(int32_t u)
+	{
+		if (_Alive[u] && ! _InQueue[u]) 
+			{ _InQueue[u] = 1 ; _Queue.push_back(u) ; }
+	}
+	void EnqueueAll(void) ;
+	void Eliminate(int32_t v) ;
+	bool IsSimplicial(int32_t v) const ;
+	bool IsAlmostSimplicial(int32_t v) const ;
+	// buddy/cube rules with v as one of the buddies/the corner d; returns true if they apply (nodes are eliminated).
+	bool ApplyBuddy(int32_t v) ;
+	bool ApplyCube(int32_t v) ;
+	void ApplyRules(void) ;
+	// true iff a, b (not adjacent) are a minimal separator : at least 2 components of the graph without a, b are adjacent to both.
+	bool IsMinimalSeparator(int32_t a, int32_t b) ;
+	// add edges of all minimal separators of size 2; returns the number of edges added.
+	int32_t AddSafeSeparatorEdges(void) ;
+
+public :
+
+	inline int32_t LowerBound(void) const { return _LowerBound ; }
+	inline int32_t nAlive(void) const { return _nAlive ; }
+	inline const std::vector<int32_t> & Order(void) const { return _Order ; }
+	inline void SetSeparatorSearchBudget(int64_t n) { _SeparatorSearchBudget = n ; }
+
+	// copy nodes of G that are not ordered yet, and edges between them; G is not changed. LowerBound is a lower bound on width of G 
+	// (e.g. from WidthLowerBound); width of the vars of G already ordered is used too. returns 0 iff ok.
+	int32_t Initialize(Graph & G, int32_t LowerBound) ;
+
+	// apply the rules as long as any applies; the nodes picked are Order(), and LowerBound() is the lower bound they were picked with. returns 0 iff ok.
+	int32_t Reduce(void) ;
+
+	SafeReductions(void) ;
+} ;
+
+} // namespace ARE
+
+#endif // ARE_SafeReductions_HXX_INCLUDED
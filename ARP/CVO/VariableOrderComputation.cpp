@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <thread>
 #include <time.h>
 
@@ -62,212 +63,614 @@ static void GetCurrentDTmsec(char *strDT, int64_t  & tNow)
 	sprintf(strDT, "%lld", tNow) ;
 }
 
-int ARE::VarElimOrderComp::CVOcontext::NoteVarOrderComputationCompletion(int w_IDX, ARE::Graph & G)
+int ARE::VarElimOrderComp::CVOcontext::NoteImprovement(int w_IDX, ARE::Graph & G)
 {
-	if (G._OrderLength != _Problem->N()) {
-		int error = 1 ;
-		return 1 ;
+	if (G._OrderLength != _Problem->N()) 
+		return 0 ;
+	return NoteImprovement(w_IDX, G._VarElimOrder, G._VarElimOrderWidth, G._MaxVarElimComplexity_Log10, G._TotalVarElimComplexity_Log10, G._TotalNewFunctionStorageAsNumOfElements_Log10, G._nFillEdges) ;
+}
+
+
+int ARE::VarElimOrderComp::CVOcontext::NoteImprovement(int w_IDX, const int *VarListInElimOrder, int W, double MaxSingleVarElimComplexity, double Complexity_Log10, double TotalNewFunctionStorage_Log10, int nFillEdges)
+{
+	// _BestScore may already be lowered by this (or a better) run; compare with the order actually stored.
+	if (! IsBetter(W, Complexity_Log10, _BestOrder->_Width, _BestOrder->_Complexity_Log10)) 
+		return 0 ;
+
+	int64_t tNow = ARE::GetTimeInMilliseconds() ;
+	if (NULL != _fpLOG) {
+		fprintf(_fpLOG, "\n%I64d worker %2d found better solution : width=%d complexity=%g space(#elements)=%g", tNow, (int) w_IDX, (int) W, (double) Complexity_Log10, (double) TotalNewFunctionStorage_Log10) ;
+		fflush(_fpLOG) ;
 		}
-	++_nRunsCompleted ;
-	if ((StateSpaceSize==_ObjCode && (G._TotalVarElimComplexity_Log10 < _BestOrder->_Complexity_Log10 || (fabs(G._TotalVarElimComplexity_Log10 - _BestOrder->_Complexity_Log10) < 0.01 && G._VarElimOrderWidth < _BestOrder->_Width))) ||  
-		(Width==_ObjCode && (G._VarElimOrderWidth < _BestOrder->_Width || (G._VarElimOrderWidth == _BestOrder->_Width && G._TotalVarElimComplexity_Log10 < _BestOrder->_Complexity_Log10)))) {
-		int64_t tNow = ARE::GetTimeInMilliseconds() ;
+
+	if (_nImprovements < 1024) {
+		ARE::VarElimOrderComp::ResultSnapShot & result_record = _Improvements[_nImprovements++] ;
+		result_record._dt = tNow - _tStart ;
+		result_record._width = W ;
+		result_record._complexity = Complexity_Log10 ;
+		}
+
+	_BestOrder->_Width = W ;
+	_BestOrder->_nFillEdges = nFillEdges ;
+	_BestOrder->_MaxSingleVarElimComplexity = MaxSingleVarElimComplexity ;
+	_BestOrder->_Complexity_Log10 = Complexity_Log10 ;
+	_BestOrder->_TotalNewFunctionStorageAsNumOfElements_Log10 = TotalNewFunctionStorage_Log10 ;
+	for (int i = 0 ; i < _Problem->N() ; i++) 
+		_BestOrder->_VarListInElimOrder[i] = VarListInElimOrder[i] ;
+
+	cout << "c status " << (1+_BestOrder->_Width) << ' ' << tNow << std::endl ;
+	cout << flush ;
+	// callers other than runs (e.g. the initial run) have not lowered _BestScore themselves.
+	OfferScore(W, Complexity_Log10) ;
+	// if the order is optimal, drop runs not started yet.
+	if (WidthLowerBoundMet()) {
 		if (NULL != _fpLOG) {
-			fprintf(_fpLOG, "\n%I64d worker %2d found better solution : width=%d complexity=%g space(#elements)=%g", tNow, (int) w_IDX, (int) G._VarElimOrderWidth, (double) G._TotalVarElimComplexity_Log10, (double) G._TotalNewFunctionStorageAsNumOfElements_Log10) ;
+			fprintf(_fpLOG, "\n%I64d width=%d is equal to the lower bound; will stop ...", tNow, (int) W) ;
 			fflush(_fpLOG) ;
 			}
+		_Scheduler.Cancel() ;
+		}
+	return 1 ;
+}
 
-		ARE::VarElimOrderComp::ResultSnapShot & result_record = _Improvements[_nImprovements++] ;
-		result_record._dt = tNow - _tStart ;
-		result_record._width = G._VarElimOrderWidth ;
-		result_record._complexity = G._TotalVarElimComplexity_Log10 ;
 
-		_BestOrder->_Width = G._VarElimOrderWidth ;
-		_BestOrder->_nFillEdges = G._nFillEdges ;
-		_BestOrder->_MaxSingleVarElimComplexity = G._MaxVarElimComplexity_Log10 ;
-		_BestOrder->_Complexity_Log10 = G._TotalVarElimComplexity_Log10 ;
-		_BestOrder->_TotalNewFunctionStorageAsNumOfElements_Log10 = G._TotalNewFunctionStorageAsNumOfElements_Log10 ;
-		for (int i = 0 ; i < _Problem->N() ; i++) 
-			_BestOrder->_VarListInElimOrder[i] = (G._VarElimOrder)[i] ;
+// log10(10^A + 10^B - 1); totals of a graph start at log10(1) = 0, so this adds the total of a group of vars to the total of another.
+static double AddTotals_Log10(double A, double B)
+{
+	double m = A > B ? A : B ;
+	double x = pow(10.0, A - m) + pow(10.0, B - m) - pow(10.0, -m) ;
+	return x > 0.0 ? m + log10(x) : 0.0 ;
+}
+
+
+int ARE::VarElimOrderComp::CVOcontext::CreateComponentSearches(const int *Order)
+{
+	DestroyComponentSearches() ;
+	ARE::Graph & M = _MasterGraph ;
+	int N = M._nNodes, i, j, k ;
+	// vars to ignore are ordered by runs in a special way; search those as a whole.
+	if (_MaxComponents < 2 || NULL == Order || M._nIgnoreVariables > 0 || M._OrderLength >= N) 
+		return 0 ;
+
+	// connected components of vars not ordered yet, largest first.
+	std::vector<int> comp(N, -1), vars, neighbors(N), sizes ;
+	vars.reserve(N - M._OrderLength) ;
+	for (i = 0 ; i < N ; i++) {
+		if (0 == M._VarType[i] || comp[i] >= 0) 
+			continue ;
+		int c = sizes.size(), first = vars.size() ;
+		comp[i] = c ;
+		vars.push_back(i) ;
+		for (j = first ; j < (int) vars.size() ; j++) {
+			int n = M.CopyNeighbors(vars[j], neighbors.data(), N) ;
+			for (k = 0 ; k < n ; k++) {
+				int u = neighbors[k] ;
+				if (comp[u] < 0) 
+					{ comp[u] = c ; vars.push_back(u) ; }
+				}
+			}
+		sizes.push_back(vars.size() - first) ;
+		}
+	if (sizes.size() < 2) 
+		return 0 ;
+	std::vector<int> byDecreasingSize(sizes.size()) ;
+	for (i = 0 ; i < (int) sizes.size() ; i++) 
+		byDecreasingSize[i] = i ;
+	std::sort(byDecreasingSize.begin(), byDecreasingSize.end(), [&sizes](int a, int b) { return sizes[a] > sizes[b] ; }) ;
+
+	// large components get a group of their own; the rest share the last group.
+	std::vector<int> comp2group(sizes.size(), -1), groupSizes ;
+	int rest = -1 ;
+	for (i = 0 ; i < (int) byDecreasingSize.size() ; i++) {
+		int c = byDecreasingSize[i] ;
+		if (rest < 0 && (int) groupSizes.size() < _MaxComponents - 1 && sizes[c] >= _ComponentMinNodes) 
+			{ comp2group[c] = groupSizes.size() ; groupSizes.push_back(sizes[c]) ; continue ; }
+		if (rest < 0) 
+			{ rest = groupSizes.size() ; groupSizes.push_back(0) ; }
+		comp2group[c] = rest ;
+		groupSizes[rest] += sizes[c] ;
+		}
+	if (groupSizes.size() < 2) 
+		return 0 ;
+	_ComponentOfVar.assign(N, -1) ;
+	for (i = 0 ; i < N ; i++) {
+		if (comp[i] >= 0) 
+			_ComponentOfVar[i] = comp2group[comp[i]] ;
+		}
+
+	// each group graph is the master graph, with vars of other groups eliminated in the given order; the order of the group is then 
+	// the given order restricted to the group.
+	std::vector<int> others, own ;
+	for (int g = 0 ; g < (int) groupSizes.size() ; g++) {
+		ARE::VarElimOrderComp::ComponentSearch *cs = new ARE::VarElimOrderComp::ComponentSearch(g, groupSizes[g]) ;
+		if (NULL == cs) 
+			goto failed ;
+		_Components.push_back(cs) ;
+		if (0 != cs->_BestOrder.Initialize(groupSizes[g])) 
+			goto failed ;
+		others.clear() ;
+		own.clear() ;
+		for (i = M._OrderLength ; i < N ; i++) {
+			int v = Order[i] ;
+			if (_ComponentOfVar[v] == g) 
+				own.push_back(v) ;
+			else if (_ComponentOfVar[v] >= 0) 
+				others.push_back(v) ;
+			}
+		if ((int) own.size() != groupSizes[g]) 
+			goto failed ;
+		ARE::Graph & G = cs->_G ;
+		G = M ;
+		if (! G._IsValid || 0 != G.EliminateVariables(others.data(), others.size(), _TempAdjVarSpaceSizeExtraArrayN, _TempAdjVarSpaceSizeExtraArray)) 
+			goto failed ;
+		// vars of the group must all be left to runs; eliminating other groups does not change them, but check anyway.
+		if (G._OrderLength != N - groupSizes[g]) 
+			goto failed ;
+		G.ReAllocateEdges() ;
+		G._VarElimOrderWidth = 0 ;
+		G._MaxVarElimComplexity_Log10 = 0.0 ;
+		G._TotalVarElimComplexity_Log10 = 0.0 ;
+		G._TotalNewFunctionStorageAsNumOfElements_Log10 = 0.0 ;
+		G._nFillEdges = 0 ;
+		// the best order of the group, to start with, is the given order.
+		ARE::Graph g0 ;
+		g0 = G ;
+		if (! g0._IsValid || 0 != g0.EliminateVariables(own.data(), own.size(), _TempAdjVarSpaceSizeExtraArrayN, _TempAdjVarSpaceSizeExtraArray) || g0._OrderLength != N) 
+			goto failed ;
+		for (i = 0 ; i < groupSizes[g] ; i++) 
+			cs->_BestOrder._VarListInElimOrder[i] = own[i] ;
+		cs->_BestOrder._Width = g0._VarElimOrderWidth ;
+		cs->_BestOrder._MaxSingleVarElimComplexity = g0._MaxVarElimComplexity_Log10 ;
+		cs->_BestOrder._Complexity_Log10 = g0._TotalVarElimComplexity_Log10 ;
+		cs->_BestOrder._TotalNewFunctionStorageAsNumOfElements_Log10 = g0._TotalNewFunctionStorageAsNumOfElements_Log10 ;
+		cs->_BestOrder._nFillEdges = g0._nFillEdges ;
+		cs->_BestScore = PackScore(g0._VarElimOrderWidth, g0._TotalVarElimComplexity_Log10) ;
+		}
+	_StitchedOrder.resize(N) ;
+	return 0 ;
+failed :
+	DestroyComponentSearches() ;
+	return 1 ;
+}
+
 
-		cout << "c status " << (1+_BestOrder->_Width) << ' ' << tNow << std::endl ;
-		cout << flush ;
+void ARE::VarElimOrderComp::CVOcontext::DestroyComponentSearches(void)
+{
+	for (int i = 0 ; i < (int) _Components.size() ; i++) 
+		delete _Components[i] ;
+	_Components.clear() ;
+	_ComponentOfVar.clear() ;
+	_StitchedOrder.clear() ;
+}
+
+
+int ARE::VarElimOrderComp::CVOcontext::PickComponent(MTRand & RNG)
+{
+	int n = _Components.size(), i ;
+	if (n < 1) 
+		return -1 ;
+	int bestWidth = ScoreWidth(_BestScore.load()) ;
+	int lb = _WidthLowerBound.load() ;
+	// all groups add to the complexity, but only the widest decide the width.
+	auto weight = [&](int IDX) -> double {
+		ARE::VarElimOrderComp::ComponentSearch *cs = _Components[IDX] ;
+		if (Width != _ObjCode) 
+			return cs->_nNodes ;
+		int W = ScoreWidth(cs->_BestScore.load()) ;
+		if (W <= lb) 
+			return 0.0 ;
+		return W < bestWidth ? cs->_nNodes / 16.0 : cs->_nNodes ;
+		} ;
+	double total = 0.0 ;
+	for (i = 0 ; i < n ; i++) 
+		total += weight(i) ;
+	if (total <= 0.0) 
+		return RNG.randInt(n - 1) ;
+	double x = RNG.randExc(total) ;
+	for (i = 0 ; i < n - 1 ; i++) {
+		double w = weight(i) ;
+		if (x < w) 
+			break ;
+		x -= w ;
 		}
+	return i ;
+}
+
+
+int ARE::VarElimOrderComp::CVOcontext::NoteComponentRun(int w_IDX, int IDX, ARE::Graph & G)
+{
+	if (IDX < 0 || IDX >= (int) _Components.size() || G._OrderLength != _Problem->N()) 
+		return 0 ;
+	ARE::VarElimOrderComp::ComponentSearch & cs = *(_Components[IDX]) ;
+	ARE::VarElimOrderComp::Order & o = cs._BestOrder ;
+	if (! IsBetter(G._VarElimOrderWidth, G._TotalVarElimComplexity_Log10, o._Width, o._Complexity_Log10)) 
+		return 0 ;
+	int i, j ;
+	for (i = j = 0 ; i < G._OrderLength ; i++) {
+		int v = G._VarElimOrder[i] ;
+		if (_ComponentOfVar[v] == IDX && j < o._nVars) 
+			o._VarListInElimOrder[j++] = v ;
+		}
+	o._Width = G._VarElimOrderWidth ;
+	o._MaxSingleVarElimComplexity = G._MaxVarElimComplexity_Log10 ;
+	o._Complexity_Log10 = G._TotalVarElimComplexity_Log10 ;
+	o._TotalNewFunctionStorageAsNumOfElements_Log10 = G._TotalNewFunctionStorageAsNumOfElements_Log10 ;
+	o._nFillEdges = G._nFillEdges ;
+	OfferScore(cs._BestScore, o._Width, o._Complexity_Log10) ;
+
+	// vars ordered in the master graph first, then each group; groups are not connected, so width is the largest of all, and totals add up.
+	ARE::Graph & M = _MasterGraph ;
+	int W = M._VarElimOrderWidth, nFillEdges = M._nFillEdges ;
+	double MaxC = M._MaxVarElimComplexity_Log10, C = M._TotalVarElimComplexity_Log10, S = M._TotalNewFunctionStorageAsNumOfElements_Log10 ;
+	for (i = 0 ; i < M._OrderLength ; i++) 
+		_StitchedOrder[i] = M._VarElimOrder[i] ;
+	for (int g = 0 ; g < (int) _Components.size() ; g++) {
+		ARE::VarElimOrderComp::Order & go = _Components[g]->_BestOrder ;
+		for (j = 0 ; j < go._nVars ; j++) 
+			_StitchedOrder[i++] = go._VarListInElimOrder[j] ;
+		if (W < go._Width) 
+			W = go._Width ;
+		if (MaxC < go._MaxSingleVarElimComplexity) 
+			MaxC = go._MaxSingleVarElimComplexity ;
+		C = AddTotals_Log10(C, go._Complexity_Log10) ;
+		S = AddTotals_Log10(S, go._TotalNewFunctionStorageAsNumOfElements_Log10) ;
+		nFillEdges += go._nFillEdges ;
+		}
+	if (i != _Problem->N()) 
+		return 0 ;
+	return NoteImprovement(w_IDX, _StitchedOrder.data(), W, MaxC, C, S, nFillEdges) ;
+}
 
-	if (G._VarElimOrderWidth >= 0 && G._VarElimOrderWidth < 1024) {
-		_Width2CountMap[G._VarElimOrderWidth]++ ;
-		if (_Width2MaxComplexityMap[G._VarElimOrderWidth] > G._TotalVarElimComplexity_Log10) 
-			_Width2MaxComplexityMap[G._VarElimOrderWidth] = G._TotalVarElimComplexity_Log10 ;
-		if (_Width2MaxComplexityMap[G._VarElimOrderWidth] < G._TotalVarElimComplexity_Log10) 
-			_Width2MaxComplexityMap[G._VarElimOrderWidth] = G._TotalVarElimComplexity_Log10 ;
+
+bool ARE::VarElimOrderComp::CVOcontext::NoteWidthLowerBound(int LB, char Algorithm)
+{
+	int lb = _WidthLowerBound.load() ;
+	bool improved = false ;
+	while (LB > lb) {
+		if (_WidthLowerBound.compare_exchange_weak(lb, LB)) 
+			{ improved = true ; break ; }
+		}
+	if (improved) {
+		ARE::utils::AutoLock lock(_BestOrderMutex) ;
+		if (_BestOrder->_WidthLowerBound < LB) 
+			_BestOrder->_WidthLowerBound = LB ;
+		if (NULL != _fpLOG) {
+			int64_t tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(_fpLOG, "\n%I64d lower_bound=%d (algorithm=%d)", tNow, LB, (int) Algorithm) ;
+			fflush(_fpLOG) ;
+			}
 		}
+	if (! WidthLowerBoundMet()) 
+		return false ;
+	if (improved) {
+		if (NULL != _fpLOG) {
+			int64_t tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(_fpLOG, "\n%I64d lower bound %d is equal to the best width; will stop ...", tNow, LB) ;
+			fflush(_fpLOG) ;
+			}
+		}
+	_Scheduler.Cancel() ;
+	return true ;
+}
 
+
+int ARE::VarElimOrderComp::CVOcontext::NoteVarOrderComputationCompletion(int w_IDX, ARE::Graph & G)
+{
+	if (G._OrderLength != _Problem->N()) {
+		int error = 1 ;
+		return 1 ;
+		}
+	NoteRun(G._VarElimOrderWidth, G._TotalVarElimComplexity_Log10) ;
+	NoteImprovement(w_IDX, G) ;
 	return 0 ;
 }
 
 
-#if defined WINDOWS || _WINDOWS
-typedef unsigned int (__stdcall *pWorkerThreadFn)(void *X) ;
-static unsigned int __stdcall WorkerThreadFn(void *X) 
-#elif defined (LINUX)
-typedef void *(*pWorkerThreadFn)(void *X) ;
-static void *WorkerThreadFn(void *X)
-#endif 
+int32_t ARE::VarElimOrderComp::RunTask::Execute(int32_t ThreadIdx)
 {
-	ARE::VarElimOrderComp::Worker *w = (ARE::VarElimOrderComp::Worker *) X;
-	ARE::VarElimOrderComp::CVOcontext & CVOcontext = *(w->_CVOcontext) ;
-	ARE::ARP & Problem = *(CVOcontext._Problem) ;
-	ARE::VarElimOrderComp::Order & best_order = *(CVOcontext._BestOrder) ;
-
-	// initialize best order to something bad; we don't want anything worse than that.
-	int bestWidth = 255 ;
-	double bestComplexity = DBL_MAX ;
-	{
-	ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
-	bestWidth = best_order._Width ;
-	bestComplexity = best_order._Complexity_Log10 ;
-	}
+	ARE::VarElimOrderComp::Worker *w = _Workers + ThreadIdx ;
+	ARE::VarElimOrderComp::CVOcontext & CVOcontext = *_CVOcontext ;
 
 	int64_t tNow = 0 ;
-	int res ;
+	int res = 1 ;
 
-	if (NULL != CVOcontext._fpLOG) {
+	if (w->_ThreadStop || _nRuns <= 0) 
+		return 0 ;
+	if (CVOcontext._nRunsStarted >= CVOcontext._nRunsToDoMax) 
+		goto out_of_runs ;
+	if (CVOcontext.WidthLowerBoundMet()) 
+		goto out_of_runs ;
+	if (CVOcontext._tToStop > 0) {
 		tNow = ARE::GetTimeInMilliseconds() ;
-		fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d start; objCode=%d alg=%d ...", tNow, (int) w->_IDX, (int) CVOcontext._ObjCode, (int) CVOcontext._AlgCode) ;
-		fflush(CVOcontext._fpLOG) ;
+		if (tNow >= CVOcontext._tToStop) 
+			goto out_of_runs ;
+		}
+
+	// give half of the runs to idle threads
+	if (_nRuns > 1) {
+		int n = _nRuns >> 1 ;
+		ARE::VarElimOrderComp::RunTask *t = new ARE::VarElimOrderComp::RunTask(_CVOcontext, _Workers, _AlgCode, _nRandomPick, _eRandomPick, n) ;
+		if (NULL != t) {
+			if (0 == CVOcontext._Scheduler.Submit(t)) 
+				_nRuns -= n ;
+			else 
+				delete t ;
+			}
+		}
+	--_nRuns ;
+
+	{
+	// if the search is split into groups of components, the run is on the graph of one group, and is compared with the best order of the group.
+	// a worker stays on its group for a batch of runs, since only then its graph can be restored from the journal; it picks again when 
+	// the batch is done, or when its group is at the lower bound.
+	int component = -1 ;
+	if (CVOcontext._Components.size() > 0) {
+		if (w->_nComponentRunsLeft <= 0 || w->_Component < 0 || w->_Component >= (int) CVOcontext._Components.size() || CVOcontext.ComponentIsAtWidthLowerBound(w->_Component)) {
+			w->_Component = CVOcontext.PickComponent(w->_G->RNG()) ;
+			w->_nComponentRunsLeft = CVOcontext._ComponentRunBatch ;
+			}
+		--(w->_nComponentRunsLeft) ;
+		component = w->_Component ;
+		}
+	const ARE::Graph & source = component >= 0 ? CVOcontext._Components[component]->_G : CVOcontext._MasterGraph ;
+	// don't want anything worse than the best order so far.
+	uint64_t bestScore = component >= 0 ? CVOcontext._Components[component]->_BestScore.load() : CVOcontext._BestScore.load() ;
+	int bestWidth = CVOcontext.ScoreWidth(bestScore) ;
+	double bestComplexity = CVOcontext.ScoreComplexity(bestScore) ;
+
+	++(w->_nRunsDone) ;
+#if defined WINDOWS || _WINDOWS
+	long v = InterlockedIncrement(&(CVOcontext._nRunsStarted)) ;
+#else
+	pthread_mutex_lock(&nRunsSumMutex) ;
+	long v = ++CVOcontext._nRunsStarted ;
+	pthread_mutex_unlock(&nRunsSumMutex) ;
+#endif
+	if (0 == (v % CVOcontext._LogIncrement)) {
+		if (NULL != CVOcontext._fpLOG) {
+			tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d will do run %d ...", tNow, (int) w->_IDX, (int) v) ;
+			fflush(CVOcontext._fpLOG) ;
+			}
 		}
 
 	try {
-		*(w->_G) = CVOcontext._MasterGraph ;
+		if (CVOcontext._UseJournaledGraphRestore) 
+			w->_G->RestoreFrom(source) ;
+		else 
+			*(w->_G) = source ;
 		if (! w->_G->_IsValid) 
-			goto done ;
+			return 0 ;
 		}
 	catch (...) {
 		if (NULL != CVOcontext._fpLOG) {
 			tNow = ARE::GetTimeInMilliseconds() ;
-			fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d prep0 exception ...", tNow, (int) w->_IDX) ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d worker %d prep exception ...", tNow, (int) w->_IDX) ;
 			fflush(CVOcontext._fpLOG) ;
 			}
+		return 0 ;
 		}
 
-	int nCompleteRunsTodo ; nCompleteRunsTodo = 3 ;
-	while (! w->_ThreadStop) {
-		tNow = 0 ;
-		++(w->_nRunsDone) ;
-#if defined WINDOWS || _WINDOWS
-		long v = InterlockedIncrement(&(CVOcontext._nRunsStarted)) ;
-#else
-		pthread_mutex_lock(&nRunsSumMutex) ;
-		long v = ++CVOcontext._nRunsStarted ;
-		pthread_mutex_unlock(&nRunsSumMutex) ;
-#endif
-		if (0 == (v % CVOcontext._LogIncrement)) {
-			if (NULL != CVOcontext._fpLOG) {
-				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d will do run %d ...", tNow, (int) w->_IDX, (int) v) ;
-				fflush(CVOcontext._fpLOG) ;
-				}
-			}
-// DEBUGGG
-//printf("\nworker %d starting; nRunsSum=%d ...", (int) w->_IDX, (int) v) ;
-		try {
-			bool earlyTerminationOk = nCompleteRunsTodo-- > 0 ? false : true ;
-			int widthLimit = bestWidth ;
-			if (CVOcontext._FindPracticalVariableOrder && widthLimit > CVOcontext._PracticalOrderLimit_W) 
-				widthLimit = CVOcontext._PracticalOrderLimit_W ;
-			int spaceLimit = bestComplexity ;
-			if (CVOcontext._FindPracticalVariableOrder && spaceLimit > CVOcontext._PracticalOrderLimit_C) 
-				spaceLimit = CVOcontext._PracticalOrderLimit_C ;
+	try {
+		bool earlyTerminationOk = w->_nCompleteRunsTodo-- > 0 ? false : true ;
+		int widthLimit = bestWidth ;
+		if (CVOcontext._FindPracticalVariableOrder && widthLimit > CVOcontext._PracticalOrderLimit_W) 
+			widthLimit = CVOcontext._PracticalOrderLimit_W ;
+		int spaceLimit = bestComplexity ;
+		if (CVOcontext._FindPracticalVariableOrder && spaceLimit > CVOcontext._PracticalOrderLimit_C) 
+			spaceLimit = CVOcontext._PracticalOrderLimit_C ;
 // 2014-03-21 KK : even if MinFill algorithm is used, run Simple(), not Simple_wMinFillOnly(), because Simple() will compute complexity also, as so we can try to minimize complexity too.
-//			if (ARE::VarElimOrderComp::MinFill == CVOcontext._AlgCode) 
-//				res = w->_G->ComputeVariableEliminationOrder_Simple_wMinFillOnly(widthLimit, earlyTerminationOk && CVOcontext._EarlyTerminationOfBasic_W, false, 1, CVOcontext._nRandomPick, CVOcontext._eRandomPick, w->_TempAdjVarSpace, TempAdjVarSpaceSize) ;
-//			else 
-				res = w->_G->ComputeVariableEliminationOrder_Simple(CVOcontext._AlgCode, widthLimit, earlyTerminationOk && CVOcontext._EarlyTerminationOfBasic_W, spaceLimit, earlyTerminationOk && CVOcontext._EarlyTerminationOfBasic_C, false, 1, CVOcontext._nRandomPick, CVOcontext._eRandomPick, w->_TempAdjVarSpaceSizeExtraArrayN, w->_TempAdjVarSpaceSizeExtraArray) ;
-// DEBUGGG_AAA
-//ARE::VarElimOrderComp::DeleteNewAdjVarList(w->_TempAdjVarSpaceSizeExtraArrayN, w->_TempAdjVarSpaceSizeExtraArray) ;
-			}
-		catch (...) {
-			if (NULL != CVOcontext._fpLOG) {
-				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d exception ...", tNow, (int) w->_IDX) ;
-				fflush(CVOcontext._fpLOG) ;
-				goto done ;
-				}
+		res = w->_G->ComputeVariableEliminationOrder_Simple(_AlgCode, widthLimit, earlyTerminationOk && CVOcontext._EarlyTerminationOfBasic_W, spaceLimit, earlyTerminationOk && CVOcontext._EarlyTerminationOfBasic_C, false, 1, _nRandomPick, _eRandomPick, w->_TempAdjVarSpaceSizeExtraArrayN, w->_TempAdjVarSpaceSizeExtraArray) ;
+		}
+	catch (...) {
+		if (NULL != CVOcontext._fpLOG) {
+			tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d worker %2d exception ...", tNow, (int) w->_IDX) ;
+			fflush(CVOcontext._fpLOG) ;
 			}
-// DEBUGGG
-//		printf("\nworker %d finished res=%d; width=%d complexity=%I64d", (int) w->_IDX, (int) res, (int) w->_G->_VarElimOrderWidth, (int64_t) w->_G->_TotalVarElimComplexity) ;
-//		if (NULL != CVOcontext._fpLOG) {
-//			fprintf(CVOcontext._fpLOG, "\nworker %d finished res=%d; width=%d complexity=%I64d", (int) w->_IDX, (int) res, (int) w->_G->_VarElimOrderWidth, (int64_t) w->_G->_TotalVarElimComplexity) ;
-//			fflush(CVOcontext._fpLOG) ;
-//			}
+		return 0 ;
+		}
+	if (w->_ThreadStop) 
+		return 0 ; // if stop requested, abandon
+	if (0 != res || w->_G->_OrderLength != CVOcontext._Problem->N()) 
+		goto next_run ;
+	// only a run that beats the best score so far locks, to store its order. runs of a group are not an order of the whole graph, so they are not in the statistics.
+	if (component >= 0) {
+		if (! CVOcontext.IsBetter(w->_G->_VarElimOrderWidth, w->_G->_TotalVarElimComplexity_Log10, bestWidth, bestComplexity)) 
+			goto next_run ;
+		}
+	else {
+		w->_Stats.NoteRun(w->_G->_VarElimOrderWidth, w->_G->_TotalVarElimComplexity_Log10) ;
+		if (! CVOcontext.OfferScore(w->_G->_VarElimOrderWidth, w->_G->_TotalVarElimComplexity_Log10)) 
+			goto next_run ;
+		}
+	try {
+		ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
 		if (w->_ThreadStop) 
-			goto done ; // if stop requested, abandon
-		try {
-			ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
-			if (w->_ThreadStop) 
-				goto done ; // if stop requested, abandon
-//GetCurrentDTmsec(strDT, tNow) ;
-//printf("\n%s worker %2d found width=%d complexity=%I64d space(#elements)=%I64d res=%d", strDT, (int) w->_IDX, (int) w->_G->_VarElimOrderWidth, (int64_t) w->_G->_TotalVarElimComplexity, (int64_t) w->_G->_TotalNewFunctionStorageAsNumOfElements, (int) res) ;
-			if (0 == res) {
-				CVOcontext.NoteVarOrderComputationCompletion(w->_IDX, *(w->_G)) ;
-				}
-			else {
-				// DEBUGGG
-//				printf("\nThread %d res=%d", w->_IDX, res) ;
-				}
-			bestWidth = best_order._Width ;
-			bestComplexity = best_order._Complexity_Log10 ;
-			if (CVOcontext._nRunsStarted >= CVOcontext._nRunsToDoMax) {
-// DEBUGGG
-//				printf("\nworker %d out of runs (%d >= %d) ...", (int) w->_IDX, (int) nRunsSum, (int) CVOcontext._nRunsToDoMax) ;
-				goto done ;
-				}
-			if (CVOcontext._tToStop > 0) {
-				if (0 == tNow) tNow = ARE::GetTimeInMilliseconds() ;
-				if (tNow >= CVOcontext._tToStop) {
-// DEBUGGG
-//					printf("\nworker %d out of time ...", (int) w->_IDX) ;
-					goto done ;
-					}
-				}
+			return 0 ; // if stop requested, abandon
+		if (component >= 0) 
+			CVOcontext.NoteComponentRun(w->_IDX, component, *(w->_G)) ;
+		else 
+			CVOcontext.NoteImprovement(w->_IDX, *(w->_G)) ;
+		}
+	catch (...) {
+		if (NULL != CVOcontext._fpLOG) {
+			tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d worker %d summary exception ...", tNow, (int) w->_IDX) ;
+			fflush(CVOcontext._fpLOG) ;
+			}
+		}
+	}
+
+next_run :
+	// put this task back in the queue, so that other tasks of this thread get a turn.
+	return _nRuns > 0 ? 1 : 0 ;
+out_of_runs :
+	// drop runs not started yet, so that the CVO thread does not wait for them.
+	CVOcontext._Scheduler.Cancel() ;
+	return 0 ;
+}
 
+
+int32_t ARE::VarElimOrderComp::LowerBoundTask::Execute(int32_t /* ThreadIdx */)
+{
+	ARE::VarElimOrderComp::CVOcontext & CVOcontext = *_CVOcontext ;
+	if (_nRepetitions <= 0 || CVOcontext.WidthLowerBoundMet()) 
+		return 0 ;
+	if (0 == _nRepetitionsDone) {
+		if (0 != _LB.Initialize(CVOcontext._MasterGraph)) 
+			return 0 ;
+		if (CVOcontext._RandomGeneratorSeed > 0) 
+			_RNG.seed(CVOcontext._RandomGeneratorSeed + _IDX) ; // set seed so that bounds can be duplicated
+		}
+	else {
+		// more repetitions are of no use when the search is over.
+		if (0 != CVOcontext._StopAndExit || CVOcontext._nRunsStarted >= CVOcontext._nRunsToDoMax) 
+			return 0 ;
+		if (CVOcontext._tToStop > 0 && ARE::GetTimeInMilliseconds() >= CVOcontext._tToStop) 
+			return 0 ;
+		}
+
+	// the bound cannot be better than the best width.
+	int lb = -1 ;
+	int target = CVOcontext.ScoreWidth(CVOcontext._BestScore.load()) ;
+	if (0 != _LB.Compute(_Algorithm, _RNG, target, lb)) 
+		return 0 ;
+	--_nRepetitions ;
+	++_nRepetitionsDone ;
+	if (CVOcontext.NoteWidthLowerBound(lb, _Algorithm)) 
+		return 0 ;
+	return _nRepetitions > 0 ? 1 : 0 ;
+}
+
+
+int32_t ARE::VarElimOrderComp::ExactSearchTask::Execute(int32_t /* ThreadIdx */)
+{
+	ARE::VarElimOrderComp::CVOcontext & CVOcontext = *_CVOcontext ;
+	if (Width != CVOcontext._ObjCode || CVOcontext.WidthLowerBoundMet()) 
+		return 0 ;
+	// vars to ignore are not part of the width of an order; this search does not know about them.
+	if (CVOcontext._MasterGraph._nIgnoreVariables > 0) 
+		return 0 ;
+	if (0 != _ET.Initialize(CVOcontext._MasterGraph) || _ET.nNodes() <= 0 || _ET.nNodes() > CVOcontext._ExactSearchMaxNodes) 
+		return 0 ;
+	_ET.SetMemoryLimit(((int64_t) CVOcontext._ExactSearchMemoryLimitInMB) << 20) ;
+	_ET.SetStopFunction([&CVOcontext](void) -> bool {
+		if (0 != CVOcontext._StopAndExit || CVOcontext._nRunsStarted >= CVOcontext._nRunsToDoMax || CVOcontext.WidthLowerBoundMet()) 
+			return true ;
+		return CVOcontext._tToStop > 0 && ARE::GetTimeInMilliseconds() >= CVOcontext._tToStop ;
+		}) ;
+
+	std::vector<int32_t> order ;
+	int64_t tNow ;
+	while (true) {
+		// widths of the graph and of vars already ordered are separate; the width of the order is the max of the two.
+		int k = CVOcontext._WidthLowerBound.load() ;
+		if (k < _ET.BaseWidth()) 
+			k = _ET.BaseWidth() ;
+		if (k >= CVOcontext.ScoreWidth(CVOcontext._BestScore.load())) 
+			return 0 ;
+		int32_t res = _ET.Decide(k, order) ;
+		if (NULL != CVOcontext._fpLOG) {
+			tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d exact search width=%d : res=%d nStates=%I64d nFailedStates=%I64d", tNow, k, (int) res, (int64_t) _ET.nStatesExpanded(), (int64_t) _ET.nFailedStates()) ;
+			fflush(CVOcontext._fpLOG) ;
 			}
-		catch (...) {
-			if (NULL != CVOcontext._fpLOG) {
-				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(CVOcontext._fpLOG, "\n%I64d worker %d summary exception ...", tNow, (int) w->_IDX) ;
-				fflush(CVOcontext._fpLOG) ;
-				}
+		if (res < 0) 
+			return 0 ;
+		if (0 == res) {
+			// no order of width k
+			if (CVOcontext.NoteWidthLowerBound(k + 1, -1)) 
+				return 0 ;
+			continue ;
 			}
-
-		if (w->_ThreadStop) 
-			goto done ; // if stop requested, abandon
+		// the order is optimal, since there is none of width k-1 (k is a lower bound).
 		try {
-			*(w->_G) = CVOcontext._MasterGraph ;
+			ARE::Graph g ;
+			g = CVOcontext._MasterGraph ;
+			if (! g._IsValid || 0 != _ET.AppendOrder(g, order)) 
+				return 0 ;
+			ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
+			CVOcontext.NoteImprovement(-1, g) ;
 			}
 		catch (...) {
 			if (NULL != CVOcontext._fpLOG) {
 				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(CVOcontext._fpLOG, "\n%I64d worker %d prep exception ...", tNow, (int) w->_IDX) ;
+				fprintf(CVOcontext._fpLOG, "\n%I64d exact search summary exception ...", tNow) ;
 				fflush(CVOcontext._fpLOG) ;
 				}
+			return 0 ;
 			}
+		CVOcontext.NoteWidthLowerBound(k, -1) ;
+		return 0 ;
 		}
+}
 
-done :
-	if (NULL != CVOcontext._fpLOG) {
-		tNow = ARE::GetTimeInMilliseconds() ;
-		fprintf(CVOcontext._fpLOG, "\n%I64d worker %d done ...", tNow, (int) w->_IDX) ;
-		fflush(CVOcontext._fpLOG) ;
+
+int32_t ARE::VarElimOrderComp::LocalSearchTask::Execute(int32_t /* ThreadIdx */)
+{
+	ARE::VarElimOrderComp::CVOcontext & CVOcontext = *_CVOcontext ;
+	if (Width != CVOcontext._ObjCode || CVOcontext.WidthLowerBoundMet()) 
+		return 0 ;
+	if (0 != CVOcontext._StopAndExit || CVOcontext._nRunsStarted >= CVOcontext._nRunsToDoMax) 
+		return 0 ;
+	if (CVOcontext._tToStop > 0 && ARE::GetTimeInMilliseconds() >= CVOcontext._tToStop) 
+		return 0 ;
+	if (0 == _nSlices++) {
+		// vars to ignore are not part of the width of an order; this search does not know about them.
+		if (CVOcontext._MasterGraph._nIgnoreVariables > 0) 
+			return 0 ;
+		if (0 != _LS.Initialize(CVOcontext._MasterGraph) || _LS.nNodes() < 2 || _LS.nNodes() > CVOcontext._LocalSearchMaxNodes) 
+			return 0 ;
+		_LS.SetMemoryLimit(((int64_t) CVOcontext._LocalSearchMemoryLimitInMB) << 20) ;
+		_LS.SetStopFunction([this, &CVOcontext](void) -> bool {
+			if (0 != CVOcontext._StopAndExit || CVOcontext.WidthLowerBoundMet()) 
+				return true ;
+			return ARE::GetTimeInMilliseconds() >= _tSliceEnd ;
+			}) ;
+		if (CVOcontext._RandomGeneratorSeed > 0) 
+			_RNG.seed(CVOcontext._RandomGeneratorSeed) ; // set seed so that results can be duplicated
+		}
+
+	// widths of the graph and of vars already ordered are separate; the width of the order is the max of the two.
+	int bestWidth = CVOcontext.ScoreWidth(CVOcontext._BestScore.load()) ;
+	if (_LS.Width() < 0 || (_LS.Width() > _LS.BaseWidth() ? _LS.Width() : _LS.BaseWidth()) > bestWidth) {
+		ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
+		if (0 != _LS.SetOrder(CVOcontext._BestOrder->_VarListInElimOrder, CVOcontext._Problem->N())) 
+			return 0 ;
+		}
+	if (_LS.Width() <= _LS.BaseWidth()) 
+		return 0 ; // the order of the graph is as good as it gets
+	_tSliceEnd = ARE::GetTimeInMilliseconds() + 50 ;
+	if (CVOcontext._tToStop > 0 && _tSliceEnd > CVOcontext._tToStop) 
+		_tSliceEnd = CVOcontext._tToStop ;
+	if (0 != _LS.Improve(_RNG, INT64_MAX)) 
+		return 0 ;
+	if ((_LS.Width() > _LS.BaseWidth() ? _LS.Width() : _LS.BaseWidth()) >= CVOcontext.ScoreWidth(CVOcontext._BestScore.load())) 
+		return 1 ;
+
+	try {
+		ARE::Graph g ;
+		g = CVOcontext._MasterGraph ;
+		if (! g._IsValid || 0 != _LS.AppendOrder(g)) 
+			return 0 ;
+		if (NULL != CVOcontext._fpLOG) {
+			int64_t tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d local search width=%d : nMoves=%I64d nMovesKept=%I64d", tNow, (int) g._VarElimOrderWidth, (int64_t) _LS.nMoves(), (int64_t) _LS.nMovesKept()) ;
+			fflush(CVOcontext._fpLOG) ;
+			}
+		ARE::utils::AutoLock lock(CVOcontext._BestOrderMutex) ;
+		CVOcontext.NoteImprovement(-1, g) ;
 		}
-	w->_ThreadHandle = 0 ;
-	w->_ThreadIsRunning = false ;
-#if defined WINDOWS || _WINDOWS
-	_endthreadex(0) ;
-	return 0  ;
-#else
-	return NULL ;
-#endif
+	catch (...) {
+		if (NULL != CVOcontext._fpLOG) {
+			int64_t tNow = ARE::GetTimeInMilliseconds() ;
+			fprintf(CVOcontext._fpLOG, "\n%I64d local search summary exception ...", tNow) ;
+			fflush(CVOcontext._fpLOG) ;
+			}
+		return 0 ;
+		}
+	return 1 ;
 }
 
 
@@ -292,12 +695,12 @@ static void *CVOThreadFn(void *X)
 
 	ARE::VarElimOrderComp::Worker *Workers = NULL ;
 
-	int nRunning, nWrunning ;
 	long stop_signalled = 0 ;
 
 	char strDT[64] ;
 	int64_t tNow = 0 ; // ARE::GetTimeInMilliseconds() ;
 	GetCurrentDTmsec(strDT, tNow) ;
+	int64_t tPhaseStart = tNow ;
 	if (NULL != context->_fpLOG) {
 		fprintf(context->_fpLOG, "\n%s CVO control thread; start preprocessing ...", strDT) ;
 		fflush(context->_fpLOG) ;
@@ -317,11 +720,18 @@ static void *CVOThreadFn(void *X)
 	// create problem graph
 	if (context->_RandomGeneratorSeed > 0) 
 		OriginalGraph.RNG().seed(context->_RandomGeneratorSeed) ; // set seed so that starting point can be duplicated
-	OriginalGraph.Create(p) ;
+	tPhaseStart = ARE::GetTimeInMilliseconds() ;
+	OriginalGraph.Create(p, nWorkers) ;
 	if (! OriginalGraph._IsValid) {
 		ret = 1001 ;
 		goto done ;
 		}
+	tNow = 0 ;
+	GetCurrentDTmsec(strDT, tNow) ;
+	if (NULL != context->_fpLOG) {
+		fprintf(context->_fpLOG, "\n%s CVO control thread; graph created in %lldmsec; N=%d E=%lld nThreads=%d ...", strDT, (long long) (tNow - tPhaseStart), (int) OriginalGraph._nNodes, (long long) OriginalGraph._nEdges, nWorkers) ;
+		fflush(context->_fpLOG) ;
+		}
 
 	// do all the easy eliminations; this will give us a starting point for large-scale randomized searches later.
 	tNow = ARE::GetTimeInMilliseconds() ;
@@ -347,12 +757,49 @@ static void *CVOThreadFn(void *X)
 		ret = 0 ;
 		goto done ;
 		}
+	// reduction rules keep the best width, but not complexity; so only when minimizing width. the lower bound they start from is noted too.
+	if (context->_SafeReductions && ARE::VarElimOrderComp::Width == context->_ObjCode && 0 == MasterGraph._nIgnoreVariables) {
+		ARE::WidthLowerBound lb ;
+		ARE::SafeReductions sr ;
+		MTRand rng ;
+		if (context->_RandomGeneratorSeed > 0) 
+			rng.seed(context->_RandomGeneratorSeed) ;
+		int low = -1, nOrdered = MasterGraph._OrderLength ;
+		if (0 != lb.Initialize(MasterGraph) || 0 != lb.Compute(ARE::WidthLowerBound::MinorMinWidth, rng, -1, low)) 
+			low = -1 ;
+		if (0 == sr.Initialize(MasterGraph, low) && 0 == sr.Reduce()) {
+			if (sr.Order().size() > 0) 
+				i = MasterGraph.EliminateVariables(sr.Order().data(), sr.Order().size(), context->_TempAdjVarSpaceSizeExtraArrayN, context->_TempAdjVarSpaceSizeExtraArray) ;
+			if (NULL != context->_fpLOG) {
+				tNow = ARE::GetTimeInMilliseconds() ;
+				fprintf(context->_fpLOG, "\n%I64d CVO control thread; safe reductions : %d vars eliminated (simplicial=%d almost_simplicial=%d buddy=%d cube=%d safe_separator_edges=%d), lower_bound=%d ...", 
+					tNow, (int) (MasterGraph._OrderLength - nOrdered), (int) sr._nSimplicial, (int) sr._nAlmostSimplicial, (int) sr._nBuddy, (int) sr._nCube, (int) sr._nSafeEdges, (int) sr.LowerBound()) ;
+				fflush(context->_fpLOG) ;
+				}
+			context->NoteWidthLowerBound(sr.LowerBound(), ARE::WidthLowerBound::MinorMinWidth) ;
+			}
+		if (MasterGraph._OrderLength >= MasterGraph._nNodes) {
+			context->NoteVarOrderComputationCompletion(-1, MasterGraph) ;
+			ret = 0 ;
+			goto done ;
+			}
+		}
 // DEBUGGG_AAA
 //ARE::VarElimOrderComp::DeleteNewAdjVarList(context->_TempAdjVarSpaceSizeExtraArrayN, context->_TempAdjVarSpaceSizeExtraArray) ;
 	MasterGraph.ReAllocateEdges() ;
+	// copies of the master graph use the same adjacency engine.
+	if (0 != MasterGraph.SetAdjacencyEngine(context->_GraphAdjacencyEngine)) {
+		if (NULL != context->_fpLOG) {
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; failed to switch to graph adjacency engine %d, will continue ...", tNow, (int) context->_GraphAdjacencyEngine) ;
+			fflush(context->_fpLOG) ;
+			}
+		}
+	MasterGraph._BitsetEngineThreshold = context->_BitsetAdjacencyThreshold ;
 	tNow = ARE::GetTimeInMilliseconds() ;
+	context->_dtGraphBuild = tNow - tPhaseStart ;
 	if (NULL != context->_fpLOG) {
 		fprintf(context->_fpLOG, "\n%I64d CVO control thread; %d vars eliminated, %d remaining ...", tNow, (int) MasterGraph._OrderLength, (int) MasterGraph._nRemainingNodes) ;
+		fprintf(context->_fpLOG, "\n%I64d CVO control thread; graph built in %lldmsec ...", tNow, (long long) context->_dtGraphBuild) ;
 		fflush(context->_fpLOG) ;
 		}
 
@@ -364,29 +811,31 @@ static void *CVOThreadFn(void *X)
 		fflush(context->_fpLOG) ;
 		}
 
-	{
-	ARE::Graph *g = new ARE::Graph ;
-	if (NULL == g) 
-		{ ret = 1003 ; goto done ; }
-	*g = MasterGraph ;
-	if (g->_IsValid) {
-		if (context->_RandomGeneratorSeed > 0) 
-			g->RNG().seed(context->_RandomGeneratorSeed) ; // set seed so that starting point can be duplicated
-		i = g->ComputeVariableEliminationOrder_LowerBound() ;
-		best_order._WidthLowerBound = g->_VarElimOrderWidth ;
+	// start the thread pool; the lower bound is computed by it, while this thread does the initial run.
+	if (0 != context->_Scheduler.Start(nWorkers)) {
+		ret = 1003 ;
 		if (NULL != context->_fpLOG) {
-			fprintf(context->_fpLOG, "\n%s lower_bound=%d", strDT, (int) best_order._WidthLowerBound) ;
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; failed to start thread pool, will quit ...", tNow) ;
 			fflush(context->_fpLOG) ;
 			}
+		goto done ;
+		}
+	// lower bounds : MMD once, since it is not randomized much; minor-min-width and MMD+(least-c) with randomized repetitions, one task per pool thread (at least one of each).
+	for (i = 0 ; i <= (nWorkers > 2 ? nWorkers : 2) ; i++) {
+		char algorithm = 0 == i ? ARE::WidthLowerBound::MMD : (1 == (i & 1) ? ARE::WidthLowerBound::LeastC : ARE::WidthLowerBound::MinorMinWidth) ;
+		ARE::VarElimOrderComp::LowerBoundTask *lbt = new ARE::VarElimOrderComp::LowerBoundTask(context, algorithm, 0 == i ? 1 : context->_nLowerBoundRepetitions, i) ;
+		if (NULL == lbt) 
+			{ ret = 1003 ; goto done ; }
+		if (0 != context->_Scheduler.Submit(lbt)) 
+			delete lbt ;
 		}
-	delete g ;
-	}
 
 	// if strictly best order (whatever the width/complexity) is required, execute one run here to get some real bound on width/complexity.
 	// when we launch multi-threaded search for good order, knowing a decent bound will help the threads right away.
 	// when we want a practical order, width/complexity limits are (should be) quite low.
 	best_order._Width = p.N() ;
 	best_order._Complexity_Log10 = DBL_MAX ;
+	context->_BestScore = context->PackScore(best_order._Width, best_order._Complexity_Log10) ;
 	// 2015-12-14 KK : do this always, so that we have some result (order); we may quite quickly, and if we did  not run this, we may have nothing.
 //	if (! context->_FindPracticalVariableOrder) {
 		{
@@ -397,17 +846,39 @@ static void *CVOThreadFn(void *X)
 				g.RNG().seed(context->_RandomGeneratorSeed) ; // set seed so that starting point can be duplicated
 			int widthLimit = INT_MAX ;
 			double spaceLimit = DBL_MAX ;
+			tPhaseStart = ARE::GetTimeInMilliseconds() ;
 			i = g.ComputeVariableEliminationOrder_Simple(0, widthLimit, false, spaceLimit, false, false, 10, 1, 0.0, context->_TempAdjVarSpaceSizeExtraArrayN, context->_TempAdjVarSpaceSizeExtraArray) ;
 			++context->_nRunsStarted ;
 			tNow = 0 ;
 			GetCurrentDTmsec(strDT, tNow) ;
+			context->_dtFirstOrder = tNow - tPhaseStart ;
 			if (0 == i) {
 				if (NULL != context->_fpLOG) {
-					fprintf(context->_fpLOG, "\n%s Initial computation width=%d; MaxSingleVarElimComplexity=%g, TotalVarElimComplexity=%g, TotalNewFunctionStorageAsNumOfElements=%g", strDT, (int) g._VarElimOrderWidth, (double) g._MaxVarElimComplexity_Log10, (double) g._TotalVarElimComplexity_Log10, (double) g._TotalNewFunctionStorageAsNumOfElements_Log10) ;
+					fprintf(context->_fpLOG, "\n%s Initial computation width=%d; MaxSingleVarElimComplexity=%g, TotalVarElimComplexity=%g, TotalNewFunctionStorageAsNumOfElements=%g; time=%lldmsec", strDT, (int) g._VarElimOrderWidth, (double) g._MaxVarElimComplexity_Log10, (double) g._TotalVarElimComplexity_Log10, (double) g._TotalNewFunctionStorageAsNumOfElements_Log10, (long long) context->_dtFirstOrder) ;
 					fflush(context->_fpLOG) ;
 					}
+				{
+				ARE::utils::AutoLock lock(context->_BestOrderMutex) ;
 				context->NoteVarOrderComputationCompletion(-1, g) ;
 				}
+				// components of the master graph are searched separately, starting from this order; runs then go to the groups that decide the width.
+				if (context->_nRunsStarted < context->_nRunsToDoMax && ! context->WidthLowerBoundMet()) {
+					tPhaseStart = ARE::GetTimeInMilliseconds() ;
+					if (0 != context->CreateComponentSearches(g._VarElimOrder)) {
+						if (NULL != context->_fpLOG) {
+							fprintf(context->_fpLOG, "\n%I64d CVO control thread; failed to split graph into components, will search it as a whole ...", tPhaseStart) ;
+							fflush(context->_fpLOG) ;
+							}
+						}
+					else if (context->_Components.size() > 0 && NULL != context->_fpLOG) {
+						tNow = ARE::GetTimeInMilliseconds() ;
+						fprintf(context->_fpLOG, "\n%I64d CVO control thread; graph split into %d groups of components in %lldmsec; sizes :", tNow, (int) context->_Components.size(), (long long) (tNow - tPhaseStart)) ;
+						for (i = 0 ; i < (int) context->_Components.size() ; i++) 
+							fprintf(context->_fpLOG, " %d(width=%d)", context->_Components[i]->_nNodes, context->_Components[i]->_BestOrder._Width) ;
+						fflush(context->_fpLOG) ;
+						}
+					}
+				}
 			else {
 				if (NULL != context->_fpLOG) {
 					fprintf(context->_fpLOG, "\n%s Initial computation failed; res=%d; will continue ...", strDT, i) ;
@@ -419,6 +890,8 @@ static void *CVOThreadFn(void *X)
 
 	if (context->_nRunsStarted >= context->_nRunsToDoMax) 
 		goto done ;
+	if (context->WidthLowerBoundMet()) 
+		goto done ;
 #if defined WINDOWS || _WINDOWS
 	stop_signalled = InterlockedCompareExchange(&(context->_StopAndExit), 1, 1) ;
 #else
@@ -450,7 +923,7 @@ static void *CVOThreadFn(void *X)
 		}
 //goto done ;
 
-	// create workers; don't let them run yet
+	// create workers, one for each pool thread; runs are tasks (RunTask), done on the graph of the worker of the pool thread that runs them.
 	Workers = new ARE::VarElimOrderComp::Worker[nWorkers] ;
 	if (NULL == Workers) {
 		ret = 1004 ;
@@ -465,6 +938,7 @@ static void *CVOThreadFn(void *X)
 		Workers[i]._IDX = i ;
 		Workers[i]._G = new ARE::Graph ;
 		Workers[i]._CVOcontext = context ;
+		Workers[i]._ThreadStop = false ;
 		if (NULL == Workers[i]._G) {
 			ret = 1005 ;
 			goto done ;
@@ -473,42 +947,58 @@ static void *CVOThreadFn(void *X)
 
 	context->_LogIncrement = nRunsToDoMax/20 ;
 	if (context->_LogIncrement < 1) context->_LogIncrement = 1 ;
-	nWrunning = 0 ;
-	for (i = 0 ; i < nWorkers ; i++) {
-		Workers[i]._ThreadIsRunning = true ;
-		Workers[i]._ThreadStop = false ;
-#if defined WINDOWS || _WINDOWS
-		Workers[i]._ThreadHandle = _beginthreadex(NULL, 0, WorkerThreadFn, &(Workers[i]), 0, NULL) ;
-#else
-		pthread_create(&(Workers[i]._ThreadHandle), NULL, WorkerThreadFn, &(Workers[i])) ; // TODO third argument
-#endif 
-		if (0 == Workers[i]._ThreadHandle) {
-			Workers[i]._ThreadIsRunning = false ;
-			Workers[i]._ThreadStop = true ;
-			if (NULL != context->_fpLOG) {
-				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(context->_fpLOG, "\n%I64d CVO control thread; FAILED to create thread %d", tNow, i) ;
-				fflush(context->_fpLOG) ;
-				}
-			}
-		else 
-			nWrunning++ ;
-		}
-	if (0 == nWrunning) {
+	{
+	ARE::VarElimOrderComp::RunTask *rt = new ARE::VarElimOrderComp::RunTask(context, Workers, context->_AlgCode, context->_nRandomPick, context->_eRandomPick, nRunsToDoMax - context->_nRunsStarted) ;
+	if (NULL == rt || 0 != context->_Scheduler.Submit(rt)) {
+		if (NULL != rt) 
+			delete rt ;
 		if (NULL != context->_fpLOG) {
 			tNow = ARE::GetTimeInMilliseconds() ;
-			fprintf(context->_fpLOG, "\n%I64d CVO control thread; no worker threads, will quite ...", tNow) ;
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; failed to queue runs, will quit ...", tNow) ;
 			fflush(context->_fpLOG) ;
 			}
 		ret = 1006 ;
 		goto done ;
 		}
+	}
+	// exact search and local search each keep a pool thread for as long as they go on : exact search is not done in slices, and local search 
+	// yields only to tasks queued on its own thread, so the thread never steals runs queued on other threads. runs left in the deque of 
+	// such a thread are done only by threads that are free; so each is done only if runs keep at least half of the pool threads.
+	{
+	int nSearchThreads = 0 ;
+	// exact search, now that runs have given it an upper bound.
+	if (context->_ExactSearch && ARE::VarElimOrderComp::Width == context->_ObjCode && 2*(nSearchThreads + 1) <= nWorkers) {
+		ARE::VarElimOrderComp::ExactSearchTask *et = new ARE::VarElimOrderComp::ExactSearchTask(context) ;
+		if (NULL != et && 0 != context->_Scheduler.Submit(et)) 
+			delete et ;
+		else if (NULL != et) 
+			++nSearchThreads ;
+		}
+	// local search on the best order.
+	if (context->_LocalSearch && ARE::VarElimOrderComp::Width == context->_ObjCode && 2*(nSearchThreads + 1) <= nWorkers) {
+		ARE::VarElimOrderComp::LocalSearchTask *lst = new ARE::VarElimOrderComp::LocalSearchTask(context) ;
+		if (NULL != lst && 0 != context->_Scheduler.Submit(lst)) 
+			delete lst ;
+		else if (NULL != lst) 
+			++nSearchThreads ;
+		}
+	if (NULL != context->_fpLOG) {
+		tNow = ARE::GetTimeInMilliseconds() ;
+		fprintf(context->_fpLOG, "\n%I64d CVO control thread; pool threads kept by exact/local search : %d of %d", tNow, nSearchThreads, nWorkers) ;
+		fflush(context->_fpLOG) ;
+		}
+	}
 
-	// loop here waiting for stop signal of until all workers threads have exited
-	nRunning = -1 ;
-	stop_signalled = 0 ;
+	// wait until all tasks are done, or stop is signalled (RequestStopCVOthread() wakes us up), or time runs out.
 	while (true) {
-		SLEEP(50) ;
+		int64_t tWait = -1 ;
+		if (context->_tToStop > 0) {
+			tWait = context->_tToStop - ARE::GetTimeInMilliseconds() ;
+			if (tWait < 0) 
+				tWait = 0 ;
+			}
+		if (context->_Scheduler.Wait(tWait)) 
+			break ;
 #if defined WINDOWS || _WINDOWS
 		stop_signalled = InterlockedCompareExchange(&(context->_StopAndExit), 1, 1) ;
 #else
@@ -516,41 +1006,34 @@ static void *CVOThreadFn(void *X)
 		stop_signalled = context->_StopAndExit;
 		pthread_mutex_unlock(&stopSignalMutex);
 #endif
-		if (0 != stop_signalled) {
-			if (NULL != context->_fpLOG) {
-				tNow = ARE::GetTimeInMilliseconds() ;
-				fprintf(context->_fpLOG, "\n%I64d CVO control thread; stop_signalled ...", tNow) ;
-				fflush(context->_fpLOG) ;
-				}
-			}
-		nRunning = 0 ;
-		for (i = 0 ; i < nWorkers ; i++) {
-			if (0 == Workers[i]._ThreadHandle) continue ;
-			if (0 != stop_signalled) {
-				if (NULL != context->_fpLOG) {
-					tNow = ARE::GetTimeInMilliseconds() ;
-					fprintf(context->_fpLOG, "\n%I64d CVO control thread; stopping worker %d ...", tNow, i) ;
-					fflush(context->_fpLOG) ;
-					}
-				Workers[i]._ThreadStop = true ;
-				}
-			++nRunning ;
-			}
-		if (nRunning <= 0 || 0 != stop_signalled) 
-			break ;
-		}
-	// wait for threads to stop
-	while (nRunning > 0) {
-		SLEEP(50) ;
-		nRunning = 0 ;
-		for (i = 0 ; i < nWorkers ; i++) {
-			if (0 == Workers[i]._ThreadHandle) continue ;
-			++nRunning ;
+		tNow = ARE::GetTimeInMilliseconds() ;
+		if (0 == stop_signalled && (context->_tToStop <= 0 || tNow < context->_tToStop)) 
+			continue ;
+		if (NULL != context->_fpLOG) {
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; %s; stopping workers ...", tNow, 0 != stop_signalled ? "stop_signalled" : "out of time") ;
+			fflush(context->_fpLOG) ;
 			}
+		// runs in progress are abandoned as soon as they finish; runs not started yet are dropped.
+		for (i = 0 ; i < nWorkers ; i++) 
+			Workers[i]._ThreadStop = true ;
+		context->_Scheduler.Cancel() ;
+		context->_Scheduler.Wait(-1) ;
+		break ;
 		}
 	if (NULL != context->_fpLOG) {
 		tNow = ARE::GetTimeInMilliseconds() ;
-		fprintf(context->_fpLOG, "\n%I64d CVO control thread; all worker threads have closed ...", tNow) ;
+		fprintf(context->_fpLOG, "\n%I64d CVO control thread; all tasks done; nTasksExecuted=%I64d nTasksStolen=%I64d ...", tNow, (int64_t) context->_Scheduler._nTasksExecuted, (int64_t) context->_Scheduler._nTasksStolen) ;
+		fflush(context->_fpLOG) ;
+		}
+	if (NULL != context->_fpLOG) {
+		int64_t memWorkers = 0 ;
+		fprintf(context->_fpLOG, "\n%I64d CVO control thread; memory : original graph %I64d bytes, master graph %I64d bytes", tNow, OriginalGraph.MemoryUsage(), MasterGraph.MemoryUsage()) ;
+		for (i = 0 ; i < nWorkers ; i++) {
+			int64_t m = Workers[i].MemoryUsage() ;
+			memWorkers += m ;
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; memory : worker %d %I64d bytes (graph %I64d bytes, fill edge buffer %d edges)", tNow, i, m, NULL != Workers[i]._G ? Workers[i]._G->MemoryUsage() : 0, NULL != Workers[i]._G ? (int) Workers[i]._G->_EdgeBufferSize : 0) ;
+			}
+		fprintf(context->_fpLOG, "\n%I64d CVO control thread; memory : all workers %I64d bytes", tNow, memWorkers) ;
 		fflush(context->_fpLOG) ;
 		}
 
@@ -579,8 +1062,26 @@ done :
 		}
 //	for (i = 0 ; i < nWorkers ; i++) 
 //		nRuns += Workers[i]._nRunsDone ;
-	if (NULL != Workers) 
+	// let the lower bound finish, unless we were told to stop; then stop the pool before its workers are gone.
+	if (0 == stop_signalled) 
+		context->_Scheduler.Wait(-1) ;
+	context->_Scheduler.Stop() ;
+	if (NULL != Workers) {
+		ARE::utils::AutoLock lock(context->_BestOrderMutex) ;
+		for (i = 0 ; i < nWorkers ; i++) {
+			context->MergeRunStatistics(Workers[i]._Stats) ;
+			if (NULL != Workers[i]._G) {
+				context->_nJournaledRestores += Workers[i]._G->_nJournaledRestores ;
+				context->_nFullRestores += Workers[i]._G->_nFullRestores ;
+				}
+			}
+		if (NULL != context->_fpLOG) {
+			fprintf(context->_fpLOG, "\n%I64d CVO control thread; worker graph restores : journaled=%I64d full=%I64d ...", tNow, context->_nJournaledRestores, context->_nFullRestores) ;
+			fflush(context->_fpLOG) ;
+			}
 		delete [] Workers ;
+		}
+	context->DestroyComponentSearches() ;
 	if (best_order._Width < p.N()) {
 		// some ordering was found
 		}
@@ -652,6 +1153,8 @@ int ARE::VarElimOrderComp::CVOcontext::RequestStopCVOthread(void)
 	if (previous_value > 0) 
 		return -1 ;
 #endif
+	// wake up the CVO thread, which is waiting for the thread pool.
+	_Scheduler.Notify() ;
 	return 1 ;
 }
 
@@ -675,6 +1178,7 @@ int ARE::VarElimOrderComp::CVOcontext::StopCVOthread(int64_t TimeoutInMillisecon
 		}
 	pthread_mutex_unlock(&stopSignalMutex);
 #endif
+	_Scheduler.Notify() ;
 	int64_t tStart = ARE::GetTimeInMilliseconds() ;
 	if (NULL != _fpLOG) {
 		fprintf(_fpLOG, "\n%I64d    CVO_th : stop variable order computation; stop signalled, will wait ...", tStart) ;
@@ -711,6 +1215,71 @@ int ARE::VarElimOrderComp::CVOcontext::StopCVOthread(int64_t TimeoutInMillisecon
 }
 
 
+int ARE::VarElimOrderComp::BenchmarkGraphEngines(ARE::ARP & P, ARE::VarElimOrderComp::NextVarPickCriteria algCode, int nRuns, int nRandomPick, double eRandomPick, unsigned long random_seed, int BitsetThreshold, FILE *fp)
+{
+	if (NULL == fp) 
+		fp = stdout ;
+	if (nRuns < 1) 
+		nRuns = 1 ;
+	if (nRandomPick < 1) 
+		nRandomPick = 1 ;
+
+	int ret = 1 ;
+	int TempAdjVarSpaceSizeExtraArrayN = 0 ;
+	ARE::AdjVar *TempAdjVarSpaceSizeExtraArray[TempAdjVarSpaceSizeExtraArraySize] ;
+	uint64_t checksum[3] = { 0, 0, 0 } ;
+
+	// same starting point as CVOThreadFn() : all easy variables eliminated.
+	ARE::Graph OriginalGraph, MasterGraph ;
+	OriginalGraph.Create(P) ;
+	if (! OriginalGraph._IsValid) 
+		goto done ;
+	MasterGraph = OriginalGraph ;
+	if (! MasterGraph._IsValid) 
+		goto done ;
+	MasterGraph.ComputeVariableEliminationOrder_Simple(0, INT_MAX, false, DBL_MAX, false, true, 1, 1, 0.0, TempAdjVarSpaceSizeExtraArrayN, TempAdjVarSpaceSizeExtraArray) ;
+	MasterGraph.ReAllocateEdges() ;
+	fprintf(fp, "\nbenchmark : N=%d, %d vars eliminated, %d remaining, nRuns=%d, nRandomPick=%d, seed=%lu", (int) MasterGraph._nNodes, (int) MasterGraph._OrderLength, (int) (MasterGraph._nNodes - MasterGraph._OrderLength), nRuns, nRandomPick, random_seed) ;
+
+	for (int config = 0 ; config < 3 ; config++) {
+		char engine = config < 2 ? config : 1 ;
+		ARE::Graph M, g ;
+		M = MasterGraph ;
+		if (! M._IsValid || 0 != M.SetAdjacencyEngine(engine)) 
+			goto done ;
+		M._BitsetEngineThreshold = 2 == config ? BitsetThreshold : 0 ;
+		int i, r, nCompleted = 0, bestWidth = INT_MAX ;
+		uint64_t h = 14695981039346656037ULL ;
+		int64_t tStart = ARE::GetTimeInMilliseconds() ;
+		for (r = 0 ; r < nRuns ; r++) {
+			if (0 != g.RestoreFrom(M)) 
+				goto done ;
+			g.RNG().seed(random_seed + r) ;
+			int res = g.ComputeVariableEliminationOrder_Simple(algCode, INT_MAX, false, DBL_MAX, false, false, 1, nRandomPick, eRandomPick, TempAdjVarSpaceSizeExtraArrayN, TempAdjVarSpaceSizeExtraArray) ;
+			h = (h ^ (uint64_t) (uint32_t) res) * 1099511628211ULL ;
+			if (0 != res) 
+				continue ;
+			++nCompleted ;
+			if (g._VarElimOrderWidth < bestWidth) 
+				bestWidth = g._VarElimOrderWidth ;
+			for (i = 0 ; i < g._OrderLength ; i++) 
+				h = (h ^ (uint64_t) g._VarElimOrder[i]) * 1099511628211ULL ;
+			}
+		int64_t dt = ARE::GetTimeInMilliseconds() - tStart ;
+		checksum[config] = h ;
+		fprintf(fp, "\nengine=%d (%s) : runs=%d completed=%d time=%lldmsec runs/sec=%g best width=%d checksum=%016llx graph memory=%lld bytes", 
+			(int) config, 0 == config ? "AdjVar lists" : (1 == config ? "sorted arrays" : "sorted arrays + bitsets"), nRuns, nCompleted, (long long) dt, dt > 0 ? (1000.0 * nRuns) / dt : 0.0, bestWidth, (unsigned long long) h, (long long) g.MemoryUsage()) ;
+		fflush(fp) ;
+		}
+
+	ret = checksum[0] == checksum[1] && checksum[0] == checksum[2] ? 0 : 2 ;
+	fprintf(fp, "\norders computed by all engines are %s", 0 == ret ? "the same" : "DIFFERENT") ;
+done :
+	ARE::VarElimOrderComp::DeleteNewAdjVarList(TempAdjVarSpaceSizeExtraArrayN, TempAdjVarSpaceSizeExtraArray) ;
+	return ret ;
+}
+
+
 int ARE::VarElimOrderComp::Compute(
 	// IN
 	const std::string & ProblemInputFile, 
@@ -745,7 +1314,9 @@ int ARE::VarElimOrderComp::Compute(
 
 	int64_t tStart;
 	int64_t tStopSignalled;
+	int64_t tLoadStart = 0 ;
 	int i;
+	ARE::ARP *p = NULL ;
 
 	ARE::VarElimOrderComp::CVOcontext *cvocontext = Context ;
 	ARE::VarElimOrderComp::CVOcontext *localCVOcontext = NULL ;
@@ -770,7 +1341,7 @@ int ARE::VarElimOrderComp::Compute(
 		if (NULL == cvocontext->_Problem) 
 			goto done ;
 		}
-	ARE::ARP *p = cvocontext->_Problem ;
+	p = cvocontext->_Problem ;
 	cvocontext->_AlgCode = algcode ;
 	cvocontext->_ObjCode = objcode ;
 	cvocontext->_SecondaryObjCode = objCodeSecondary ;
@@ -825,7 +1396,8 @@ int ARE::VarElimOrderComp::Compute(
 	p->SetName(fn) ;
 	}
 
-	if (0 != p->LoadFromFile(ProblemInputFile)) {
+	tLoadStart = ARE::GetTimeInMilliseconds() ;
+	if (0 != p->LoadFromFile(ProblemInputFile, cvocontext->_nThreads)) {
 		ret = 2 ;
 #ifdef VERBOSE_CVO
 		printf("\nload failed ...") ;
@@ -856,13 +1428,18 @@ int ARE::VarElimOrderComp::Compute(
 
 	tNow = 0 ;
 	GetCurrentDTmsec(strDT, tNow) ;
+	cvocontext->_dtLoad = tNow - tLoadStart ;
+	{
+	double MBps = (p->FileSize() / 1048576.0) / (p->LoadTimeInMilliseconds() > 0 ? p->LoadTimeInMilliseconds() / 1000.0 : 0.001) ;
+	int64_t peakKB = ARE::GetPeakMemoryUsageInKB() ;
 #ifdef VERBOSE_CVO
-	printf("\n%s File loaded; start preprocessing; N=%d ...", strDT, p->N()) ;
+	printf("\n%s File loaded in %lldmsec (parse %.1f MB/s, peak memory %lldKB); start preprocessing; N=%d ...", strDT, (long long) cvocontext->_dtLoad, MBps, (long long) peakKB, p->N()) ;
 #endif
 	if (NULL != cvocontext->_fpLOG) {
-		fprintf(cvocontext->_fpLOG, "\n%s File loaded; start preprocessing ...", strDT) ;
+		fprintf(cvocontext->_fpLOG, "\n%s File loaded in %lldmsec (parse %.1f MB/s, peak memory %lldKB); start preprocessing ...", strDT, (long long) cvocontext->_dtLoad, MBps, (long long) peakKB) ;
 		fflush(cvocontext->_fpLOG) ;
 		}
+	}
 
 	// eliminate singleton-domain variables; do this before ordering is computed; this is easy and should be done by any algorithm processing the network
 	if (EliminateSingletonDomainVariables) {
@@ -976,6 +1553,7 @@ int ARE::VarElimOrderComp::Compute(
 				}
 			pthread_mutex_unlock(&stopSignalMutex);
 #endif
+			cvocontext->_Scheduler.Notify() ;
 			continue ;
 			}
 		dt = tNow - tStopSignalled ;
@@ -1199,6 +1777,9 @@ int main(int argc, char* argv[])
 	int nArgs = (nParams-1)>>1 ;
 	bool findPracticalVariableOrder = true ;
 	ARE::VarElimOrderComp::ObjectiveToMinimize objCodeSecondary = ARE::VarElimOrderComp::None ;
+	int graphAdjacencyEngine = 1 ;
+	int nBenchmarkRuns = 0 ;
+	int bitsetThreshold = -1 ;
 	if (1 + 2*nArgs != nParams) {
 		printf("\nBAD COMMAND LINE; will exit ...") ;
 		return 1 ;
@@ -1216,6 +1797,12 @@ int main(int argc, char* argv[])
 			findPracticalVariableOrder = '1' == sArg[0] || 'y' == sArg[0] || 'Y' == sArg[0] ;
 		else if (0 == stricmp("-O2", sArgID.c_str()))
 			objCodeSecondary = (ARE::VarElimOrderComp::ObjectiveToMinimize) atoi(sArg.c_str()) ;
+		else if (0 == stricmp("-ge", sArgID.c_str()))
+			graphAdjacencyEngine = atoi(sArg.c_str()) ;
+		else if (0 == stricmp("-bench", sArgID.c_str()))
+			nBenchmarkRuns = atoi(sArg.c_str()) ;
+		else if (0 == stricmp("-bst", sArgID.c_str()))
+			bitsetThreshold = atoi(sArg.c_str()) ;
 		}
 	if (nrunstodo < 1) 
 		nrunstodo = 1 ;
@@ -1315,7 +1902,22 @@ for (int ii = 0 ; ii < nFiles ; ii++) {
 #ifdef VERBOSE_CVO
 	printf("\nnThreads2Use=%d nrunstodo=%d TimeLimitInMilliSeconds=%lld", (int)nThreads2Use, (int)nrunstodo, (int64_t)TimeLimitInMilliSeconds);
 #endif
+	if (bitsetThreshold >= 0) 
+		Context._BitsetAdjacencyThreshold = bitsetThreshold ;
+	// compare graph adjacency engines on this problem, instead of computing an order.
+	if (nBenchmarkRuns > 0) {
+		ARE::ARP p("benchmark") ;
+		if (0 != p.LoadFromFile(problem_filename) || 0 != p.PerformPostConstructionAnalysis()) {
+			printf("\nload failed ...") ;
+			return 1 ;
+			}
+		int res = ARE::VarElimOrderComp::BenchmarkGraphEngines(p, ARE::VarElimOrderComp::MinFill, nBenchmarkRuns, nRP, eRP, randomGeneratorSeed, Context._BitsetAdjacencyThreshold, stdout) ;
+		printf("\n") ;
+		return res ;
+		}
+
 	Context._BestOrder = &BestOrder ;
+	Context._GraphAdjacencyEngine = 0 != graphAdjacencyEngine ? 1 : 0 ;
 	ARE::VarElimOrderComp::CVOcontext *context = &Context ;
 	tStart = ARE::GetTimeInMilliseconds();
 	int res = ARE::VarElimOrderComp::Compute(problem_filename,
@@ -1327,6 +1929,7 @@ for (int ii = 0 ; ii < nFiles ; ii++) {
 
 #ifdef VERBOSE_CVO
 	printf("\nBEST ORDER width = %d, varElimComplexity = %f, lower bound = %d, nRunsDone = %d/%d, nImprovements = %d, nTrivialVars = %d, runtime = %lldmsec", (int) BestOrder._Width, (double)BestOrder._Complexity_Log10, (int) BestOrder._WidthLowerBound, (int)Context._nRunsStarted, (int)Context._nRunsCompleted, (int) Context._nImprovements, (int) Context._MasterGraph._OrderLength, (int64_t) (tEnd - tStart)) ;
+	printf("\nSTARTUP load = %lldmsec, graph build = %lldmsec, first order = %lldmsec", (long long) Context._dtLoad, (long long) Context._dtGraphBuild, (long long) Context._dtFirstOrder) ;
 #endif
 
 	// save order
@@ -3,9 +3,20 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
 #include <string>
+#include <vector>
+#include <atomic>
 
 #include "Graph.hxx"
+#include "WidthLowerBound.hxx"
+#include "ExactTreewidth.hxx"
+#include "SafeReductions.hxx"
+#include "OrderLocalSearch.hxx"
+#include "Utils/TaskScheduler.hxx"
 
 namespace BucketElimination { class MBEworkspace ; }
 
@@ -131,7 +142,81 @@ public :
 	}
 } ;
 
-class CVOcontext
+// width/complexity statistics of completed runs. each worker keeps its own, so that runs don't have to lock anything to update them; 
+// they are merged into the CVOcontext (MergeRunStatistics()) when the runs are done.
+class RunStatistics
+{
+public :
+	int _nRunsCompleted ;
+	int64_t _Width2CountMap[1024] ; // for widths [0,1023], how many times it was obtained
+	double _Width2MinComplexityMap[1024] ; // for widths [0,1023], log of smallest complexity
+	double _Width2MaxComplexityMap[1024] ; // for widths [0,1023], log of largest complexity
+public :
+	// note completed run of width W and complexity (log10) C.
+	inline void NoteRun(int W, double C)
+	{
+		++_nRunsCompleted ;
+		if (W < 0 || W >= 1024) 
+			return ;
+		_Width2CountMap[W]++ ;
+		if (_Width2MinComplexityMap[W] > C) 
+			_Width2MinComplexityMap[W] = C ;
+		if (_Width2MaxComplexityMap[W] < C) 
+			_Width2MaxComplexityMap[W] = C ;
+	}
+	void MergeRunStatistics(const RunStatistics & S)
+	{
+		_nRunsCompleted += S._nRunsCompleted ;
+		for (int i = 0 ; i < 1024 ; i++) {
+			if (0 == S._Width2CountMap[i]) 
+				continue ;
+			_Width2CountMap[i] += S._Width2CountMap[i] ;
+			if (_Width2MinComplexityMap[i] > S._Width2MinComplexityMap[i]) 
+				_Width2MinComplexityMap[i] = S._Width2MinComplexityMap[i] ;
+			if (_Width2MaxComplexityMap[i] < S._Width2MaxComplexityMap[i]) 
+				_Width2MaxComplexityMap[i] = S._Width2MaxComplexityMap[i] ;
+			}
+	}
+	void ResetRunStatistics(void)
+	{
+		_nRunsCompleted = 0 ;
+		for (int i = 0 ; i < 1024 ; i++) {
+			_Width2CountMap[i] = 0 ;
+			_Width2MinComplexityMap[i] = DBL_MAX ;
+			_Width2MaxComplexityMap[i] = 0 ;
+			}
+	}
+public :
+	RunStatistics(void)
+	{
+		ResetRunStatistics() ;
+	}
+} ;
+
+// search for an order of one group of connected components of the master graph (see CVOcontext::CreateComponentSearches()). 
+// _G is a copy of the master graph, with vars of all other groups eliminated, and its width/complexity reset; so a run on it orders vars of the group only, 
+// and its width/complexity are those of the group. the best order of the group is kept here; orders of the master graph are stitched from the best 
+// orders of all groups (CVOcontext::NoteComponentRun()).
+class ComponentSearch
+{
+public :
+	int _IDX ;
+	int _nNodes ; // number of vars in the group
+	ARE::Graph _G ;
+	// width/complexity of _BestOrder, as CVOcontext::_BestScore; the order itself is guarded by CVOcontext::_BestOrderMutex.
+	std::atomic<uint64_t> _BestScore ;
+	ARE::VarElimOrderComp::Order _BestOrder ; // vars of the group only
+public :
+	ComponentSearch(int IDX, int nNodes)
+		:
+		_IDX(IDX), 
+		_nNodes(nNodes), 
+		_BestScore(0)
+	{
+	}
+} ;
+
+class CVOcontext : public RunStatistics
 {
 public :
 	// IN
@@ -151,10 +236,30 @@ public :
 	bool _FindPracticalVariableOrder ; // this will cut off computation when we know that the result will not be practical
 	int _PracticalOrderLimit_W ; // default is 42 (2^42 = 4TB)
 	double _PracticalOrderLimit_C ; // default is 13.0 (10^13 = 10TB)
+	bool _UseJournaledGraphRestore ; // if true, workers reset their graph between runs by undoing the changes of the run (Graph::RestoreFrom()), instead of copying the master graph
+	char _GraphAdjacencyEngine ; // adjacency engine of the master graph, and so of worker graphs; 0=linked AdjVar lists, 1=sorted neighbor arrays (see Graph::_AdjEngine)
+	int _BitsetAdjacencyThreshold ; // during a run, switch graph to bitset adjacency matrix when fewer than this many variables are left; 0=never (see Graph::_BitsetEngineThreshold)
+	int _nLowerBoundRepetitions ; // number of randomized repetitions of the contraction lower bounds (see LowerBoundTask), per pool thread
+	bool _StopAtWidthLowerBound ; // when minimizing width, stop as soon as the best width equals the lower bound, since the best order is then optimal
+	bool _SafeReductions ; // when minimizing width, after easy vars, eliminate vars picked by treewidth-safe reduction rules (see SafeReductions) from the master graph
+	bool _ExactSearch ; // when minimizing width, one pool thread searches for an order of optimal width (see ExactSearchTask), while the others do runs; only with 2+ pool threads
+	int _ExactSearchMaxNodes ; // exact search is not done if more than this many vars are left after easy vars are eliminated
+	int _ExactSearchMemoryLimitInMB ; // memory for states of the exact search
+	bool _LocalSearch ; // when minimizing width, one pool thread improves the best order by local search (see LocalSearchTask); only if runs keep half of the pool threads
+	int _LocalSearchMaxNodes ; // local search is not done if more than this many vars are left after easy vars are eliminated
+	int _LocalSearchMemoryLimitInMB ; // memory for checkpoints of the local search
+	int _MaxComponents ; // if the master graph is not connected, split the search into at most this many groups of components (see ComponentSearch); 1=no split
+	int _ComponentMinNodes ; // components with fewer vars than this are not searched on their own, but in one group with all other small components
+	int _ComponentRunBatch ; // number of runs a worker does on one group before it picks a group again; runs on the same group restore the worker graph from its journal
 	// OUT
 	ARE::utils::RecursiveMutex _BestOrderMutex ;
 	int _ret ;
 	ARE::VarElimOrderComp::Order *_BestOrder ;
+	// width/complexity of _BestOrder, packed into one word (see PackScore()), so that runs can read it and test their result without locking; 
+	// only a run that is better takes _BestOrderMutex to store its order. it can be lower than _BestOrder while that run is storing its order.
+	std::atomic<uint64_t> _BestScore ;
+	// best lower bound on width found so far; -1 if none. same as _BestOrder->_WidthLowerBound, but can be read without locking.
+	std::atomic<int> _WidthLowerBound ;
 	// CONTROL
 	FILE *_fpLOG ;
 	unsigned long _RandomGeneratorSeed ;
@@ -173,15 +278,98 @@ public :
 	// AdjVar space is allocated it blocks (each size is TempAdjVarSpaceSize) and here we store ptrs to each block.
 	int _TempAdjVarSpaceSizeExtraArrayN ;
 	ARE::AdjVar *_TempAdjVarSpaceSizeExtraArray[TempAdjVarSpaceSizeExtraArraySize] ;
-	// STATISTICS
+	// thread pool doing the runs (see RunTask) and other jobs of the CVO thread; threads are started/stopped by the CVO thread.
+	ARE::utils::TaskScheduler _Scheduler ;
+	// searches of groups of components; empty if the master graph is searched as a whole. _ComponentOfVar is the group of each var; -1 for vars ordered in the master graph.
+	std::vector<ARE::VarElimOrderComp::ComponentSearch*> _Components ;
+	std::vector<int> _ComponentOfVar ;
+	std::vector<int> _StitchedOrder ; // guarded by _BestOrderMutex
+	// STATISTICS (see also RunStatistics)
 	volatile long _nRunsStarted ;
-	int _nRunsCompleted ;
-	int64_t _Width2CountMap[1024] ; // for widths [0,1023], how many times it was obtained
-	double _Width2MinComplexityMap[1024] ; // for widths [0,1023], log of smallest complexity
-	double _Width2MaxComplexityMap[1024] ; // for widths [0,1023], log of largest complexity
 	int _nImprovements ;
+	int64_t _nJournaledRestores, _nFullRestores ; // restores of worker graphs between runs (see Graph::RestoreFrom()), summed over workers when runs are done
+	// durations (msec) of startup phases : loading the problem, building the master graph (creating the graph and eliminating easy vars), computing the initial order.
+	int64_t _dtLoad, _dtGraphBuild, _dtFirstOrder ;
 	ARE::VarElimOrderComp::ResultSnapShot _Improvements[1024] ;
 public :
+	// width in the high 32 bits; complexity (log10) in the low 32 bits, as fixed point with 20 fraction bits (rounded down), so that scores 
+	// compare as (width, complexity) do. complexities less than 2^-20 apart (in log10), or above 4096, get the same code, and a run better 
+	// than the best order only by that much is dropped by OfferScore(); NoteImprovement() compares the orders themselves. DBL_MAX (no order) 
+	// has a code of its own.
+	static inline uint64_t PackScore(int W, double C)
+	{
+		uint32_t c ;
+		if (C >= DBL_MAX) 
+			c = UINT32_MAX ;
+		else if (C >= 4096.0) 
+			c = UINT32_MAX - 1 ;
+		else if (C > 0.0) 
+			c = (uint32_t) (C * (double) (1 << 20)) ;
+		else 
+			c = 0 ;
+		return (((uint64_t) (uint32_t) W) << 32) | c ;
+	}
+	static inline int ScoreWidth(uint64_t Score) { return (int) (Score >> 32) ; }
+	static inline double ScoreComplexity(uint64_t Score)
+	{
+		uint32_t c = (uint32_t) Score ;
+		return UINT32_MAX == c ? DBL_MAX : (double) c / (double) (1 << 20) ;
+	}
+	// true iff (W, C) is better than (BestW, BestC), wrt. the objective; C, BestC are log10 of complexity.
+	inline bool IsBetter(int W, double C, int BestW, double BestC) const
+	{
+		if (StateSpaceSize == _ObjCode) 
+			return C < BestC || (fabs(C - BestC) < 0.01 && W < BestW) ;
+		if (Width == _ObjCode) 
+			return W < BestW || (W == BestW && C < BestC) ;
+		return false ;
+	}
+	// lower Score to (W, C), if it is better; returns true iff it was lowered.
+	inline bool OfferScore(std::atomic<uint64_t> & Score, int W, double C)
+	{
+		uint64_t s = Score.load() ;
+		while (IsBetter(W, C, ScoreWidth(s), ScoreComplexity(s))) {
+			if (Score.compare_exchange_weak(s, PackScore(W, C))) 
+				return true ;
+			}
+		return false ;
+	}
+	inline bool OfferScore(int W, double C) { return OfferScore(_BestScore, W, C) ; }
+	// true iff the search can stop because the best width is equal to the lower bound.
+	inline bool WidthLowerBoundMet(void) const
+	{
+		if (! _StopAtWidthLowerBound || Width != _ObjCode) 
+			return false ;
+		int lb = _WidthLowerBound.load() ;
+		return lb >= 0 && ScoreWidth(_BestScore.load()) <= lb ;
+	}
+	// note lower bound LB on width, found by the given algorithm (see WidthLowerBound::Algorithm; -1 = exact search); it is stored in _BestOrder if it is better. 
+	// if the bound is met (WidthLowerBoundMet()), runs not started yet are dropped. returns true iff the bound is met.
+	bool NoteWidthLowerBound(int LB, char Algorithm) ;
+	// store order of G as _BestOrder, if it is better; caller must hold _BestOrderMutex. returns 1 iff G is the new best order.
+	int NoteImprovement(int w_IDX, Graph & G) ;
+	// same, for an order given as a list of all vars, with its width/complexity.
+	int NoteImprovement(int w_IDX, const int *VarListInElimOrder, int W, double MaxSingleVarElimComplexity, double Complexity_Log10, double TotalNewFunctionStorage_Log10, int nFillEdges) ;
+	// split the search of the master graph into groups of its connected components, if it is not connected (see ComponentSearch). Order is an order 
+	// of all vars; each group starts with it as its best order. returns 0 iff ok (whether or not the graph was split).
+	// only connected components are split off; the graph is not split at clique or almost-clique separators.
+	int CreateComponentSearches(const int *Order) ;
+	void DestroyComponentSearches(void) ;
+	// pick a group for the next run, with probability proportional to its size; groups that don't decide the width of the stitched order 
+	// get 1/16th of their share, and groups at the lower bound get none. returns -1 iff there are no groups.
+	int PickComponent(MTRand & RNG) ;
+	// true iff runs on group IDX can not improve the width, since its best width is at the lower bound.
+	inline bool ComponentIsAtWidthLowerBound(int IDX) const
+	{
+		if (Width != _ObjCode) 
+			return false ;
+		int lb = _WidthLowerBound.load() ;
+		return lb >= 0 && ScoreWidth(_Components[IDX]->_BestScore.load()) <= lb ;
+	}
+	// note completed run G of group IDX; if it is the best order of the group, the orders of all groups are stitched into an order of the 
+	// master graph, which is noted as NoteImprovement() does. caller must hold _BestOrderMutex. returns 1 iff the stitched order is the new best order.
+	int NoteComponentRun(int w_IDX, int IDX, Graph & G) ;
+	// note completed run G in the statistics of the context, and store it as _BestOrder, if it is better; caller must hold _BestOrderMutex.
 	int NoteVarOrderComputationCompletion(int w_IDX, Graph & G) ;
 	int CreateCVOthread(void) ;
 	int RequestStopCVOthread(void) ; // ret=0 means stopped; 1=stop requested, but still running; -1=stop requested before, but still running.
@@ -189,13 +377,12 @@ public :
 	int Reset(void)
 	{
 		_nRunsStarted = 0 ;
-		_nRunsCompleted = 0 ;
 		_nImprovements = 0 ;
-		for (int i = 0 ; i < 1024 ; i++) {
-			_Width2CountMap[i] = 0 ;
-			_Width2MinComplexityMap[i] = DBL_MAX ;
-			_Width2MaxComplexityMap[i] = 0 ;
-			}
+		_nJournaledRestores = 0 ;
+		_nFullRestores = 0 ;
+		_BestScore = PackScore(INT_MAX, DBL_MAX) ;
+		_WidthLowerBound = -1 ;
+		ResetRunStatistics() ;
 		return 0 ;
 	}
 	int Destroy(void)
@@ -205,6 +392,7 @@ public :
 			delete [] _TempAdjVarSpaceSizeExtraArray[i] ;
 			}
 		_TempAdjVarSpaceSizeExtraArrayN = 0 ;
+		DestroyComponentSearches() ;
 		if (NULL != _BestOrder) 
 			_BestOrder->Destroy() ;
 		Reset() ;
@@ -230,8 +418,25 @@ public :
 		_FindPracticalVariableOrder(true), 
 		_PracticalOrderLimit_W(42), 
 		_PracticalOrderLimit_C(13.0), 
+		_UseJournaledGraphRestore(true), 
+		_GraphAdjacencyEngine(1), 
+		_BitsetAdjacencyThreshold(2048), 
+		_nLowerBoundRepetitions(4), 
+		_StopAtWidthLowerBound(true), 
+		_SafeReductions(true), 
+		_ExactSearch(true), 
+		_ExactSearchMaxNodes(256), 
+		_ExactSearchMemoryLimitInMB(256), 
+		_LocalSearch(true), 
+		_LocalSearchMaxNodes(4096), 
+		_LocalSearchMemoryLimitInMB(64), 
+		_MaxComponents(8), 
+		_ComponentMinNodes(16), 
+		_ComponentRunBatch(16), 
 		_ret(-1), 
 		_BestOrder(NULL), 
+		_BestScore(PackScore(INT_MAX, DBL_MAX)), 
+		_WidthLowerBound(-1), 
 		_fpLOG(NULL), 
 		_RandomGeneratorSeed(0), 
 		_StopAndExit(0), 
@@ -239,14 +444,11 @@ public :
 		_tStart(0), _tEnd(0), _tToStop(0), 
 		_TempAdjVarSpaceSizeExtraArrayN(0), 
 		_nRunsStarted(0), 
-		_nRunsCompleted(0), 
-		_nImprovements(0)
+		_nImprovements(0), 
+		_nJournaledRestores(0), 
+		_nFullRestores(0), 
+		_dtLoad(0), _dtGraphBuild(0), _dtFirstOrder(0)
 	{
-		for (int i = 0 ; i < 1024 ; i++) {
-			_Width2CountMap[i] = 0 ;
-			_Width2MinComplexityMap[i] = DBL_MAX ;
-			_Width2MaxComplexityMap[i] = 0 ;
-			}
 	}
 	~CVOcontext(void)
 	{
@@ -263,14 +465,12 @@ public :
 public :
 //	ARE::VarElimOrderComp::NextVarPickCriteria _Algorithm ; // 0=MinFill, 1=MinDegree(MinInducedWidth), 2=MinComplexity
 //	int _nRandomPick ;
-#if defined WINDOWS || _WINDOWS
-	uintptr_t _ThreadHandle ;
-#elif defined (LINUX)
-	pthread_t _ThreadHandle ;
-#endif 
-	bool _ThreadIsRunning ;
 	bool _ThreadStop ; // signal the thread to stop
 	int _nRunsDone ;
+	int _nCompleteRunsTodo ; // first few runs of each worker are not terminated early
+	int _Component ; // group of components the runs of this worker are on (see CVOcontext::PickComponent()); -1 if none
+	int _nComponentRunsLeft ; // runs left before the worker picks a group again
+	RunStatistics _Stats ; // runs completed by this worker; merged into the context when runs are done
 	// AdjVar space is allocated it blocks (each size is TempAdjVarSpaceSize) and here we store ptrs to each block.
 	int _TempAdjVarSpaceSizeExtraArrayN ;
 	ARE::AdjVar *_TempAdjVarSpaceSizeExtraArray[TempAdjVarSpaceSizeExtraArraySize] ;
@@ -282,13 +482,22 @@ public :
 		_G(G), 
 //		_Algorithm(ARE::VarElimOrderComp::MinFill), 
 //		_nRandomPick(1), 
-		_ThreadHandle(0), 
-		_ThreadIsRunning(false), 
 		_ThreadStop(true), 
 		_nRunsDone(0), 
+		_nCompleteRunsTodo(3), 
+		_Component(-1), 
+		_nComponentRunsLeft(0), 
 		_TempAdjVarSpaceSizeExtraArrayN(0)
 	{
 	}
+	// number of bytes used by this worker : the object, its graph and AdjVar space blocks.
+	inline int64_t MemoryUsage(void) const
+	{
+		int64_t n = sizeof(Worker) + (int64_t) _TempAdjVarSpaceSizeExtraArrayN * TempAdjVarSpaceSize * sizeof(ARE::AdjVar) ;
+		if (NULL != _G) 
+			n += _G->MemoryUsage() ;
+		return n ;
+	}
 	~Worker(void)
 	{
 		for (int i = 0 ; i < _TempAdjVarSpaceSizeExtraArrayN ; i++) {
@@ -299,6 +508,104 @@ public :
 	}
 } ;
 
+// randomized order computation runs, done by the thread pool of the CVO thread (CVOcontext::_Scheduler). 
+// each Execute() does one run, on the graph of the worker of the pool thread; a task with more runs left first gives half of them to a new task, 
+// which idle threads can steal. each task has its own algorithm and random pick parameters, so different kinds of runs can be mixed.
+class RunTask : public ARE::utils::Task
+{
+public :
+	CVOcontext *_CVOcontext ;
+	Worker *_Workers ; // one for each pool thread
+	ARE::VarElimOrderComp::NextVarPickCriteria _AlgCode ;
+	int _nRandomPick ;
+	double _eRandomPick ;
+	int _nRuns ; // number of runs left
+public :
+	virtual int32_t Execute(int32_t ThreadIdx) ;
+public :
+	RunTask(CVOcontext *CVOcontext, Worker *Workers, ARE::VarElimOrderComp::NextVarPickCriteria AlgCode, int nRandomPick, double eRandomPick, int nRuns)
+		:
+		_CVOcontext(CVOcontext), 
+		_Workers(Workers), 
+		_AlgCode(AlgCode), 
+		_nRandomPick(nRandomPick), 
+		_eRandomPick(eRandomPick), 
+		_nRuns(nRuns)
+	{
+	}
+} ;
+
+// lower bound on width of the master graph, computed by one of the WidthLowerBound algorithms; the best bound is noted in the context 
+// (CVOcontext::NoteWidthLowerBound()). each Execute() does one randomized repetition and puts the task back in the queue, so that runs are 
+// interleaved with it. repetitions after the first are dropped when the search is over (out of runs/time, stop requested, or the bound is met).
+class LowerBoundTask : public ARE::utils::Task
+{
+public :
+	CVOcontext *_CVOcontext ;
+	char _Algorithm ; // see WidthLowerBound::Algorithm
+	int _nRepetitions ; // number of repetitions left
+	int _nRepetitionsDone ;
+	int _IDX ; // index of the task; used to seed its RNG
+	ARE::WidthLowerBound _LB ; // copy of the master graph, made by the first Execute()
+	MTRand _RNG ;
+public :
+	virtual int32_t Execute(int32_t ThreadIdx) ;
+public :
+	LowerBoundTask(CVOcontext *CVOcontext, char Algorithm, int nRepetitions, int IDX)
+		:
+		_CVOcontext(CVOcontext), 
+		_Algorithm(Algorithm), 
+		_nRepetitions(nRepetitions), 
+		_nRepetitionsDone(0), 
+		_IDX(IDX)
+	{
+	}
+} ;
+
+// exact search for an order of optimal width (see ExactTreewidth), on the master graph. it decides width k for k = lower bound, lower bound + 1, ... 
+// up to the best width found by runs; each k that fails is a new lower bound (CVOcontext::NoteWidthLowerBound()), and the first k that succeeds gives 
+// an optimal order (CVOcontext::NoteImprovement()). as runs improve the best width and lower bound tasks raise the lower bound, the range of k shrinks. 
+// it is stopped when the search is over (out of runs/time, stop requested, or the bound is met), or when it runs out of memory.
+class ExactSearchTask : public ARE::utils::Task
+{
+public :
+	CVOcontext *_CVOcontext ;
+	ARE::ExactTreewidth _ET ;
+public :
+	virtual int32_t Execute(int32_t ThreadIdx) ;
+public :
+	ExactSearchTask(CVOcontext *CVOcontext)
+		:
+		_CVOcontext(CVOcontext)
+	{
+	}
+} ;
+
+// local search improvement (see OrderLocalSearch) of the best order, on the master graph. each Execute() does moves for a short time slice and 
+// puts the task back in the queue, so that tasks queued on its thread are interleaved with it; the thread does not steal runs queued on other 
+// threads, so in effect it keeps a pool thread (see CVOThreadFn()). it starts from the best order, and starts over 
+// from it whenever runs (or other tasks) find an order narrower than its own; when its own order is narrower than the best, it is noted 
+// (CVOcontext::NoteImprovement()). it is stopped when the search is over (out of runs/time, stop requested, or the bound is met).
+class LocalSearchTask : public ARE::utils::Task
+{
+public :
+	CVOcontext *_CVOcontext ;
+	ARE::OrderLocalSearch _LS ;
+	MTRand _RNG ;
+	int64_t _tSliceEnd ;
+	int _nSlices ;
+public :
+	virtual int32_t Execute(int32_t ThreadIdx) ;
+public :
+	LocalSearchTask(CVOcontext *CVOcontext)
+		:
+		_CVOcontext(CVOcontext), 
+		_tSliceEnd(0), 
+		_nSlices(0)
+	{
+	}
+} ;
+
 int Compute(
 	// IN
 	const std::string & ProblemInputFile, 
@@ -321,6 +628,11 @@ int Compute(
 	CVOcontext * & CVOcontext
 	) ;
 
+// run the same nRuns order computations (same seeds, one thread) from the same starting graph, with each graph adjacency engine, and print runs/sec of each to fp.
+// sorted arrays are run twice, the second time switching to bitsets when fewer than BitsetThreshold variables are left.
+// all engines should compute the same orders; returns 0 iff they did.
+int BenchmarkGraphEngines(ARE::ARP & P, ARE::VarElimOrderComp::NextVarPickCriteria algCode, int nRuns, int nRandomPick, double eRandomPick, unsigned long random_seed, int BitsetThreshold, FILE *fp) ;
+
 inline void DeleteNewAdjVarList(int & n, ARE::AdjVar *TempAdjVarSpaceSizeExtraArray[]) 
 {
 	for (int i = n-1 ; i >=0 ; i--) 
@@ -0,0 +1,157 @@
+#include <stdlib.h>
+
+#include "Globals.hxx"
+
+#include "Problem.hxx"
+#include "Graph.hxx"
+#include "WidthLowerBound.hxx"
+
+ARE::WidthLowerBound::WidthLowerBound(void)
+	:
+	_nNodes(0), 
+	_BaseWidth(0), 
+	_MarkValue(0)
+{
+}
+
+
+int32_t ARE::WidthLowerBound::Initialize(ARE::Graph & G)
+{
+	_nNodes = 0 ;
+	_AdjOffset.clear() ;
+	_Adj.clear() ;
+	_BaseWidth = G._VarElimOrderWidth > 0 ? G._VarElimOrderWidth : 0 ;
+	if (! G._IsValid || G._nNodes <= 0) 
+		return 1 ;
+
+	// number nodes not ordered yet 0..n-1
+	std::vector<int32_t> node2local(G._nNodes, -1) ;
+	int32_t u, i ;
+	for (u = 0 ; u < G._nNodes ; u++) {
+		if (0 != G._VarType[u]) 
+			node2local[u] = _nNodes++ ;
+		}
+	_AdjOffset.reserve(_nNodes + 1) ;
+	_AdjOffset.push_back(0) ;
+	std::vector<int32_t> neighbors ;
+	for (u = 0 ; u < G._nNodes ; u++) {
+		if (node2local[u] < 0) 
+			continue ;
+		int32_t n = G._Nodes[u]._Degree > 0 ? G._Nodes[u]._Degree : 0 ;
+		neighbors.resize(n) ;
+		int32_t m = G.CopyNeighbors(u, neighbors.data(), n) ;
+		if (m > n) {
+			neighbors.resize(m) ;
+			G.CopyNeighbors(u, neighbors.data(), m) ;
+			}
+		for (i = 0 ; i < m ; i++) {
+			int32_t w = neighbors[i] ;
+			if (w != u && node2local[w] >= 0) 
+				_Adj.push_back(node2local[w]) ;
+			}
+		_AdjOffset.push_back(_Adj.size()) ;
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::WidthLowerBound::PickContractionNeighbor(int32_t v, char Algorithm, MTRand & RNG)
+{
+	const std::vector<int32_t> & nv = _Neighbors[v] ;
+	int32_t best = -1, bestScore = INT32_MAX, nTies = 0 ;
+	int32_t mark = LeastC == Algorithm ? NewMarkValue() : 0 ;
+	if (LeastC == Algorithm) {
+		for (int32_t u : nv) 
+			_Mark[u] = mark ;
+		}
+	for (int32_t u : nv) {
+		int32_t score = 0 ;
+		if (LeastC == Algorithm) {
+			for (int32_t w : _Neighbors[u]) 
+				{ if (mark == _Mark[w]) ++score ; }
+			}
+		else 
+			score = _Neighbors[u].size() ;
+		// pick randomly among the best
+		if (score < bestScore) 
+			{ best = u ; bestScore = score ; nTies = 1 ; }
+		else if (score == bestScore && 0 == RNG.randInt(nTies++)) 
+			best = u ;
+		}
+	return best ;
+}
+
+
+void ARE::WidthLowerBound::Contract(int32_t v, int32_t u)
+{
+	ReplaceNeighbor(u, v, -1) ;
+	int32_t mark = NewMarkValue() ;
+	for (int32_t w : _Neighbors[u]) 
+		_Mark[w] = mark ;
+	for (int32_t w : _Neighbors[v]) {
+		if (u == w) 
+			continue ;
+		if (mark == _Mark[w]) {
+			// w is adjacent to both; edge (v,w) goes away
+			ReplaceNeighbor(w, v, -1) ;
+			UpdateBucket(w) ;
+			}
+		else {
+			// edge (v,w) becomes (u,w); degree of w does not change
+			ReplaceNeighbor(w, v, u) ;
+			_Neighbors[u].push_back(w) ;
+			}
+		}
+	UpdateBucket(u) ;
+}
+
+
+int32_t ARE::WidthLowerBound::Compute(char Algorithm, MTRand & RNG, int32_t Target, int32_t & LowerBound)
+{
+	LowerBound = _BaseWidth ;
+	int32_t i, n = _nNodes ;
+	if (n <= 0) 
+		return 0 ;
+
+	// working copy of the graph
+	if ((int32_t) _Neighbors.size() < n) 
+		_Neighbors.resize(n) ;
+	if ((int32_t) _DegreeBuckets.size() < n) 
+		_DegreeBuckets.resize(n) ;
+	for (i = 0 ; i < n ; i++) 
+		_DegreeBuckets[i].clear() ;
+	_Degree.resize(n) ;
+	_PosInBucket.resize(n) ;
+	_Mark.assign(n, 0) ;
+	_MarkValue = 0 ;
+	for (i = 0 ; i < n ; i++) {
+		_Neighbors[i].assign(_Adj.begin() + _AdjOffset[i], _Adj.begin() + _AdjOffset[i+1]) ;
+		InsertIntoBucket(i) ;
+		}
+
+	// min degree is at most the number of nodes left - 1, so the bound cannot improve once there are no more than LowerBound+1 nodes left.
+	// deleting/contracting a node lowers the degree of any other node by at most 1, so min degree goes down by at most 1 in each step.
+	int32_t nLeft = n, minDegree = 0 ;
+	while (nLeft > LowerBound + 1) {
+		if (Target >= 0 && LowerBound >= Target) 
+			break ;
+		while (_DegreeBuckets[minDegree].empty()) 
+			++minDegree ;
+		if (minDegree > LowerBound) 
+			LowerBound = minDegree ;
+		std::vector<int32_t> & bucket = _DegreeBuckets[minDegree] ;
+		int32_t v = bucket.size() > 1 ? bucket[RNG.randInt(bucket.size() - 1)] : bucket[0] ;
+		RemoveFromBucket(v) ;
+		--nLeft ;
+		if (0 == minDegree || MMD == Algorithm) {
+			for (int32_t w : _Neighbors[v]) 
+				{ ReplaceNeighbor(w, v, -1) ; UpdateBucket(w) ; }
+			}
+		else 
+			Contract(v, PickContractionNeighbor(v, Algorithm, RNG)) ;
+		_Neighbors[v].clear() ;
+		if (minDegree > 0) 
+			--minDegree ;
+		}
+	return 0 ;
+}
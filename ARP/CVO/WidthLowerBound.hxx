@@ -0,0 +1,108 @@
+#ifndef ARE_WidthLowerBound_HXX_INCLUDED
+#define ARE_WidthLowerBound_HXX_INCLUDED
+
+#include <stdint.h>
+#include <vector>
+
+#include "Utils/MersenneTwister.h"
+
+namespace ARE
+{
+
+class Graph ;
+
+// lower bounds on the width of the graph of the nodes of a Graph that are not ordered yet (e.g. the CVO master graph, after easy vars are eliminated). 
+// all algorithms repeatedly pick a node of min degree, and the largest min degree seen is the bound; the picked node is 
+//    MMD : deleted; this gives the degeneracy of the graph (this is what Graph::ComputeVariableEliminationOrder_LowerBound() computes), 
+//    MinorMinWidth : contracted into its neighbor of min degree (minor-min-width, i.e. MMD+ with the min-d heuristic), 
+//    LeastC : contracted into its neighbor with the fewest common neighbors (MMD+ with the least-c heuristic); this approximates the contraction 
+//       degeneracy and is usually the best of the three.
+// contracting an edge gives a minor of the graph, whose treewidth is not larger, so all of these are lower bounds on the treewidth. 
+// ties are broken randomly, so repetitions with different RNG states can give different bounds.
+// an object is used by one thread at a time; its buffers are kept between runs.
+class WidthLowerBound
+{
+public :
+	enum Algorithm { MMD = 0, MinorMinWidth = 1, LeastC = 2 } ;
+
+protected :
+	// copy of the graph; neighbors of node i are _Adj[_AdjOffset[i], _AdjOffset[i+1]).
+	int32_t _nNodes ;
+	std::vector<int32_t> _AdjOffset, _Adj ;
+	int32_t _BaseWidth ; // width of the nodes of the Graph that are already ordered
+
+	// working copy of the graph; neighbor lists are not sorted.
+	std::vector<std::vector<int32_t>> _Neighbors ;
+	// nodes left, by degree; node u is _DegreeBuckets[_Degree[u]][_PosInBucket[u]].
+	std::vector<std::vector<int32_t>> _DegreeBuckets ;
+	std::vector<int32_t> _Degree, _PosInBucket ;
+	std::vector<int32_t> _Mark ;
+	int32_t _MarkValue ;
+
+	inline void InsertIntoBucket(int32_t u)
+	{
+		int32_t d = _Neighbors[u].size() ;
+		_Degree[u] = d ;
+		_PosInBucket[u] = _DegreeBuckets[d].size() ;
+		_DegreeBuckets[d].push_back(u) ;
+	}
+	inline void RemoveFromBucket(int32_t u)
+	{
+		std::vector<int32_t> & b = _DegreeBuckets[_Degree[u]] ;
+		int32_t last = b.back() ;
+		b[_PosInBucket[u]] = last ;
+		_PosInBucket[last] = _PosInBucket[u] ;
+		b.pop_back() ;
+	}
+	inline void UpdateBucket(int32_t u)
+	{
+		if ((int32_t) _Neighbors[u].size() == _Degree[u]) 
+			return ;
+		RemoveFromBucket(u) ;
+		InsertIntoBucket(u) ;
+	}
+	// remove v from the neighbors of u; if Replacement >= 0, v is replaced by it.
+	inline void ReplaceNeighbor(int32_t u, int32_t v, int32_t Replacement)
+	{
+		std::vector<int32_t> & nu = _Neighbors[u] ;
+		for (size_t i = 0 ; i < nu.size() ; i++) {
+			if (v != nu[i]) 
+				continue ;
+			if (Replacement >= 0) 
+				nu[i] = Replacement ;
+			else 
+				{ nu[i] = nu.back() ; nu.pop_back() ; }
+			return ;
+			}
+	}
+	inline int32_t NewMarkValue(void)
+	{
+		if (++_MarkValue == INT32_MAX) 
+			{ _Mark.assign(_Mark.size(), 0) ; _MarkValue = 1 ; }
+		return _MarkValue ;
+	}
+	// neighbor of v to contract v into.
+	int32_t PickContractionNeighbor(int32_t v, char Algorithm, MTRand & RNG) ;
+	// contract v into its neighbor u; v is removed from the graph.
+	void Contract(int32_t v, int32_t u) ;
+
+public :
+
+	inline int32_t nNodes(void) const { return _nNodes ; }
+	inline int32_t BaseWidth(void) const { return _BaseWidth ; }
+
+	// copy nodes of G that are not ordered yet, and edges between them; G is not changed, so this can be done concurrently on the same G.
+	// returns 0 iff ok.
+	int32_t Initialize(Graph & G) ;
+
+	// compute a lower bound with the given algorithm. LowerBound is the larger of the bound and BaseWidth(). 
+	// computation stops when LowerBound reaches Target (e.g. width of the best order known), if Target >= 0.
+	// returns 0 iff ok.
+	int32_t Compute(char Algorithm, MTRand & RNG, int32_t Target, int32_t & LowerBound) ;
+
+	WidthLowerBound(void) ;
+} ;
+
+} // namespace ARE
+
+#endif // ARE_WidthLowerBound_HXX_INCLUDED
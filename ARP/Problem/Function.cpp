@@ -5,9 +5,11 @@
 
 #include "Utils/Sort.hxx"
 #include "Utils/MersenneTwister.h"
+#include "Utils/MiscUtils.hxx"
 #include "Problem.hxx"
 #include "Function.hxx"
 #include "Bucket.hxx"
+#include "MiniBucket.hxx"
 
 static MTRand RNG ;
 
@@ -273,6 +275,105 @@ int32_t ARE::Function::CheckIntegrity(void)
 }
 
 
+int32_t ARE::Function::AllocateTableMemory(int64_t Size)
+{
+	ARE::utils::TablePool *pool = NULL != _Workspace ? _Workspace->TableDataPool() : NULL ;
+	if (NULL != pool) {
+		_TableData = (ARE_Function_TableType *) pool->Allocate(Size) ;
+		if (NULL != _TableData) 
+			{ _TableDataPool = pool ; _TableDataPoolSize = Size ; }
+		}
+	else {
+		try {
+			_TableData = new ARE_Function_TableType[(Size + sizeof(ARE_Function_TableType) - 1)/sizeof(ARE_Function_TableType)] ;
+			}
+		catch (...) {
+			}
+		}
+	return NULL != _TableData ? 0 : 1 ;
+}
+
+
+int32_t ARE::Function::AllocateTableData(void)
+{
+	if (NULL != _TableData && ARE_Function_TableStorage_Double != _TableStorage) 
+		DestroyTableData() ;
+	if (_TableSize <= 0) 
+		DestroyTableData() ;
+	else if (NULL == _TableData) {
+		_TableStorage = ARE_Function_TableStorage_Double ;
+		if (0 != AllocateTableMemory(_TableSize*sizeof(ARE_Function_TableType))) 
+			return 1 ;
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::Function::ConvertTableStorage(int32_t Storage, bool Relative, double & MaxError)
+{
+	MaxError = 0.0 ;
+	if (Storage == _TableStorage || NULL == _TableData || _TableSize <= 0) 
+		return 0 ;
+	if (ARE_Function_TableStorage_Double != _TableStorage) 
+		return 1 ;
+	ARE_Function_TableType *table = _TableData ;
+	ARE::utils::TablePool *pool = _TableDataPool ;
+	int64_t poolSize = _TableDataPoolSize ;
+	_TableData = NULL ;
+	_TableDataPool = NULL ;
+	if (0 != AllocateTableMemory(_TableSize*TableStorageEntrySize(Storage))) 
+		{ _TableData = table ; _TableDataPool = pool ; _TableDataPoolSize = poolSize ; return 1 ; }
+
+	int64_t i ;
+	double e ;
+	if (ARE_Function_TableStorage_Float == Storage) {
+		float *t = (float *) _TableData ;
+		for (i = 0 ; i < _TableSize ; i++) {
+			t[i] = (float) table[i] ;
+			if (t[i] == table[i]) 
+				continue ; // includes infinity
+			e = fabs(t[i] - table[i]) ;
+			if (Relative) 
+				e /= fabs(table[i]) ;
+			if (e > MaxError) 
+				MaxError = e ;
+			}
+		}
+	else {
+		ARE_Function_TableType lo = std::numeric_limits<ARE_Function_TableType>::infinity(), hi = -lo ;
+		for (i = 0 ; i < _TableSize ; i++) {
+			if (isinf(table[i])) 
+				continue ;
+			if (table[i] < lo) lo = table[i] ;
+			if (table[i] > hi) hi = table[i] ;
+			}
+		_QuantizationBase = hi >= lo ? lo : 0.0 ;
+		_QuantizationStep = hi > lo ? (hi - lo)/65533.0 : 0.0 ;
+		uint16_t *t = (uint16_t *) _TableData ;
+		for (i = 0 ; i < _TableSize ; i++) {
+			ARE_Function_TableType v = table[i] ;
+			if (isinf(v)) 
+				{ t[i] = v < 0.0 ? 0 : 65535 ; continue ; }
+			int64_t q = _QuantizationStep > 0.0 ? (int64_t) ((v - _QuantizationBase)/_QuantizationStep + 0.5) : 0 ;
+			if (q < 0) q = 0 ; else if (q > 65533) q = 65533 ;
+			t[i] = (uint16_t) (q + 1) ;
+			e = fabs(DecodeTableEntryQ16(t[i], _QuantizationBase, _QuantizationStep) - v) ;
+			if (Relative && 0.0 != v) 
+				e /= fabs(v) ;
+			if (e > MaxError) 
+				MaxError = e ;
+			}
+		}
+	_TableStorage = Storage ;
+
+	if (NULL != pool) 
+		pool->Free(table, poolSize) ;
+	else 
+		delete [] table ;
+	return 0 ;
+}
+
+
 int32_t ARE::Function::AllocateInMemoryAsSingleTableBlock(void)
 {
 	DestroyTableData() ;
@@ -285,6 +386,129 @@ int32_t ARE::Function::AllocateInMemoryAsSingleTableBlock(void)
 }
 
 
+void ARE::Function::NoteTableBlocksUnLoaded(void)
+{
+	if (NULL == _Workspace || _nTableBlocks <= 0) 
+		return ;
+	for (int64_t i = 0 ; i < _nTableBlocks ; i++) {
+		int64_t n = i < _nTableBlocks - 1 ? _TableBlockSize : _TableSize - i*_TableBlockSize ;
+		_Workspace->NoteDiskMemoryBlockUnLoaded(n*TableEntrySize()) ;
+		}
+}
+
+
+int32_t ARE::Function::GetTableBlockFilename(const std::string & Dir, int64_t BlockIDX, std::string & fn)
+{
+	char s[128] ;
+	if (NULL != _OriginatingBucket && NULL != _OriginatingMiniBucket) 
+		sprintf(s, "ftb-b%d-mb%d-%lld.bin", (int) _OriginatingBucket->IDX(), (int) _OriginatingMiniBucket->IDX(), (long long) BlockIDX) ;
+	else 
+		sprintf(s, "ftb-f%d-%lld.bin", (int) _IDX, (long long) BlockIDX) ;
+	fn = Dir ;
+	if (fn.length() > 0 && '/' != fn[fn.length()-1] && '\\' != fn[fn.length()-1]) 
+		fn += '/' ;
+	fn += s ;
+	return 0 ;
+}
+
+
+int32_t ARE::Function::SaveTableBlocks(int64_t BlockSize)
+{
+	if (_nTableBlocks > 0) 
+		// table does not change once computed; blocks on disk are up to date.
+		return 0 ;
+	if (NULL == _Workspace || NULL == _TableData || _TableSize <= 0 || BlockSize <= 0) 
+		return 1 ;
+	const std::string & dir = _Workspace->DiskSpaceDirectory() ;
+	if (0 == dir.length()) 
+		return 1 ;
+
+	INT64 tStart = ARE::GetTimeInMilliseconds() ;
+	int64_t i, nBlocks = (_TableSize + BlockSize - 1)/BlockSize ;
+	std::string fn ;
+	for (i = 0 ; i < nBlocks ; i++) {
+		size_t n = (size_t) (i < nBlocks - 1 ? BlockSize : _TableSize - i*BlockSize) ;
+		GetTableBlockFilename(dir, i, fn) ;
+		FILE *fp = fopen(fn.c_str(), "wb") ;
+		if (NULL == fp) 
+			break ;
+		size_t nWritten = fwrite(((const char *) _TableData) + i*BlockSize*TableEntrySize(), (size_t) TableEntrySize(), n, fp) ;
+		if (0 != fclose(fp) || nWritten != n) 
+			{ remove(fn.c_str()) ; break ; }
+		_Workspace->IncrementnTableBlocksSaved() ;
+		}
+	if (i < nBlocks) {
+		// failed; remove blocks written so far.
+		for (--i ; i >= 0 ; i--) 
+			{ GetTableBlockFilename(dir, i, fn) ; remove(fn.c_str()) ; }
+		return 1 ;
+		}
+	_nTableBlocks = nBlocks ;
+	_TableBlockSize = BlockSize ;
+	_Workspace->NoteFileSaveTime((DWORD) (ARE::GetTimeInMilliseconds() - tStart)) ;
+	return 0 ;
+}
+
+
+int32_t ARE::Function::LoadTableBlocks(void)
+{
+	if (NULL != _TableData) 
+		return 0 ;
+	if (NULL == _Workspace || _nTableBlocks <= 0) 
+		return 1 ;
+	const std::string & dir = _Workspace->DiskSpaceDirectory() ;
+
+	INT64 tStart = ARE::GetTimeInMilliseconds() ;
+	if (_TableSize <= 0 || 0 != AllocateTableMemory(_TableSize*TableEntrySize())) 
+		return 1 ;
+	int64_t i ;
+	std::string fn ;
+	for (i = 0 ; i < _nTableBlocks ; i++) {
+		size_t n = (size_t) (i < _nTableBlocks - 1 ? _TableBlockSize : _TableSize - i*_TableBlockSize) ;
+		GetTableBlockFilename(dir, i, fn) ;
+		FILE *fp = fopen(fn.c_str(), "rb") ;
+		if (NULL == fp) 
+			break ;
+		size_t nRead = fread(((char *) _TableData) + i*_TableBlockSize*TableEntrySize(), (size_t) TableEntrySize(), n, fp) ;
+		fclose(fp) ;
+		if (nRead != n) 
+			break ;
+		}
+	if (i < _nTableBlocks) 
+		{ DestroyTableData() ; return 1 ; }
+
+	int32_t bucketIDX = NULL != _OriginatingBucket ? _OriginatingBucket->IDX() : -1 ;
+	for (i = 0 ; i < _nTableBlocks ; i++) {
+		int64_t n = i < _nTableBlocks - 1 ? _TableBlockSize : _TableSize - i*_TableBlockSize ;
+		_Workspace->IncrementnTableBlocksLoaded(bucketIDX) ;
+		_Workspace->NoteDiskMemoryBlockLoaded(n*TableEntrySize()) ;
+		}
+	_TableLoadedFromDisk = true ;
+	_Workspace->NoteFileLoadTime((DWORD) (ARE::GetTimeInMilliseconds() - tStart)) ;
+	return 0 ;
+}
+
+
+int32_t ARE::Function::DeleteTableBlocks(void)
+{
+	if (_nTableBlocks <= 0) 
+		return 0 ;
+	if (_TableLoadedFromDisk) {
+		// table in memory is no longer counted as coming from disk.
+		NoteTableBlocksUnLoaded() ;
+		_TableLoadedFromDisk = false ;
+		}
+	if (NULL != _Workspace) {
+		const std::string & dir = _Workspace->DiskSpaceDirectory() ;
+		std::string fn ;
+		for (int64_t i = 0 ; i < _nTableBlocks ; i++) 
+			{ GetTableBlockFilename(dir, i, fn) ; remove(fn.c_str()) ; }
+		}
+	_nTableBlocks = _TableBlockSize = -1 ;
+	return 0 ;
+}
+
+
 int32_t ARE::Function::ReOrderArguments(int32_t nAF, const int32_t *AF, int32_t nAB, const int32_t *AB)
 {
 	if (_nArgs < 1 || NULL == _Arguments) 
@@ -623,14 +847,14 @@ int32_t ARE::Function::SaveXMLString(const char *prefixspaces, const char *tag,
 		sprintf(s, " TableSize=\"%I64d\"", _TableSize) ;
 		S += s ;
 		}
-/*	if (_nTableBlocks >= 0) {
+	if (_nTableBlocks >= 0) {
 		sprintf(s, " nTableBlocks=\"%I64d\"", _nTableBlocks) ;
 		S += s ;
 		}
 	if (_nTableBlocks >= 0) {
 		sprintf(s, " TableBlockSize=\"%I64d\"", _TableBlockSize) ;
 		S += s ;
-		}*/
+		}
 	if (_FileName.length() > 0) {
 		sprintf(s, " filename=\"%s\"", _FileName.c_str()) ;
 		S += s ;
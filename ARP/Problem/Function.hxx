@@ -2,11 +2,13 @@
 #define Function_HXX_INCLUDED
 
 #include <climits>
+#include <limits>
 #include <stdlib.h>
 #include <string>
 
 #include "Utils/Mutex.h"
 #include "Utils/Sort.hxx"
+#include "Utils/TablePool.hxx"
 #include "Problem/Globals.hxx"
 #include "Problem/Workspace.hxx"
 
@@ -24,6 +26,12 @@ namespace BucketElimination { class Bucket ; class MiniBucket ; }
 #define ARE_Function_TableType double
 #define ARE_Function_TableTypeString "double"
 
+// storage of the entries of a function table (see Function::ConvertTableStorage()) : double; float; 16-bit codes of a uniform 
+// quantization of the range of finite entries, where code 0 is -infinity, code 65535 is +infinity and code q in [1,65534] is Base + (q-1)*Step.
+#define ARE_Function_TableStorage_Double	0
+#define ARE_Function_TableStorage_Float		1
+#define ARE_Function_TableStorage_Q16		2
+
 /*
 	Addressing scheme in the table is as follows. Store sequentially values of argument value combinations 
 	in order: 0,...,0; 0,...,1; 0,...,2; ...; 0,...,k-1; 0,...,1,0; 0,...,1,1; etc.
@@ -38,6 +46,15 @@ namespace ARE
 
 class ARP ;
 
+inline ARE_Function_TableType DecodeTableEntryQ16(uint16_t Code, ARE_Function_TableType Base, ARE_Function_TableType Step)
+{
+	if (0 == Code) 
+		return -std::numeric_limits<ARE_Function_TableType>::infinity() ;
+	if (65535 == Code) 
+		return std::numeric_limits<ARE_Function_TableType>::infinity() ;
+	return Base + (Code - 1)*Step ;
+}
+
 class Function
 {
 protected :
@@ -323,35 +340,76 @@ protected :
 
 	// when fn is represented as a table, its contents are here.
 	ARE_Function_TableType *_TableData ;
+	// if not NULL, _TableData was allocated (as _TableDataPoolSize bytes) from this pool of the workspace; otherwise with new [].
+	ARE::utils::TablePool *_TableDataPool ;
+	int64_t _TableDataPoolSize ;
+	// storage of the entries of the table, in memory or on disk (ARE_Function_TableStorage_*); unless it is double, _TableData holds entries of 
+	// that type. _QuantizationBase/_QuantizationStep are the parameters of the Q16 storage.
+	int32_t _TableStorage ;
+	ARE_Function_TableType _QuantizationBase ;
+	ARE_Function_TableType _QuantizationStep ;
+	// bound on the difference between the entries of this table and the entries it would have if all tables were stored as double; 
+	// relative or absolute, see BucketElimination::MBEworkspace::TableErrorIsRelative().
+	double _TableErrorBound ;
+
+	// allocate Size bytes for _TableData, as AllocateTableData() does.
+	int32_t AllocateTableMemory(int64_t Size) ;
+
+	// when the table is saved on disk, it is saved as _nTableBlocks blocks (files) of _TableBlockSize elements each (last block may be smaller).
+	// _nTableBlocks is -1 when the table is not on disk. a table saved on disk stays there until the fn is destroyed, so it can be unloaded/loaded many times.
+	int64_t _nTableBlocks ;
+	int64_t _TableBlockSize ;
+	// true iff _TableData was loaded from disk; it is counted in the workspace disk memory stats until it is destroyed.
+	bool _TableLoadedFromDisk ;
+
+	void NoteTableBlocksUnLoaded(void) ;
 
 public :
 
 	inline int64_t TableSize(void) const { return _TableSize ; }
-	inline ARE_Function_TableType TableEntry(int64_t IDX) const { return _TableData[IDX] ; }
-	inline ARE_Function_TableType *TableData(void) { return _TableData ; }
+	inline ARE_Function_TableType TableEntry(int64_t IDX) const
+	{
+		if (ARE_Function_TableStorage_Double == _TableStorage) 
+			return _TableData[IDX] ;
+		if (ARE_Function_TableStorage_Float == _TableStorage) 
+			return ((const float *) _TableData)[IDX] ;
+		return DecodeTableEntryQ16(((const uint16_t *) _TableData)[IDX], _QuantizationBase, _QuantizationStep) ;
+	}
+	// the table as an array of doubles; NULL if the table is stored as float/Q16, in which case use TableStorageData()/TableEntry().
+	inline ARE_Function_TableType *TableData(void) { return ARE_Function_TableStorage_Double == _TableStorage ? _TableData : NULL ; }
+	inline const void *TableStorageData(void) const { return _TableData ; }
+	inline int32_t TableStorage(void) const { return _TableStorage ; }
+	inline int64_t TableEntrySize(void) const { return TableStorageEntrySize(_TableStorage) ; }
+	static inline int64_t TableStorageEntrySize(int32_t Storage)
+	{
+		if (ARE_Function_TableStorage_Float == Storage) 
+			return sizeof(float) ;
+		if (ARE_Function_TableStorage_Q16 == Storage) 
+			return sizeof(uint16_t) ;
+		return sizeof(ARE_Function_TableType) ;
+	}
+	inline ARE_Function_TableType QuantizationBase(void) const { return _QuantizationBase ; }
+	inline ARE_Function_TableType QuantizationStep(void) const { return _QuantizationStep ; }
+	inline double TableErrorBound(void) const { return _TableErrorBound ; }
+	inline void SetTableErrorBound(double Bound) { _TableErrorBound = Bound ; }
+	// convert the table (stored as double) to the given storage. MaxError is the largest difference between an entry and its stored value, 
+	// divided by the entry if Relative.
+	int32_t ConvertTableStorage(int32_t Storage, bool Relative, double & MaxError) ;
 	inline bool HasTableData(void) const { return NULL != _TableData ; }
 	inline void DestroyTableData(void)
 	{
 		if (NULL != _TableData) {
-			delete [] _TableData ;
+			if (_TableLoadedFromDisk) 
+				{ NoteTableBlocksUnLoaded() ; _TableLoadedFromDisk = false ; }
+			if (NULL != _TableDataPool) 
+				{ _TableDataPool->Free(_TableData, _TableDataPoolSize) ; _TableDataPool = NULL ; }
+			else 
+				delete [] _TableData ;
 			_TableData = NULL ;
 			}
 	}
-	inline int32_t AllocateTableData(void)
-	{
-		if (_TableSize <= 0) 
-			DestroyTableData() ;
-		else if (NULL == _TableData) {
-			try {
-				_TableData = new ARE_Function_TableType[_TableSize] ;
-				}
-			catch (...) {
-				}
-			if (NULL == _TableData) 
-				return 1 ;
-			}
-		return 0 ;
-	}
+	// allocate the table (of doubles); tables of functions that belong to a workspace come from the table pool of the workspace, if it has one.
+	int32_t AllocateTableData(void) ;
 	inline int32_t SetTableData(int64_t Size, ARE_Function_TableType *TableData)
 	{
 		if (_TableSize < 0) 
@@ -362,6 +420,7 @@ public :
 			return 0 ;
 		DestroyTableData() ;
 		_TableData = TableData ;
+		_TableStorage = ARE_Function_TableStorage_Double ;
 		return 0 ;
 	}
 	inline int32_t CheckData(void)
@@ -369,7 +428,7 @@ public :
 		if (NULL != _TableData) {
 			for (int64_t i = _TableSize-1 ; i >= 0 ; i--) {
 //				if (0 != _isnan(_Data[i]))
-				if (_TableData[i] != _TableData[i]) // tests for NaN
+				if (TableEntry(i) != TableEntry(i)) // tests for NaN
 					// don't check if 0 == _finite(_Data[i])), since we may have -INF when the table is converted to log
 					return 1 ;
 				}
@@ -382,7 +441,7 @@ public :
 			return 0 ;
 		int64_t n = 0 ;
 		for (int64_t i = _TableSize-1 ; i >= 0 ; i--) 
-			{ if (0.0 == _TableData[i]) n++ ; }
+			{ if (0.0 == TableEntry(i)) n++ ; }
 		return n ;
 	}
 	inline int32_t SumEntireData(ARE_Function_TableType & sum)
@@ -399,7 +458,7 @@ public :
 				{ int32_t bug = 1 ; }
 #endif // _DEBUG
 */
-			sum += _TableData[i] ;
+			sum += TableEntry(i) ;
 			}
 		return 0 ;
 	}
@@ -426,6 +485,26 @@ public :
 	// this fn should be called when the table size can be huge.
 	double GetTableSpace_Log10(void) ;
 
+	// **************************************************************************************************
+	// table blocks on disk (external memory BE).
+	// blocks are stored in Workspace::DiskSpaceDirectory(), one file per block.
+	// **************************************************************************************************
+
+	inline int64_t nTableBlocks(void) const { return _nTableBlocks ; }
+	inline int64_t TableBlockSize(void) const { return _TableBlockSize ; }
+	inline bool TableIsOnDisk(void) const { return _nTableBlocks > 0 ; }
+	inline bool TableLoadedFromDisk(void) const { return _TableLoadedFromDisk ; }
+
+	// get the filename of the given block of the table of this function.
+	int32_t GetTableBlockFilename(const std::string & Dir, int64_t BlockIDX, std::string & fn) ;
+	// save the table (in memory) to disk as blocks of BlockSize elements; the table stays in memory.
+	// if the table is already on disk, nothing is written.
+	int32_t SaveTableBlocks(int64_t BlockSize) ;
+	// load the table from its blocks on disk; does nothing if the table is in memory.
+	int32_t LoadTableBlocks(void) ;
+	// remove the blocks of the table from disk.
+	int32_t DeleteTableBlocks(void) ;
+
 	// table will be stored in memory as a 1 (single) block; allocate table.
 	// this fn assumes that the table is not allocated yet; i.e. no blocks of the table have ever been allocated.
 	int32_t AllocateInMemoryAsSingleTableBlock(void) ;
@@ -491,6 +570,8 @@ public :
 	void Destroy(void)
 	{
 		DestroyTableData() ;
+		if (_nTableBlocks > 0) 
+			DeleteTableBlocks() ;
 		if (NULL != _Arguments) {
 			delete [] _Arguments ;
 			_Arguments = _ArgumentsPermutationList = NULL ;
@@ -502,6 +583,8 @@ public :
 		_nArgs = 0 ;
 		_BayesianCPTChildVariable = -1 ;
 		_IsQueryIrrelevant = false ;
+		_TableStorage = ARE_Function_TableStorage_Double ;
+		_TableErrorBound = 0.0 ;
 	}
 	Function(void)
 		:
@@ -519,6 +602,15 @@ public :
 		_OriginatingMiniBucket(NULL), 
 		_TableSize(-1), 
 		_TableData(NULL), 
+		_TableDataPool(NULL), 
+		_TableDataPoolSize(0), 
+		_TableStorage(ARE_Function_TableStorage_Double), 
+		_QuantizationBase(0.0), 
+		_QuantizationStep(0.0), 
+		_TableErrorBound(0.0), 
+		_nTableBlocks(-1), 
+		_TableBlockSize(-1), 
+		_TableLoadedFromDisk(false), 
 //		_nArgumentDomainFactorization(0),
 		_ConstValue(-1.0)
 	{
@@ -539,6 +631,15 @@ public :
 		_OriginatingMiniBucket(NULL), 
 		_TableSize(-1), 
 		_TableData(NULL), 
+		_TableDataPool(NULL), 
+		_TableDataPoolSize(0), 
+		_TableStorage(ARE_Function_TableStorage_Double), 
+		_QuantizationBase(0.0), 
+		_QuantizationStep(0.0), 
+		_TableErrorBound(0.0), 
+		_nTableBlocks(-1), 
+		_TableBlockSize(-1), 
+		_TableLoadedFromDisk(false), 
 //		_nArgumentDomainFactorization(0),
 		_ConstValue(-1.0)
 	{
@@ -99,7 +99,8 @@ int ARE::LoadVarOrderFromFile(
 			{ if (NULL != ARE::fpLOG) fprintf(ARE::fpLOG, "\nVariable ordering file data is bad; cannot file end of first line; nRead=%d ...", nRead) ; delete [] buf ; return 1 ; }
 		// load nVars
 		const char *buf_ = buf+i, *buf__ = NULL ;
-		int L = nRead - i, l ;
+		int64_t L = nRead - i ;
+		int l ;
 		if (0 != fileload_getnexttoken(buf_, L, buf__, l, false)) 
 			{ if (NULL != ARE::fpLOG) fprintf(ARE::fpLOG, "\nVariable ordering file data is bad; cannot get nVars; nRead=%d ...", nRead) ; delete [] buf ; return 1 ; }
 		int nVars = atoi(buf__) ;
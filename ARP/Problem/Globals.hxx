@@ -58,6 +58,9 @@ namespace ARE
 #define MAX_DEGREE_OF_GRAPH_NODE		1024
 #define MAX_NUM_VARIABLES_PER_PROBLEM   1000000
 
+// default number of elements in a block of a function table saved on disk (8MB of doubles).
+#define ARE_Function_TableBlockSize		1048576
+
 #define ERRORCODE_generic									100
 #define ERRORCODE_too_many_variables						101
 #define ERRORCODE_too_many_functions						102
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sstream>
 #include <fstream>
 
@@ -9,6 +10,8 @@
 #include "Utils/MersenneTwister.h"
 #include "Utils/Sort.hxx"
 #include "Utils/MiscUtils.hxx"
+#include "Utils/MappedFile.hxx"
+#include "Utils/TaskScheduler.hxx"
 #include "Globals.hxx"
 #include "Function.hxx"
 #include "Problem.hxx"
@@ -16,6 +19,11 @@
 
 static MTRand RNG ;
 
+// UAI files at least this large (in bytes) have their function tables parsed in parallel (when more than one thread is allowed).
+#define ARE_UAI_PARALLEL_LOAD_MIN_SIZE 1048576
+// number of functions in a chunk of tables parsed by one thread.
+#define ARE_UAI_PARALLEL_LOAD_CHUNK_SIZE 16
+
 int32_t ARE::ARP::GetFilename(const std::string & Dir, std::string & fn)
 {
 	if (0 == _Name.length()) 
@@ -222,12 +230,12 @@ int32_t error = 1 ;
 }
 
 
-int32_t ARE::fileload_getnexttoken(const char * & buf, int32_t & L, const char * & B, int32_t & l, bool IncludeSpecialSymbols)
+int32_t ARE::fileload_getnexttoken(const char * & buf, int64_t & L, const char * & B, int32_t & l, bool IncludeSpecialSymbols)
 {
 	B = NULL ;
 	l = 0 ;
 	// find beginning
-	int32_t i ;
+	int64_t i ;
 	for (i = 0 ; i < L ; i++) { if ('\r' != buf[i] && '\n' != buf[i] && ' ' != buf[i] && '\t' != buf[i]) break ; }
 	buf += i ;
 	L -= i ;
@@ -259,13 +267,113 @@ int32_t ARE::fileload_getnexttoken(const char * & buf, int32_t & L, const char *
 }
 
 
-int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int32_t L)
+int32_t ARE::fileload_parseint(const char *B, int32_t l, int64_t & v)
+{
+	v = 0 ;
+	int32_t i = 0 ;
+	bool negative = false ;
+	if (i < l && ('-' == B[i] || '+' == B[i])) 
+		{ negative = '-' == B[i] ; i++ ; }
+	int32_t iFirstDigit = i ;
+	// like atoi(), stop at the first non-digit.
+	for (; i < l && (uint32_t) (B[i] - '0') < 10 ; i++) {
+		if (v > (INT64_MAX - 9) / 10) 
+			return 1 ;
+		v = 10*v + (B[i] - '0') ;
+		}
+	if (i == iFirstDigit) 
+		return 1 ;
+	if (negative) 
+		v = -v ;
+	return 0 ;
+}
+
+
+int32_t ARE::fileload_parseint(const char *B, int32_t l, int32_t & v)
+{
+	int64_t v64 ;
+	if (0 != fileload_parseint(B, l, v64)) 
+		return 1 ;
+	if (v64 < INT32_MIN || v64 > INT32_MAX) 
+		return 1 ;
+	v = (int32_t) v64 ;
+	return 0 ;
+}
+
+
+int32_t ARE::fileload_parsedouble(const char *B, int32_t l, double & x)
+{
+	static const double pow10[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 } ;
+
+	// fast path : [+-]digits[.digits][(e|E)[+-]digits]. when the mantissa (significant digits as an integer) fits in 53 bits and the decimal 
+	// exponent is at most 22 in absolute value, both are exact doubles and one multiplication/division gives the correctly rounded result, 
+	// i.e. the same as strtod(). everything else (long mantissas, large exponents, inf/nan, hex, ...) goes to strtod().
+	int32_t i = 0 ;
+	bool negative = false ;
+	if (i < l && ('-' == B[i] || '+' == B[i])) 
+		{ negative = '-' == B[i] ; i++ ; }
+	uint64_t m = 0 ;
+	int32_t nDigits = 0, nSignificantDigits = 0, e = 0 ;
+	for (; i < l && (uint32_t) (B[i] - '0') < 10 ; i++, nDigits++) {
+		if (0 == m && '0' == B[i]) continue ;
+		if (++nSignificantDigits <= 19) 
+			m = 10*m + (B[i] - '0') ;
+		else 
+			e++ ;
+		}
+	if (i < l && '.' == B[i]) {
+		for (i++ ; i < l && (uint32_t) (B[i] - '0') < 10 ; i++, nDigits++) {
+			if (0 == m && '0' == B[i]) 
+				{ e-- ; continue ; }
+			if (++nSignificantDigits <= 19) 
+				{ m = 10*m + (B[i] - '0') ; e-- ; }
+			}
+		}
+	if (nDigits > 0 && i < l && ('e' == B[i] || 'E' == B[i])) {
+		int32_t j = i + 1, exp = 0 ;
+		bool exp_negative = false ;
+		if (j < l && ('-' == B[j] || '+' == B[j])) 
+			{ exp_negative = '-' == B[j] ; j++ ; }
+		int32_t jFirstDigit = j ;
+		for (; j < l && (uint32_t) (B[j] - '0') < 10 ; j++) {
+			if (exp < 100000) 
+				exp = 10*exp + (B[j] - '0') ;
+			}
+		if (j > jFirstDigit) 
+			{ e += exp_negative ? -exp : exp ; i = j ; }
+		}
+	if (nDigits > 0 && i == l && nSignificantDigits <= 19 && m <= (((uint64_t) 1) << 53) && e >= -22 && e <= 22) {
+		x = (double) m ;
+		if (e < 0) 
+			x /= pow10[-e] ;
+		else if (e > 0) 
+			x *= pow10[e] ;
+		if (negative) 
+			x = -x ;
+		return 0 ;
+		}
+
+	// slow path; strtod() needs a 0-terminated string.
+	char temp[64] ;
+	std::string s ;
+	const char *str = temp ;
+	if (l < (int32_t) sizeof(temp)) 
+		{ memcpy(temp, B, l) ; temp[l] = 0 ; }
+	else 
+		{ s.assign(B, l) ; str = s.c_str() ; }
+	char *end = NULL ;
+	x = strtod(str, &end) ;
+	return end > str ? 0 : 1 ;
+}
+
+
+int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int64_t L, int32_t nThreads)
 {
 	int32_t i ;
 
 	if (NULL != _fpLOG) {
 		int64_t tNOW = ARE::GetTimeInMilliseconds() ;
-		fprintf(_fpLOG, "\n%I64d ARE::ARP::LoadFromBuffer(); L=%d ...", tNOW, L) ;
+		fprintf(_fpLOG, "\n%I64d ARE::ARP::LoadFromBuffer(); L=%lld ...", tNOW, (long long) L) ;
 		fflush(_fpLOG) ;
 		}
 
@@ -283,7 +391,7 @@ int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int32_t L)
 				fprintf(_fpLOG, "\n%I64d ARE::ARP::LoadFromBuffer(); UAI type is BAYES ...", tNOW) ;
 				fflush(_fpLOG) ;
 				}
-			i = LoadUAIFormat(buf+6, L-6) ;
+			i = LoadUAIFormat(buf+6, L-6, nThreads) ;
 			}
 		else if (6 == i ? 0 == memcmp(buf, "MARKOV", i) : false) {
 			if (NULL != _fpLOG) {
@@ -291,7 +399,7 @@ int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int32_t L)
 				fprintf(_fpLOG, "\n%I64d ARE::ARP::LoadFromBuffer(); UAI type is MARKOV ...", tNOW) ;
 				fflush(_fpLOG) ;
 				}
-			i = LoadUAIFormat(buf+7, L-7) ;
+			i = LoadUAIFormat(buf+7, L-7, nThreads) ;
 			}
 		else if (6 == i ? 0 == memcmp(buf, "SPARSE", i) : false) {
 			if (NULL != _fpLOG) {
@@ -299,7 +407,7 @@ int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int32_t L)
 				fprintf(_fpLOG, "\n%I64d ARE::ARP::LoadFromBuffer(); UAI type is SPARSE ...", tNOW) ;
 				fflush(_fpLOG) ;
 				}
-			i = LoadUAIFormat(buf+7, L-7) ;
+			i = LoadUAIFormat(buf+7, L-7, nThreads) ;
 			}
 		else {
 			if (NULL != _fpLOG) {
@@ -331,7 +439,7 @@ int32_t ARE::ARP::LoadFromBuffer(const char *format, const char *buf, int32_t L)
 }
 
 
-int32_t ARE::ARP::LoadFromBuffer_Evidence(const char *format, const char *buf, int32_t L, int32_t & nEvidenceVars)
+int32_t ARE::ARP::LoadFromBuffer_Evidence(const char *format, const char *buf, int64_t L, int32_t & nEvidenceVars)
 {
 	nEvidenceVars = 0 ;
 
@@ -402,9 +510,10 @@ int32_t ARE::ARP::DeleteDuplicateFunctions(void)
 }
 
 
-int32_t ARE::ARP::LoadFromFile(const std::string & FileName)
+int32_t ARE::ARP::LoadFromFile(const std::string & FileName, int32_t nThreads)
 {
 	int32_t res = -1 ;
+	int64_t tStart = ARE::GetTimeInMilliseconds(), fileSize = 0 ;
 
 	// fn may have dir in it; extract filename.
 	int32_t i = FileName.length() - 1 ;
@@ -428,122 +537,298 @@ int32_t ARE::ARP::LoadFromFile(const std::string & FileName)
 	if (NULL != ARE::fpLOG) 
 		fprintf(ARE::fpLOG, "\nWill load problem from %s", FileName.c_str()) ;
 	if ("gr" == fn_ext) {
-		std::istream *input = NULL ;
-		bool delete_istream = false ;
-		if ("cin" == fn_pure) {
-			input = &(std::cin) ;
-			}
-		else {
-			input = new ifstream(FileName.c_str()) ;
-			}
-
-		Destroy();
-
-		std::string s, s1, s2; int32_t nV = -1, nE = -1, nEdgesRead = 0;
-		bool have_1stline = false;
-		while (true) {
-			getline(*input, s);
-			if (s.length() <= 0) continue;
-			if ('c' == s[0] || 'C' == s[0]) continue;
-			std::istringstream line_stream(s);
-			if (!have_1stline) {
-				line_stream >> s1; line_stream >> s2; line_stream >> nV; line_stream >> nE;
-				if (0 == s1.length() || 0 == s2.length()) { res = 1 ; goto done ; }
-				if ('p' != s1[0] || "tw" != s2) { res = 1; goto done; }
-				have_1stline = true; break;
-				}
-			if (++nEdgesRead >= nE)
-				break;
-			}
-
-		SetN(nV) ;
-		SetK(1) ;
-
-		_nFunctions = nE;
-		if (_nFunctions < 1)
-			{ _nFunctions = 0; res = 0; goto done; }
-		_Functions = new ARE::Function*[_nFunctions];
-		if (NULL == _Functions)
-			{ res = 1 ; goto done ; }
-		for (i = 0; i < _nFunctions; i++)
-			_Functions[i] = NULL;
-
-		// read in function signatures
-		int32_t A[2] ;
-		while (true) {
-			getline(*input, s);
-			if (s.length() <= 0) continue;
-			if ('c' == s[0] || 'C' == s[0]) continue;
-			std::istringstream line_stream(s);
-			int32_t v1, v2 ; line_stream >> v1 ; line_stream >> v2 ;
-			_Functions[nEdgesRead] = new ARE::Function(NULL, this, nEdgesRead);
-			if (NULL == _Functions[nEdgesRead])
-				{ res = 1; goto done; }
-			ARE::Function *f = _Functions[nEdgesRead];
-			f->SetType(ARE_Function_Type_Const);
-			A[0] = v1-1 ; A[1] = v2-1 ; // var indeces in input range [1,n]
-			if (A[0] < 0 || A[0] >= _nVars || A[1] < 0 || A[1] >= _nVars)
-				{ res = 1; goto done; }
-			if (0 != f->SetArguments(2, A, -1))
-				goto done;
-			// sort scope, so that we can sort the function list easily
-			int32_t *sorted_scope = f->SortedArgumentsList(true);
-			if (NULL == sorted_scope)
-				{ res = 1; goto done; }
-			int64_t ts = f->ComputeTableSize();
-			f->ConstValue() = 0.0 ;
-			if (++nEdgesRead >= nE)
-				break;
+		// the file is mapped (stdin is read) as is, and parsed in place; adjacency lists are built directly, without functions.
+		ARE::utils::MappedFile file ;
+		if (0 != ("cin" == fn_pure ? file.Read(stdin) : file.Open(FileName))) {
+			if (NULL != ARE::fpLOG)
+				fprintf(ARE::fpLOG, "\nfailed to open file; will quit ...") ;
+			return ERRORCODE_cannot_open_file ;
 			}
-
-		DeleteDuplicateFunctions() ;
-
-		if (delete_istream) 
-			{ delete input ; input = NULL ; }
-		res = 0 ; goto done ;
+		res = LoadPACEFormat(file.Data(), file.Size()) ;
+		fileSize = file.Size() ;
 		}
 	else {
-		FILE *fp = fopen(FileName.c_str(), "rb") ;
-		if (NULL == fp) {
+		// the file is mapped and parsed in place (64-bit offsets throughout), so peak memory is the problem itself, not the problem plus a copy of the file.
+		ARE::utils::MappedFile file ;
+		if (0 != file.Open(FileName)) {
 			if (NULL != ARE::fpLOG)
 				fprintf(ARE::fpLOG, "\nfailed to open file; will quit ...") ;
 			return ERRORCODE_cannot_open_file ;
 			}
-		// get file size
-		fseek(fp, 0, SEEK_END) ;
-		int32_t filesize = ftell(fp) ;
-		fseek(fp, 0, SEEK_SET) ;
-//#define bufsize	 1048576
-//#define bufsize	16777216
-//#define bufsize	33554432
-		char *buf = new char[filesize] ;
-		if (NULL == buf) {
-			fclose(fp) ;
-			if (NULL != ARE::fpLOG)
-				fprintf(ARE::fpLOG, "\nfailed to allocate buffer for file data; will quit ...") ;
-			return ERRORCODE_cannot_allocate_buffer_size_too_large ;
-			}
-		int32_t L = fread(buf, 1, filesize, fp) ;
-		fclose(fp) ;
-		if (filesize != L) {
-			// we probably did not read in the whole file; buf is too small
-			// todo : can use foef() or ferror.
-			if (NULL != ARE::fpLOG) 
-				fprintf(ARE::fpLOG, "\nfailed to load file; will quit ...") ;
-			delete [] buf ;
-			return ERRORCODE_file_too_large ;
-			}
+		res = LoadFromBuffer("UAI", file.Data(), file.Size(), nThreads) ;
+		fileSize = file.Size() ;
+		}
 
-		res = LoadFromBuffer("UAI", buf, L) ;
-		delete [] buf ;
+	_FileSize = fileSize ;
+	_LoadTimeInMilliseconds = ARE::GetTimeInMilliseconds() - tStart ;
+	if (NULL != ARE::fpLOG) {
+		double MBps = (fileSize / 1048576.0) / (_LoadTimeInMilliseconds > 0 ? _LoadTimeInMilliseconds / 1000.0 : 0.001) ;
+		fprintf(ARE::fpLOG, "\nLoaded %lld bytes in %lldmsec (%.1f MB/s); peak memory %lldKB; res=%d", (long long) fileSize, (long long) _LoadTimeInMilliseconds, MBps, (long long) ARE::GetPeakMemoryUsageInKB(), (int) res) ;
 		}
 
-done :
 	return res ;
 }
 
 
-int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
+// scanner for PACE .gr format data : skips white space and comment lines (lines starting with 'c'), reads non-negative integers.
+class PACEformatScanner
+{
+public :
+	const char *_P, *_E ;
+	bool _LineStart ;
+	// move to the next token; returns false at the end of data.
+	inline bool SkipSpace(void)
+	{
+		while (_P < _E) {
+			char c = *_P ;
+			if ('\n' == c) 
+				{ _LineStart = true ; ++_P ; continue ; }
+			if (' ' == c || '\t' == c || '\r' == c) 
+				{ ++_P ; continue ; }
+			if (_LineStart && ('c' == c || 'C' == c)) {
+				const char *eol = (const char *) memchr(_P, '\n', _E - _P) ;
+				_P = NULL != eol ? eol : _E ;
+				continue ;
+				}
+			_LineStart = false ;
+			return true ;
+			}
+		return false ;
+	}
+	// read a non-negative integer (at most INT32_MAX); returns -1 if there is none.
+	inline int64_t ReadInt(void)
+	{
+		if (! SkipSpace()) 
+			return -1 ;
+		const char *p = _P ;
+		int64_t v = 0 ;
+		for (; p < _E && (uint32_t) (*p - '0') < 10 ; p++) {
+			v = 10*v + (*p - '0') ;
+			if (v > INT32_MAX) 
+				return -1 ;
+			}
+		if (p == _P) 
+			return -1 ;
+		_P = p ;
+		return v ;
+	}
+	PACEformatScanner(const char *buf, int64_t L) : _P(buf), _E(buf + L), _LineStart(true) { }
+} ;
+
+
+int32_t ARE::ARP::LoadPACEFormat(const char *buf, int64_t L)
+{
+	Destroy() ;
+	if (NULL == buf) 
+		return 1 ;
+
+	// header : p tw nVars nEdges
+	PACEformatScanner s(buf, L) ;
+	if (! s.SkipSpace() || 'p' != *s._P) 
+		return 1 ;
+	++s._P ;
+	if (! s.SkipSpace() || s._E - s._P < 2 || 't' != s._P[0] || 'w' != s._P[1]) 
+		return 1 ;
+	s._P += 2 ;
+	int64_t nV = s.ReadInt(), nE = s.ReadInt() ;
+	if (nV < 0 || nE < 0) 
+		return 1 ;
+	if (0 != SetN((int32_t) nV) || 0 != SetK(1)) 
+		return ERRORCODE_out_of_memory ;
+	_nFunctions = 0 ;
+	_IsGraph = true ;
+	if (nV < 1) 
+		return 0 ;
+
+	int32_t i, j, k ;
+	_Degree = new int32_t[_nVars] ;
+	_AdjVars = new int32_t[_nVars] ;
+	if (NULL == _Degree || NULL == _AdjVars) 
+		{ DestroyAdjVarList() ; return ERRORCODE_out_of_memory ; }
+	for (i = 0 ; i < _nVars ; i++) 
+		_Degree[i] = 0 ;
+
+	// pass 1 : count degrees (with duplicate edges); self-loops are ignored.
+	const char *edges = s._P ;
+	bool edgesLineStart = s._LineStart ;
+	int64_t e, n = 0 ;
+	for (e = 0 ; e < nE ; e++) {
+		int64_t u = s.ReadInt() - 1, v = s.ReadInt() - 1 ; // var indeces in input range [1,n]
+		if (u < 0 || u >= _nVars || v < 0 || v >= _nVars) 
+			{ DestroyAdjVarList() ; return 1 ; }
+		if (u == v) 
+			continue ;
+		_Degree[u]++ ;
+		_Degree[v]++ ;
+		n += 2 ;
+		}
+	if (n > INT32_MAX) 
+		{ DestroyAdjVarList() ; return ERRORCODE_file_too_large ; }
+	_StaticVarTotalList = n > 0 ? new int32_t[n] : NULL ;
+	if (n > 0 && NULL == _StaticVarTotalList) 
+		{ DestroyAdjVarList() ; return ERRORCODE_out_of_memory ; }
+	_StaticVarTotalListSize = (int32_t) n ;
+	for (n = i = 0 ; i < _nVars ; i++) {
+		_AdjVars[i] = (int32_t) n ;
+		n += _Degree[i] ;
+		_Degree[i] = 0 ;
+		}
+
+	// pass 2 : fill in adjacency lists.
+	s._P = edges ;
+	s._LineStart = edgesLineStart ;
+	for (e = 0 ; e < nE ; e++) {
+		int32_t u = (int32_t) s.ReadInt() - 1, v = (int32_t) s.ReadInt() - 1 ;
+		if (u == v) 
+			continue ;
+		_StaticVarTotalList[_AdjVars[u] + _Degree[u]++] = v ;
+		_StaticVarTotalList[_AdjVars[v] + _Degree[v]++] = u ;
+		}
+
+	// sort each list and drop duplicates; lists are moved down to fill the space freed by duplicates.
+	int32_t left[32], right[32] ;
+	_nSingletonVariables = 0 ;
+	for (n = i = 0 ; i < _nVars ; i++) {
+		int32_t *vars = _StaticVarTotalList + _AdjVars[i] ;
+		int32_t d = _Degree[i] ;
+		_AdjVars[i] = (int32_t) n ;
+		if (0 == d) 
+			{ ++_nSingletonVariables ; _AdjVars[i] = -1 ; continue ; }
+		for (j = 1 ; j < d && vars[j-1] < vars[j] ; j++) ;
+		if (j < d) 
+			QuickSortLong2(vars, d, left, right) ;
+		int32_t *out = _StaticVarTotalList + n ;
+		out[0] = vars[0] ;
+		for (k = 0, j = 1 ; j < d ; j++) {
+			if (vars[j] != out[k]) 
+				out[++k] = vars[j] ;
+			}
+		_Degree[i] = ++k ;
+		n += k ;
+		}
+
+	return 0 ;
+}
+
+
+int32_t ARE::ARP::CreateFunctionsFromGraph(void)
+{
+	if (! _IsGraph || _nFunctions > 0) 
+		return 0 ;
+	if (_nVars < 1 || NULL == _Degree) 
+		return 0 ;
+
+	int32_t i, j, n = 0 ;
+	for (i = 0 ; i < _nVars ; i++) {
+		for (j = 0 ; j < _Degree[i] ; j++) 
+			{ if (i < AdjVar(i, j)) n++ ; }
+		}
+	if (n < 1) 
+		return 0 ;
+	_Functions = new ARE::Function*[n] ;
+	if (NULL == _Functions) 
+		return ERRORCODE_out_of_memory ;
+	for (i = 0 ; i < n ; i++) 
+		_Functions[i] = NULL ;
+	_nFunctions = n ;
+
+	int32_t A[2] ;
+	for (n = i = 0 ; i < _nVars ; i++) {
+		for (j = 0 ; j < _Degree[i] ; j++) {
+			if (AdjVar(i, j) < i) 
+				continue ;
+			ARE::Function *f = _Functions[n] = new ARE::Function(NULL, this, n) ;
+			if (NULL == f) 
+				{ Destroy() ; return ERRORCODE_out_of_memory ; }
+			++n ;
+			f->SetType(ARE_Function_Type_Const) ;
+			A[0] = i ; A[1] = AdjVar(i, j) ;
+			if (0 != f->SetArguments(2, A, -1)) 
+				{ Destroy() ; return 1 ; }
+			if (NULL == f->SortedArgumentsList(true)) 
+				{ Destroy() ; return 1 ; }
+			f->ComputeTableSize() ;
+			f->ConstValue() = 0.0 ;
+			}
+		}
+
+	return ComputeAdjFnList(false) ;
+}
+
+
+// load the table of function F from [buf, buf+L) : # of entries, then the entries, some possibly in the sparse-factor encoding "(x:n)".
+// buf/L are moved past the table. if Store is false, the table is only skipped (this is used to find where each table starts). returns 0 iff ok.
+static int32_t LoadUAIFunctionTable(ARE::Function & F, const char * & buf, int64_t & L, bool Store)
+{
+	if (F.TableSize() < 0) 
+		return 0 ; // error
+	ARE_Function_TableType *data = F.TableData() ; // this may be NULL if const fn
+	const char *token = NULL ;
+	int32_t l = 0 ;
+	// load # of entries
+	int64_t n, j ;
+	if (0 != ARE::fileload_getnexttoken(buf, L, token, l, false) || 0 != ARE::fileload_parseint(token, l, n)) 
+		return 1 ;
+	if (n <= 0) 
+		return 1 ;
+	if (F.N() > 0 ? n != F.TableSize() : 1 != n) 
+		return 1 ;
+	for (j = 0 ; j < n ;) {
+		if (0 != ARE::fileload_getnexttoken(buf, L, token, l, true)) 
+			return 1 ;
+		// check sparse-factor encoding "(x:n)" where x is real number and n is an int32_t. meaning of this is, next entries in the table equal x.
+		if (1 == l && '(' == *token) {
+			// next token is x
+			double x = 0.0 ;
+			if (0 != ARE::fileload_getnexttoken(buf, L, token, l, true)) 
+				return 1 ;
+			if (Store && 0 != ARE::fileload_parsedouble(token, l, x)) 
+				return 1 ;
+			// next token is ":"
+			if (0 != ARE::fileload_getnexttoken(buf, L, token, l, true)) 
+				return 1 ;
+			if (1 != l || ':' != *token) 
+				return 1 ;
+			// next token is n
+			int64_t nEntries ;
+			if (0 != ARE::fileload_getnexttoken(buf, L, token, l, true) || 0 != ARE::fileload_parseint(token, l, nEntries)) 
+				return 1 ;
+			if (nEntries <= 0 || nEntries > n - j) 
+				return 1 ;
+			// next token is ")"
+			if (0 != ARE::fileload_getnexttoken(buf, L, token, l, true)) 
+				return 1 ;
+			if (1 != l || ')' != *token) 
+				return 1 ;
+			if (! Store) 
+				j += nEntries ;
+			else if (F.N() <= 0) {
+				F.ConstValue() = x ;
+				j += nEntries ;
+				}
+			else {
+				for (int64_t ni = 0 ; ni < nEntries ; ni++) 
+					data[j++] = x ;
+				}
+			}
+		else if (! Store) 
+			j++ ;
+		else {
+			// token is a table entry
+			double x ;
+			if (0 != ARE::fileload_parsedouble(token, l, x)) 
+				return 1 ;
+			if (F.N() <= 0) 
+				{ F.ConstValue() = x ; j++ ; }
+			else 
+				data[j++] = x ;
+			}
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::ARP::LoadUAIFormat(const char *buf, int64_t L, int32_t nThreads)
 {
 	if (NULL == buf) 
 		return 1 ;
@@ -565,18 +850,17 @@ int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
 		goto done ;
 */
 	// get # of variables
-	if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+	int32_t N ;
+	if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, N)) 
 		goto done ;
-	int32_t N = atoi(token) ;
 
 	if (N > 0) {
 		// get domain size of each variable
 		K = new int32_t[N] ;
 		if (NULL == K) goto done ;
 		for (i = 0 ; i < N ; i++) {
-			if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+			if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, K[i])) 
 				goto done ;
-			K[i] = atoi(token) ;
 			if (K[i] < 0 || K[i] > MAX_NUM_VALUES_PER_VAR_DOMAIN) 
 				{ ret = ERRORCODE_VarDomainSizeTooLarge ; goto done ; }
 			}
@@ -587,9 +871,8 @@ int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
 		}
 
 	// get # of functions
-	if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+	if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, _nFunctions)) 
 		goto done ;
-	_nFunctions = atoi(token) ;
 	if (_nFunctions < 1) 
 		{ _nFunctions = 0 ; ret = 0 ; goto done ; }
 	_Functions = new ARE::Function*[_nFunctions] ;
@@ -601,14 +884,14 @@ int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
 	// read in function signatures
 	int32_t A[MAX_NUM_ARGUMENTS_PER_FUNCTION] ;
 	for (i = 0 ; i < _nFunctions ; i++) {
-		if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+		int32_t nA ;
+		if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, nA)) 
 			goto done ;
-		int32_t nA = atoi(token) ;
 // 2014-11-09 KK : allow const functions; a function with nA==0 is a const fn.
 //		if (0 == nA) 
 //			// this means function is missing essentially
 //			continue ;
-		if (nA < 0) 
+		if (nA < 0 || nA > MAX_NUM_ARGUMENTS_PER_FUNCTION) 
 			goto done ;
 		_Functions[i] = new ARE::Function(NULL, this, i) ;
 		if (NULL == _Functions[i]) 
@@ -616,9 +899,8 @@ int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
 		ARE::Function *f = _Functions[i] ;
 		f->SetType(ARE_Function_Type_RealCost) ;
 		for (j = 0 ; j < nA ; j++) {
-			if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+			if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, A[j])) 
 				goto done ;
-			A[j] = atoi(token) ;
 			if (A[j] < 0 || A[j] >= _nVars) 
 				goto done ;
 			}
@@ -649,65 +931,39 @@ int32_t ARE::ARP::LoadUAIFormat(const char *buf, int32_t L)
 			}
 		}
 
-	// load function tables
+	// load function tables. with multiple threads, first find where each table starts (skipping a table is much cheaper than 
+	// parsing its entries), then parse tables in parallel; each table is written by one thread only.
 	for (i = 0 ; i < _nFunctions ; i++) {
-		ARE::Function *f = _Functions[i] ;
-		if (NULL == f) 
-			goto done ;
-		if (f->TableSize() < 0) 
-			continue ; // error
-		ARE_Function_TableType *data = f->TableData() ; // this may be NULL if const fn
-		// load # of entries
-		if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
-			goto done ;
-		int32_t n = atoi(token) ;
-		if (n <= 0) 
-			goto done ;
-		if (f->N() > 0 ? n != f->TableSize() : 1 != n) 
+		if (NULL == _Functions[i]) 
 			goto done ;
-		for (j = 0 ; j < n ;) {
-			if (0 != fileload_getnexttoken(buf, L, token, l, true)) 
+		}
+	if (nThreads > 1 && _nFunctions > 1 && L >= ARE_UAI_PARALLEL_LOAD_MIN_SIZE) {
+		std::vector<const char *> tableStart(_nFunctions) ;
+		std::vector<int64_t> tableL(_nFunctions) ;
+		for (i = 0 ; i < _nFunctions ; i++) {
+			tableStart[i] = buf ;
+			tableL[i] = L ;
+			if (0 != LoadUAIFunctionTable(*_Functions[i], buf, L, false)) 
 				goto done ;
-			// check sparse-factor encoding "(x:n)" where x is real number and n is an int32_t. meaning of this is, next entries in the table equal x.
-			if (1 == l && '(' == *token) {
-				// next token is x
-				if (0 != fileload_getnexttoken(buf, L, token, l, true)) 
-					goto done ;
-				double x = atof(token) ;
-				// next token is ":"
-				if (0 != fileload_getnexttoken(buf, L, token, l, true)) 
-					goto done ;
-				if (1 != l || ':' != *token) 
-					goto done ;
-				// next token is n
-				if (0 != fileload_getnexttoken(buf, L, token, l, true)) 
-					goto done ;
-				int32_t nEntriesLeft = n - j ;
-				int32_t nEntries = atoi(token) ;
-				if (nEntries <= 0 || nEntries > nEntriesLeft) 
-					goto done ;
-				// next token is ")"
-				if (0 != fileload_getnexttoken(buf, L, token, l, true)) 
-					goto done ;
-				if (1 != l || ')' != *token) 
-					goto done ;
-				if (f->N() <= 0) {
-					f->ConstValue() = x ;
-					j += nEntries ;
-					}
-				else {
-					for (int32_t ni = 0 ; ni < nEntries ; ni++) 
-						data[j++] = x ;
-					}
-				}
-			else {
-				// token is a table entry
-				double x = atof(token) ;
-				if (f->N() <= 0) 
-					{ f->ConstValue() = x ; j++ ; }
-				else 
-					data[j++] = x ;
+			}
+		std::atomic<int32_t> nErrors(0) ;
+		int32_t res = ARE::utils::ParallelFor(nThreads, _nFunctions, ARE_UAI_PARALLEL_LOAD_CHUNK_SIZE, [&](int32_t /* ThreadIdx */, int64_t Begin, int64_t End)
+		{
+			for (int64_t k = Begin ; k < End ; k++) {
+				const char *b = tableStart[k] ;
+				int64_t bL = tableL[k] ;
+				if (0 != LoadUAIFunctionTable(*_Functions[k], b, bL, true)) 
+					++nErrors ;
 				}
+		}) ;
+		// a chunk that threw (e.g. out of memory) left some tables unparsed.
+		if (0 != res || nErrors > 0) 
+			goto done ;
+		}
+	else {
+		for (i = 0 ; i < _nFunctions ; i++) {
+			if (0 != LoadUAIFunctionTable(*_Functions[i], buf, L, true)) 
+				goto done ;
 			}
 		}
 
@@ -734,46 +990,22 @@ int32_t ARE::ARP::LoadFromFile_Evidence(const std::string & FileName, int32_t &
 {
 	nEvidenceVars = 0 ;
 
-	int32_t ret = 1 ;
-	const char *buf = NULL ;
-	char *BUF = NULL ;
-	int32_t *K = NULL ;
-
-	FILE *fp = fopen(FileName.c_str(), "r") ;
-	if (NULL == fp) 
+	ARE::utils::MappedFile file ;
+	if (0 != file.Open(FileName)) 
 		return 1 ;
-
-	// get file size
-	fseek(fp, 0, SEEK_END) ;
-	int32_t filesize = ftell(fp) ;
-	if (filesize <= 0) {
+	if (file.Size() <= 0) {
 		printf("\nevidencefile empty; will quit ...") ;
 		return 1 ;
 		}
-	fseek(fp, 0, SEEK_SET) ;
-
-	BUF = new char[filesize] ;
-	if (NULL == BUF) {
-		printf("\nfailed to allocate memory for evidencefile; will quit ...") ;
-		return 1 ;
-		}
-	int32_t L = fread(BUF, 1, filesize, fp) ;
-	fclose(fp) ;
-	if (filesize == L) {
-		delete [] BUF ;
-		printf("\nfailed to load evidence file ...") ;
-		return 1 ;
-		}
 
-	int32_t res = LoadUAIFormat_Evidence(BUF, L, nEvidenceVars) ;
+	int32_t res = LoadUAIFormat_Evidence(file.Data(), file.Size(), nEvidenceVars) ;
 	if (0 == res) 
 		_EvidenceFileName = FileName ;
-	delete [] BUF ;
 	return res ;
 }
 
 
-int32_t ARE::ARP::LoadUAIFormat_Evidence(const char *BUF, int32_t L, int32_t & nEvidenceVars)
+int32_t ARE::ARP::LoadUAIFormat_Evidence(const char *BUF, int64_t L, int32_t & nEvidenceVars)
 {
 	// file format is : <nEvidence> followed by nEvidence times <evidVar> <evidValue>.
 	// it will set evidence as the current value of the variable.
@@ -793,9 +1025,9 @@ int32_t ARE::ARP::LoadUAIFormat_Evidence(const char *BUF, int32_t L, int32_t & n
 	{
 	// get # of evidence
 	buf = BUF ;
-	if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+	int32_t N ;
+	if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, N)) 
 		goto done ;
-	int32_t N = atoi(token) ;
 	if (N < 1) 
 		goto doneok ;
 
@@ -811,12 +1043,11 @@ int32_t ARE::ARP::LoadUAIFormat_Evidence(const char *BUF, int32_t L, int32_t & n
 	// read in evidence
 	int32_t n = 0 ;
 	for (i = 0 ; i < N ; i++) {
-		if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+		int32_t var, val ;
+		if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, var)) 
 			goto done ;
-		int32_t var = atoi(token) ;
-		if (0 != fileload_getnexttoken(buf, L, token, l, false)) 
+		if (0 != fileload_getnexttoken(buf, L, token, l, false) || 0 != fileload_parseint(token, l, val)) 
 			goto done ;
-		int32_t val = atoi(token) ;
 		if (var < 0 || var >= _nVars) 
 			goto done ;
 		if (val < 0 || val >= _K[var]) 
@@ -847,7 +1078,8 @@ int32_t ARE::ARP::PerformPostConstructionAnalysis(void)
 	int32_t i = 0 ;
 	if (0 == i) 
 		i = ComputeAdjFnList(false) ;
-	if (0 == i) 
+	// for a graph, adjacency is given; there are no functions to compute it from.
+	if (0 == i && ! _IsGraph) 
 		i = ComputeAdjVarList() ;
 	if (0 == i) 
 		i = ComputeConnectedComponents() ;
@@ -40,6 +40,13 @@ public :
 	int32_t GetFilename(const std::string & Dir, std::string & fn) ; // filename will not have an extension
 	inline void SetFileName(const std::string & FileName) { _FileName = FileName ; }
 
+protected :
+	int64_t _FileSize ; // size (in bytes) of the data loaded by LoadFromFile()
+	int64_t _LoadTimeInMilliseconds ; // time LoadFromFile() took to map/read and parse the data
+public :
+	inline int64_t FileSize(void) const { return _FileSize ; }
+	inline int64_t LoadTimeInMilliseconds(void) const { return _LoadTimeInMilliseconds ; }
+
 protected :
 	FILE *_fpLOG ;
 public :
@@ -224,7 +231,9 @@ protected :
 	int32_t *_Degree ; // for each variable, its degree in the graph
 	int32_t *_AdjVars ; // for each variable, idx into _StaticVarTotalList[] array where AdjVar list (vars that this var is adj to) for that var start; length of list is _Degree[].
 	int32_t _nSingletonVariables ;
+	bool _IsGraph ; // problem is just a graph (e.g. loaded from a .gr file) : there are no functions, adjacency (_Degree/_AdjVars/_StaticVarTotalList) is given.
 public :
+	inline bool IsGraph(void) const { return _IsGraph ; }
 	inline int32_t Degree(int32_t idxVar) { return _Degree[idxVar] ; }
 	inline int32_t AdjVar(int32_t idxVar, int32_t idxAdjVar) { return _StaticVarTotalList[_AdjVars[idxVar] + idxAdjVar] ; }
 	int32_t DestroyAdjVarList(void) ;
@@ -391,16 +400,21 @@ public :
 	virtual int32_t SaveXML(const std::string & Dir) ;
 	virtual int32_t SaveUAI08(const std::string & Dir) ;
 
-	// load from file/buffer.
-	int32_t LoadFromFile(const std::string & FileName) ;
+	// load from file/buffer. nThreads is the number of threads that can be used to parse (UAI) function tables.
+	int32_t LoadFromFile(const std::string & FileName, int32_t nThreads = 1) ;
 	int32_t LoadFromFile_Evidence(const std::string & FileName, int32_t & nEvidenceVars) ;
 
 	// this function loads problem from UAI format file; we assume data is already in buf.
-	int32_t LoadFromBuffer(const char *format, const char *buf, int32_t L) ;
-	int32_t LoadFromBuffer_Evidence(const char *format, const char *buf, int32_t L, int32_t & nEvidenceVars) ;
+	int32_t LoadFromBuffer(const char *format, const char *buf, int64_t L, int32_t nThreads = 1) ;
+	int32_t LoadFromBuffer_Evidence(const char *format, const char *buf, int64_t L, int32_t & nEvidenceVars) ;
 
-	int32_t LoadUAIFormat(const char *buf, int32_t L) ;
-	int32_t LoadUAIFormat_Evidence(const char *buf, int32_t L, int32_t & nEvidenceVars) ;
+	int32_t LoadUAIFormat(const char *buf, int64_t L, int32_t nThreads = 1) ;
+	// load graph in PACE .gr format ("p tw nVars nEdges", then one edge "u v" per line, vars in [1,nVars]); adjacency lists are built directly, without functions. 
+	// self-loops and duplicate edges are dropped.
+	int32_t LoadPACEFormat(const char *buf, int64_t L) ;
+	// for a graph (see IsGraph()), create a const function for each edge; needed by algorithms that work with functions (e.g. bucket elimination).
+	int32_t CreateFunctionsFromGraph(void) ;
+	int32_t LoadUAIFormat_Evidence(const char *buf, int64_t L, int32_t & nEvidenceVars) ;
 
 public :
 
@@ -431,11 +445,16 @@ public :
 		_nVars = 0 ;
 		_nSingletonDomainVariables = -1 ;
 		_nConnectedComponents = -1 ;
+		_IsGraph = false ;
 		_FileName.erase() ;
+		_FileSize = 0 ;
+		_LoadTimeInMilliseconds = 0 ;
 		_QueryVariable = -1 ;
 	}
 	ARP(const char *Name = NULL)
 		:
+		_FileSize(0), 
+		_LoadTimeInMilliseconds(0), 
 		_fpLOG(NULL), 
 		_nVars(0), 
 		_K(NULL), 
@@ -455,6 +474,7 @@ public :
 		_Degree(NULL), 
 		_AdjVars(NULL), 
 		_nSingletonVariables(-1), 
+		_IsGraph(false), 
 		_nConnectedComponents(-1), 
 		_VarOrdering_InducedWidth(-1), 
 		_VarOrdering_VarList(NULL), 
@@ -472,7 +492,11 @@ public :
 	}
 } ;
 
-int32_t fileload_getnexttoken(const char * & buf, int32_t & L, const char * & B, int32_t & l, bool IncludeSpecialSymbols) ;
+int32_t fileload_getnexttoken(const char * & buf, int64_t & L, const char * & B, int32_t & l, bool IncludeSpecialSymbols) ;
+// parse token [B, B+l) as an integer/real number; return 0 iff ok.
+int32_t fileload_parseint(const char *B, int32_t l, int64_t & v) ;
+int32_t fileload_parseint(const char *B, int32_t l, int32_t & v) ;
+int32_t fileload_parsedouble(const char *B, int32_t l, double & x) ;
 
 } // namespace ARE
 
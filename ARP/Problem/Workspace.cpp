@@ -6,6 +6,8 @@
 //#include "ProblemGraphNode.hxx"
 #include "Workspace.hxx"
 #include "MBEworkspace.hxx"
+#include "Bucket.hxx"
+#include "MiniBucket.hxx"
 
 int ARE::Workspace::Destroy(void)
 {
@@ -16,6 +18,8 @@ int ARE::Workspace::Destroy(void)
 		}
 	if (NULL != _Problem && _ProblemBelongsToWorkspace) 
 		delete _Problem ;
+	// tables of the functions of the workspace have been released by now.
+	_TablePool.Trim() ;
 	_IsValid = true ;
 	return 0 ;
 }
@@ -43,11 +47,9 @@ bool ARE::Workspace::HasErrorExplanation(void)
 void ARE::Workspace::LogStatistics(time_t ttStart, time_t ttFinish)
 {
 	if (NULL != ARE::fpLOG) {
-/*		char s[1024] ;
-		__int64 i64 ;
-		int i ;
+		int32_t i ;
 
-		BucketElimination::BEworkspace *bews = dynamic_cast<BucketElimination::BEworkspace *>(this) ;
+		BucketElimination::MBEworkspace *bews = dynamic_cast<BucketElimination::MBEworkspace *>(this) ;
 
 		// compute runtime
 		time_t runtime = ttFinish - ttStart ;
@@ -58,22 +60,17 @@ void ARE::Workspace::LogStatistics(time_t ttStart, time_t ttFinish)
 		d -= min*60 ;
 		int sec = d ;
 
-		time_t ttNow ;
-		time(&ttNow) ;
-		struct tm *pTime = localtime(&ttNow) ;
-		char *sDT = asctime(pTime) ; // from manual : The string result produced by asctime contains exactly 26 characters and has the form Wed Jan 02 02:03:55 1980\n\0.
-		fprintf(ARE::fpLOG, "\nBEEM Task Generator : no more FTBs to compute; runtime=%d:%d:%d DT=%s", hour, min, sec, sDT) ;
-
 		__int64 curSpace = CurrentDiskMemorySpaceCached() ;
 		__int64 maxSpace = MaximumDiskMemorySpaceCached() ;
 		int nInMemory = nDiskTableBlocksInMemory() ;
 		int maxInMemory = MaximumNumConcurrentDiskTableBlocksInMemory() ;
 		bool hasErrors = HasErrorExplanation() ;
-		fprintf(ARE::fpLOG, "\nBEEM Task Generator : stats : \n   hasErrors=%c \n   nTableBlocksLoaded=%I64d nTableBlocksSaved=%I64d \n   CurrentDiskMemorySpaceCached=%I64d MaximumDiskMemorySpaceCached=%I64d \n   CurrentNumDiskBlocksInMemory=%d maxNumConcurDiskBlocksInMemory=%d", 
+		fprintf(ARE::fpLOG, "\nExternal memory stats : \n   hasErrors=%c \n   TableMemoryLimit=%lld DiskTableBlockSize=%lld \n   nTableBlocksLoaded=%lld nTableBlocksSaved=%lld \n   CurrentDiskMemorySpaceCached=%lld MaximumDiskMemorySpaceCached=%lld \n   CurrentNumDiskBlocksInMemory=%d maxNumConcurDiskBlocksInMemory=%d", 
 			(char) (hasErrors ? 'Y' : 'N'), 
-			(__int64) nTableBlocksLoaded(), 
-			(__int64) nTableBlocksSaved(), 
-			curSpace, maxSpace, nInMemory, maxInMemory) ;
+			(long long) _TableMemoryLimit, (long long) _DiskTableBlockSize, 
+			(long long) nTableBlocksLoaded(), 
+			(long long) nTableBlocksSaved(), 
+			(long long) curSpace, (long long) maxSpace, nInMemory, maxInMemory) ;
 		__int64 tw = InputTableBlocksWaitPeriodTotal() ;
 		__int64 nBlocksWaited = nInputTableBlocksWaited() ;
 		if (NULL != bews) {
@@ -81,7 +78,7 @@ void ARE::Workspace::LogStatistics(time_t ttStart, time_t ttFinish)
 			fprintf(ARE::fpLOG, "\n   nBucketsWithSingleChild_initial=%d nBucketsWithSingleChild_final=%d", (int) bews->nBucketsWithSingleChild_initial(), (int) bews->nBucketsWithSingleChild_final()) ;
 			fprintf(ARE::fpLOG, "\n   nVarsWithoutBucket=%d nConstValueFunctions=%d", (int) bews->nVarsWithoutBucket(), (int) bews->nConstValueFunctions()) ;
 			}
-		fprintf(ARE::fpLOG, "\n   InputTableBlockWaiting=(%I64d times, %I64d millisec) ", nBlocksWaited, tw) ;
+		fprintf(ARE::fpLOG, "\n   InputTableBlockWaiting=(%lld times, %lld millisec) ", (long long) nBlocksWaited, (long long) tw) ;
 		double x = _InputTableGetTimeTotal/1000.0 ;
 		fprintf(ARE::fpLOG, "\n   InputTableGetTimeTotal=%g sec", x) ;
 		x = _FileLoadTimeTotal/1000.0 ;
@@ -90,7 +87,6 @@ void ARE::Workspace::LogStatistics(time_t ttStart, time_t ttFinish)
 		fprintf(ARE::fpLOG, "\n   FileSaveTimeTotal=%g sec", x) ;
 		x = _FTBComputationTimeTotal/1000.0 ;
 		fprintf(ARE::fpLOG, "\n   FTBComputationTimeTotal=%g sec", x) ;
-		x = _FTBComputationTimeTotal/1000.0 ;
 		fprintf(ARE::fpLOG, "\n   runtime=%d sec (%d:%d:%d)", (int) runtime, (int) hour, (int) min, (int) sec) ;
 		x = runtime > 0 ? ((double) _FTBComputationTimeTotal + tw)/((double) 1000.0*runtime) : -1.0 ;
 		fprintf(ARE::fpLOG, "\n   avg num threads busy+wait = %g", x) ;
@@ -99,13 +95,19 @@ void ARE::Workspace::LogStatistics(time_t ttStart, time_t ttFinish)
 		fprintf(ARE::fpLOG, "\n   avg num threads actually computing data = %g", x) ;
 		if (NULL != bews) {
 			fprintf(ARE::fpLOG, "\nNumber of FTBs loaded per bucket") ;
-			for (i = 0 ; i < bews->nBuckets() ; i++) {
+			for (i = 0 ; i < bews->nBuckets() && i < MAX_NUM_BUCKETS ; i++) {
 				BucketElimination::Bucket *b = bews->getBucket(i) ;
-				Function & f = b->OutputFunction() ;
-				__int64 nblocks = f.nTableBlocks() ;
-				fprintf(ARE::fpLOG, "\n bucket %d OUT : n blocks = %I64d, n times loaded %d", (int) i, nblocks, _nFTBsLoadedPerBucket[i]) ;
+				if (NULL == b) continue ;
+				__int64 nblocks = 0 ;
+				for (BucketElimination::MiniBucket *mb : b->MiniBuckets()) {
+					Function & f = mb->OutputFunction() ;
+					if (f.nTableBlocks() > 0) 
+						nblocks += f.nTableBlocks() ;
+					}
+				if (nblocks > 0 || _nFTBsLoadedPerBucket[i] > 0) 
+					fprintf(ARE::fpLOG, "\n bucket %d OUT : n blocks = %lld, n times loaded %d", (int) i, (long long) nblocks, _nFTBsLoadedPerBucket[i]) ;
 				}
-			}*/
+			}
 		fflush(ARE::fpLOG) ;
 		}
 }
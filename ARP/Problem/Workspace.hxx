@@ -9,6 +9,7 @@
 
 #include "Explanation.hxx"
 #include "Function.hxx"
+#include "Utils/TablePool.hxx"
 
 namespace ARE { class ARP ; }
 namespace ARE { class Function ; }
@@ -52,6 +53,24 @@ public :
 	void AddExplanation(ARE::Explanation & E) ;
 	bool HasErrorExplanation(void) ;
 
+	// **************************************************************************************************
+	// Table memory
+	// **************************************************************************************************
+
+protected :
+	// tables of functions that belong to this workspace (i.e. generated during the computation) are allocated from this pool, so that their memory 
+	// is recycled. the pool enforces the table space budget (if any) and keeps the high-water mark of table space in use.
+	ARE::utils::TablePool _TablePool ;
+	bool _UseTablePool ;
+public :
+	inline ARE::utils::TablePool *TableDataPool(void) { return _UseTablePool ? &_TablePool : NULL ; }
+	inline void SetUseTablePool(bool Use) { _UseTablePool = Use ; }
+	// hard budget (in bytes) of pool tables in memory; allocating a table that would exceed it fails. 0 = no limit.
+	inline int64_t TableSpaceBudget(void) const { return _TablePool.ByteLimit() ; }
+	inline void SetTableSpaceBudget(int64_t Budget) { _TablePool.SetByteLimit(Budget) ; }
+	// large pool tables are advised to be backed by (transparent) huge pages.
+	inline void SetUseHugePagesForTables(bool Use) { _TablePool.SetUseHugePages(Use) ; }
+
 	// **************************************************************************************************
 	// External Memory BE
 	// **************************************************************************************************
@@ -69,8 +88,19 @@ public :
 
 protected :
 	std::string _DiskSpaceDirectory ;
+	// memory budget (in bytes) for tables of functions generated during the computation. when it is exceeded, tables are saved to 
+	// _DiskSpaceDirectory as blocks of _DiskTableBlockSize elements and removed from memory, then loaded back when needed. 0 = no limit.
+	int64_t _TableMemoryLimit ;
+	int64_t _DiskTableBlockSize ;
 public :
 	inline const std::string & DiskSpaceDirectory(void) const { return _DiskSpaceDirectory ; }
+	inline void SetDiskSpaceDirectory(const char *Dir) { _DiskSpaceDirectory = NULL != Dir ? Dir : "" ; }
+	inline int64_t TableMemoryLimit(void) const { return _TableMemoryLimit ; }
+	inline void SetTableMemoryLimit(int64_t Limit) { _TableMemoryLimit = Limit > 0 ? Limit : 0 ; }
+	inline int64_t DiskTableBlockSize(void) const { return _DiskTableBlockSize ; }
+	inline void SetDiskTableBlockSize(int64_t Size) { _DiskTableBlockSize = Size > 0 ? Size : ARE_Function_TableBlockSize ; }
+	// tables are moved to disk iff there is a memory budget and a directory to store the tables in.
+	inline bool UseDiskTableBlocks(void) const { return _TableMemoryLimit > 0 && _DiskSpaceDirectory.length() > 0 ; }
 
 protected :
 	__int64 _nInputTableBlocksWaited ;
@@ -135,10 +165,10 @@ public :
 		ARE::utils::AutoLock lock(_FTBMutex) ;
 		_InputTableBlocksWaitPeriodTotal += WaitInMilliseconds ;
 		if (Increment) {
-//if (_nInputTableBlocksWaited < 128) {
-//_InputFTBWait_BucketIDX[_nInputTableBlocksWaited] = BucketIDX ;
-//_InputFTBWait_BlockIDX[_nInputTableBlocksWaited] = BlockIDX ;
-//}
+			if (_nInputTableBlocksWaited < 128) {
+				_InputFTBWait_BucketIDX[_nInputTableBlocksWaited] = BucketIDX ;
+				_InputFTBWait_BlockIDX[_nInputTableBlocksWaited] = (int) BlockIDX ;
+				}
 			++_nInputTableBlocksWaited ;
 			}
 	}
@@ -146,7 +176,7 @@ public :
 	{
 		ARE::utils::AutoLock lock(_FTBMutex) ;
 		++_nTableBlocksLoaded ;
-		if (IDX >= 0) 
+		if (IDX >= 0 && IDX < MAX_NUM_BUCKETS) 
 			_nFTBsLoadedPerBucket[IDX]++ ;
 	}
 	inline void IncrementnTableBlocksSaved(void)
@@ -196,6 +226,9 @@ public :
 		_Problem(NULL), 
 		_HasFatalError(false), 
 		_ExplanationList(NULL), 
+		_UseTablePool(true), 
+		_TableMemoryLimit(0), 
+		_DiskTableBlockSize(ARE_Function_TableBlockSize), 
 		_nInputTableBlocksWaited(0), 
 		_InputTableBlocksWaitPeriodTotal(0), 
 		_InputTableGetTimeTotal(0), 
@@ -211,6 +244,7 @@ public :
 	{
 		if (NULL != BEEMDiskSpaceDirectory) 
 			_DiskSpaceDirectory = BEEMDiskSpaceDirectory ;
+		ResetStatistics() ;
 	}
 	virtual ~Workspace(void)
 	{
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Utils/MappedFile.hxx"
+
+ARE::utils::MappedFile::MappedFile(void)
+	:
+	_Data(NULL), 
+	_Size(0), 
+	_IsMapped(false)
+{
+}
+
+
+ARE::utils::MappedFile::~MappedFile(void)
+{
+	Close() ;
+}
+
+
+void ARE::utils::MappedFile::Close(void)
+{
+	if (NULL != _Data) {
+#if defined (LINUX)
+		if (_IsMapped) 
+			munmap(_Data, _Size) ;
+		else 
+#endif
+			delete [] _Data ;
+		}
+	_Data = NULL ;
+	_Size = 0 ;
+	_IsMapped = false ;
+}
+
+
+int32_t ARE::utils::MappedFile::Open(const std::string & FileName)
+{
+	Close() ;
+#if defined (LINUX)
+	int fd = open(FileName.c_str(), O_RDONLY) ;
+	if (fd < 0) 
+		return 1 ;
+	struct stat st ;
+	if (0 != fstat(fd, &st)) 
+		{ close(fd) ; return 1 ; }
+	if (st.st_size > 0) {
+		void *p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+		if (MAP_FAILED == p) 
+			{ close(fd) ; return 1 ; }
+		madvise(p, (size_t) st.st_size, MADV_SEQUENTIAL) ;
+		_Data = (char *) p ;
+		_Size = st.st_size ;
+		_IsMapped = true ;
+		}
+	close(fd) ;
+	return 0 ;
+#else
+	FILE *fp = fopen(FileName.c_str(), "rb") ;
+	if (NULL == fp) 
+		return 1 ;
+	int32_t res = Read(fp) ;
+	fclose(fp) ;
+	return res ;
+#endif
+}
+
+
+int32_t ARE::utils::MappedFile::Read(FILE *fp)
+{
+	Close() ;
+	if (NULL == fp) 
+		return 1 ;
+	int64_t capacity = 0 ;
+	while (true) {
+		if (_Size >= capacity) {
+			int64_t newCapacity = capacity > 0 ? capacity << 1 : 1048576 ;
+			char *d = new char[newCapacity] ;
+			if (NULL == d) 
+				{ Close() ; return 1 ; }
+			if (_Size > 0) 
+				memcpy(d, _Data, _Size) ;
+			if (NULL != _Data) 
+				delete [] _Data ;
+			_Data = d ;
+			capacity = newCapacity ;
+			}
+		size_t n = fread(_Data + _Size, 1, (size_t) (capacity - _Size), fp) ;
+		if (0 == n) 
+			break ;
+		_Size += n ;
+		}
+	if (ferror(fp)) 
+		{ Close() ; return 1 ; }
+	return 0 ;
+}
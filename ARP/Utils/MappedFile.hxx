@@ -0,0 +1,35 @@
+#ifndef ARE_MappedFile_HXX_INCLUDED
+#define ARE_MappedFile_HXX_INCLUDED
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+
+namespace ARE {
+namespace utils {
+
+// read-only view of the contents of a file. on LINUX the file is memory-mapped, so that loading a large file does not need 
+// a copy of it in the heap; elsewhere (and for streams, e.g. stdin) the contents are read into memory.
+class MappedFile
+{
+protected :
+	char *_Data ;
+	int64_t _Size ;
+	bool _IsMapped ; // true iff _Data is a mapping; otherwise it was allocated with new []
+public :
+	inline const char *Data(void) const { return _Data ; }
+	inline int64_t Size(void) const { return _Size ; }
+	// open the file; returns 0 iff ok.
+	int32_t Open(const std::string & FileName) ;
+	// read the stream until its end; returns 0 iff ok.
+	int32_t Read(FILE *fp) ;
+	void Close(void) ;
+public :
+	MappedFile(void) ;
+	~MappedFile(void) ;
+} ;
+
+}} // namespace ARE::utils
+
+#endif // ARE_MappedFile_HXX_INCLUDED
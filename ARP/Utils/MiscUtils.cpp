@@ -9,6 +9,7 @@
 
 #if defined WINDOWS || _WINDOWS
 #include <windows.h>
+#include <psapi.h>
 #endif
 
 #include <cstring>
@@ -18,6 +19,7 @@
 
 #ifdef LINUX
 #include <chrono>
+#include <sys/resource.h>
 #endif
 
 
@@ -39,6 +41,24 @@ INT64 ARE::GetTimeInMilliseconds(void)
 }
 
 
+int64_t ARE::GetPeakMemoryUsageInKB(void)
+{
+#if defined WINDOWS || _WINDOWS
+	PROCESS_MEMORY_COUNTERS pmc ;
+	if (! GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) 
+		return -1 ;
+	return pmc.PeakWorkingSetSize >> 10 ;
+#elif defined LINUX
+	struct rusage ru ;
+	if (0 != getrusage(RUSAGE_SELF, &ru)) 
+		return -1 ;
+	return ru.ru_maxrss ; // in KB on linux
+#else
+	return -1 ;
+#endif
+}
+
+
 int ARE::ExtractVarValuePairs(char *BUF, int L, std::list<std::pair<std::string,std::string>> & AssignmentList)
 {
 	AssignmentList.clear() ;
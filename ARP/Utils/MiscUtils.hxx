@@ -16,6 +16,8 @@ typedef int64_t INT64 ;
 namespace ARE {
 
 int64_t GetTimeInMilliseconds(void) ;
+// peak resident memory of this process so far, in KB; -1 if not known.
+int64_t GetPeakMemoryUsageInKB(void) ;
 
 int ExtractVarValuePairs(/* IN */ char *BUF, int L, /* OUT */ std::list<std::pair<std::string,std::string>> & List) ;
 int ExtractParameterValue(/* IN */ std::string & Paramater, std::list<std::pair<std::string,std::string>> AssignmentList, /* OUT */ std::string & Value) ;
@@ -0,0 +1,186 @@
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (LINUX)
+#include <sys/mman.h>
+#elif defined WINDOWS || _WINDOWS
+#include <malloc.h>
+#endif
+
+#include "Utils/TablePool.hxx"
+
+ARE::utils::TablePool::TablePool(void)
+	:
+	_ByteLimit(0), 
+	_UseHugePages(false), 
+	_nBytesInUse(0), 
+	_MaxBytesInUse(0), 
+	_nBytesCached(0), 
+	_MaxBytesReserved(0), 
+	_nAllocations(0), 
+	_nAllocationsReused(0), 
+	_nAllocationsFailed(0)
+{
+}
+
+
+ARE::utils::TablePool::~TablePool(void)
+{
+	Trim() ;
+}
+
+
+void ARE::utils::TablePool::ResetStatistics(void)
+{
+	std::lock_guard<std::mutex> lock(_M) ;
+	_MaxBytesInUse = _nBytesInUse ;
+	_MaxBytesReserved = _nBytesInUse + _nBytesCached ;
+	_nAllocations = _nAllocationsReused = _nAllocationsFailed = 0 ;
+}
+
+
+int32_t ARE::utils::TablePool::SizeClass(int64_t Size)
+{
+	if (Size <= ARE_TablePool_MinBlockSize) 
+		return 0 ;
+	// 2^e <= Size-1 < 2^(e+1); the classes between 2^e and 2^(e+1) are 2^e + m*2^(e-2), m=1..4.
+	uint64_t s = (uint64_t) (Size - 1) ;
+	int32_t e = 0 ;
+	while ((s >> e) > 1) 
+		++e ;
+	int32_t m = (int32_t) (s >> (e - 2)) - 3 ;
+	int32_t e0 = 0 ;
+	while ((1 << e0) < ARE_TablePool_MinBlockSize) 
+		++e0 ;
+	return (e - e0)*4 + m ;
+}
+
+
+int64_t ARE::utils::TablePool::ClassSize(int32_t SizeClass)
+{
+	int32_t e0 = 0 ;
+	while ((1 << e0) < ARE_TablePool_MinBlockSize) 
+		++e0 ;
+	int32_t e = e0 + SizeClass/4, m = SizeClass%4 ;
+	return ((int64_t) (4 + m)) << (e - 2) ;
+}
+
+
+void *ARE::utils::TablePool::AllocateBlock(int64_t Size, bool UseHugePages)
+{
+	void *p = NULL ;
+#if defined (LINUX)
+	if (Size >= ARE_TablePool_MapThreshold) {
+		p = mmap(NULL, (size_t) Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ;
+		if (MAP_FAILED == p) 
+			return NULL ;
+#ifdef MADV_HUGEPAGE
+		if (UseHugePages) 
+			madvise(p, (size_t) Size, MADV_HUGEPAGE) ;
+#endif
+		return p ;
+		}
+	if (0 != posix_memalign(&p, ARE_TablePool_Alignment, (size_t) Size)) 
+		return NULL ;
+#elif defined WINDOWS || _WINDOWS
+	p = _aligned_malloc((size_t) Size, ARE_TablePool_Alignment) ;
+#else
+	p = malloc((size_t) Size) ;
+#endif
+	return p ;
+}
+
+
+void ARE::utils::TablePool::FreeBlock(void *Block, int64_t Size)
+{
+#if defined (LINUX)
+	if (Size >= ARE_TablePool_MapThreshold) 
+		munmap(Block, (size_t) Size) ;
+	else 
+		free(Block) ;
+#elif defined WINDOWS || _WINDOWS
+	_aligned_free(Block) ;
+#else
+	free(Block) ;
+#endif
+}
+
+
+void ARE::utils::TablePool::ReleaseCachedBlocks(int64_t Keep)
+{
+	for (int32_t c = (int32_t) _FreeLists.size() - 1 ; c >= 0 && _nBytesCached > Keep ; c--) {
+		int64_t size = ClassSize(c) ;
+		while (NULL != _FreeLists[c] && _nBytesCached > Keep) {
+			void *p = _FreeLists[c] ;
+			_FreeLists[c] = *((void**) p) ;
+			FreeBlock(p, size) ;
+			_nBytesCached -= size ;
+			}
+		}
+}
+
+
+void *ARE::utils::TablePool::Allocate(int64_t Size)
+{
+	if (Size <= 0) 
+		return NULL ;
+	int32_t c = SizeClass(Size) ;
+	int64_t size = ClassSize(c) ;
+
+	std::lock_guard<std::mutex> lock(_M) ;
+	++_nAllocations ;
+	if (_ByteLimit > 0 && _nBytesInUse + size > _ByteLimit) 
+		{ ++_nAllocationsFailed ; return NULL ; }
+	void *p = NULL ;
+	if (c < (int32_t) _FreeLists.size() && NULL != _FreeLists[c]) {
+		p = _FreeLists[c] ;
+		_FreeLists[c] = *((void**) p) ;
+		_nBytesCached -= size ;
+		++_nAllocationsReused ;
+		}
+	else {
+		if (c >= (int32_t) _FreeLists.size()) 
+			_FreeLists.resize(c + 1, NULL) ;
+		// don't let cached blocks of other classes grow the pool beyond its high-water mark.
+		int64_t reserved = _nBytesInUse + _nBytesCached + size ;
+		if (reserved > _MaxBytesReserved && _nBytesCached > 0) 
+			ReleaseCachedBlocks(_MaxBytesReserved - _nBytesInUse - size) ;
+		p = AllocateBlock(size, _UseHugePages) ;
+		if (NULL == p && _nBytesCached > 0) {
+			ReleaseCachedBlocks(0) ;
+			p = AllocateBlock(size, _UseHugePages) ;
+			}
+		if (NULL == p) 
+			{ ++_nAllocationsFailed ; return NULL ; }
+		}
+	_nBytesInUse += size ;
+	if (_nBytesInUse > _MaxBytesInUse) 
+		_MaxBytesInUse = _nBytesInUse ;
+	if (_nBytesInUse + _nBytesCached > _MaxBytesReserved) 
+		_MaxBytesReserved = _nBytesInUse + _nBytesCached ;
+	return p ;
+}
+
+
+void ARE::utils::TablePool::Free(void *Block, int64_t Size)
+{
+	if (NULL == Block || Size <= 0) 
+		return ;
+	int32_t c = SizeClass(Size) ;
+	int64_t size = ClassSize(c) ;
+
+	std::lock_guard<std::mutex> lock(_M) ;
+	_nBytesInUse -= size ;
+	if (c >= (int32_t) _FreeLists.size()) 
+		_FreeLists.resize(c + 1, NULL) ;
+	*((void**) Block) = _FreeLists[c] ;
+	_FreeLists[c] = Block ;
+	_nBytesCached += size ;
+}
+
+
+void ARE::utils::TablePool::Trim(void)
+{
+	std::lock_guard<std::mutex> lock(_M) ;
+	ReleaseCachedBlocks(0) ;
+}
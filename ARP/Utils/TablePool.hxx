@@ -0,0 +1,80 @@
+#ifndef ARE_TablePool_HXX_INCLUDED
+#define ARE_TablePool_HXX_INCLUDED
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+// blocks are aligned to this many bytes (a cache line; enough for any SIMD load).
+#define ARE_TablePool_Alignment		64
+// smallest block size; requests are rounded up to a size class; there are 4 size classes per power of 2, so at most 25% of a block is unused.
+#define ARE_TablePool_MinBlockSize		64
+// on LINUX, blocks of at least this many bytes are mapped directly from the OS (and may be backed by huge pages); smaller blocks come from the heap.
+#define ARE_TablePool_MapThreshold		(2*1048576)
+
+namespace ARE {
+namespace utils {
+
+// size-class pool of memory blocks for function tables. a released block is kept on the free list of its size class and handed out
+// again for the next request of the same class, so table memory is recycled (e.g. across buckets) instead of going back to the heap.
+// free blocks are given back to the OS before the pool would grow beyond its high-water mark, so the pool holds no more memory than
+// the peak amount of memory in use. optionally, the pool enforces a hard budget: Allocate() fails if the memory in use would exceed it.
+// thread safe.
+class TablePool
+{
+protected :
+	std::mutex _M ;
+	// free lists, one per size class; the next ptr of a free block is stored in the block itself.
+	std::vector<void*> _FreeLists ;
+	// hard budget in bytes of memory in use; 0 = no limit.
+	int64_t _ByteLimit ;
+	// if true, mapped blocks are advised to be backed by (transparent) huge pages.
+	bool _UseHugePages ;
+protected :
+	// statistics; all sizes are in bytes, as rounded up to the size class.
+	int64_t _nBytesInUse ;
+	int64_t _MaxBytesInUse ;
+	int64_t _nBytesCached ; // in free lists
+	int64_t _MaxBytesReserved ; // max of in use + cached
+	int64_t _nAllocations ;
+	int64_t _nAllocationsReused ; // served from a free list
+	int64_t _nAllocationsFailed ; // over budget or out of memory
+public :
+	inline int64_t ByteLimit(void) const { return _ByteLimit ; }
+	inline void SetByteLimit(int64_t Limit) { _ByteLimit = Limit > 0 ? Limit : 0 ; }
+	inline bool UseHugePages(void) const { return _UseHugePages ; }
+	inline void SetUseHugePages(bool Use) { _UseHugePages = Use ; }
+	inline int64_t nBytesInUse(void) const { return _nBytesInUse ; }
+	inline int64_t MaxBytesInUse(void) const { return _MaxBytesInUse ; }
+	inline int64_t nBytesCached(void) const { return _nBytesCached ; }
+	inline int64_t MaxBytesReserved(void) const { return _MaxBytesReserved ; }
+	inline int64_t nAllocations(void) const { return _nAllocations ; }
+	inline int64_t nAllocationsReused(void) const { return _nAllocationsReused ; }
+	inline int64_t nAllocationsFailed(void) const { return _nAllocationsFailed ; }
+	void ResetStatistics(void) ;
+
+protected :
+	static int32_t SizeClass(int64_t Size) ;
+	static int64_t ClassSize(int32_t SizeClass) ;
+	static void *AllocateBlock(int64_t Size, bool UseHugePages) ;
+	static void FreeBlock(void *Block, int64_t Size) ;
+	// give free blocks back to the OS, largest first, until at most Keep bytes are cached. caller holds _M.
+	void ReleaseCachedBlocks(int64_t Keep) ;
+
+public :
+	// get a block of at least Size bytes; NULL if the budget would be exceeded or there is no memory.
+	void *Allocate(int64_t Size) ;
+	// return a block; Size must be the size it was allocated with.
+	void Free(void *Block, int64_t Size) ;
+	// give all free blocks back to the OS.
+	void Trim(void) ;
+
+public :
+	TablePool(void) ;
+	~TablePool(void) ;
+} ;
+
+}} // namespace ARE::utils
+
+#endif // ARE_TablePool_HXX_INCLUDED
@@ -0,0 +1,346 @@
+#include <stdlib.h>
+#include <chrono>
+#include <memory>
+
+#include "Utils/TaskScheduler.hxx"
+
+// pool (and thread index) of the pool thread running; NULL/-1 for other threads.
+static thread_local const ARE::utils::TaskScheduler *tlsScheduler = NULL ;
+static thread_local int32_t tlsThreadIdx = -1 ;
+
+ARE::utils::TaskScheduler::TaskScheduler(void)
+	:
+	_nThreads(0), 
+	_Queues(NULL), 
+	_NextQueue(0), 
+	_nQueued(0), 
+	_nPending(0), 
+	_StopThreads(false), 
+	_Notified(false), 
+	_nTasksExecuted(0), 
+	_nTasksStolen(0)
+{
+}
+
+
+ARE::utils::TaskScheduler::~TaskScheduler(void)
+{
+	Stop() ;
+}
+
+
+int32_t ARE::utils::TaskScheduler::CurrentThreadIdx(void) const
+{
+	return this == tlsScheduler ? tlsThreadIdx : -1 ;
+}
+
+
+int32_t ARE::utils::TaskScheduler::Start(int32_t nThreads)
+{
+	if (_nThreads > 0) 
+		return 1 ;
+	if (nThreads < 1) 
+		nThreads = 1 ;
+	_Queues = new TaskQueue[nThreads] ;
+	if (NULL == _Queues) 
+		return 1 ;
+	_StopThreads = false ;
+	_Notified = false ;
+	_NextQueue = 0 ;
+	_nTasksExecuted = 0 ;
+	_nTasksStolen = 0 ;
+	_nThreads = nThreads ;
+	try {
+		for (int32_t i = 0 ; i < nThreads ; i++) 
+			_Threads.push_back(std::thread(&TaskScheduler::ThreadFn, this, i)) ;
+		}
+	catch (...) {
+		Stop() ;
+		return 1 ;
+		}
+	return 0 ;
+}
+
+
+int32_t ARE::utils::TaskScheduler::Stop(void)
+{
+	if (_nThreads <= 0) 
+		return 0 ;
+	Cancel() ;
+	{
+	std::lock_guard<std::mutex> lock(_M) ;
+	_StopThreads = true ;
+	}
+	_WorkCV.notify_all() ;
+	for (size_t i = 0 ; i < _Threads.size() ; i++) {
+		if (_Threads[i].joinable()) 
+			_Threads[i].join() ;
+		}
+	_Threads.clear() ;
+	delete [] _Queues ;
+	_Queues = NULL ;
+	_nThreads = 0 ;
+	_nQueued = _nPending = 0 ;
+	return 0 ;
+}
+
+
+void ARE::utils::TaskScheduler::Push(int32_t Idx, Task *T, bool Requeue)
+{
+	// count first, so that a thread woken up does not go back to sleep before the task is in the queue.
+	{
+	std::lock_guard<std::mutex> lock(_M) ;
+	++_nQueued ;
+	}
+	{
+	std::lock_guard<std::mutex> lock(_Queues[Idx]._M) ;
+	if (Requeue) 
+		_Queues[Idx]._Tasks.push_front(T) ;
+	else 
+		_Queues[Idx]._Tasks.push_back(T) ;
+	}
+	_WorkCV.notify_one() ;
+}
+
+
+int32_t ARE::utils::TaskScheduler::Submit(Task *T)
+{
+	if (NULL == T || _nThreads <= 0) 
+		return 1 ;
+	int32_t idx = CurrentThreadIdx() ;
+	{
+	std::lock_guard<std::mutex> lock(_M) ;
+	++_nPending ;
+	if (idx < 0) {
+		idx = _NextQueue ;
+		_NextQueue = (_NextQueue + 1) % _nThreads ;
+		}
+	}
+	Push(idx, T, false) ;
+	return 0 ;
+}
+
+
+int32_t ARE::utils::TaskScheduler::Cancel(void)
+{
+	int32_t i, n = 0 ;
+	for (i = 0 ; i < _nThreads ; i++) {
+		std::deque<Task*> tasks ;
+		{
+		std::lock_guard<std::mutex> lock(_Queues[i]._M) ;
+		tasks.swap(_Queues[i]._Tasks) ;
+		}
+		for (size_t j = 0 ; j < tasks.size() ; j++) 
+			tasks[j]->Release() ;
+		n += (int32_t) tasks.size() ;
+		}
+	if (n > 0) {
+		std::lock_guard<std::mutex> lock(_M) ;
+		_nQueued -= n ;
+		_nPending -= n ;
+		if (_nPending <= 0) 
+			_DoneCV.notify_all() ;
+		}
+	return n ;
+}
+
+
+ARE::utils::Task *ARE::utils::TaskScheduler::GetTask(int32_t Idx)
+{
+	Task *t = NULL ;
+	{
+	std::lock_guard<std::mutex> lock(_Queues[Idx]._M) ;
+	if (! _Queues[Idx]._Tasks.empty()) {
+		t = _Queues[Idx]._Tasks.back() ;
+		_Queues[Idx]._Tasks.pop_back() ;
+		}
+	}
+	for (int32_t i = 1 ; NULL == t && i < _nThreads ; i++) {
+		TaskQueue & q = _Queues[(Idx + i) % _nThreads] ;
+		std::lock_guard<std::mutex> lock(q._M) ;
+		if (! q._Tasks.empty()) {
+			t = q._Tasks.front() ;
+			q._Tasks.pop_front() ;
+			++_nTasksStolen ;
+			}
+		}
+	if (NULL != t) {
+		std::lock_guard<std::mutex> lock(_M) ;
+		--_nQueued ;
+		}
+	return t ;
+}
+
+
+void ARE::utils::TaskScheduler::ThreadFn(int32_t Idx)
+{
+	tlsScheduler = this ;
+	tlsThreadIdx = Idx ;
+	while (true) {
+		Task *t = GetTask(Idx) ;
+		if (NULL == t) {
+			std::unique_lock<std::mutex> lock(_M) ;
+			_WorkCV.wait(lock, [this] { return _StopThreads || _nQueued > 0 ; }) ;
+			if (_StopThreads) 
+				break ;
+			continue ;
+			}
+		int32_t res = 0 ;
+		try {
+			res = t->Execute(Idx) ;
+			}
+		catch (...) {
+			res = 0 ;
+			}
+		++_nTasksExecuted ;
+		if (0 != res) {
+			// behind the other tasks of this thread, since the thread takes tasks from the back.
+			Push(Idx, t, true) ;
+			continue ;
+			}
+		t->Release() ;
+		std::lock_guard<std::mutex> lock(_M) ;
+		if (--_nPending <= 0) 
+			_DoneCV.notify_all() ;
+		}
+	tlsScheduler = NULL ;
+	tlsThreadIdx = -1 ;
+}
+
+
+bool ARE::utils::TaskScheduler::Wait(int64_t TimeoutInMilliseconds)
+{
+	std::unique_lock<std::mutex> lock(_M) ;
+	if (TimeoutInMilliseconds < 0) 
+		_DoneCV.wait(lock, [this] { return _nPending <= 0 || _Notified ; }) ;
+	else 
+		_DoneCV.wait_for(lock, std::chrono::milliseconds(TimeoutInMilliseconds), [this] { return _nPending <= 0 || _Notified ; }) ;
+	_Notified = false ;
+	return _nPending <= 0 ;
+}
+
+
+void ARE::utils::TaskScheduler::Notify(void)
+{
+	{
+	std::lock_guard<std::mutex> lock(_M) ;
+	_Notified = true ;
+	}
+	_DoneCV.notify_all() ;
+}
+
+
+namespace ARE {
+namespace utils {
+
+// state of a ParallelFor() call; shared by the calling thread and its helper tasks, since helpers may start after the call has returned.
+class ParallelForLoop
+{
+public :
+	const std::function<void(int32_t ThreadIdx, int64_t Begin, int64_t End)> *_Fn ; // used only while some chunk is not done
+	int64_t _N ;
+	int64_t _ChunkSize ;
+	int64_t _nChunks ;
+	std::atomic<int64_t> _NextChunk ;
+	std::mutex _M ;
+	std::condition_variable _DoneCV ;
+	int64_t _nChunksDone ;
+	bool _Failed ;
+	// do chunks until none is left.
+	void Run(int32_t ThreadIdx)
+	{
+		int64_t c ;
+		while ((c = _NextChunk++) < _nChunks) {
+			int64_t b = c * _ChunkSize ;
+			bool ok = true ;
+			try {
+				(*_Fn)(ThreadIdx, b, b + _ChunkSize < _N ? b + _ChunkSize : _N) ;
+				}
+			catch (...) {
+				ok = false ;
+				}
+			std::lock_guard<std::mutex> lock(_M) ;
+			if (! ok) 
+				_Failed = true ;
+			if (++_nChunksDone >= _nChunks) 
+				_DoneCV.notify_all() ;
+			}
+	}
+	ParallelForLoop(void) : _Fn(NULL), _N(0), _ChunkSize(1), _nChunks(0), _NextChunk(0), _nChunksDone(0), _Failed(false) { }
+} ;
+
+class ParallelForTask : public Task
+{
+protected :
+	std::shared_ptr<ParallelForLoop> _Loop ;
+	int32_t _ThreadIdx ; // index of this helper in the loop, not the pool thread index
+public :
+	virtual int32_t Execute(int32_t /* ThreadIdx */)
+	{
+		_Loop->Run(_ThreadIdx) ;
+		return 0 ;
+	}
+	ParallelForTask(const std::shared_ptr<ParallelForLoop> & Loop, int32_t ThreadIdx) : _Loop(Loop), _ThreadIdx(ThreadIdx) { }
+} ;
+
+}} // namespace ARE::utils
+
+
+ARE::utils::TaskScheduler & ARE::utils::SharedScheduler(void)
+{
+	static TaskScheduler scheduler ;
+	static std::once_flag started ;
+	std::call_once(started, [](void)
+	{
+		int32_t n = (int32_t) std::thread::hardware_concurrency() ;
+		scheduler.Start(n > 1 ? n : 1) ;
+	}) ;
+	return scheduler ;
+}
+
+
+int32_t ARE::utils::ParallelFor(int32_t nThreads, int64_t N, int64_t ChunkSize, const std::function<void(int32_t ThreadIdx, int64_t Begin, int64_t End)> & Fn, TaskScheduler *Scheduler)
+{
+	if (N <= 0) 
+		return 0 ;
+	if (ChunkSize < 1) 
+		ChunkSize = 1 ;
+	int64_t nChunks = (N + ChunkSize - 1) / ChunkSize ;
+	if (nThreads > nChunks) 
+		nThreads = (int32_t) nChunks ;
+	if (nThreads > 1 && NULL == Scheduler) 
+		Scheduler = &SharedScheduler() ;
+	if (nThreads > 1 && nThreads > Scheduler->nThreads()) 
+		// more helpers than pool threads would not run concurrently; a calling thread that is a pool thread is one of them.
+		nThreads = Scheduler->nThreads() + (Scheduler->CurrentThreadIdx() < 0 ? 1 : 0) ;
+	if (nThreads <= 1) {
+		// as with helpers, an exception is reported by the return value; chunks after the one that failed are not done.
+		try {
+			for (int64_t b = 0 ; b < N ; b += ChunkSize) 
+				Fn(0, b, b + ChunkSize < N ? b + ChunkSize : N) ;
+			}
+		catch (...) {
+			return 1 ;
+			}
+		return 0 ;
+		}
+	std::shared_ptr<ParallelForLoop> loop(new ParallelForLoop) ;
+	loop->_Fn = &Fn ;
+	loop->_N = N ;
+	loop->_ChunkSize = ChunkSize ;
+	loop->_nChunks = nChunks ;
+	for (int32_t i = 1 ; i < nThreads ; i++) {
+		ParallelForTask *t = new ParallelForTask(loop, i) ;
+		if (NULL == t) 
+			break ;
+		if (0 != Scheduler->Submit(t)) {
+			// the ones submitted (and this thread) will do all chunks anyway.
+			t->Release() ;
+			break ;
+			}
+		}
+	loop->Run(0) ;
+	std::unique_lock<std::mutex> lock(loop->_M) ;
+	loop->_DoneCV.wait(lock, [&loop] { return loop->_nChunksDone >= loop->_nChunks ; }) ;
+	return loop->_Failed ? 1 : 0 ;
+}
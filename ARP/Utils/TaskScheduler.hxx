@@ -0,0 +1,97 @@
+#ifndef ARE_TaskScheduler_HXX_INCLUDED
+#define ARE_TaskScheduler_HXX_INCLUDED
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace ARE {
+namespace utils {
+
+// a unit of work for TaskScheduler.
+class Task
+{
+public :
+	// run the task (or a part of it) on pool thread ThreadIdx.
+	// return 0 when the task is done; 1 to put it back in the queue of this thread, so that it runs again later (after tasks queued since).
+	virtual int32_t Execute(int32_t ThreadIdx) = 0 ;
+	// called when the task is done, or discarded by Cancel(); by default the task is deleted.
+	virtual void Release(void) { delete this ; }
+	virtual ~Task(void) { }
+} ;
+
+// thread pool with a deque of tasks for each thread. a thread runs tasks from the back of its own deque; when it is empty,
+// it takes (steals) tasks from the front of other deques. tasks submitted by a task go to the deque of the thread running it,
+// so large tasks can split themselves and let idle threads steal the pieces. a task put back (see Task::Execute()) goes to the front 
+// of the deque, so its thread runs the other tasks of the deque before it runs it again.
+class TaskScheduler
+{
+protected :
+	class TaskQueue
+	{
+	public :
+		std::mutex _M ;
+		std::deque<Task*> _Tasks ;
+	} ;
+	int32_t _nThreads ;
+	std::vector<std::thread> _Threads ;
+	TaskQueue *_Queues ;
+	int32_t _NextQueue ; // queue for the next task submitted from outside the pool
+	// _M/_CV guard sleeping threads and Wait(); _nQueued is the number of tasks in the queues, _nPending is the number of tasks queued or running.
+	std::mutex _M ;
+	std::condition_variable _WorkCV ;
+	std::condition_variable _DoneCV ;
+	int64_t _nQueued ;
+	int64_t _nPending ;
+	bool _StopThreads ;
+	bool _Notified ;
+	void ThreadFn(int32_t Idx) ;
+	Task *GetTask(int32_t Idx) ;
+	// queue T at the back of deque Idx; at the front if Requeue.
+	void Push(int32_t Idx, Task *T, bool Requeue) ;
+public :
+	// STATISTICS
+	std::atomic<int64_t> _nTasksExecuted ;
+	std::atomic<int64_t> _nTasksStolen ;
+public :
+	inline int32_t nThreads(void) const { return _nThreads ; }
+	// index of the pool thread calling this function, -1 if it is not a thread of this pool.
+	int32_t CurrentThreadIdx(void) const ;
+	// start nThreads threads; returns 0 iff ok.
+	int32_t Start(int32_t nThreads) ;
+	// discard tasks not started yet, wait for running tasks to finish and for threads to exit.
+	int32_t Stop(void) ;
+	// queue a task. called from a pool thread, the task goes to the deque of that thread; otherwise deques are used in round-robin fashion.
+	int32_t Submit(Task *T) ;
+	// discard all tasks not started yet; returns number of tasks discarded.
+	int32_t Cancel(void) ;
+	// wait until all tasks are done, Notify() is called or TimeoutInMilliseconds passes (<0 means no timeout).
+	// returns true iff all tasks are done.
+	bool Wait(int64_t TimeoutInMilliseconds) ;
+	// wake up Wait().
+	void Notify(void) ;
+public :
+	TaskScheduler(void) ;
+	~TaskScheduler(void) ;
+} ;
+
+// run Fn(ThreadIdx, Begin, End) for all chunks [Begin, End) of [0, N), each chunk (but the last) of size ChunkSize, using at most nThreads threads : 
+// the calling thread (ThreadIdx 0) and up to nThreads-1 helper tasks (ThreadIdx 1, 2, ...) submitted to Scheduler; NULL means SharedScheduler(). 
+// no threads are created; called from a thread of Scheduler, the loop uses the threads of that pool, so it does not add to the number of threads running. 
+// chunks are handed out dynamically, but each chunk is a fixed range, so as long as Fn writes only data of its own range, results do not depend on nThreads. 
+// the calling thread does chunks too, and waits only for chunks taken by helpers that started; so this does not wait for a busy pool. 
+// returns 0 iff ok; 1 if Fn threw an exception on some chunk.
+int32_t ParallelFor(int32_t nThreads, int64_t N, int64_t ChunkSize, const std::function<void(int32_t ThreadIdx, int64_t Begin, int64_t End)> & Fn, TaskScheduler *Scheduler = NULL) ;
+
+// pool used by ParallelFor() when it is not given one; started on first use, with one thread per hardware thread.
+TaskScheduler & SharedScheduler(void) ;
+
+}} // namespace ARE::utils
+
+#endif // ARE_TaskScheduler_HXX_INCLUDED
@@ -0,0 +1,344 @@
+// regression test of (mini-)bucket elimination (see MBEworkspace) : small random models are solved by exact BE and by MBE, with different
+// table kernels, thread counts, bucket orders, disk spilling and table storage, and results are checked against brute-force enumeration.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <set>
+
+#include "Problem.hxx"
+#include "Function.hxx"
+#include "MiniBucket.hxx"
+#include "MBEworkspace.hxx"
+#include "TableKernels.hxx"
+#include "Utils/MersenneTwister.h"
+
+class TestModel
+{
+public :
+	std::string _Name ;
+	int _N ;
+	std::vector<int> _K ; // domain size of each var
+	std::vector<std::vector<int> > _Scopes ;
+	std::vector<std::vector<double> > _Tables ; // in UAI order; the last var of the scope changes fastest
+	std::vector<int> _Order ; // elimination order
+	int _Width ; // induced width of _Order
+public :
+	TestModel(const char *Name, int N, int K)
+		:
+		_Name(Name), 
+		_N(N), 
+		_K(N, K), 
+		_Width(-1)
+	{
+	}
+	// factor over Scope, with random entries in [0.1,1.1); no entry is 0, so the model can be converted to log scale.
+	void AddFactor(const std::vector<int> & Scope, MTRand & RNG)
+	{
+		int64_t n = 1 ;
+		for (int v : Scope) 
+			n *= _K[v] ;
+		std::vector<double> table(n) ;
+		for (int64_t i = 0 ; i < n ; i++) 
+			table[i] = 0.1 + RNG.randExc() ;
+		_Scopes.push_back(Scope) ;
+		_Tables.push_back(table) ;
+	}
+	std::string UAI(void) const
+	{
+		std::string s = "MARKOV\n" + std::to_string(_N) + "\n" ;
+		for (int i = 0 ; i < _N ; i++) 
+			s += std::to_string(_K[i]) + (i < _N - 1 ? " " : "\n") ;
+		s += std::to_string(_Scopes.size()) + "\n" ;
+		for (const std::vector<int> & scope : _Scopes) {
+			s += std::to_string(scope.size()) ;
+			for (int v : scope) 
+				s += " " + std::to_string(v) ;
+			s += "\n" ;
+			}
+		char buf[64] ;
+		for (const std::vector<double> & table : _Tables) {
+			s += "\n" + std::to_string(table.size()) + "\n" ;
+			for (double x : table) 
+				{ sprintf(buf, "%.17g ", x) ; s += buf ; }
+			s += "\n" ;
+			}
+		return s ;
+	}
+	// sum (or max) over all assignments of the product of all factors.
+	double BruteForce(bool Max) const
+	{
+		std::vector<int> a(_N, 0) ;
+		double result = 0.0 ;
+		while (true) {
+			double p = 1.0 ;
+			for (int j = 0 ; j < (int) _Scopes.size() ; j++) {
+				int64_t idx = 0 ;
+				for (int v : _Scopes[j]) 
+					idx = idx*_K[v] + a[v] ;
+				p *= _Tables[j][idx] ;
+				}
+			if (Max) 
+				{ if (p > result) result = p ; }
+			else 
+				result += p ;
+			int i = _N - 1 ;
+			for (; i >= 0 ; i--) {
+				if (++a[i] < _K[i]) 
+					break ;
+				a[i] = 0 ;
+				}
+			if (i < 0) 
+				break ;
+			}
+		return result ;
+	}
+	// set the elimination order to Order, or to a min-fill order if Order is NULL; computes its induced width.
+	void SetOrder(const std::vector<int> *Order)
+	{
+		std::vector<std::set<int> > adj(_N) ;
+		for (const std::vector<int> & scope : _Scopes) {
+			for (int u : scope) 
+				for (int v : scope) 
+					if (u != v) adj[u].insert(v) ;
+			}
+		std::vector<int> done(_N, 0) ;
+		_Order.clear() ;
+		_Width = 0 ;
+		for (int i = 0 ; i < _N ; i++) {
+			int best = -1 ;
+			if (NULL != Order) 
+				best = (*Order)[i] ;
+			else {
+				int64_t bestFill = -1 ;
+				for (int u = 0 ; u < _N ; u++) {
+					if (done[u]) 
+						continue ;
+					int64_t fill = 0 ;
+					for (int a : adj[u]) 
+						for (int b : adj[u]) 
+							if (a < b && 0 == adj[a].count(b)) fill++ ;
+					if (best < 0 || fill < bestFill || (fill == bestFill && adj[u].size() < adj[best].size())) 
+						{ best = u ; bestFill = fill ; }
+					}
+				}
+			_Order.push_back(best) ;
+			done[best] = 1 ;
+			if ((int) adj[best].size() > _Width) 
+				_Width = adj[best].size() ;
+			for (int a : adj[best]) {
+				for (int b : adj[best]) 
+					if (a != b) adj[a].insert(b) ;
+				adj[a].erase(best) ;
+				}
+			}
+	}
+} ;
+
+// options of one (M)BE run.
+class TestOptions
+{
+public :
+	std::string _Name ;
+	bool _Max ; // product-max query; otherwise product-sum
+	bool _LogScale ;
+	int _iBound ; // 0 = exact (induced width + 1)
+	bool _MomentMatching ;
+	int _SIMDLevel ;
+	int _nThreads ;
+	int _ComputationOrder ; // see MBEworkspace::CreateComputationOrder()
+	int64_t _SchedulingSpaceLimit ;
+	bool _DeleteUsedTables ;
+	bool _UseTablePool ;
+	int _TableStorage ;
+	int64_t _TableMemoryLimit, _DiskTableBlockSize ; // tables are spilled to disk if the limit is > 0
+public :
+	TestOptions(const char *Name)
+		:
+		_Name(Name), 
+		_Max(false), 
+		_LogScale(false), 
+		_iBound(0), 
+		_MomentMatching(false), 
+		_SIMDLevel(2), 
+		_nThreads(1), 
+		_ComputationOrder(0), 
+		_SchedulingSpaceLimit(0), 
+		_DeleteUsedTables(false), 
+		_UseTablePool(true), 
+		_TableStorage(ARE_Function_TableStorage_Double), 
+		_TableMemoryLimit(0), 
+		_DiskTableBlockSize(0)
+	{
+	}
+} ;
+
+static int nFailed = 0 ;
+
+static void Check(bool OK, const TestModel & M, const TestOptions & O, const char *What, double Value, double Expected)
+{
+	if (OK) 
+		return ;
+	++nFailed ;
+	printf("\nFAILED : model %s, run %s : %s; value=%.17g expected=%.17g", M._Name.c_str(), O._Name.c_str(), What, Value, Expected) ;
+}
+
+// solve M with options O, and check the result against Z (brute-force sum or max); returns the result.
+static double Run(const TestModel & M, const TestOptions & O, double Z)
+{
+	// operators are set before loading, since functions over the same scope are combined into one when they are loaded.
+	ARE::ARP p("test") ;
+	p.SetOperators(O._Max ? "product-max" : "product-sum") ;
+	std::string uai = M.UAI() ;
+	if (0 != p.LoadFromBuffer("UAI", uai.c_str(), uai.length()) || 0 != p.PerformPostConstructionAnalysis()) 
+		{ Check(false, M, O, "load failed", 0.0, 0.0) ; return -1.0 ; }
+	if (0 != p.SetVarElimOrdering(M._Order.data(), M._Width)) 
+		{ Check(false, M, O, "SetVarElimOrdering failed", 0.0, 0.0) ; return -1.0 ; }
+	BucketElimination::TableKernels::SetSIMDLevel(O._SIMDLevel) ;
+
+	BucketElimination::MBEworkspace bews ;
+	if (0 != bews.Initialize(p, O._LogScale, NULL, 0) || 0 != bews.CreateBuckets(true, false, false)) 
+		{ Check(false, M, O, "initialize failed", 0.0, 0.0) ; return -1.0 ; }
+	bews.iBound() = O._iBound > 0 ? O._iBound : M._Width + 1 ;
+	bews.SetDeleteUsedTables(O._DeleteUsedTables) ;
+	bews.SetnThreads(O._nThreads) ;
+	// the symbolic partitioning estimate should agree with the partitioning that is created; max simultaneous space needs a computation order.
+	double estTotal = -1.0, estMax = -1.0 ;
+	int32_t estNP = -1 ;
+	int32_t resEst = bews.EstimateMBPartitioning(bews.iBound(), estTotal, estMax, estNP) ;
+	if (0 != bews.CreateMBPartitioning(false, O._MomentMatching, O._ComputationOrder)) 
+		{ Check(false, M, O, "CreateMBPartitioning failed", 0.0, 0.0) ; return -1.0 ; }
+	Check(0 == resEst && estNP == bews.nBucketsWithPartitioning(), M, O, "estimated number of partitioned buckets", estNP, bews.nBucketsWithPartitioning()) ;
+	Check(0 == resEst && fabs(estTotal - bews.TotalNewFunctionSpace_Log10()) < 1.0e-9, M, O, "estimated new function space", estTotal, bews.TotalNewFunctionSpace_Log10()) ;
+	Check(estMax < 0.0, M, O, "estimated max simultaneous space without a computation order", estMax, -1.0) ;
+	resEst = bews.EstimateMBPartitioning(bews.iBound(), estTotal, estMax, estNP) ;
+	Check(0 == resEst && fabs(estMax - bews.MaxSimultaneousNewFunctionSpace_Log10()) < 1.0e-9, M, O, "estimated max simultaneous new function space", estMax, bews.MaxSimultaneousNewFunctionSpace_Log10()) ;
+	if (O._iBound > 0 && O._iBound <= M._Width) 
+		Check(bews.nBucketsWithPartitioning() > 0, M, O, "no bucket is partitioned", bews.nBucketsWithPartitioning(), 1) ;
+	bews.SetBucketSchedulingSpaceLimit(O._SchedulingSpaceLimit) ;
+	bews.SetUseTablePool(O._UseTablePool) ;
+	bews.SetTableStorage(O._TableStorage) ;
+	if (O._TableMemoryLimit > 0) {
+		bews.SetDiskSpaceDirectory(".") ;
+		bews.SetTableMemoryLimit(O._TableMemoryLimit) ;
+		bews.SetDiskTableBlockSize(O._DiskTableBlockSize) ;
+		}
+	if (0 != bews.ComputeOutputFunctions(O._MomentMatching)) 
+		{ Check(false, M, O, "ComputeOutputFunctions failed", 0.0, 0.0) ; return -1.0 ; }
+	bews.PostComputationProcessing() ;
+	if (O._TableMemoryLimit > 0) 
+		Check(bews.nTableBlocksSaved() > 0, M, O, "no table was spilled to disk", bews.nTableBlocksSaved(), 1) ;
+
+	// error allowed for rounding, and for table storage (see MBEworkspace::TableStorageErrorBound()).
+	double v = bews.CompleteEliminationResultEx() ;
+	double eps = 1.0e-9 ;
+	if (ARE_Function_TableStorage_Double != O._TableStorage) {
+		Check(bews.TableStorage() == O._TableStorage || ! O._LogScale, M, O, "table storage not used", bews.TableStorage(), O._TableStorage) ;
+		Check(bews.TableStorageErrorBound() > 0.0, M, O, "no table storage error", bews.TableStorageErrorBound(), 0.0) ;
+		// absolute errors are in log10 scale; make them relative.
+		eps += bews.TableErrorIsRelative() ? bews.TableStorageErrorBound() : pow(10.0, bews.TableStorageErrorBound()) - 1.0 ;
+		}
+	if (O._iBound > 0 && O._iBound <= M._Width) 
+		Check(v >= Z*(1.0 - eps), M, O, "MBE result is not an upper bound", v, Z) ;
+	else 
+		Check(fabs(v - Z) <= eps*Z, M, O, "BE result is wrong", v, Z) ;
+	printf("\nmodel %s (N=%d w=%d), run %s : value=%.17g expected=%.17g", M._Name.c_str(), M._N, M._Width, O._Name.c_str(), v, Z) ;
+	return v ;
+}
+
+int main(int argc, char *argv[])
+{
+	ARE::Initialize() ;
+	ARE::fpLOG = stdout ;
+	MTRand rng(17) ;
+	std::vector<TestModel> models ;
+
+	// 4x4 grid of binary vars, with unary factors.
+	{
+	TestModel m("grid", 16, 2) ;
+	for (int i = 0 ; i < 16 ; i++) {
+		m.AddFactor({ i }, rng) ;
+		if (i % 4 < 3) 
+			m.AddFactor({ i, i + 1 }, rng) ;
+		if (i < 12) 
+			m.AddFactor({ i, i + 4 }, rng) ;
+		}
+	m.SetOrder(NULL) ;
+	models.push_back(m) ;
+	}
+	// random factors of 2-3 vars, with domains of 2-3 values; factors are over an unordered scope.
+	{
+	TestModel m("random", 14, 2) ;
+	for (int i = 0 ; i < m._N ; i++) 
+		m._K[i] = 2 + rng.randInt(1) ;
+	for (int j = 0 ; j < 22 ; j++) {
+		std::vector<int> scope ;
+		int n = 2 + rng.randInt(1) ;
+		while ((int) scope.size() < n) {
+			int v = rng.randInt(m._N - 1) ;
+			bool in = false ;
+			for (int u : scope) 
+				in = in || u == v ;
+			if (! in) 
+				scope.push_back(v) ;
+			}
+		m.AddFactor(scope, rng) ;
+		}
+	m.SetOrder(NULL) ;
+	models.push_back(m) ;
+	}
+
+	for (const TestModel & m : models) {
+		double Z = m.BruteForce(false), Zmax = m.BruteForce(true) ;
+		std::vector<TestOptions> runs ;
+		{ TestOptions o("exact scalar") ; o._SIMDLevel = 0 ; runs.push_back(o) ; }
+		{ TestOptions o("exact simd") ; runs.push_back(o) ; }
+		{ TestOptions o("exact max") ; o._Max = true ; runs.push_back(o) ; }
+		{ TestOptions o("exact log") ; o._LogScale = true ; runs.push_back(o) ; }
+		{ TestOptions o("exact log max scalar") ; o._LogScale = true ; o._Max = true ; o._SIMDLevel = 0 ; runs.push_back(o) ; }
+		{ TestOptions o("mbe i=2") ; o._iBound = 2 ; runs.push_back(o) ; }
+		{ TestOptions o("mbe i=2 max") ; o._iBound = 2 ; o._Max = true ; runs.push_back(o) ; }
+		{ TestOptions o("mbe i=3 log") ; o._iBound = 3 ; o._LogScale = true ; runs.push_back(o) ; }
+		{ TestOptions o("exact 4 threads") ; o._nThreads = 4 ; runs.push_back(o) ; }
+		{ TestOptions o("exact 4 threads, space order, space limit") ; o._nThreads = 4 ; o._ComputationOrder = 2 ; o._DeleteUsedTables = true ; o._SchedulingSpaceLimit = 256 ; runs.push_back(o) ; }
+		{ TestOptions o("mbe i=3 4 threads, depth-first order, no table pool") ; o._iBound = 3 ; o._nThreads = 4 ; o._ComputationOrder = 1 ; o._UseTablePool = false ; runs.push_back(o) ; }
+		{ TestOptions o("exact disk") ; o._TableMemoryLimit = 64 ; o._DiskTableBlockSize = 4 ; runs.push_back(o) ; }
+		{ TestOptions o("exact disk 4 threads") ; o._nThreads = 4 ; o._DeleteUsedTables = true ; o._TableMemoryLimit = 64 ; o._DiskTableBlockSize = 4 ; runs.push_back(o) ; }
+		{ TestOptions o("exact float") ; o._TableStorage = ARE_Function_TableStorage_Float ; runs.push_back(o) ; }
+		{ TestOptions o("exact log float") ; o._LogScale = true ; o._TableStorage = ARE_Function_TableStorage_Float ; runs.push_back(o) ; }
+		{ TestOptions o("exact log q16") ; o._LogScale = true ; o._TableStorage = ARE_Function_TableStorage_Q16 ; runs.push_back(o) ; }
+		{ TestOptions o("mbe i=3 log q16 disk") ; o._iBound = 3 ; o._LogScale = true ; o._TableStorage = ARE_Function_TableStorage_Q16 ; o._TableMemoryLimit = 64 ; o._DiskTableBlockSize = 4 ; runs.push_back(o) ; }
+		for (const TestOptions & o : runs) 
+			Run(m, o, o._Max ? Zmax : Z) ;
+		// moment matching should not depend on kernels, threads or scale.
+		TestOptions mm("mbe i=3 moment matching scalar") ; mm._iBound = 3 ; mm._MomentMatching = true ; mm._SIMDLevel = 0 ;
+		TestOptions mm4("mbe i=3 moment matching 4 threads, log") ; mm4._iBound = 3 ; mm4._MomentMatching = true ; mm4._nThreads = 4 ; mm4._LogScale = true ;
+		double v = Run(m, mm, Z), v4 = Run(m, mm4, Z) ;
+		Check(v > 0.0 && fabs(v4 - v) <= 1.0e-9*v, m, mm4, "moment matching result differs", v4, v) ;
+		}
+
+	// tables of the first bucket are large enough to be split into chunks, computed by several threads (see ARE_BE_PARALLEL_TABLE_MIN_SIZE).
+	{
+	TestModel m("star", 11, 4) ;
+	for (int i = 1 ; i < m._N ; i++) {
+		m.AddFactor({ 0, i }, rng) ;
+		if (i + 1 < m._N) 
+			m.AddFactor({ i, i + 1 }, rng) ;
+		}
+	std::vector<int> order ;
+	for (int i = 0 ; i < m._N ; i++) 
+		order.push_back(i) ;
+	m.SetOrder(&order) ;
+	if (pow(4.0, m._Width + 1) < ARE_BE_PARALLEL_TABLE_MIN_SIZE) 
+		{ ++nFailed ; printf("\nFAILED : model %s is too small to be split into chunks", m._Name.c_str()) ; }
+	double Z = m.BruteForce(false), Zmax = m.BruteForce(true) ;
+	{ TestOptions o("exact 4 threads, chunks") ; o._nThreads = 4 ; Run(m, o, Z) ; }
+	{ TestOptions o("exact 4 threads, chunks, scalar max") ; o._nThreads = 4 ; o._Max = true ; o._SIMDLevel = 0 ; Run(m, o, Zmax) ; }
+	{ TestOptions o("exact 4 threads, chunks, log") ; o._nThreads = 4 ; o._LogScale = true ; Run(m, o, Z) ; }
+	}
+
+	printf("\n%s\n", 0 == nFailed ? "OK" : "FAILED") ;
+	return 0 == nFailed ? 0 : 1 ;
+}
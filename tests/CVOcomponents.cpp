@@ -0,0 +1,68 @@
+// regression test of the component search (see CVOcontext::CreateComponentSearches()) : when the master graph is split into groups 
+// of components, worker graphs should still be restored from their journal between runs (see Graph::RestoreFrom()), instead of 
+// being copied in full for every run.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "CVO/VariableOrderComputation.hxx"
+#include "Utils/MersenneTwister.h"
+
+// write k disjoint copies of one random graph of n nodes (edge probability p) to file fn, in PACE .gr format.
+static int WriteDisjointUnion(const char *fn, int n, int k, double p, unsigned long seed)
+{
+	MTRand rng(seed) ;
+	std::vector<int> edges ;
+	int i, j, c ;
+	for (i = 0 ; i < n ; i++) {
+		for (j = i + 1 ; j < n ; j++) {
+			if (rng.randExc() < p) 
+				{ edges.push_back(i) ; edges.push_back(j) ; }
+			}
+		}
+	FILE *fp = fopen(fn, "w") ;
+	if (NULL == fp) 
+		return 1 ;
+	fprintf(fp, "p tw %d %d\n", n*k, (int) (k*(edges.size() >> 1))) ;
+	for (c = 0 ; c < k ; c++) {
+		for (i = 0 ; i < (int) edges.size() ; i += 2) 
+			fprintf(fp, "%d %d\n", 1 + c*n + edges[i], 1 + c*n + edges[i+1]) ;
+		}
+	fclose(fp) ;
+	return 0 ;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *fn = "cvo_components_test.gr" ;
+	const int n = 60, k = 4, nRuns = 1000 ;
+	if (0 != WriteDisjointUnion(fn, n, k, 0.12, 5)) {
+		printf("\nFAILED : can't write %s\n", fn) ;
+		return 1 ;
+		}
+
+	ARE::VarElimOrderComp::Order BestOrder ;
+	ARE::VarElimOrderComp::CVOcontext *context = new ARE::VarElimOrderComp::CVOcontext ;
+	// keep all pool threads on runs, and don't stop at the lower bound.
+	context->_StopAtWidthLowerBound = false ;
+	context->_ExactSearch = false ;
+	context->_LocalSearch = false ;
+	int res = ARE::VarElimOrderComp::Compute(fn, ARE::VarElimOrderComp::Width, ARE::VarElimOrderComp::MinFill, ARE::VarElimOrderComp::None, 
+		2, nRuns, 60000, 8, 0.5, false, false, true, false, true, 1, BestOrder, context) ;
+
+	// groups are gone when runs are done; the master graph is kept, so split it again, to check that runs were on k groups.
+	int nGroups = -1 ;
+	if (0 == res && 0 == context->CreateComponentSearches(BestOrder._VarListInElimOrder)) 
+		nGroups = context->_Components.size() ;
+	context->DestroyComponentSearches() ;
+	int64_t nJournaled = context->_nJournaledRestores, nFull = context->_nFullRestores ;
+	printf("\nres=%d width=%d groups=%d runs=%d restores : journaled=%lld full=%lld\n", res, (int) BestOrder._Width, nGroups, (int) context->_nRunsStarted, (long long) nJournaled, (long long) nFull) ;
+	remove(fn) ;
+
+	// a full copy is done when a worker moves to another group, which should be once per batch of runs at most.
+	bool ok = 0 == res && k == nGroups && nJournaled + nFull >= nRuns/2 && nJournaled > 4*nFull ;
+	printf("%s\n", ok ? "OK" : "FAILED") ;
+	return ok ? 0 : 1 ;
+}
@@ -0,0 +1,71 @@
+// regression test of the tasks that run next to the randomized runs (see CVOThreadFn()) : exact search and local search each keep a
+// pool thread for a long time, so with few pool threads the runs should still get threads, and all runs requested should be done
+// well within the time limit.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "CVO/VariableOrderComputation.hxx"
+#include "Utils/MersenneTwister.h"
+#include "Utils/MiscUtils.hxx"
+
+// write a random graph of n nodes (edge probability p) to file fn, in PACE .gr format.
+static int WriteRandomGraph(const char *fn, int n, double p, unsigned long seed)
+{
+	MTRand rng(seed) ;
+	std::vector<int> edges ;
+	int i, j ;
+	for (i = 0 ; i < n ; i++) {
+		for (j = i + 1 ; j < n ; j++) {
+			if (rng.randExc() < p) 
+				{ edges.push_back(i) ; edges.push_back(j) ; }
+			}
+		}
+	FILE *fp = fopen(fn, "w") ;
+	if (NULL == fp) 
+		return 1 ;
+	fprintf(fp, "p tw %d %d\n", n, (int) (edges.size() >> 1)) ;
+	for (i = 0 ; i < (int) edges.size() ; i += 2) 
+		fprintf(fp, "%d %d\n", 1 + edges[i], 1 + edges[i+1]) ;
+	fclose(fp) ;
+	return 0 ;
+}
+
+// run nRuns runs with nThreads pool threads, exact and local search on; returns true iff all runs were done before the time limit.
+static bool RunAll(const char *fn, int nThreads, int nRuns, int64_t TimeLimit)
+{
+	ARE::VarElimOrderComp::Order BestOrder ;
+	ARE::VarElimOrderComp::CVOcontext *context = new ARE::VarElimOrderComp::CVOcontext ;
+	// don't stop at the lower bound, so that the number of runs does not depend on the bounds found.
+	context->_StopAtWidthLowerBound = false ;
+	context->_ExactSearch = true ;
+	context->_LocalSearch = true ;
+	int64_t tStart = ARE::GetTimeInMilliseconds() ;
+	int res = ARE::VarElimOrderComp::Compute(fn, ARE::VarElimOrderComp::Width, ARE::VarElimOrderComp::MinFill, ARE::VarElimOrderComp::None,
+		nThreads, nRuns, TimeLimit, 8, 0.5, false, false, true, false, true, 1, BestOrder, context) ;
+	int64_t dt = ARE::GetTimeInMilliseconds() - tStart ;
+	int nRunsDone = context->_nRunsStarted ;
+	printf("\nthreads=%d : res=%d width=%d lb=%d runs=%d/%d time=%lldmsec", nThreads, res, (int) BestOrder._Width, (int) BestOrder._WidthLowerBound, nRunsDone, nRuns, (long long) dt) ;
+	return 0 == res && nRunsDone >= nRuns && dt < TimeLimit ;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *fn = "cvo_local_search_test.gr" ;
+	const int nRuns = 3000 ;
+	const int64_t tLimit = 20000 ;
+	if (0 != WriteRandomGraph(fn, 40, 0.3, 7)) {
+		printf("\nFAILED : can't write %s\n", fn) ;
+		return 1 ;
+		}
+	bool ok = true ;
+	for (int nThreads = 2 ; nThreads <= 4 ; nThreads++) {
+		if (! RunAll(fn, nThreads, nRuns, tLimit)) 
+			ok = false ;
+		}
+	remove(fn) ;
+	printf("\n%s\n", ok ? "OK" : "FAILED") ;
+	return ok ? 0 : 1 ;
+}
@@ -0,0 +1,77 @@
+// regression test of TaskScheduler : a task that is put back in the queue (Task::Execute() returns 1) should run again only after
+// the other tasks queued on its thread, so that tasks done in slices share a thread.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+#include "Utils/TaskScheduler.hxx"
+
+static std::mutex LogMutex ;
+static std::vector<int> Log ; // ids of tasks, in the order their slices ran
+
+// a task done in nSlices slices; each slice notes the id of the task.
+class SliceTask : public ARE::utils::Task
+{
+protected :
+	int _ID ;
+	int _nSlicesLeft ;
+public :
+	virtual int32_t Execute(int32_t /* ThreadIdx */)
+	{
+		{
+		std::lock_guard<std::mutex> lock(LogMutex) ;
+		Log.push_back(_ID) ;
+		}
+		return --_nSlicesLeft > 0 ? 1 : 0 ;
+	}
+	SliceTask(int ID, int nSlices) : _ID(ID), _nSlicesLeft(nSlices) { }
+} ;
+
+// keeps the (only) pool thread busy until Go is set, so that the tasks to test are queued before any of them runs.
+class GateTask : public ARE::utils::Task
+{
+public :
+	std::atomic<bool> *_Started, *_Go ;
+	virtual int32_t Execute(int32_t /* ThreadIdx */)
+	{
+		*_Started = true ;
+		while (! *_Go) 
+			std::this_thread::yield() ;
+		return 0 ;
+	}
+	GateTask(std::atomic<bool> *Started, std::atomic<bool> *Go) : _Started(Started), _Go(Go) { }
+} ;
+
+int main(int argc, char *argv[])
+{
+	const int nSlices = 5 ;
+	ARE::utils::TaskScheduler scheduler ;
+	if (0 != scheduler.Start(1)) {
+		printf("\nFAILED : can't start the pool\n") ;
+		return 1 ;
+		}
+	std::atomic<bool> started(false), go(false) ;
+	scheduler.Submit(new GateTask(&started, &go)) ;
+	while (! started) 
+		std::this_thread::yield() ;
+	scheduler.Submit(new SliceTask(1, nSlices)) ;
+	scheduler.Submit(new SliceTask(2, nSlices)) ;
+	go = true ;
+	bool done = scheduler.Wait(10000) ;
+	scheduler.Stop() ;
+
+	// both tasks are queued on the same thread, so their slices should alternate.
+	bool ok = done && 2*nSlices == (int) Log.size() ;
+	printf("\nslices :") ;
+	for (size_t i = 0 ; i < Log.size() ; i++) {
+		printf(" %d", Log[i]) ;
+		if (i > 0 && Log[i] == Log[i-1]) 
+			ok = false ;
+		}
+	printf("\n%s\n", ok ? "OK" : "FAILED") ;
+	return ok ? 0 : 1 ;
+}